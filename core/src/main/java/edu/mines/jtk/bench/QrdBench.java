@@ -15,63 +15,148 @@ limitations under the License.
 package edu.mines.jtk.bench;
 
 import static edu.mines.jtk.util.ArrayMath.sum;
+import edu.mines.jtk.util.Parallel;
 import edu.mines.jtk.util.Stopwatch;
 
 /**
  * Benchmark QR decompositions in packages la and lapack.
+ * For large matrices, decompositions in the package la are blocked,
+ * and are benchmarked with and without multiple threads. For
+ * comparison, LU and Cholesky decompositions are also benchmarked.
  * @author Dave Hale, Colorado School of Mines
  * @version 2005.12.14
  */
 public class QrdBench {
 
   public static void main(String[] args) {
-    double maxtime = 5;
-    int m = 100;
-    int n = 5;
+    int[][] mns = {{100,5},{500,250},{2000,1000}};
+    for (int[] mn:mns)
+      benchQrd(mn[0],mn[1]);
+    int[] ns = {250,1000,2000};
+    for (int n:ns) {
+      benchLud(n);
+      benchChd(n);
+    }
+  }
+
+  private static final double MAXTIME = 5.0;
+  private static final int NITER = 3;
+
+  private static void benchQrd(int m, int n) {
     int nrhs = 5;
+    System.out.println("QR: m="+m+" n="+n+" nrhs="+nrhs);
 
     // Pure Java.
-    edu.mines.jtk.la.DMatrix aj = 
+    edu.mines.jtk.la.DMatrix aj =
       edu.mines.jtk.la.DMatrix.random(m,n);
-    edu.mines.jtk.la.DMatrix bj = 
+    edu.mines.jtk.la.DMatrix bj =
       edu.mines.jtk.la.DMatrix.random(m,nrhs);
 
     // LAPACK.
-    edu.mines.jtk.lapack.DMatrix al = 
+    edu.mines.jtk.lapack.DMatrix al =
       new edu.mines.jtk.lapack.DMatrix(aj.get());
-    edu.mines.jtk.lapack.DMatrix bl = 
+    edu.mines.jtk.lapack.DMatrix bl =
       new edu.mines.jtk.lapack.DMatrix(bj.get());
 
     double rate,sum;
     int nqrd;
     Stopwatch sw = new Stopwatch();
-    for (int niter=0; niter<5; ++niter) {
+    for (int niter=0; niter<NITER; ++niter) {
 
-      // edu.mines.jtk.la
-      edu.mines.jtk.la.DMatrixQrd qrd1;
-      edu.mines.jtk.la.DMatrix x1 = new edu.mines.jtk.la.DMatrix(1,1);
-      sw.restart();
-      for (nqrd=0;  sw.time()<maxtime; ++nqrd) {
-        qrd1 = new edu.mines.jtk.la.DMatrixQrd(aj);
-        x1 = qrd1.solve(bj);
+      // edu.mines.jtk.la, single- and multi-threaded
+      for (int parallel=0; parallel<2; ++parallel) {
+        Parallel.setParallel(parallel==1);
+        edu.mines.jtk.la.DMatrixQrd qrd1;
+        edu.mines.jtk.la.DMatrix x1 = new edu.mines.jtk.la.DMatrix(1,1);
+        sw.restart();
+        for (nqrd=0;  sw.time()<MAXTIME; ++nqrd) {
+          qrd1 = new edu.mines.jtk.la.DMatrixQrd(aj);
+          x1 = qrd1.solve(bj);
+        }
+        sw.stop();
+        sum = sum(x1.getArray());
+        rate = nqrd/sw.time();
+        System.out.println(label(parallel)+" rate="+rate+" sum="+sum);
       }
-      sw.stop();
-      sum = sum(x1.getArray());
-      rate = nqrd/sw.time();
-      System.out.println("edu.mines.jtk.la:     rate="+rate+" sum="+sum);
 
       // edu.mines.jtk.lapack
       edu.mines.jtk.lapack.DMatrixQrd qrd2;
       edu.mines.jtk.lapack.DMatrix x2 = new edu.mines.jtk.lapack.DMatrix(1,1);
       sw.restart();
-      for (nqrd=0;  sw.time()<maxtime; ++nqrd) {
+      for (nqrd=0;  sw.time()<MAXTIME; ++nqrd) {
         qrd2 = new edu.mines.jtk.lapack.DMatrixQrd(al);
         x2 = qrd2.solve(bl);
       }
       sw.stop();
       sum = sum(x2.getArray());
       rate = nqrd/sw.time();
-      System.out.println("edu.mines.jtk.lapack: rate="+rate+" sum="+sum);
+      System.out.println("edu.mines.jtk.lapack:    rate="+rate+" sum="+sum);
     }
   }
+
+  private static void benchLud(int n) {
+    System.out.println("LU: n="+n);
+    edu.mines.jtk.la.DMatrix aj = edu.mines.jtk.la.DMatrix.random(n,n);
+    edu.mines.jtk.lapack.DMatrix al =
+      new edu.mines.jtk.lapack.DMatrix(aj.get());
+    double rate,det;
+    int nlud;
+    Stopwatch sw = new Stopwatch();
+    for (int niter=0; niter<NITER; ++niter) {
+      for (int parallel=0; parallel<2; ++parallel) {
+        Parallel.setParallel(parallel==1);
+        det = 0.0;
+        sw.restart();
+        for (nlud=0;  sw.time()<MAXTIME; ++nlud)
+          det = new edu.mines.jtk.la.DMatrixLud(aj).det();
+        sw.stop();
+        rate = nlud/sw.time();
+        System.out.println(label(parallel)+" rate="+rate+" det="+det);
+      }
+      det = 0.0;
+      sw.restart();
+      for (nlud=0;  sw.time()<MAXTIME; ++nlud)
+        det = new edu.mines.jtk.lapack.DMatrixLud(al).det();
+      sw.stop();
+      rate = nlud/sw.time();
+      System.out.println("edu.mines.jtk.lapack:    rate="+rate+" det="+det);
+    }
+  }
+
+  private static void benchChd(int n) {
+    System.out.println("Cholesky: n="+n);
+    edu.mines.jtk.la.DMatrix rj = edu.mines.jtk.la.DMatrix.random(n,n);
+    edu.mines.jtk.la.DMatrix aj = rj.transposeTimes(rj).plus(
+      edu.mines.jtk.la.DMatrix.identity(n,n));
+    edu.mines.jtk.lapack.DMatrix al =
+      new edu.mines.jtk.lapack.DMatrix(aj.get());
+    double rate,det;
+    int nchd;
+    Stopwatch sw = new Stopwatch();
+    for (int niter=0; niter<NITER; ++niter) {
+      for (int parallel=0; parallel<2; ++parallel) {
+        Parallel.setParallel(parallel==1);
+        det = 0.0;
+        sw.restart();
+        for (nchd=0;  sw.time()<MAXTIME; ++nchd)
+          det = new edu.mines.jtk.la.DMatrixChd(aj).det();
+        sw.stop();
+        rate = nchd/sw.time();
+        System.out.println(label(parallel)+" rate="+rate+" det="+det);
+      }
+      det = 0.0;
+      sw.restart();
+      for (nchd=0;  sw.time()<MAXTIME; ++nchd)
+        det = new edu.mines.jtk.lapack.DMatrixChd(al).det();
+      sw.stop();
+      rate = nchd/sw.time();
+      System.out.println("edu.mines.jtk.lapack:    rate="+rate+" det="+det);
+    }
+  }
+
+  private static String label(int parallel) {
+    return (parallel==1) ?
+      "edu.mines.jtk.la (mt):  " :
+      "edu.mines.jtk.la (st):  ";
+  }
 }
@@ -15,6 +15,7 @@ limitations under the License.
 package edu.mines.jtk.dsp;
 
 import static edu.mines.jtk.util.ArrayMath.*;
+import edu.mines.jtk.la.DMatrixBatch;
 import edu.mines.jtk.util.Check;
 
 /**
@@ -521,27 +522,25 @@ public class LocalShiftFinder {
       s[i2][0] = 0.0f;
     for (int i1=0; i1<n1; ++i1)
       s[0][i1] = 0.0f;
+
+    // Prediction-error filter coefficients for one row of samples are
+    // solutions of a batch of 2-by-2 normal equations.
+    double[][][] a = new double[2][2][n1-1];
+    double[][] b = new double[2][n1-1];
     for (int i2=1; i2<n2; ++i2) {
       for (int i1=1; i1<n1; ++i1) {
-        double b1 = rm0[i2][i1];
-        double b2 = r0m[i2][i1];
-        double a11 = r00[i2][i1-1];
-        double a21 = rpm[i2][i1-1];
-        double a22 = r00[i2-1][i1];
-        double l11 = sqrt(a11);
-        double l21 = a21/l11;
-        double d22 = a22-l21*l21;
-        double x1 = 0.0;
-        double x2 = 0.0;
-        if (d22>0.0) {
-          double l22 = sqrt(d22);
-          double v1 = b1/l11;
-          double v2 = (b2-l21*v1)/l22;
-          x2 = v2/l22;
-          x1 = (v1-l21*x2)/l11;
-        }
-        float a1 = (float)x1;
-        float a2 = (float)x2;
+        int k = i1-1;
+        b[0][k] = rm0[i2][i1];
+        b[1][k] = r0m[i2][i1];
+        a[0][0][k] = r00[i2][i1-1];
+        a[1][0][k] = rpm[i2][i1-1];
+        a[1][1][k] = r00[i2-1][i1];
+      }
+      DMatrixBatch.solveCholesky(a,b);
+      for (int i1=1; i1<n1; ++i1) {
+        int k = i1-1;
+        float a1 = (float)b[0][k];
+        float a2 = (float)b[1][k];
         s[i2][i1] = f[i2][i1]
                     - a1*f[i2][i1-1]
                     - a2*f[i2-1][i1];
@@ -605,42 +604,31 @@ public class LocalShiftFinder {
     for (int i2=0; i2<n2; ++i2)
       for (int i1=0; i1<n1; ++i1)
         s[0][i2][i1] = 0.0f;
+
+    // Prediction-error filter coefficients for one row of samples are
+    // solutions of a batch of 3-by-3 normal equations.
+    double[][][] a = new double[3][3][n1-1];
+    double[][] b = new double[3][n1-1];
     for (int i3=1; i3<n3; ++i3) {
       for (int i2=1; i2<n2; ++i2) {
         for (int i1=1; i1<n1; ++i1) {
-          double b1 = rm00[i3][i2][i1];
-          double b2 = r0m0[i3][i2][i1];
-          double b3 = r00m[i3][i2][i1];
-          double a11 = r000[i3][i2][i1-1];
-          double a21 = rpm0[i3][i2][i1-1];
-          double a22 = r000[i3][i2-1][i1];
-          double a31 = rp0m[i3][i2][i1-1];
-          double a32 = r0pm[i3][i2-1][i1];
-          double a33 = r000[i3-1][i2][i1];
-          double x1 = 0.0;
-          double x2 = 0.0;
-          double x3 = 0.0;
-          double l11 = sqrt(a11);
-          double l21 = a21/l11;
-          double l31 = a31/l11;
-          double d22 = a22-l21*l21;
-          if (d22>0.0) {
-            double l22 = sqrt(d22);
-            double l32 = (a32-l31*l21)/l22;
-            double d33 = a33-l31*l31-l32*l32;
-            if (d33>0.0) {
-              double l33 = sqrt(d33);
-              double v1 = b1/l11;
-              double v2 = (b2-l21*v1)/l22;
-              double v3 = (b3-l31*v1-l32*v2)/l33;
-              x3 = v3/l33;
-              x2 = (v2-l32*x3)/l22;
-              x1 = (v1-l21*x2-l31*x3)/l11;
-            }
-          }
-          float a1 = (float)x1;
-          float a2 = (float)x2;
-          float a3 = (float)x3;
+          int k = i1-1;
+          b[0][k] = rm00[i3][i2][i1];
+          b[1][k] = r0m0[i3][i2][i1];
+          b[2][k] = r00m[i3][i2][i1];
+          a[0][0][k] = r000[i3][i2][i1-1];
+          a[1][0][k] = rpm0[i3][i2][i1-1];
+          a[1][1][k] = r000[i3][i2-1][i1];
+          a[2][0][k] = rp0m[i3][i2][i1-1];
+          a[2][1][k] = r0pm[i3][i2-1][i1];
+          a[2][2][k] = r000[i3-1][i2][i1];
+        }
+        DMatrixBatch.solveCholesky(a,b);
+        for (int i1=1; i1<n1; ++i1) {
+          int k = i1-1;
+          float a1 = (float)b[0][k];
+          float a2 = (float)b[1][k];
+          float a3 = (float)b[2][k];
           s[i3][i2][i1] = f[i3][i2][i1]
                           - a1*f[i3][i2][i1-1]
                           - a2*f[i3][i2-1][i1]
@@ -215,6 +215,88 @@ public class SibsonInterpolator2 {
       estimateGradients();
   }
 
+  /**
+   * Adds one sample to the samples to be interpolated.
+   * The mesh is updated incrementally, and the region in which
+   * interpolated values may change is remembered, so that values
+   * previously interpolated on a grid can be updated quickly.
+   * <p>
+   * If gradients are used, then a gradient for the new sample is
+   * estimated. Gradients for other samples are not modified.
+   * <p>
+   * If bounds have been set explicitly, and the sample lies outside the
+   * bounds of all previous samples, then ghost samples are replaced,
+   * so that they remain outside the convex hull, and all previously
+   * interpolated values become invalid.
+   * @param f the sample value f(x1,x2).
+   * @param x1 the sample x1 coordinate.
+   * @param x2 the sample x2 coordinate.
+   * @return the index of the new sample.
+   */
+  public int addSample(float f, float x1, float x2) {
+    TriMesh.Node node = new TriMesh.Node(x1,x2);
+    boolean added = _mesh.addNode(node);
+    Check.argument(added,"sample has unique coordinates");
+    int i = _nodes.length;
+    NodeData data = new NodeData();
+    data.f = f;
+    node.data = data;
+    node.index = i;
+    TriMesh.Node[] nodes = new TriMesh.Node[i+1];
+    System.arraycopy(_nodes,0,nodes,0,i);
+    nodes[i] = node;
+    _nodes = nodes;
+    updateBounds(x1,x2);
+    if (_haveGradients)
+      estimateGradient(node);
+    invalidate(node);
+    return i;
+  }
+
+  /**
+   * Removes the sample with specified index. The indices of other
+   * samples are unchanged. The mesh is updated incrementally, and the
+   * region in which interpolated values may change is remembered.
+   * @param i the index of the sample to remove.
+   */
+  public void removeSample(int i) {
+    TriMesh.Node node = _nodes[i];
+    Check.argument(node!=null,"sample has not been removed");
+    invalidate(node);
+    _mesh.removeNode(node);
+    _nodes[i] = null;
+  }
+
+  /**
+   * Moves the sample with specified index to specified coordinates.
+   * The mesh is updated incrementally, and the region in which
+   * interpolated values may change is remembered.
+   * <p>
+   * If gradients are used, then the gradient for the moved sample is
+   * estimated again. Gradients for other samples are not modified.
+   * <p>
+   * If bounds have been set explicitly, and the sample lies outside the
+   * bounds of all previous samples, then ghost samples are replaced,
+   * so that they remain outside the convex hull, and all previously
+   * interpolated values become invalid.
+   * @param i the index of the sample to move.
+   * @param x1 the new sample x1 coordinate.
+   * @param x2 the new sample x2 coordinate.
+   */
+  public void moveSample(int i, float x1, float x2) {
+    TriMesh.Node node = _nodes[i];
+    Check.argument(node!=null,"sample has not been removed");
+    if (x1==node.x() && x2==node.y())
+      return;
+    invalidate(node);
+    boolean moved = _mesh.moveNode(node,x1,x2);
+    Check.argument(moved,"sample has unique coordinates");
+    updateBounds(x1,x2);
+    if (_haveGradients)
+      estimateGradient(node);
+    invalidate(node);
+  }
+
   /**
    * Sets the null value for this interpolator.
    * This null value is returned when interpolation is attempted at a
@@ -239,6 +321,7 @@ public class SibsonInterpolator2 {
     int n = g1.length;
     for (int i=0; i<n; ++i) {
       TriMesh.Node node = _nodes[i];
+      if (node==null) continue;
       NodeData data = data(node);
       data.gx = g1[i];
       data.gy = g2[i];
@@ -290,6 +373,7 @@ public class SibsonInterpolator2 {
     _x1bmn = x1min; _x1bmx = x1max;
     _x2bmn = x2min; _x2bmx = x2max;
     _useBoundingBox = true;
+    invalidateAll();
 
     // Compute coordinates for ghost nodes, and add them to the mesh.
     float scale = 1.0f;
@@ -329,6 +413,7 @@ public class SibsonInterpolator2 {
   public void useConvexHullBounds() {
     _useBoundingBox = false;
     removeGhostNodes();
+    invalidateAll();
   }
 
   /**
@@ -367,9 +452,37 @@ public class SibsonInterpolator2 {
         f[i2][i1] = interpolate(x1,x2);
       }
     }
+    clearInvalid();
     return f;
   }
 
+  /**
+   * Updates an array of values previously interpolated on a grid.
+   * Values are interpolated again only for grid points in the region
+   * affected by samples added, removed or moved since the most recent
+   * interpolation on a grid. That region is the union of circumcircles
+   * of tris that reference those samples in the Delaunay tri mesh,
+   * before and after the changes. The array must contain values that
+   * were interpolated before those changes.
+   * @param s1 the sampling of n1 x1 coordinates.
+   * @param s2 the sampling of n2 x2 coordinates.
+   * @param f array[n2][n1] of interpolated values to update.
+   */
+  public void interpolate(Sampling s1, Sampling s2, float[][] f) {
+    int n1 = s1.getCount();
+    int n2 = s2.getCount();
+    for (int i2=0; i2<n2; ++i2) {
+      float x2 = (float)s2.getValue(i2);
+      if (x2<_x2imn || _x2imx<x2) continue;
+      for (int i1=0; i1<n1; ++i1) {
+        float x1 = (float)s1.getValue(i1);
+        if (x1<_x1imn || _x1imx<x1) continue;
+        f[i2][i1] = interpolate(x1,x2);
+      }
+    }
+    clearInvalid();
+  }
+
   /**
    * Gets sample indices and interpolation weights for the specified point.
    * Given a point (x1,x2), the sample indices represent the natural
@@ -481,7 +594,7 @@ public class SibsonInterpolator2 {
   }
 
   private TriMesh _mesh; // the mesh
-  private TriMesh.Node[] _nodes; // array of real (not ghost) nodes
+  private TriMesh.Node[] _nodes; // real (not ghost) nodes; null if removed
   private TriMesh.NodeList _nodeList; // list of natural neighbor nodes
   private TriMesh.TriList _triList; // list of natural neighbor tris
   private AreaAccumulator _va; // accumulates Sibson's areas
@@ -491,6 +604,7 @@ public class SibsonInterpolator2 {
   private float _x1min,_x1max,_x2min,_x2max; // bounds on specified (x1,x2)
   private float _x1bmn,_x1bmx,_x2bmn,_x2bmx; // bounding box if bounds set
   private boolean _useBoundingBox; // true if using bounding box
+  private double _x1imn,_x1imx,_x2imn,_x2imx; // invalid region
 
   // Builds the tri mesh from specified scattered samples.
   private void makeMesh(float[] f, float[] x1, float[] x2) {
@@ -508,6 +622,7 @@ public class SibsonInterpolator2 {
 
     // ArrayMath of nodes, one for each specified sample.
     _nodes = new TriMesh.Node[n];
+    clearInvalid();
 
     // Construct the mesh with nodes at sample points.
     _mesh = new TriMesh();
@@ -537,6 +652,48 @@ public class SibsonInterpolator2 {
     }
   }
 
+  // Adds to the invalid region the circumcircles of all tris that
+  // reference the specified node. Outside these circles, the node is
+  // not a natural neighbor of any point, so that changes to the node
+  // do not change interpolated values.
+  private void invalidate(TriMesh.Node node) {
+    TriMesh.Tri[] tris = _mesh.getTriNabors(node);
+    double[] c = new double[2];
+    for (TriMesh.Tri tri:tris) {
+      double r = Math.sqrt(tri.centerCircle(c));
+      if (c[0]-r<_x1imn) _x1imn = c[0]-r;
+      if (c[0]+r>_x1imx) _x1imx = c[0]+r;
+      if (c[1]-r<_x2imn) _x2imn = c[1]-r;
+      if (c[1]+r>_x2imx) _x2imx = c[1]+r;
+    }
+  }
+
+  // Makes the invalid region empty.
+  private void clearInvalid() {
+    _x1imn = _x2imn =  Double.MAX_VALUE;
+    _x1imx = _x2imx = -Double.MAX_VALUE;
+  }
+
+  // Makes the invalid region include all points.
+  private void invalidateAll() {
+    _x1imn = _x2imn = -Double.MAX_VALUE;
+    _x1imx = _x2imx =  Double.MAX_VALUE;
+  }
+
+  // Expands bounds on sample coordinates to include the specified point.
+  // Because coordinates of ghost nodes depend on these bounds, if they
+  // change while a bounding box is used, then ghost nodes are replaced.
+  private void updateBounds(float x1, float x2) {
+    if (x1>=_x1min && x1<=_x1max && x2>=_x2min && x2<=_x2max)
+      return;
+    _x1min = Math.min(_x1min,x1);  _x1max = Math.max(_x1max,x1);
+    _x2min = Math.min(_x2min,x2);  _x2max = Math.max(_x2max,x2);
+    if (_useBoundingBox) {
+      removeGhostNodes();
+      setBounds(_x1bmn,_x1bmx,_x2bmn,_x2bmx);
+    }
+  }
+
   // Returns true if gradients are being used in interpolation.
   private boolean usingGradients() {
     return _haveGradients && _gradientPower>0.0;
@@ -576,6 +733,7 @@ public class SibsonInterpolator2 {
     }
     for (int in=0; in<nn; ++in) {
       TriMesh.Node n = _nodes[in];
+      if (n==null) continue;
       double fn = f(n);
       double xn = n.xp();
       double yn = n.yp();
@@ -763,7 +921,8 @@ public class SibsonInterpolator2 {
   private void estimateGradients() {
     int nnode = _nodes.length;
     for (int inode=0; inode<nnode; ++inode)
-      estimateGradient(_nodes[inode]);
+      if (_nodes[inode]!=null)
+        estimateGradient(_nodes[inode]);
     _haveGradients = true;
   }
 
@@ -218,6 +218,90 @@ public class SibsonInterpolator3 {
       estimateGradients();
   }
 
+  /**
+   * Adds one sample to the samples to be interpolated.
+   * The mesh is updated incrementally, and the region in which
+   * interpolated values may change is remembered, so that values
+   * previously interpolated on a grid can be updated quickly.
+   * <p>
+   * If gradients are used, then a gradient for the new sample is
+   * estimated. Gradients for other samples are not modified.
+   * <p>
+   * If bounds have been set explicitly, and the sample lies outside the
+   * bounds of all previous samples, then ghost samples are replaced,
+   * so that they remain outside the convex hull, and all previously
+   * interpolated values become invalid.
+   * @param f the sample value f(x1,x2,x3).
+   * @param x1 the sample x1 coordinate.
+   * @param x2 the sample x2 coordinate.
+   * @param x3 the sample x3 coordinate.
+   * @return the index of the new sample.
+   */
+  public int addSample(float f, float x1, float x2, float x3) {
+    TetMesh.Node node = new TetMesh.Node(x1,x2,x3);
+    boolean added = _mesh.addNode(node);
+    Check.argument(added,"sample has unique coordinates");
+    int i = _nodes.length;
+    NodeData data = new NodeData();
+    data.f = f;
+    node.data = data;
+    node.index = i;
+    TetMesh.Node[] nodes = new TetMesh.Node[i+1];
+    System.arraycopy(_nodes,0,nodes,0,i);
+    nodes[i] = node;
+    _nodes = nodes;
+    updateBounds(x1,x2,x3);
+    if (_haveGradients)
+      estimateGradient(node);
+    invalidate(node);
+    return i;
+  }
+
+  /**
+   * Removes the sample with specified index. The indices of other
+   * samples are unchanged. The mesh is updated incrementally, and the
+   * region in which interpolated values may change is remembered.
+   * @param i the index of the sample to remove.
+   */
+  public void removeSample(int i) {
+    TetMesh.Node node = _nodes[i];
+    Check.argument(node!=null,"sample has not been removed");
+    invalidate(node);
+    _mesh.removeNode(node);
+    _nodes[i] = null;
+  }
+
+  /**
+   * Moves the sample with specified index to specified coordinates.
+   * The mesh is updated incrementally, and the region in which
+   * interpolated values may change is remembered.
+   * <p>
+   * If gradients are used, then the gradient for the moved sample is
+   * estimated again. Gradients for other samples are not modified.
+   * <p>
+   * If bounds have been set explicitly, and the sample lies outside the
+   * bounds of all previous samples, then ghost samples are replaced,
+   * so that they remain outside the convex hull, and all previously
+   * interpolated values become invalid.
+   * @param i the index of the sample to move.
+   * @param x1 the new sample x1 coordinate.
+   * @param x2 the new sample x2 coordinate.
+   * @param x3 the new sample x3 coordinate.
+   */
+  public void moveSample(int i, float x1, float x2, float x3) {
+    TetMesh.Node node = _nodes[i];
+    Check.argument(node!=null,"sample has not been removed");
+    if (x1==node.x() && x2==node.y() && x3==node.z())
+      return;
+    invalidate(node);
+    boolean moved = _mesh.moveNode(node,x1,x2,x3);
+    Check.argument(moved,"sample has unique coordinates");
+    updateBounds(x1,x2,x3);
+    if (_haveGradients)
+      estimateGradient(node);
+    invalidate(node);
+  }
+
   /**
    * Sets gradients for all samples. If the gradient power is currently 
    * zero, then this method also sets the gradient power to one. To later
@@ -231,6 +315,7 @@ public class SibsonInterpolator3 {
     int n = g1.length;
     for (int i=0; i<n; ++i) {
       TetMesh.Node node = _nodes[i];
+      if (node==null) continue;
       NodeData data = data(node);
       data.gx = g1[i];
       data.gy = g2[i];
@@ -303,6 +388,7 @@ public class SibsonInterpolator3 {
     _x2bmn = x2min; _x2bmx = x2max;
     _x3bmn = x3min; _x3bmx = x3max;
     _useBoundingBox = true;
+    invalidateAll();
 
     // Compute coordinates for ghost nodes, and add them to the mesh.
     float scale = 1.0f;
@@ -350,6 +436,7 @@ public class SibsonInterpolator3 {
   public void useConvexHullBounds() {
     _useBoundingBox = false;
     removeGhostNodes();
+    invalidateAll();
   }
 
   /**
@@ -398,9 +485,45 @@ public class SibsonInterpolator3 {
       }
     }
     log.fine("interpolate: end");
+    clearInvalid();
     return f;
   }
 
+  /**
+   * Updates an array of values previously interpolated on a grid.
+   * Values are interpolated again only for grid points in the region
+   * affected by samples added, removed or moved since the most recent
+   * interpolation on a grid. That region is the union of circumspheres
+   * of tets that reference those samples in the Delaunay tet mesh,
+   * before and after the changes. The array must contain values that
+   * were interpolated before those changes.
+   * @param s1 the sampling of n1 x1 coordinates.
+   * @param s2 the sampling of n2 x2 coordinates.
+   * @param s3 the sampling of n3 x3 coordinates.
+   * @param f array[n3][n2][n1] of interpolated values to update.
+   */
+  public void interpolate(
+    Sampling s1, Sampling s2, Sampling s3, float[][][] f)
+  {
+    int n1 = s1.getCount();
+    int n2 = s2.getCount();
+    int n3 = s3.getCount();
+    for (int i3=0; i3<n3; ++i3) {
+      float x3 = (float)s3.getValue(i3);
+      if (x3<_x3imn || _x3imx<x3) continue;
+      for (int i2=0; i2<n2; ++i2) {
+        float x2 = (float)s2.getValue(i2);
+        if (x2<_x2imn || _x2imx<x2) continue;
+        for (int i1=0; i1<n1; ++i1) {
+          float x1 = (float)s1.getValue(i1);
+          if (x1<_x1imn || _x1imx<x1) continue;
+          f[i3][i2][i1] = interpolate(x1,x2,x3);
+        }
+      }
+    }
+    clearInvalid();
+  }
+
   /**
    * Gets sample indices and interpolation weights for the specified point.
    * Given a point (x1,x2,x3), the sample indices represent the natural
@@ -520,7 +643,7 @@ public class SibsonInterpolator3 {
   }
 
   private TetMesh _mesh; // the mesh
-  private TetMesh.Node[] _nodes; // array of real (not ghost) nodes
+  private TetMesh.Node[] _nodes; // real (not ghost) nodes; null if removed
   private TetMesh.NodeList _nodeList; // list of natural neighbor nodes
   private TetMesh.TetList _tetList; // list of natural neighbor tets
   private VolumeAccumulator _va; // accumulates Sibson's volumes
@@ -530,6 +653,7 @@ public class SibsonInterpolator3 {
   private float _x1min,_x1max,_x2min,_x2max,_x3min,_x3max; // for (x1,x2,x3)
   private float _x1bmn,_x1bmx,_x2bmn,_x2bmx,_x3bmn,_x3bmx; // if bounds set
   private boolean _useBoundingBox; // true if using bounding box
+  private double _x1imn,_x1imx,_x2imn,_x2imx,_x3imn,_x3imx; // invalid region
 
   // Returns a tet mesh built from specified scattered samples.
   private void makeMesh(float[] f, float[] x1, float[] x2, float[] x3) {
@@ -550,6 +674,7 @@ public class SibsonInterpolator3 {
 
     // ArrayMath of nodes, one for each specified sample.
     _nodes = new TetMesh.Node[n];
+    clearInvalid();
 
     // Construct the mesh with nodes at sample points.
     _mesh = new TetMesh();
@@ -582,6 +707,53 @@ public class SibsonInterpolator3 {
     }
   }
 
+  // Adds to the invalid region the circumspheres of all tets that
+  // reference the specified node. Outside these spheres, the node is
+  // not a natural neighbor of any point, so that changes to the node
+  // do not change interpolated values.
+  private void invalidate(TetMesh.Node node) {
+    TetMesh.Tet[] tets = _mesh.getTetNabors(node);
+    double[] c = new double[3];
+    for (TetMesh.Tet tet:tets) {
+      double r = Math.sqrt(tet.centerSphere(c));
+      if (c[0]-r<_x1imn) _x1imn = c[0]-r;
+      if (c[0]+r>_x1imx) _x1imx = c[0]+r;
+      if (c[1]-r<_x2imn) _x2imn = c[1]-r;
+      if (c[1]+r>_x2imx) _x2imx = c[1]+r;
+      if (c[2]-r<_x3imn) _x3imn = c[2]-r;
+      if (c[2]+r>_x3imx) _x3imx = c[2]+r;
+    }
+  }
+
+  // Makes the invalid region empty.
+  private void clearInvalid() {
+    _x1imn = _x2imn = _x3imn =  Double.MAX_VALUE;
+    _x1imx = _x2imx = _x3imx = -Double.MAX_VALUE;
+  }
+
+  // Makes the invalid region include all points.
+  private void invalidateAll() {
+    _x1imn = _x2imn = _x3imn = -Double.MAX_VALUE;
+    _x1imx = _x2imx = _x3imx =  Double.MAX_VALUE;
+  }
+
+  // Expands bounds on sample coordinates to include the specified point.
+  // Because coordinates of ghost nodes depend on these bounds, if they
+  // change while a bounding box is used, then ghost nodes are replaced.
+  private void updateBounds(float x1, float x2, float x3) {
+    if (x1>=_x1min && x1<=_x1max &&
+        x2>=_x2min && x2<=_x2max &&
+        x3>=_x3min && x3<=_x3max)
+      return;
+    _x1min = Math.min(_x1min,x1);  _x1max = Math.max(_x1max,x1);
+    _x2min = Math.min(_x2min,x2);  _x2max = Math.max(_x2max,x2);
+    _x3min = Math.min(_x3min,x3);  _x3max = Math.max(_x3max,x3);
+    if (_useBoundingBox) {
+      removeGhostNodes();
+      setBounds(_x1bmn,_x1bmx,_x2bmn,_x2bmx,_x3bmn,_x3bmx);
+    }
+  }
+
   // Returns true if gradients are being used in interpolation.
   private boolean usingGradients() {
     return _haveGradients && _gradientPower>0.0;
@@ -622,6 +794,7 @@ public class SibsonInterpolator3 {
     }
     for (int in=0; in<nn; ++in) {
       TetMesh.Node n = _nodes[in];
+      if (n==null) continue;
       double fn = f(n);
       double xn = n.xp();
       double yn = n.yp();
@@ -825,7 +998,8 @@ public class SibsonInterpolator3 {
   private void estimateGradients() {
     int nnode = _nodes.length;
     for (int inode=0; inode<nnode; ++inode)
-      estimateGradient(_nodes[inode]);
+      if (_nodes[inode]!=null)
+        estimateGradient(_nodes[inode]);
     _haveGradients = true;
   }
 
@@ -0,0 +1,229 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.io;
+
+import java.io.Closeable;
+import java.io.File;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.ByteOrder;
+import java.nio.FloatBuffer;
+import java.nio.channels.FileChannel;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * An array of floats stored in a memory-mapped file. The number of floats
+ * may exceed both the maximum length of a Java array and the amount of
+ * physical memory. The operating system pages parts of the file in and
+ * out of memory as those parts are accessed.
+ * <p>
+ * Because a single mapped buffer cannot exceed 2 GB, the file is mapped
+ * in segments of {@link #SEGMENT_LENGTH} floats. Each segment may be
+ * accessed as a {@link java.nio.FloatBuffer}, and contiguous ranges of
+ * floats within a segment may be copied to and from arrays. Different
+ * threads may concurrently access different ranges of floats.
+ * <p>
+ * Floats are stored in native byte order. Files created as temporary
+ * files are deleted when this array is closed, or else when the virtual
+ * machine exits. Mapped segments are released by the garbage collector,
+ * after this array is closed.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.21
+ */
+public class MappedFloatArray implements Closeable {
+
+  /**
+   * The number of floats in each mapped segment, except perhaps the last.
+   */
+  public static final int SEGMENT_LENGTH = 1<<28;
+
+  /**
+   * Constructs an array for the specified file and number of floats.
+   * If necessary, the file is created or extended to hold the floats.
+   * Values of floats not already in the file are zero.
+   * @param file the file.
+   * @param n the number of floats.
+   */
+  public MappedFloatArray(File file, long n) throws IOException {
+    this(file,n,false);
+  }
+
+  /**
+   * Returns a new array of floats stored in a temporary file.
+   * Values of all floats are initially zero. The file is deleted
+   * when the array is closed, or else when the virtual machine exits.
+   * @param dir the directory for the temporary file; if null, the
+   *  default temporary-file directory.
+   * @param n the number of floats.
+   * @return the array.
+   */
+  public static MappedFloatArray createTemp(File dir, long n)
+    throws IOException
+  {
+    File file = File.createTempFile("jtk",".dat",dir);
+    file.deleteOnExit();
+    return new MappedFloatArray(file,n,true);
+  }
+
+  /**
+   * Gets the number of floats in this array.
+   * @return the number of floats.
+   */
+  public long size() {
+    return _n;
+  }
+
+  /**
+   * Gets the file that stores this array.
+   * @return the file.
+   */
+  public File getFile() {
+    return _file;
+  }
+
+  /**
+   * Gets the number of mapped segments.
+   * @return the number of segments.
+   */
+  public int getSegmentCount() {
+    return _fb.length;
+  }
+
+  /**
+   * Gets a view of the specified segment. The returned buffer has an
+   * independent position and limit, and may be used by one thread while
+   * other threads use other views.
+   * @param iseg the segment index.
+   * @return the buffer.
+   */
+  public FloatBuffer getSegment(int iseg) {
+    return checkOpen()[iseg].duplicate();
+  }
+
+  /**
+   * Gets the value of one float.
+   * @param i the index of the float.
+   * @return the value.
+   */
+  public float get(long i) {
+    return checkOpen()[(int)(i/SEGMENT_LENGTH)].get((int)(i%SEGMENT_LENGTH));
+  }
+
+  /**
+   * Sets the value of one float.
+   * @param i the index of the float.
+   * @param v the value.
+   */
+  public void set(long i, float v) {
+    checkOpen()[(int)(i/SEGMENT_LENGTH)].put((int)(i%SEGMENT_LENGTH),v);
+  }
+
+  /**
+   * Copies a contiguous range of floats from this array. The range may
+   * span more than one segment.
+   * @param i the index of the first float to copy.
+   * @param n the number of floats to copy.
+   * @param a the array to which to copy floats.
+   * @param j the index in the array a of the first float copied.
+   */
+  public void get(long i, int n, float[] a, int j) {
+    FloatBuffer[] fb = checkOpen();
+    while (n>0) {
+      int iseg = (int)(i/SEGMENT_LENGTH);
+      int ioff = (int)(i%SEGMENT_LENGTH);
+      int m = Math.min(n,SEGMENT_LENGTH-ioff);
+      FloatBuffer b = fb[iseg].duplicate();
+      b.position(ioff);
+      b.get(a,j,m);
+      i += m;
+      j += m;
+      n -= m;
+    }
+  }
+
+  /**
+   * Copies a contiguous range of floats to this array. The range may
+   * span more than one segment.
+   * @param i the index of the first float to copy to.
+   * @param n the number of floats to copy.
+   * @param a the array from which to copy floats.
+   * @param j the index in the array a of the first float copied.
+   */
+  public void set(long i, int n, float[] a, int j) {
+    FloatBuffer[] fb = checkOpen();
+    while (n>0) {
+      int iseg = (int)(i/SEGMENT_LENGTH);
+      int ioff = (int)(i%SEGMENT_LENGTH);
+      int m = Math.min(n,SEGMENT_LENGTH-ioff);
+      FloatBuffer b = fb[iseg].duplicate();
+      b.position(ioff);
+      b.put(a,j,m);
+      i += m;
+      j += m;
+      n -= m;
+    }
+  }
+
+  /**
+   * Closes this array. The array cannot be used after it is closed.
+   * If created as a temporary file, the file is deleted.
+   */
+  public void close() throws IOException {
+    if (_fb!=null) {
+      _fb = null;
+      _raf.close();
+      if (_temp)
+        _file.delete();
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private File _file; // the file
+  private RandomAccessFile _raf; // random-access file, while open
+  private long _n; // number of floats
+  private boolean _temp; // true, if temporary file
+  private FloatBuffer[] _fb; // mapped segments; null, if closed
+
+  private MappedFloatArray(File file, long n, boolean temp)
+    throws IOException
+  {
+    Check.argument(n>=0,"n is non-negative");
+    _file = file;
+    _n = n;
+    _temp = temp;
+    _raf = new RandomAccessFile(file,"rw");
+    if (_raf.length()<4*n)
+      _raf.setLength(4*n);
+    FileChannel fc = _raf.getChannel();
+    int nseg = (int)((n+SEGMENT_LENGTH-1)/SEGMENT_LENGTH);
+    _fb = new FloatBuffer[nseg];
+    for (int iseg=0; iseg<nseg; ++iseg) {
+      long i = (long)iseg*SEGMENT_LENGTH;
+      long m = Math.min(n-i,SEGMENT_LENGTH);
+      _fb[iseg] = fc.map(FileChannel.MapMode.READ_WRITE,4*i,4*m)
+        .order(ByteOrder.nativeOrder()).asFloatBuffer();
+    }
+  }
+
+  private FloatBuffer[] checkOpen() {
+    FloatBuffer[] fb = _fb;
+    Check.state(fb!=null,"array is open");
+    return fb;
+  }
+}
@@ -0,0 +1,300 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.max;
+import static java.lang.Math.min;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A banded matrix is a square matrix specified by a few diagonals. All
+ * elements except for those on kl lower sub-diagonals, the diagonal, and
+ * ku upper super-diagonals are equal to zero. The diagonals are
+ * represented by kl+ku+1 arrays d[0], d[1], ..., d[kl+ku], in which
+ * element (i,j) of the matrix is stored in d[kl+j-i][i]. Here is an
+ * example of a pentadiagonal system of n = 5 equations, with kl = ku = 2:
+ * <pre><code>
+ *  |d[2][0] d[3][0] d[4][0]    0       0   | |u[0]|   |r[0]|
+ *  |d[1][1] d[2][1] d[3][1] d[4][1]    0   | |u[1]|   |r[1]|
+ *  |d[0][2] d[1][2] d[2][2] d[3][2] d[4][2]| |u[2]| = |r[2]|
+ *  |   0    d[0][3] d[1][3] d[2][3] d[3][3]| |u[3]|   |r[3]|
+ *  |   0       0    d[0][4] d[1][4] d[2][4]| |u[4]|   |r[4]|
+ * </code></pre>
+ * Array elements that correspond to matrix elements outside the matrix,
+ * such as d[0][0] and d[4][4] above, are ignored. For kl = ku = 1, the
+ * arrays d[0], d[1] and d[2] are the arrays a, b and c of a
+ * {@link TridiagonalFMatrix}.
+ * <p>
+ * Like those for tridiagonal matrices, solutions for banded systems
+ * use Gaussian elimination without pivoting. They are appropriate for
+ * matrices that are diagonally dominant or positive-definite. Systems
+ * with many right-hand-side vectors may be solved in parallel with one
+ * call, so that the factorization of this matrix is computed only once.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.20
+ */
+public class BandedFMatrix {
+
+  /**
+   * Constructs a banded matrix with the specified number of rows and
+   * diagonals. All matrix elements are initially zero.
+   * @param n the number of rows (and columns) in the matrix.
+   * @param kl the number of lower sub-diagonals.
+   * @param ku the number of upper super-diagonals.
+   */
+  public BandedFMatrix(int n, int kl, int ku) {
+    this(n,kl,ku,new float[kl+ku+1][n]);
+  }
+
+  /**
+   * Constructs a banded matrix with specified elements.
+   * The array d is passed by reference, not by copy.
+   * @param n the number of rows (and columns) in the matrix.
+   * @param kl the number of lower sub-diagonals.
+   * @param ku the number of upper super-diagonals.
+   * @param d array[kl+ku+1][n] of diagonals.
+   */
+  public BandedFMatrix(int n, int kl, int ku, float[][] d) {
+    Check.argument(kl>=0,"kl is non-negative");
+    Check.argument(ku>=0,"ku is non-negative");
+    Check.argument(d.length==kl+ku+1,"d.length equals kl+ku+1");
+    _n = n;
+    _kl = kl;
+    _ku = ku;
+    _d = d;
+  }
+
+  /**
+   * Returns the number of rows and columns in this matrix.
+   * @return the number of rows and columns.
+   */
+  public int n() {
+    return _n;
+  }
+
+  /**
+   * Returns the number of lower sub-diagonals in this matrix.
+   * @return the number of lower sub-diagonals.
+   */
+  public int kl() {
+    return _kl;
+  }
+
+  /**
+   * Returns the number of upper super-diagonals in this matrix.
+   * @return the number of upper super-diagonals.
+   */
+  public int ku() {
+    return _ku;
+  }
+
+  /**
+   * Returns the array of diagonals of this matrix.
+   * @return the array of diagonals; by reference, not by copy.
+   */
+  public float[][] d() {
+    return _d;
+  }
+
+  /**
+   * Gets the element (i,j) of this matrix.
+   * @param i the row index.
+   * @param j the column index.
+   * @return the element; zero, if outside the band.
+   */
+  public float get(int i, int j) {
+    int k = _kl+j-i;
+    return (0<=k && k<=_kl+_ku)?_d[k][i]:0.0f;
+  }
+
+  /**
+   * Sets the element (i,j) of this matrix.
+   * @param i the row index.
+   * @param j the column index, which must be within the band.
+   * @param v the element value.
+   */
+  public void set(int i, int j, float v) {
+    int k = _kl+j-i;
+    Check.argument(0<=k && k<=_kl+_ku,"element (i,j) is within the band");
+    _d[k][i] = v;
+  }
+
+  /**
+   * Solves this banded system for specified right-hand-side.
+   * Uses Gaussian elimination without pivoting, and assumes that this
+   * matrix is non-singular.
+   * @param r input array containing the right-hand-side column vector.
+   * @param u output array containing the left-hand-side vector of unknowns;
+   *  may be the same as the array r.
+   */
+  public void solve(float[] r, float[] u) {
+    solve(factor(),r,u);
+  }
+
+  /**
+   * Solves this banded system for many right-hand-side vectors stored in
+   * the 1st dimension of 2D arrays.
+   * @param r input array[m][n] containing m right-hand-side vectors.
+   * @param u output array[m][n] containing m vectors of unknowns;
+   *  may be the same as the array r.
+   */
+  public void solve1(final float[][] r, final float[][] u) {
+    Check.argument(r.length==u.length,"r and u have same number of vectors");
+    final float[][] f = factor();
+    Parallel.loop(r.length,new Parallel.LoopInt() {
+      public void compute(int i) {
+        solve(f,r[i],u[i]);
+      }
+    });
+  }
+
+  /**
+   * Solves this banded system for many right-hand-side vectors stored in
+   * the 2nd dimension of 2D arrays. Loops over vectors are innermost,
+   * and may be vectorized.
+   * @param r input array[n][m] containing m right-hand-side vectors.
+   * @param u output array[n][m] containing m vectors of unknowns;
+   *  may be the same as the array r.
+   */
+  public void solve2(final float[][] r, final float[][] u) {
+    Check.argument(r.length==_n,"r.length equals n");
+    Check.argument(u.length==_n,"u.length equals n");
+    final float[][] f = factor();
+    final int m = r[0].length;
+    int nc = (m+CHUNK-1)/CHUNK;
+    Parallel.loop(nc,new Parallel.LoopInt() {
+      public void compute(int ic) {
+        int k0 = ic*CHUNK;
+        int k1 = min(k0+CHUNK,m);
+        solve2(k0,k1,f,r,u);
+      }
+    });
+  }
+
+  /**
+   * Multiplies this matrix by the specified column vector.
+   * @param x input array containing the column vector.
+   * @return array containing the matrix-vector product.
+   */
+  public float[] times(float[] x) {
+    float[] y = new float[_n];
+    times(x,y);
+    return y;
+  }
+
+  /**
+   * Multiplies this matrix by the specified column vector.
+   * @param x input array containing the column vector.
+   * @param y output array containing the matrix-vector product.
+   */
+  public void times(float[] x, float[] y) {
+    for (int i=0; i<_n; ++i) {
+      int j0 = max(0,i-_kl);
+      int j1 = min(_n-1,i+_ku);
+      float yi = 0.0f;
+      for (int j=j0; j<=j1; ++j)
+        yi += _d[_kl+j-i][i]*x[j];
+      y[i] = yi;
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int CHUNK = 256; // vectors per task in solve2
+
+  private int _n; // number of rows and columns
+  private int _kl,_ku; // numbers of sub- and super-diagonals
+  private float[][] _d; // the diagonals
+
+  /**
+   * Returns the factors L and U, stored in the same way as the diagonals
+   * of this matrix. The unit diagonal of L is not stored, and the diagonal
+   * of U is stored as reciprocals of pivots.
+   */
+  private float[][] factor() {
+    int n = _n;
+    int kl = _kl;
+    int ku = _ku;
+    float[][] f = new float[kl+ku+1][];
+    for (int k=0; k<=kl+ku; ++k)
+      f[k] = Arrays.copyOf(_d[k],n);
+    for (int j=0; j<n; ++j) {
+      float p = f[kl][j] = 1.0f/f[kl][j];
+      int i1 = min(n-1,j+kl);
+      int c1 = min(n-1,j+ku);
+      for (int i=j+1; i<=i1; ++i) {
+        float lij = f[kl+j-i][i] *= p;
+        for (int c=j+1; c<=c1; ++c)
+          f[kl+c-i][i] -= lij*f[kl+c-j][j];
+      }
+    }
+    return f;
+  }
+
+  private void solve(float[][] f, float[] r, float[] u) {
+    int n = _n;
+    int kl = _kl;
+    int ku = _ku;
+    for (int i=0; i<n; ++i) {
+      float ui = r[i];
+      for (int j=max(0,i-kl); j<i; ++j)
+        ui -= f[kl+j-i][i]*u[j];
+      u[i] = ui;
+    }
+    for (int i=n-1; i>=0; --i) {
+      float ui = u[i];
+      int j1 = min(n-1,i+ku);
+      for (int j=i+1; j<=j1; ++j)
+        ui -= f[kl+j-i][i]*u[j];
+      u[i] = ui*f[kl][i];
+    }
+  }
+
+  private void solve2(int k0, int k1, float[][] f, float[][] r, float[][] u) {
+    int n = _n;
+    int kl = _kl;
+    int ku = _ku;
+    for (int i=0; i<n; ++i) {
+      float[] ri = r[i];
+      float[] ui = u[i];
+      for (int k=k0; k<k1; ++k)
+        ui[k] = ri[k];
+      for (int j=max(0,i-kl); j<i; ++j) {
+        float fij = f[kl+j-i][i];
+        float[] uj = u[j];
+        for (int k=k0; k<k1; ++k)
+          ui[k] -= fij*uj[k];
+      }
+    }
+    for (int i=n-1; i>=0; --i) {
+      float[] ui = u[i];
+      int j1 = min(n-1,i+ku);
+      for (int j=i+1; j<=j1; ++j) {
+        float fij = f[kl+j-i][i];
+        float[] uj = u[j];
+        for (int k=k0; k<k1; ++k)
+          ui[k] -= fij*uj[k];
+      }
+      float fii = f[kl][i];
+      for (int k=k0; k<k1; ++k)
+        ui[k] *= fii;
+    }
+  }
+}
@@ -0,0 +1,258 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A sparse double-precision matrix in block compressed sparse row (BSR)
+ * format. The matrix is partitioned into dense square blocks with nb rows
+ * and nb columns, and only blocks with non-zero elements are stored. The
+ * storage is like that for {@link CsrDMatrix}, but with indices for block
+ * rows and columns. For the k'th row of blocks, elements rp[k] through
+ * rp[k+1]-1 of the array ci contain the column indices of non-zero blocks
+ * in that block row. The nb*nb values of the block with index p are stored
+ * by rows in elements p*nb*nb through (p+1)*nb*nb-1 of the array v.
+ * <p>
+ * Block storage is efficient for matrices with multiple unknowns per
+ * node, such as those for vector fields sampled on meshes. Only one
+ * column index is stored for each block, and the elements in each block
+ * are multiplied with contiguous inner loops. Matrix-vector multiplication
+ * y = A*x is computed using multiple threads, for blocks of block rows.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class BsrDMatrix implements DOperator {
+
+  /**
+   * Constructs a matrix from the specified arrays in BSR format. The
+   * arrays are referenced, not copied. Column indices within each block
+   * row must be sorted in increasing order, without duplicates.
+   * @param mb the number of block rows.
+   * @param nb the number of rows and columns in each block.
+   * @param n the number of columns; must be a multiple of nb.
+   * @param rp array[mb+1] of block row pointers.
+   * @param ci array[rp[mb]] of block column indices.
+   * @param v array[rp[mb]*nb*nb] of values.
+   */
+  public BsrDMatrix(
+    int mb, int nb, int n, int[] rp, int[] ci, double[] v)
+  {
+    Check.argument(n%nb==0,"n is a multiple of nb");
+    Check.argument(rp.length==mb+1,"rp.length equals mb+1");
+    Check.argument(ci.length>=rp[mb],"ci.length not less than rp[mb]");
+    Check.argument(v.length>=rp[mb]*nb*nb,"v.length >= rp[mb]*nb*nb");
+    for (int kb=0; kb<mb; ++kb) {
+      for (int p=rp[kb]; p<rp[kb+1]; ++p) {
+        Check.argument(0<=ci[p] && ci[p]<n/nb,"block indices are in bounds");
+        Check.argument(p==rp[kb] || ci[p-1]<ci[p],
+          "block column indices in each block row are increasing");
+      }
+    }
+    _mb = mb;
+    _nb = nb;
+    _n = n;
+    _rp = rp;
+    _ci = ci;
+    _v = v;
+  }
+
+  /**
+   * Returns a matrix in BSR format with the same elements as the
+   * specified matrix in CSR format. A block is stored for every
+   * block that contains at least one stored element.
+   * @param a the matrix in CSR format.
+   * @param nb the number of rows and columns in each block. The
+   *  numbers of rows and columns in the matrix must be multiples of nb.
+   * @return the matrix in BSR format.
+   */
+  public static BsrDMatrix fromCsr(CsrDMatrix a, int nb) {
+    int m = a.getM();
+    int n = a.getN();
+    Check.argument(m%nb==0,"m is a multiple of nb");
+    Check.argument(n%nb==0,"n is a multiple of nb");
+    int mb = m/nb;
+    int[] arp = a.getRowPointers();
+    int[] aci = a.getColumnIndices();
+    double[] av = a.getValues();
+    int nbb = nb*nb;
+
+    // Sorted block column indices for each block row. The array mark
+    // records for each block column the index of the last block stored.
+    int[] mark = new int[n/nb];
+    Arrays.fill(mark,-1);
+    int[] rp = new int[mb+1];
+    int[] ci = new int[a.countNonZeros()];
+    int nnzb = 0;
+    for (int kb=0; kb<mb; ++kb) {
+      int p0 = nnzb;
+      for (int i=kb*nb; i<kb*nb+nb; ++i) {
+        for (int p=arp[i]; p<arp[i+1]; ++p) {
+          int kj = aci[p]/nb;
+          if (mark[kj]<p0) {
+            mark[kj] = nnzb;
+            ci[nnzb++] = kj;
+          }
+        }
+      }
+      Arrays.sort(ci,p0,nnzb);
+      rp[kb+1] = nnzb;
+    }
+
+    // Values, copied into blocks for each block row.
+    double[] v = new double[nnzb*nbb];
+    for (int kb=0; kb<mb; ++kb) {
+      for (int p=rp[kb]; p<rp[kb+1]; ++p)
+        mark[ci[p]] = p;
+      for (int ib=0,i=kb*nb; ib<nb; ++ib,++i) {
+        for (int p=arp[i]; p<arp[i+1]; ++p) {
+          int j = aci[p];
+          v[mark[j/nb]*nbb+ib*nb+j%nb] = av[p];
+        }
+      }
+    }
+    return new BsrDMatrix(mb,nb,n,rp,Arrays.copyOf(ci,nnzb),v);
+  }
+
+  /**
+   * Gets the number of rows in this matrix.
+   * @return the number of rows.
+   */
+  public int getM() {
+    return _mb*_nb;
+  }
+
+  /**
+   * Gets the number of columns in this matrix.
+   * @return the number of columns.
+   */
+  public int getN() {
+    return _n;
+  }
+
+  /**
+   * Gets the number of rows and columns in each block.
+   * @return the block size.
+   */
+  public int getBlockSize() {
+    return _nb;
+  }
+
+  /**
+   * Returns the number of non-zero blocks stored in this matrix.
+   * @return the number of non-zero blocks.
+   */
+  public int countNonZeroBlocks() {
+    return _rp[_mb];
+  }
+
+  /**
+   * Computes y = A*x, where A is this matrix. Block rows of y are
+   * computed in parallel.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void times(final double[] x, final double[] y) {
+    Check.argument(x.length>=_n,"x.length not less than n");
+    Check.argument(y.length>=getM(),"y.length not less than m");
+    int nnzk = 1+_rp[_mb]*_nb*_nb/Math.max(1,_mb); // non-zeros per block row
+    final int kc = Math.max(1,Math.min(_mb,NNZ_BLOCK/nnzk));
+    int nc = (_mb+kc-1)/kc;
+    if (nc<2) {
+      times(0,_mb,x,y);
+    } else {
+      Parallel.loop(nc,new Parallel.LoopInt() {
+        public void compute(int ic) {
+          times(ic*kc,Math.min(_mb,ic*kc+kc),x,y);
+        }
+      });
+    }
+  }
+
+  /**
+   * Returns y = A*x, where A is this matrix.
+   * @param x input array[n].
+   * @return output array[m].
+   */
+  public double[] times(double[] x) {
+    double[] y = new double[getM()];
+    times(x,y);
+    return y;
+  }
+
+  /**
+   * Applies this matrix. Computes y = A*x.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void apply(double[] x, double[] y) {
+    times(x,y);
+  }
+
+  /**
+   * Returns a dense copy of this matrix.
+   * @return the dense matrix.
+   */
+  public DMatrix toDMatrix() {
+    int nb = _nb;
+    double[][] a = new double[getM()][_n];
+    for (int kb=0; kb<_mb; ++kb) {
+      for (int p=_rp[kb]; p<_rp[kb+1]; ++p) {
+        int kj = _ci[p];
+        for (int ib=0; ib<nb; ++ib)
+          for (int jb=0; jb<nb; ++jb)
+            a[kb*nb+ib][kj*nb+jb] = _v[p*nb*nb+ib*nb+jb];
+      }
+    }
+    return new DMatrix(getM(),_n,a);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NNZ_BLOCK = 16384; // non-zeros per parallel task
+
+  private int _mb; // number of block rows
+  private int _nb; // number of rows and columns in each block
+  private int _n; // number of columns
+  private int[] _rp; // block row pointers
+  private int[] _ci; // block column indices
+  private double[] _v; // values
+
+  private void times(int kb0, int kb1, double[] x, double[] y) {
+    int nb = _nb;
+    int nbb = nb*nb;
+    int[] rp = _rp;
+    int[] ci = _ci;
+    double[] v = _v;
+    for (int kb=kb0; kb<kb1; ++kb) {
+      int i0 = kb*nb;
+      for (int ib=0; ib<nb; ++ib)
+        y[i0+ib] = 0.0;
+      for (int p=rp[kb]; p<rp[kb+1]; ++p) {
+        int j0 = ci[p]*nb;
+        for (int ib=0,q=p*nbb; ib<nb; ++ib,q+=nb) {
+          double s = 0.0;
+          for (int jb=0; jb<nb; ++jb)
+            s += v[q+jb]*x[j0+jb];
+          y[i0+ib] += s;
+        }
+      }
+    }
+  }
+}
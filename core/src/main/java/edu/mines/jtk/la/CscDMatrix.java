@@ -0,0 +1,242 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A sparse double-precision matrix in compressed sparse column (CSC) format.
+ * Non-zero elements of an m-by-n matrix are stored in three arrays. For
+ * the j'th column, elements cp[j] through cp[j+1]-1 of the arrays ri and v
+ * contain the row indices and values of non-zero elements in that column.
+ * Row indices in each column are sorted in increasing order.
+ * <p>
+ * The arrays for a matrix in CSC format are the same as those for its
+ * transpose in CSR format. Multiplication with the transpose, y = A'*x,
+ * is therefore computed in parallel in the same way as for a
+ * {@link CsrDMatrix}. For y = A*x, blocks of columns are multiplied in
+ * parallel, each into a separate array, and those arrays are summed.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class CscDMatrix implements DOperator {
+
+  /**
+   * Constructs a matrix from the specified arrays in CSC format. The
+   * arrays are referenced, not copied. Row indices within each column
+   * must be sorted in increasing order, without duplicates.
+   * @param m the number of rows.
+   * @param n the number of columns.
+   * @param cp array[n+1] of column pointers.
+   * @param ri array[cp[n]] of row indices.
+   * @param v array[cp[n]] of values.
+   */
+  public CscDMatrix(int m, int n, int[] cp, int[] ri, double[] v) {
+    this(new CsrDMatrix(n,m,cp,ri,v));
+  }
+
+  /**
+   * Returns a matrix in CSC format with the same elements as the
+   * specified matrix in CSR format.
+   * @param a the matrix in CSR format.
+   * @return the matrix in CSC format.
+   */
+  public static CscDMatrix fromCsr(CsrDMatrix a) {
+    return new CscDMatrix(a.transpose());
+  }
+
+  /**
+   * Returns a matrix constructed from the specified triplets (i,j,v).
+   * Triplets may be specified in any order. The values of triplets with
+   * the same indices (i,j) are summed.
+   * @param m the number of rows.
+   * @param n the number of columns.
+   * @param i array of row indices.
+   * @param j array of column indices.
+   * @param v array of values.
+   * @return the matrix.
+   */
+  public static CscDMatrix fromTriplets(
+    int m, int n, int[] i, int[] j, double[] v)
+  {
+    return new CscDMatrix(CsrDMatrix.fromTriplets(n,m,j,i,v));
+  }
+
+  /**
+   * Gets the number of rows in this matrix.
+   * @return the number of rows.
+   */
+  public int getM() {
+    return _t.getN();
+  }
+
+  /**
+   * Gets the number of columns in this matrix.
+   * @return the number of columns.
+   */
+  public int getN() {
+    return _t.getM();
+  }
+
+  /**
+   * Returns the number of non-zero elements stored in this matrix.
+   * @return the number of non-zero elements.
+   */
+  public int countNonZeros() {
+    return _t.countNonZeros();
+  }
+
+  /**
+   * Gets the array of column pointers.
+   * @return array[n+1] of column pointers; by reference, not by copy.
+   */
+  public int[] getColumnPointers() {
+    return _t.getRowPointers();
+  }
+
+  /**
+   * Gets the array of row indices.
+   * @return array of row indices; by reference, not by copy.
+   */
+  public int[] getRowIndices() {
+    return _t.getColumnIndices();
+  }
+
+  /**
+   * Gets the array of values of non-zero elements.
+   * @return array of values; by reference, not by copy.
+   */
+  public double[] getValues() {
+    return _t.getValues();
+  }
+
+  /**
+   * Gets a matrix element.
+   * @param i the row index.
+   * @param j the column index.
+   * @return the element; zero, if not stored.
+   */
+  public double get(int i, int j) {
+    return _t.get(j,i);
+  }
+
+  /**
+   * Computes y = A*x, where A is this matrix.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void times(final double[] x, double[] y) {
+    final int m = getM();
+    final int n = getN();
+    Check.argument(x.length>=n,"x.length not less than n");
+    Check.argument(y.length>=m,"y.length not less than m");
+    final int[] cp = getColumnPointers();
+    int nnz = cp[n];
+    int nb = Math.max(1,Math.min(NBLOCK_MAX,nnz/NNZ_BLOCK));
+    if (nb==1) {
+      Arrays.fill(y,0,m,0.0);
+      times(0,n,x,y);
+    } else {
+      final int jb = (n+nb-1)/nb;
+      double[] ys = Parallel.reduce(nb,new Parallel.ReduceInt<double[]>() {
+        public double[] compute(int ib) {
+          double[] s = new double[m];
+          times(ib*jb,Math.min(n,ib*jb+jb),x,s);
+          return s;
+        }
+        public double[] combine(double[] s1, double[] s2) {
+          for (int i=0; i<m; ++i)
+            s1[i] += s2[i];
+          return s1;
+        }
+      });
+      System.arraycopy(ys,0,y,0,m);
+    }
+  }
+
+  /**
+   * Returns y = A*x, where A is this matrix.
+   * @param x input array[n].
+   * @return output array[m].
+   */
+  public double[] times(double[] x) {
+    double[] y = new double[getM()];
+    times(x,y);
+    return y;
+  }
+
+  /**
+   * Computes y = A'*x, where A' is the transpose of this matrix.
+   * Elements of y are computed in parallel.
+   * @param x input array[m].
+   * @param y output array[n].
+   */
+  public void transposeTimes(double[] x, double[] y) {
+    _t.times(x,y);
+  }
+
+  /**
+   * Applies this matrix. Computes y = A*x.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void apply(double[] x, double[] y) {
+    times(x,y);
+  }
+
+  /**
+   * Returns a copy of this matrix in CSR format.
+   * @return the matrix in CSR format.
+   */
+  public CsrDMatrix toCsr() {
+    return _t.transpose();
+  }
+
+  /**
+   * Returns a dense copy of this matrix.
+   * @return the dense matrix.
+   */
+  public DMatrix toDMatrix() {
+    return _t.toDMatrix().transpose();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NNZ_BLOCK = 65536; // min non-zeros per block
+  private static final int NBLOCK_MAX = 16; // max number of column blocks
+
+  private CsrDMatrix _t; // transpose in CSR format has same arrays
+
+  private CscDMatrix(CsrDMatrix t) {
+    _t = t;
+  }
+
+  private void times(int j0, int j1, double[] x, double[] y) {
+    int[] cp = getColumnPointers();
+    int[] ri = getRowIndices();
+    double[] v = getValues();
+    for (int j=j0; j<j1; ++j) {
+      double xj = x[j];
+      if (xj!=0.0) {
+        for (int p=cp[j],pend=cp[j+1]; p<pend; ++p)
+          y[ri[p]] += v[p]*xj;
+      }
+    }
+  }
+}
@@ -0,0 +1,433 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A sparse double-precision matrix in compressed sparse row (CSR) format.
+ * Non-zero elements of an m-by-n matrix are stored in three arrays. For
+ * the i'th row, elements rp[i] through rp[i+1]-1 of the arrays ci and v
+ * contain the column indices and values of non-zero elements in that row.
+ * Column indices in each row are sorted in increasing order.
+ * <p>
+ * Matrix-vector multiplication y = A*x is computed using multiple threads,
+ * with rows partitioned into blocks that have similar numbers of non-zero
+ * elements. Multiplication with the transpose, y = A'*x, is serial; for
+ * that product, a {@link CscDMatrix} with the same elements is faster.
+ * <p>
+ * Sparse matrices are constructed from arrays in CSR format, or from
+ * triplets (i,j,v) of row indices, column indices and values in any order,
+ * or from dense matrices.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class CsrDMatrix implements DOperator {
+
+  /**
+   * Constructs a matrix from the specified arrays in CSR format. The
+   * arrays are referenced, not copied. Column indices within each row
+   * must be sorted in increasing order, without duplicates.
+   * @param m the number of rows.
+   * @param n the number of columns.
+   * @param rp array[m+1] of row pointers.
+   * @param ci array[rp[m]] of column indices.
+   * @param v array[rp[m]] of values.
+   */
+  public CsrDMatrix(int m, int n, int[] rp, int[] ci, double[] v) {
+    Check.argument(rp.length==m+1,"rp.length equals m+1");
+    Check.argument(rp[0]==0,"rp[0] equals zero");
+    Check.argument(ci.length>=rp[m],"ci.length not less than rp[m]");
+    Check.argument(v.length>=rp[m],"v.length not less than rp[m]");
+    for (int i=0; i<m; ++i) {
+      Check.argument(rp[i]<=rp[i+1],"row pointers are non-decreasing");
+      for (int p=rp[i]; p<rp[i+1]; ++p) {
+        Check.argument(0<=ci[p] && ci[p]<n,"column indices are in bounds");
+        Check.argument(p==rp[i] || ci[p-1]<ci[p],
+          "column indices in each row are increasing");
+      }
+    }
+    _m = m;
+    _n = n;
+    _rp = rp;
+    _ci = ci;
+    _v = v;
+    _rb = makeRowBlocks(m,rp);
+  }
+
+  /**
+   * Constructs a sparse copy of the specified dense matrix. Only
+   * non-zero elements of the dense matrix are stored.
+   * @param a the dense matrix.
+   */
+  public CsrDMatrix(DMatrix a) {
+    int m = _m = a.getM();
+    int n = _n = a.getN();
+    double[][] aa = a.getArray();
+    int nnz = 0;
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        if (aa[i][j]!=0.0) ++nnz;
+    _rp = new int[m+1];
+    _ci = new int[nnz];
+    _v = new double[nnz];
+    for (int i=0,p=0; i<m; ++i) {
+      for (int j=0; j<n; ++j) {
+        if (aa[i][j]!=0.0) {
+          _ci[p] = j;
+          _v[p++] = aa[i][j];
+        }
+      }
+      _rp[i+1] = p;
+    }
+    _rb = makeRowBlocks(m,_rp);
+  }
+
+  /**
+   * Returns a matrix constructed from the specified triplets (i,j,v).
+   * Triplets may be specified in any order. The values of triplets with
+   * the same indices (i,j) are summed.
+   * @param m the number of rows.
+   * @param n the number of columns.
+   * @param i array of row indices.
+   * @param j array of column indices.
+   * @param v array of values.
+   * @return the matrix.
+   */
+  public static CsrDMatrix fromTriplets(
+    int m, int n, int[] i, int[] j, double[] v)
+  {
+    int nt = i.length;
+    Check.argument(j.length==nt,"j.length equals i.length");
+    Check.argument(v.length==nt,"v.length equals i.length");
+
+    // Sort triplets by row, with a counting sort.
+    int[] rp = new int[m+1];
+    for (int it=0; it<nt; ++it) {
+      Check.argument(0<=i[it] && i[it]<m,"row indices are in bounds");
+      Check.argument(0<=j[it] && j[it]<n,"column indices are in bounds");
+      ++rp[i[it]+1];
+    }
+    for (int ir=0; ir<m; ++ir)
+      rp[ir+1] += rp[ir];
+    int[] next = Arrays.copyOf(rp,m);
+    int[] cj = new int[nt];
+    double[] cv = new double[nt];
+    for (int it=0; it<nt; ++it) {
+      int p = next[i[it]]++;
+      cj[p] = j[it];
+      cv[p] = v[it];
+    }
+
+    // Within each row, sort by column and sum duplicates.
+    int[] ci = new int[nt];
+    double[] cw = new double[nt];
+    int[] rq = new int[m+1];
+    int nnz = 0;
+    for (int ir=0; ir<m; ++ir) {
+      int p0 = rp[ir], p1 = rp[ir+1];
+      sortRow(cj,cv,p0,p1);
+      for (int p=p0; p<p1; ++p) {
+        if (nnz>rq[ir] && ci[nnz-1]==cj[p]) {
+          cw[nnz-1] += cv[p];
+        } else {
+          ci[nnz] = cj[p];
+          cw[nnz++] = cv[p];
+        }
+      }
+      rq[ir+1] = nnz;
+    }
+    return wrap(m,n,rq,Arrays.copyOf(ci,nnz),Arrays.copyOf(cw,nnz));
+  }
+
+  /**
+   * Gets the number of rows in this matrix.
+   * @return the number of rows.
+   */
+  public int getM() {
+    return _m;
+  }
+
+  /**
+   * Gets the number of columns in this matrix.
+   * @return the number of columns.
+   */
+  public int getN() {
+    return _n;
+  }
+
+  /**
+   * Returns the number of non-zero elements stored in this matrix.
+   * @return the number of non-zero elements.
+   */
+  public int countNonZeros() {
+    return _rp[_m];
+  }
+
+  /**
+   * Gets the array of row pointers.
+   * @return array[m+1] of row pointers; by reference, not by copy.
+   */
+  public int[] getRowPointers() {
+    return _rp;
+  }
+
+  /**
+   * Gets the array of column indices.
+   * @return array of column indices; by reference, not by copy.
+   */
+  public int[] getColumnIndices() {
+    return _ci;
+  }
+
+  /**
+   * Gets the array of values of non-zero elements.
+   * @return array of values; by reference, not by copy.
+   */
+  public double[] getValues() {
+    return _v;
+  }
+
+  /**
+   * Gets a matrix element.
+   * @param i the row index.
+   * @param j the column index.
+   * @return the element; zero, if not stored.
+   */
+  public double get(int i, int j) {
+    int p = find(i,j);
+    return (p>=0)?_v[p]:0.0;
+  }
+
+  /**
+   * Gets the diagonal elements of this matrix.
+   * @return array[min(m,n)] of diagonal elements.
+   */
+  public double[] getDiagonal() {
+    int mn = Math.min(_m,_n);
+    double[] d = new double[mn];
+    for (int i=0; i<mn; ++i)
+      d[i] = get(i,i);
+    return d;
+  }
+
+  /**
+   * Determines whether this matrix is symmetric (and square).
+   * @return true, if symmetric (and square); false, otherwise.
+   */
+  public boolean isSymmetric() {
+    if (_m!=_n)
+      return false;
+    for (int i=0; i<_m; ++i) {
+      for (int p=_rp[i]; p<_rp[i+1]; ++p) {
+        int q = find(_ci[p],i);
+        if (q<0 || _v[q]!=_v[p])
+          return false;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Computes y = A*x, where A is this matrix. Rows of y are computed in
+   * parallel.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void times(final double[] x, final double[] y) {
+    Check.argument(x.length>=_n,"x.length not less than n");
+    Check.argument(y.length>=_m,"y.length not less than m");
+    int nb = _rb.length-1;
+    if (nb==1) {
+      times(0,_m,x,y);
+    } else {
+      Parallel.loop(nb,new Parallel.LoopInt() {
+        public void compute(int ib) {
+          times(_rb[ib],_rb[ib+1],x,y);
+        }
+      });
+    }
+  }
+
+  /**
+   * Returns y = A*x, where A is this matrix.
+   * @param x input array[n].
+   * @return output array[m].
+   */
+  public double[] times(double[] x) {
+    double[] y = new double[_m];
+    times(x,y);
+    return y;
+  }
+
+  /**
+   * Computes y = A'*x, where A' is the transpose of this matrix.
+   * @param x input array[m].
+   * @param y output array[n].
+   */
+  public void transposeTimes(double[] x, double[] y) {
+    Check.argument(x.length>=_m,"x.length not less than m");
+    Check.argument(y.length>=_n,"y.length not less than n");
+    Arrays.fill(y,0,_n,0.0);
+    for (int i=0; i<_m; ++i) {
+      double xi = x[i];
+      if (xi!=0.0) {
+        for (int p=_rp[i]; p<_rp[i+1]; ++p)
+          y[_ci[p]] += _v[p]*xi;
+      }
+    }
+  }
+
+  /**
+   * Applies this matrix. Computes y = A*x.
+   * @param x input array[n].
+   * @param y output array[m].
+   */
+  public void apply(double[] x, double[] y) {
+    times(x,y);
+  }
+
+  /**
+   * Returns the transpose of this matrix.
+   * @return the transpose.
+   */
+  public CsrDMatrix transpose() {
+    int m = _m, n = _n, nnz = _rp[m];
+    int[] tp = new int[n+1];
+    for (int p=0; p<nnz; ++p)
+      ++tp[_ci[p]+1];
+    for (int j=0; j<n; ++j)
+      tp[j+1] += tp[j];
+    int[] next = Arrays.copyOf(tp,n);
+    int[] ti = new int[nnz];
+    double[] tv = new double[nnz];
+    for (int i=0; i<m; ++i) {
+      for (int p=_rp[i]; p<_rp[i+1]; ++p) {
+        int q = next[_ci[p]]++;
+        ti[q] = i;
+        tv[q] = _v[p];
+      }
+    }
+    return wrap(n,m,tp,ti,tv);
+  }
+
+  /**
+   * Returns a dense copy of this matrix.
+   * @return the dense matrix.
+   */
+  public DMatrix toDMatrix() {
+    double[][] a = new double[_m][_n];
+    for (int i=0; i<_m; ++i)
+      for (int p=_rp[i]; p<_rp[i+1]; ++p)
+        a[i][_ci[p]] = _v[p];
+    return new DMatrix(_m,_n,a);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // package
+
+  /**
+   * Returns the index of element (i,j) in the arrays of column indices
+   * and values; or -1, if that element is not stored.
+   */
+  int find(int i, int j) {
+    int p = Arrays.binarySearch(_ci,_rp[i],_rp[i+1],j);
+    return (p>=0)?p:-1;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NNZ_BLOCK = 16384; // non-zeros per row block
+
+  private int _m; // number of rows
+  private int _n; // number of columns
+  private int[] _rp; // row pointers
+  private int[] _ci; // column indices
+  private double[] _v; // values
+  private int[] _rb; // first rows in blocks used in parallel products
+
+  private CsrDMatrix() {
+  }
+
+  /**
+   * Returns a matrix that references the specified arrays, without
+   * checking them. Used for arrays computed here, which are known to
+   * be valid.
+   */
+  private static CsrDMatrix wrap(
+    int m, int n, int[] rp, int[] ci, double[] v)
+  {
+    CsrDMatrix a = new CsrDMatrix();
+    a._m = m;
+    a._n = n;
+    a._rp = rp;
+    a._ci = ci;
+    a._v = v;
+    a._rb = makeRowBlocks(m,rp);
+    return a;
+  }
+
+  private void times(int i0, int i1, double[] x, double[] y) {
+    int[] rp = _rp;
+    int[] ci = _ci;
+    double[] v = _v;
+    for (int i=i0; i<i1; ++i) {
+      double s = 0.0;
+      for (int p=rp[i],pend=rp[i+1]; p<pend; ++p)
+        s += v[p]*x[ci[p]];
+      y[i] = s;
+    }
+  }
+
+  /**
+   * Partitions rows into blocks with about NNZ_BLOCK non-zeros each.
+   * Returns an array of first rows in each block, terminated by m.
+   */
+  private static int[] makeRowBlocks(int m, int[] rp) {
+    int nnz = rp[m];
+    int nb = Math.max(1,Math.min(m,nnz/NNZ_BLOCK));
+    int[] rb = new int[nb+1];
+    for (int ib=1,i=0; ib<nb; ++ib) {
+      long target = (long)nnz*ib/nb;
+      while (i<m && rp[i]<target)
+        ++i;
+      rb[ib] = Math.max(i,rb[ib-1]);
+    }
+    rb[nb] = m;
+    return rb;
+  }
+
+  /**
+   * Sorts column indices and corresponding values in the specified range.
+   * Rows are typically short, so an insertion sort is used.
+   */
+  private static void sortRow(int[] c, double[] v, int p0, int p1) {
+    for (int p=p0+1; p<p1; ++p) {
+      int cp = c[p];
+      double vp = v[p];
+      int q = p-1;
+      for (; q>=p0 && c[q]>cp; --q) {
+        c[q+1] = c[q];
+        v[q+1] = v[q];
+      }
+      c[q+1] = cp;
+      v[q+1] = vp;
+    }
+  }
+}
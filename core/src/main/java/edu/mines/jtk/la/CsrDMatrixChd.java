@@ -0,0 +1,369 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.max;
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Cholesky decomposition of a sparse symmetric positive-definite matrix.
+ * The decomposition is P*A*P' = L*L', where P is a permutation matrix
+ * and L is a sparse lower triangular matrix.
+ * <p>
+ * The permutation P is either the identity or a reverse Cuthill-McKee
+ * ordering, which tends to reduce the bandwidth of P*A*P' and therefore
+ * the number of non-zero elements in L. The factor L is computed one row
+ * at a time with an up-looking algorithm. The non-zero pattern of each row
+ * of L is obtained by traversing the elimination tree of P*A*P', and that
+ * row is computed by a sparse triangular solve with the rows above it.
+ * <p>
+ * This decomposition is intended for matrices of moderate size, those
+ * with up to a few hundred thousand rows and columns, and with factors
+ * L that fit in memory.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class CsrDMatrixChd {
+
+  /**
+   * Constructs a decomposition of the specified matrix A, using
+   * a reverse Cuthill-McKee ordering.
+   * The matrix A must be symmetric. For efficiency, this condition
+   * is assumed and not checked. That is, only the lower triangular
+   * part of A is used to perform the decomposition.
+   * @param a the matrix.
+   */
+  public CsrDMatrixChd(CsrDMatrix a) {
+    this(a,true);
+  }
+
+  /**
+   * Constructs a decomposition of the specified matrix A.
+   * The matrix A must be symmetric. For efficiency, this condition
+   * is assumed and not checked. That is, only the lower triangular
+   * part of A is used to perform the decomposition.
+   * @param a the matrix.
+   * @param reorder true, to use a reverse Cuthill-McKee ordering;
+   *  false, to use the original ordering.
+   */
+  public CsrDMatrixChd(CsrDMatrix a, boolean reorder) {
+    Check.argument(a.getM()==a.getN(),"A is square");
+    int n = _n = a.getN();
+    _p = reorder?rcm(a):identity(n);
+    _pinv = new int[n];
+    for (int k=0; k<n; ++k)
+      _pinv[_p[k]] = k;
+    permute(a);
+    int[] parent = etree();
+    _pd = decompose(parent);
+  }
+
+  /**
+   * Determines whether the matrix A is positive definite. (The matrix
+   * A was assumed to be symmetric when this decomposition was constructed.)
+   * If not symmetric and positive-definite, then this decomposition cannot
+   * be used to solve systems of linear equations.
+   * @return true, if positive-definite; false, otherwise.
+   */
+  public boolean isPositiveDefinite() {
+    return _pd;
+  }
+
+  /**
+   * Returns the number of non-zero elements in the factor L.
+   * @return the number of non-zero elements.
+   */
+  public int countNonZeros() {
+    return _lp[_n];
+  }
+
+  /**
+   * Gets the permutation used in this decomposition. Row k of
+   * P*A*P' is row p[k] of A.
+   * @return array of permuted indices p.
+   */
+  public int[] getPermutation() {
+    return Arrays.copyOf(_p,_n);
+  }
+
+  /**
+   * Returns the solution x of the linear system A*x = b.
+   * The matrix A must be symmetric and positive-definite.
+   * @param b the right-hand-side array b.
+   * @return the solution array x.
+   */
+  public double[] solve(double[] b) {
+    Check.argument(_n==b.length,"A and b have same number of rows");
+    Check.state(_pd,"A is positive-definite");
+    int n = _n;
+    int[] lp = _lp;
+    int[] li = _li;
+    double[] lx = _lx;
+    double[] y = new double[n];
+    for (int k=0; k<n; ++k)
+      y[k] = b[_p[k]];
+
+    // Solve L*z = P*b, with L stored by columns.
+    for (int j=0; j<n; ++j) {
+      double yj = y[j] /= lx[lp[j]];
+      for (int p=lp[j]+1; p<lp[j+1]; ++p)
+        y[li[p]] -= lx[p]*yj;
+    }
+
+    // Solve L'*y = z.
+    for (int j=n-1; j>=0; --j) {
+      double yj = y[j];
+      for (int p=lp[j]+1; p<lp[j+1]; ++p)
+        yj -= lx[p]*y[li[p]];
+      y[j] = yj/lx[lp[j]];
+    }
+
+    double[] x = new double[n];
+    for (int k=0; k<n; ++k)
+      x[_p[k]] = y[k];
+    return x;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private int _n; // number of rows and columns
+  private int[] _p,_pinv; // permutation and its inverse
+  private int[] _cp,_ci; // row pointers and columns for lower part of PAP'
+  private double[] _cv; // values for lower part of PAP'
+  private int[] _lp,_li; // column pointers and row indices for L
+  private double[] _lx; // values for L, with diagonal first in columns
+  private boolean _pd; // true, if positive-definite
+
+  private static int[] identity(int n) {
+    int[] p = new int[n];
+    for (int i=0; i<n; ++i)
+      p[i] = i;
+    return p;
+  }
+
+  /**
+   * Returns a reverse Cuthill-McKee ordering for the graph of the
+   * lower triangle of A (and its transpose).
+   */
+  private static int[] rcm(CsrDMatrix a) {
+    int n = a.getN();
+    int[] rp = a.getRowPointers();
+    int[] ci = a.getColumnIndices();
+
+    // Symmetric adjacency lists, without diagonal elements.
+    int[] deg = new int[n];
+    for (int i=0; i<n; ++i) {
+      for (int p=rp[i]; p<rp[i+1] && ci[p]<i; ++p) {
+        ++deg[i];
+        ++deg[ci[p]];
+      }
+    }
+    int[] gp = new int[n+1];
+    for (int i=0; i<n; ++i)
+      gp[i+1] = gp[i]+deg[i];
+    int[] gi = new int[gp[n]];
+    int[] next = Arrays.copyOf(gp,n);
+    for (int i=0; i<n; ++i) {
+      for (int p=rp[i]; p<rp[i+1] && ci[p]<i; ++p) {
+        int j = ci[p];
+        gi[next[i]++] = j;
+        gi[next[j]++] = i;
+      }
+    }
+
+    // Nodes sorted by increasing degree, for starting nodes.
+    int dmax = 0;
+    for (int i=0; i<n; ++i)
+      dmax = max(dmax,deg[i]);
+    int[] dp = new int[dmax+2];
+    for (int i=0; i<n; ++i)
+      ++dp[deg[i]+1];
+    for (int d=0; d<=dmax; ++d)
+      dp[d+1] += dp[d];
+    int[] byDegree = new int[n];
+    for (int i=0; i<n; ++i)
+      byDegree[dp[deg[i]]++] = i;
+
+    // Breadth-first searches, with neighbors in order of increasing degree.
+    boolean[] visited = new boolean[n];
+    int[] q = new int[n];
+    int nq = 0;
+    for (int s=0; s<n; ++s) {
+      int i0 = byDegree[s];
+      if (visited[i0])
+        continue;
+      visited[i0] = true;
+      q[nq++] = i0;
+      for (int iq=nq-1; iq<nq; ++iq) {
+        int i = q[iq];
+        int nq0 = nq;
+        for (int p=gp[i]; p<gp[i+1]; ++p) {
+          int j = gi[p];
+          if (!visited[j]) {
+            visited[j] = true;
+            int m = nq++;
+            for (; m>nq0 && deg[q[m-1]]>deg[j]; --m)
+              q[m] = q[m-1];
+            q[m] = j;
+          }
+        }
+      }
+    }
+
+    // Reverse the ordering.
+    int[] perm = new int[n];
+    for (int k=0; k<n; ++k)
+      perm[k] = q[n-1-k];
+    return perm;
+  }
+
+  /**
+   * Computes the lower triangle of C = P*A*P' in compressed row format.
+   * Row k of the lower triangle of C is column k of its upper triangle.
+   */
+  private void permute(CsrDMatrix a) {
+    int n = _n;
+    int[] pinv = _pinv;
+    int[] rp = a.getRowPointers();
+    int[] ci = a.getColumnIndices();
+    double[] v = a.getValues();
+    int[] cp = _cp = new int[n+1];
+    for (int i=0; i<n; ++i) {
+      for (int p=rp[i]; p<rp[i+1] && ci[p]<=i; ++p)
+        ++cp[max(pinv[i],pinv[ci[p]])+1];
+    }
+    for (int k=0; k<n; ++k)
+      cp[k+1] += cp[k];
+    _ci = new int[cp[n]];
+    _cv = new double[cp[n]];
+    int[] next = Arrays.copyOf(cp,n);
+    for (int i=0; i<n; ++i) {
+      for (int p=rp[i]; p<rp[i+1] && ci[p]<=i; ++p) {
+        int ki = pinv[i], kj = pinv[ci[p]];
+        int k = max(ki,kj);
+        int q = next[k]++;
+        _ci[q] = min(ki,kj);
+        _cv[q] = v[p];
+      }
+    }
+  }
+
+  /**
+   * Returns the elimination tree of C, with path compression.
+   */
+  private int[] etree() {
+    int n = _n;
+    int[] cp = _cp;
+    int[] ci = _ci;
+    int[] parent = new int[n];
+    int[] ancestor = new int[n];
+    for (int k=0; k<n; ++k) {
+      parent[k] = -1;
+      ancestor[k] = -1;
+      for (int p=cp[k]; p<cp[k+1]; ++p) {
+        int inext;
+        for (int i=ci[p]; i!=-1 && i<k; i=inext) {
+          inext = ancestor[i];
+          ancestor[i] = k;
+          if (inext==-1)
+            parent[i] = k;
+        }
+      }
+    }
+    return parent;
+  }
+
+  /**
+   * Finds the non-zero pattern of row k of L, by traversing the
+   * elimination tree from each non-zero element in row k of C.
+   * Stores the pattern in s[top:n-1], in topological order,
+   * and returns top. Nodes visited are marked with w[i] = k.
+   */
+  private int ereach(int k, int[] parent, int[] s, int[] w) {
+    int n = _n;
+    int top = n;
+    w[k] = k;
+    for (int p=_cp[k]; p<_cp[k+1]; ++p) {
+      int i = _ci[p];
+      int len = 0;
+      for (; w[i]!=k; i=parent[i]) {
+        s[len++] = i;
+        w[i] = k;
+      }
+      while (len>0)
+        s[--top] = s[--len];
+    }
+    return top;
+  }
+
+  /**
+   * Computes the factor L, by columns, using an up-looking algorithm.
+   * Returns true, if successful; false, if A is not positive-definite.
+   */
+  private boolean decompose(int[] parent) {
+    int n = _n;
+    int[] s = new int[n];
+    int[] w = new int[n];
+    double[] x = new double[n];
+
+    // Column counts, from the patterns of rows of L.
+    Arrays.fill(w,-1);
+    int[] lp = _lp = new int[n+1];
+    for (int k=0; k<n; ++k) {
+      ++lp[k+1];
+      for (int top=ereach(k,parent,s,w); top<n; ++top)
+        ++lp[s[top]+1];
+    }
+    for (int k=0; k<n; ++k)
+      lp[k+1] += lp[k];
+    int[] li = _li = new int[lp[n]];
+    double[] lx = _lx = new double[lp[n]];
+    int[] c = Arrays.copyOf(lp,n);
+
+    // Row k of L, by solving L(0:k-1,0:k-1)*l = C(0:k-1,k).
+    Arrays.fill(w,-1);
+    for (int k=0; k<n; ++k) {
+      int top = ereach(k,parent,s,w);
+      x[k] = 0.0;
+      for (int p=_cp[k]; p<_cp[k+1]; ++p)
+        x[_ci[p]] += _cv[p];
+      double d = x[k];
+      x[k] = 0.0;
+      for (; top<n; ++top) {
+        int i = s[top];
+        double lki = x[i]/lx[lp[i]];
+        x[i] = 0.0;
+        for (int p=lp[i]+1; p<c[i]; ++p)
+          x[li[p]] -= lx[p]*lki;
+        d -= lki*lki;
+        int p = c[i]++;
+        li[p] = k;
+        lx[p] = lki;
+      }
+      if (!(d>0.0))
+        return false;
+      int p = c[k]++;
+      li[p] = k;
+      lx[p] = sqrt(d);
+    }
+    return true;
+  }
+}
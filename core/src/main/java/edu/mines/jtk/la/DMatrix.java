@@ -16,6 +16,7 @@ package edu.mines.jtk.la;
 
 import static edu.mines.jtk.util.ArrayMath.*;
 import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
 
 /**
  * A double-precision matrix.
@@ -598,7 +599,7 @@ public class DMatrix {
    */
   public DMatrix arrayTimes(DMatrix b) {
     DMatrix c = new DMatrix(_m,_n);
-    mul(_a,b._a,c._a);
+    arrayTimes(_a,b._a,c._a);
     return c;
   }
 
@@ -609,7 +610,7 @@ public class DMatrix {
    * @return A = A .* B.
    */
   public DMatrix arrayTimesEquals(DMatrix b) {
-    mul(_a,b._a,_a);
+    arrayTimes(_a,b._a,_a);
     return this;
   }
 
@@ -683,6 +684,8 @@ public class DMatrix {
   /**
    * Returns C = A * B, where A is this matrix. The number of columns in 
    * this matrix A must equal the number of rows in the specified matrix B.
+   * For large matrices, the product is computed in cache-sized blocks,
+   * using multiple threads.
    * @param b the matrix B.
    * @return C = A * B.
    */
@@ -690,21 +693,39 @@ public class DMatrix {
     Check.argument(_n==b._m,
       "number of columns in A equals number of rows in B");
     DMatrix c = new DMatrix(_m,b._n);
-    double[][] aa = _a;
-    double[][] ba = b._a;
-    double[][] ca = c._a;
-    double[] bj = new double[_n];
-    for (int j=0; j<b._n; ++j) {
-      for (int k=0; k<_n; ++k)
-        bj[k] = ba[k][j];
-      for (int i=0; i<_m; ++i) {
-        double[] ai = aa[i];
-        double s = 0.0;
-        for (int k=0; k<_n; ++k)
-          s += ai[k]*bj[k];
-        ca[i][j] = s;
-      }
-    }
+    Gemm.gemm(_m,b._n,_n,1.0,_a,0,0,b._a,0,0,0.0,c._a,0,0);
+    return c;
+  }
+
+  /**
+   * Returns C = A * B', where A is this matrix and B' is B transposed.
+   * The number of columns in this matrix A must equal the number of
+   * columns in the specified matrix B.
+   * @param b the matrix B.
+   * @return C = A * B'.
+   */
+  public DMatrix timesTranspose(DMatrix b) {
+    Check.argument(_n==b._n,
+      "number of columns in A equals number of columns in B");
+    DMatrix c = new DMatrix(_m,b._m);
+    double[][] bt = b.transpose()._a;
+    Gemm.gemm(_m,b._m,_n,1.0,_a,0,0,bt,0,0,0.0,c._a,0,0);
+    return c;
+  }
+
+  /**
+   * Returns C = A' * B, where A' is this matrix transposed.
+   * The number of rows in this matrix A must equal the number of
+   * rows in the specified matrix B.
+   * @param b the matrix B.
+   * @return C = A' * B.
+   */
+  public DMatrix transposeTimes(DMatrix b) {
+    Check.argument(_m==b._m,
+      "number of rows in A equals number of rows in B");
+    DMatrix c = new DMatrix(_n,b._n);
+    double[][] at = transpose()._a;
+    Gemm.gemm(_n,b._n,_m,1.0,at,0,0,b._a,0,0,0.0,c._a,0,0);
     return c;
   }
 
@@ -839,6 +860,26 @@ public class DMatrix {
   private int _n; // number of columns
   private double[][] _a; // array[_m][_n] of matrix elements
 
+  // Element-by-element multiplication, with rows in parallel.
+  private static void arrayTimes(
+    final double[][] a, final double[][] b, final double[][] c)
+  {
+    int m = a.length;
+    if (m==0)
+      return;
+    int n = a[0].length;
+    if (m<2 || (long)m*n<ARRAY_PARALLEL_MIN) {
+      mul(a,b,c);
+    } else {
+      Parallel.loop(m,new Parallel.LoopInt() {
+        public void compute(int i) {
+          mul(a[i],b[i],c[i]);
+        }
+      });
+    }
+  }
+  private static final int ARRAY_PARALLEL_MIN = 65536;
+
   private void checkI(int i) {
     if (i<0 || i>=_m)
       Check.argument(0<=i && i<_m,"row index i="+i+" is in bounds");
@@ -0,0 +1,527 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.max;
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Decompositions and solutions for batches of many small matrices.
+ * Algorithms that solve millions of tiny independent problems, such as
+ * one per sample in an image, should not construct a {@link DMatrix}
+ * and a decomposition for each of them. The methods of this class instead
+ * operate on batches of matrices stored as structures of arrays.
+ * <p>
+ * A batch of nb matrices, each with m rows and n columns, is stored in an
+ * array a[m][n][nb], so that element (i,j) of matrix k is a[i][j][k].
+ * Likewise, a batch of vectors with n elements is stored in an array
+ * b[n][nb]. Innermost loops are over the index k of matrices in the
+ * batch, so that they access memory sequentially and may be vectorized.
+ * Subsets of matrices are processed in parallel.
+ * <p>
+ * A matrix is deemed singular, not positive-definite, or not of full
+ * rank if any diagonal element of its factor U, L, or R is not greater
+ * in magnitude than a tolerance. That tolerance is the product of the
+ * machine epsilon, the number of rows, and the largest magnitude of any
+ * element of the matrix, so that it scales with the matrix.
+ * <p>
+ * These methods are intended for matrices with no more than about eight
+ * rows and columns. Larger matrices should be solved one at a time with
+ * decompositions such as {@link DMatrixLud} and {@link DMatrixChd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.19
+ */
+public class DMatrixBatch {
+
+  /**
+   * Solves linear systems A*x = b by LU decompositions with partial
+   * pivoting. On return, the arrays a contain the factors L and U, and
+   * the arrays b contain the solutions x. Solutions for singular matrices
+   * are zero, and the factors for those matrices are meaningless.
+   * @param a input/output array[n][n][nb] of square matrices.
+   * @param b input/output array[n][nb] of right-hand-side vectors.
+   * @return the number of singular matrices.
+   */
+  public static int solveLu(final double[][][] a, final double[][] b) {
+    checkSquare(a,b);
+    return loop(a,new Chunk() {
+      public int solve(int k0, int k1) {
+        return solveLu(k0,k1,a,b);
+      }
+    });
+  }
+
+  /**
+   * Solves linear systems A*x = b by Cholesky decompositions. The
+   * matrices A must be symmetric, and only their lower triangles are
+   * used. On return, the lower triangles of arrays a contain the factors
+   * L, and the arrays b contain the solutions x. Solutions for matrices
+   * that are not positive-definite are zero.
+   * @param a input/output array[n][n][nb] of symmetric matrices.
+   * @param b input/output array[n][nb] of right-hand-side vectors.
+   * @return the number of matrices that are not positive-definite.
+   */
+  public static int solveCholesky(final double[][][] a, final double[][] b) {
+    checkSquare(a,b);
+    return loop(a,new Chunk() {
+      public int solve(int k0, int k1) {
+        return solveCholesky(k0,k1,a,b);
+      }
+    });
+  }
+
+  /**
+   * Solves least-squares problems A*x ~ b by QR decompositions. Each
+   * matrix A has m rows and n columns, with m not less than n. The
+   * arrays a and b are overwritten with Householder transformations
+   * of A and b. Solutions for matrices that do not have full rank
+   * are zero.
+   * @param a input/output array[m][n][nb] of matrices.
+   * @param b input/output array[m][nb] of right-hand-side vectors.
+   * @param x output array[n][nb] of solution vectors.
+   * @return the number of matrices that do not have full rank.
+   */
+  public static int solveQr(
+    final double[][][] a, final double[][] b, final double[][] x)
+  {
+    Check.argument(a.length>=a[0].length,"m is not less than n");
+    Check.argument(b.length==a.length,"b.length equals m");
+    Check.argument(x.length==a[0].length,"x.length equals n");
+    return loop(a,new Chunk() {
+      public int solve(int k0, int k1) {
+        return solveQr(k0,k1,a,b,x);
+      }
+    });
+  }
+
+  /**
+   * Computes eigenvalues and eigenvectors of symmetric matrices, by
+   * cyclic Jacobi rotations. For each matrix, eigenvalues are sorted
+   * in descending order, and eigenvector i corresponds to eigenvalue i,
+   * as in {@link edu.mines.jtk.dsp.Eigen}. On return, the arrays a are
+   * nearly diagonal.
+   * @param a input/output array[n][n][nb] of symmetric matrices.
+   * @param v output array[n][n][nb] of eigenvectors; element j of
+   *  eigenvector i of matrix k is v[i][j][k].
+   * @param d output array[n][nb] of eigenvalues.
+   */
+  public static void solveSymmetricEigen(
+    final double[][][] a, final double[][][] v, final double[][] d)
+  {
+    checkSquare(a,d);
+    Check.argument(v.length==a.length,"v.length equals n");
+    loop(a,new Chunk() {
+      public int solve(int k0, int k1) {
+        solveSymmetricEigen(k0,k1,a,v,d);
+        return 0;
+      }
+    });
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int CHUNK = 256; // number of matrices per task
+  private static final int NSWEEP_MAX = 50; // maximum Jacobi sweeps
+  private static final double EPSILON = Math.ulp(1.0);
+
+  private DMatrixBatch() {
+  }
+
+  // Solves a subset of matrices, and returns the number that fail.
+  private interface Chunk {
+    public int solve(int k0, int k1);
+  }
+
+  private static void checkSquare(double[][][] a, double[][] b) {
+    Check.argument(a.length==a[0].length,"A is square");
+    Check.argument(b.length==a.length,"b.length equals n");
+  }
+
+  private static int loop(double[][][] a, final Chunk chunk) {
+    final int nb = a[0][0].length;
+    int nc = (nb+CHUNK-1)/CHUNK;
+    if (nc<=1)
+      return chunk.solve(0,nb);
+    return Parallel.reduce(nc,new Parallel.ReduceInt<Integer>() {
+      public Integer compute(int ic) {
+        int k0 = ic*CHUNK;
+        int k1 = min(k0+CHUNK,nb);
+        return chunk.solve(k0,k1);
+      }
+      public Integer combine(Integer n1, Integer n2) {
+        return n1+n2;
+      }
+    });
+  }
+
+  // Sets to zero solutions for matrices that failed; returns their number.
+  private static int zero(int k0, int k1, boolean[] bad, double[][] x) {
+    int nbad = 0;
+    for (int k=k0; k<k1; ++k) {
+      if (bad[k-k0]) {
+        ++nbad;
+        for (int i=0; i<x.length; ++i)
+          x[i][k] = 0.0;
+      }
+    }
+    return nbad;
+  }
+
+  // Computes tolerances for diagonal elements of factors of matrices,
+  // using only the lower triangles of those matrices, if lower is true.
+  private static double[] tolerance(
+    int k0, int k1, double[][][] a, boolean lower)
+  {
+    int m = a.length;
+    int n = a[0].length;
+    double[] tol = new double[k1-k0];
+    for (int i=0; i<m; ++i) {
+      int nj = (lower)?i+1:n;
+      for (int j=0; j<nj; ++j) {
+        double[] aij = a[i][j];
+        for (int k=k0; k<k1; ++k)
+          tol[k-k0] = max(tol[k-k0],abs(aij[k]));
+      }
+    }
+    for (int k=k0; k<k1; ++k)
+      tol[k-k0] *= m*EPSILON;
+    return tol;
+  }
+
+  private static int solveLu(int k0, int k1, double[][][] a, double[][] b) {
+    int n = a.length;
+    int[] p = new int[k1-k0];
+    double[] t = new double[k1-k0];
+    double[] tol = tolerance(k0,k1,a,false);
+    boolean[] bad = new boolean[k1-k0];
+    for (int j=0; j<n; ++j) {
+      double[] ajj = a[j][j];
+
+      // Find pivots.
+      for (int k=k0; k<k1; ++k) {
+        p[k-k0] = j;
+        t[k-k0] = abs(ajj[k]);
+      }
+      for (int i=j+1; i<n; ++i) {
+        double[] aij = a[i][j];
+        for (int k=k0; k<k1; ++k) {
+          double aaij = abs(aij[k]);
+          if (aaij>t[k-k0]) {
+            p[k-k0] = i;
+            t[k-k0] = aaij;
+          }
+        }
+      }
+
+      // Swap rows, where necessary.
+      for (int k=k0; k<k1; ++k) {
+        int pk = p[k-k0];
+        if (pk!=j) {
+          for (int c=0; c<n; ++c) {
+            double act = a[pk][c][k];
+            a[pk][c][k] = a[j][c][k];
+            a[j][c][k] = act;
+          }
+          double bt = b[pk][k];
+          b[pk][k] = b[j][k];
+          b[j][k] = bt;
+        }
+        if (abs(ajj[k])<=tol[k-k0]) {
+          bad[k-k0] = true;
+          ajj[k] = 1.0;
+        }
+      }
+
+      // Eliminate below the diagonal.
+      double[] bj = b[j];
+      for (int i=j+1; i<n; ++i) {
+        double[] aij = a[i][j];
+        for (int k=k0; k<k1; ++k)
+          aij[k] /= ajj[k];
+        for (int c=j+1; c<n; ++c) {
+          double[] aic = a[i][c];
+          double[] ajc = a[j][c];
+          for (int k=k0; k<k1; ++k)
+            aic[k] -= aij[k]*ajc[k];
+        }
+        double[] bi = b[i];
+        for (int k=k0; k<k1; ++k)
+          bi[k] -= aij[k]*bj[k];
+      }
+    }
+
+    // Solve U*x = L\b.
+    for (int i=n-1; i>=0; --i) {
+      double[] bi = b[i];
+      for (int c=i+1; c<n; ++c) {
+        double[] aic = a[i][c];
+        double[] bc = b[c];
+        for (int k=k0; k<k1; ++k)
+          bi[k] -= aic[k]*bc[k];
+      }
+      double[] aii = a[i][i];
+      for (int k=k0; k<k1; ++k)
+        bi[k] /= aii[k];
+    }
+    return zero(k0,k1,bad,b);
+  }
+
+  private static int solveCholesky(
+    int k0, int k1, double[][][] a, double[][] b)
+  {
+    int n = a.length;
+    double[] tol = tolerance(k0,k1,a,true);
+    boolean[] bad = new boolean[k1-k0];
+    for (int j=0; j<n; ++j) {
+      double[] ajj = a[j][j];
+      for (int c=0; c<j; ++c) {
+        double[] ajc = a[j][c];
+        for (int k=k0; k<k1; ++k)
+          ajj[k] -= ajc[k]*ajc[k];
+      }
+      for (int k=k0; k<k1; ++k) {
+        if (ajj[k]>tol[k-k0]) {
+          ajj[k] = sqrt(ajj[k]);
+        } else {
+          bad[k-k0] = true;
+          ajj[k] = 1.0;
+        }
+      }
+      for (int i=j+1; i<n; ++i) {
+        double[] aij = a[i][j];
+        for (int c=0; c<j; ++c) {
+          double[] aic = a[i][c];
+          double[] ajc = a[j][c];
+          for (int k=k0; k<k1; ++k)
+            aij[k] -= aic[k]*ajc[k];
+        }
+        for (int k=k0; k<k1; ++k)
+          aij[k] /= ajj[k];
+      }
+    }
+
+    // Solve L*y = b.
+    for (int i=0; i<n; ++i) {
+      double[] bi = b[i];
+      for (int c=0; c<i; ++c) {
+        double[] aic = a[i][c];
+        double[] bc = b[c];
+        for (int k=k0; k<k1; ++k)
+          bi[k] -= aic[k]*bc[k];
+      }
+      double[] aii = a[i][i];
+      for (int k=k0; k<k1; ++k)
+        bi[k] /= aii[k];
+    }
+
+    // Solve L'*x = y.
+    for (int i=n-1; i>=0; --i) {
+      double[] bi = b[i];
+      for (int c=i+1; c<n; ++c) {
+        double[] aci = a[c][i];
+        double[] bc = b[c];
+        for (int k=k0; k<k1; ++k)
+          bi[k] -= aci[k]*bc[k];
+      }
+      double[] aii = a[i][i];
+      for (int k=k0; k<k1; ++k)
+        bi[k] /= aii[k];
+    }
+    return zero(k0,k1,bad,b);
+  }
+
+  private static int solveQr(
+    int k0, int k1, double[][][] a, double[][] b, double[][] x)
+  {
+    int m = a.length;
+    int n = a[0].length;
+    double[] s = new double[k1-k0];
+    double[] r = new double[k1-k0];
+    double[] t = new double[k1-k0];
+    double[] tol = tolerance(k0,k1,a,false);
+    boolean[] bad = new boolean[k1-k0];
+    for (int j=0; j<n; ++j) {
+      double[] ajj = a[j][j];
+
+      // Householder vector v = A(j:m,j)-alpha*e(j), where alpha is the
+      // diagonal element of R, and scale factor s = 1/(v'*v/2).
+      for (int k=k0; k<k1; ++k)
+        s[k-k0] = 0.0;
+      for (int i=j; i<m; ++i) {
+        double[] aij = a[i][j];
+        for (int k=k0; k<k1; ++k)
+          s[k-k0] += aij[k]*aij[k];
+      }
+      for (int k=k0; k<k1; ++k) {
+        double sk = s[k-k0];
+        double alpha = (ajj[k]>0.0)?-sqrt(sk):sqrt(sk);
+        double vtv = sk-ajj[k]*alpha;
+        r[k-k0] = alpha;
+        s[k-k0] = (vtv>0.0)?1.0/vtv:0.0;
+        ajj[k] -= alpha;
+        if (abs(alpha)<=tol[k-k0])
+          bad[k-k0] = true;
+      }
+
+      // Apply the transformation to remaining columns of A and to b.
+      for (int c=j+1; c<=n; ++c) {
+        for (int k=k0; k<k1; ++k)
+          t[k-k0] = 0.0;
+        for (int i=j; i<m; ++i) {
+          double[] aij = a[i][j];
+          double[] aic = (c<n)?a[i][c]:b[i];
+          for (int k=k0; k<k1; ++k)
+            t[k-k0] += aij[k]*aic[k];
+        }
+        for (int k=k0; k<k1; ++k)
+          t[k-k0] *= s[k-k0];
+        for (int i=j; i<m; ++i) {
+          double[] aij = a[i][j];
+          double[] aic = (c<n)?a[i][c]:b[i];
+          for (int k=k0; k<k1; ++k)
+            aic[k] -= t[k-k0]*aij[k];
+        }
+      }
+      for (int k=k0; k<k1; ++k)
+        ajj[k] = r[k-k0];
+    }
+
+    // Solve R*x = Q'*b.
+    for (int i=n-1; i>=0; --i) {
+      double[] xi = x[i];
+      double[] bi = b[i];
+      for (int k=k0; k<k1; ++k)
+        xi[k] = bi[k];
+      for (int c=i+1; c<n; ++c) {
+        double[] aic = a[i][c];
+        double[] xc = x[c];
+        for (int k=k0; k<k1; ++k)
+          xi[k] -= aic[k]*xc[k];
+      }
+      double[] aii = a[i][i];
+      for (int k=k0; k<k1; ++k)
+        xi[k] = (aii[k]!=0.0)?xi[k]/aii[k]:0.0;
+    }
+    return zero(k0,k1,bad,x);
+  }
+
+  private static void solveSymmetricEigen(
+    int k0, int k1, double[][][] a, double[][][] v, double[][] d)
+  {
+    int n = a.length;
+    double[] c = new double[k1-k0];
+    double[] s = new double[k1-k0];
+    double[] off = new double[k1-k0];
+    double[] all = new double[k1-k0];
+
+    // Eigenvectors, initially the identity.
+    for (int i=0; i<n; ++i) {
+      for (int j=0; j<n; ++j) {
+        double[] vij = v[i][j];
+        double vt = (i==j)?1.0:0.0;
+        for (int k=k0; k<k1; ++k)
+          vij[k] = vt;
+      }
+    }
+
+    // Cyclic sweeps of Jacobi rotations, until for all matrices the sum of
+    // squares of off-diagonal elements is negligible.
+    for (int sweep=0; sweep<NSWEEP_MAX; ++sweep) {
+      for (int k=k0; k<k1; ++k)
+        off[k-k0] = all[k-k0] = 0.0;
+      for (int p=0; p<n; ++p) {
+        for (int q=0; q<n; ++q) {
+          double[] apq = a[p][q];
+          for (int k=k0; k<k1; ++k) {
+            double aa = apq[k]*apq[k];
+            all[k-k0] += aa;
+            if (p!=q) off[k-k0] += aa;
+          }
+        }
+      }
+      boolean done = true;
+      for (int k=k0; k<k1 && done; ++k)
+        done = off[k-k0]<=EPSILON*EPSILON*all[k-k0];
+      if (done)
+        break;
+      for (int p=0; p<n; ++p) {
+        for (int q=p+1; q<n; ++q) {
+          double[] app = a[p][p];
+          double[] aqq = a[q][q];
+          double[] apq = a[p][q];
+          for (int k=k0; k<k1; ++k) {
+            if (apq[k]==0.0) {
+              c[k-k0] = 1.0;
+              s[k-k0] = 0.0;
+            } else {
+              double theta = 0.5*(aqq[k]-app[k])/apq[k];
+              double t = 1.0/(abs(theta)+sqrt(theta*theta+1.0));
+              if (theta<0.0) t = -t;
+              c[k-k0] = 1.0/sqrt(t*t+1.0);
+              s[k-k0] = t*c[k-k0];
+            }
+          }
+          for (int i=0; i<n; ++i) {
+            rotate(k0,k1,c,s,a[i][p],a[i][q]);
+          }
+          for (int i=0; i<n; ++i) {
+            rotate(k0,k1,c,s,a[p][i],a[q][i]);
+            rotate(k0,k1,c,s,v[p][i],v[q][i]);
+          }
+        }
+      }
+    }
+
+    // Eigenvalues, and sort in descending order.
+    for (int i=0; i<n; ++i) {
+      double[] aii = a[i][i];
+      double[] di = d[i];
+      for (int k=k0; k<k1; ++k)
+        di[k] = aii[k];
+    }
+    for (int k=k0; k<k1; ++k) {
+      for (int i=1; i<n; ++i) {
+        for (int j=i; j>0 && d[j-1][k]<d[j][k]; --j) {
+          double dt = d[j][k];
+          d[j][k] = d[j-1][k];
+          d[j-1][k] = dt;
+          for (int l=0; l<n; ++l) {
+            double vt = v[j][l][k];
+            v[j][l][k] = v[j-1][l][k];
+            v[j-1][l][k] = vt;
+          }
+        }
+      }
+    }
+  }
+
+  // Computes (x,y) = (c*x-s*y,s*x+c*y).
+  private static void rotate(
+    int k0, int k1, double[] c, double[] s, double[] x, double[] y)
+  {
+    for (int k=k0; k<k1; ++k) {
+      double xk = x[k];
+      double yk = y[k];
+      x[k] = c[k-k0]*xk-s[k-k0]*yk;
+      y[k] = s[k-k0]*xk+c[k-k0]*yk;
+    }
+  }
+}
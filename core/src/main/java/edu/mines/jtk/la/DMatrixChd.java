@@ -0,0 +1,227 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import static edu.mines.jtk.util.ArrayMath.copy;
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Cholesky decomposition of a symmetric positive-definite matrix A.
+ * For a symmetric positive-definite matrix A, the Cholesky decomposition
+ * is A = L*L', where L is a lower triangular matrix.
+ * <p>
+ * The decomposition is computed with a blocked, right-looking algorithm.
+ * For each panel of columns, the diagonal block is decomposed, the block
+ * below it is computed by triangular solves, and the lower triangle of
+ * the trailing submatrix is updated by multi-threaded matrix-matrix
+ * multiplications.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.14
+ */
+public class DMatrixChd {
+
+  /**
+   * Constructs a Cholesky decomposition of the specified matrix A.
+   * The matrix A must be symmetric. For efficiency, this condition
+   * is assumed and not checked. That is, only the lower triangular
+   * part of A is used to perform the decomposition.
+   * @param a the matrix.
+   */
+  public DMatrixChd(DMatrix a) {
+    Check.argument(a.isSquare(),"A is square");
+    int n = _n = a.getN();
+    double[][] aa = a.getArray();
+    double[][] l = _l = new double[n][n];
+    for (int i=0; i<n; ++i)
+      System.arraycopy(aa[i],0,l[i],0,i+1);
+    _pd = true;
+    for (int j0=0; j0<n && _pd; j0+=NB) {
+      int j1 = min(j0+NB,n);
+      _pd = decomposeDiagonal(j0,j1);
+      if (_pd && j1<n) {
+        solveBelowDiagonal(j0,j1);
+        updateTrailing(j0,j1);
+      }
+    }
+
+    // Zero elements above the lower triangle, which may have been
+    // modified when updating trailing submatrices.
+    for (int i=0; i<n; ++i) {
+      for (int j=i+1; j<n; ++j)
+        l[i][j] = 0.0;
+    }
+
+    _det = 1.0;
+    for (int i=0; i<n; ++i)
+      _det *= l[i][i];
+    _det = _det*_det;
+  }
+
+  /**
+   * Determines whether the matrix A is positive definite. (The matrix
+   * A was assumed to be symmetric when this decomposition was constructed.)
+   * If not symmetric and positive-definite, then this decomposition cannot
+   * be used to solve systems of linear equations.
+   * @return true, if positive-definite; false, otherwise.
+   */
+  public boolean isPositiveDefinite() {
+    return _pd;
+  }
+
+  /**
+   * Gets the lower triangular factor L.
+   * @return the factor L.
+   */
+  public DMatrix getL() {
+    return new DMatrix(_n,_n,copy(_l));
+  }
+
+  /**
+   * Returns the determinant of the matrix A.
+   * @return the determinant.
+   */
+  public double det() {
+    return _det;
+  }
+
+  /**
+   * Returns the solution X of the linear system A*X = B.
+   * The matrix A must be symmetric and positive-definite.
+   * Also, the matrices A and B must have the same number of rows.
+   * @param b the right-hand-side matrix B.
+   * @return the solution matrix X.
+   */
+  public DMatrix solve(DMatrix b) {
+    Check.argument(_n==b.getM(),"A and B have same number of rows");
+    Check.state(_pd,"A is positive-definite");
+    int n = _n;
+    int nx = b.getN();
+    double[][] l = _l;
+    double[][] x = b.get();
+
+    // Solve L*Y = B.
+    for (int i=0; i<n; ++i) {
+      double[] li = l[i];
+      double[] xi = x[i];
+      for (int k=0; k<i; ++k) {
+        double lik = li[k];
+        double[] xk = x[k];
+        for (int j=0; j<nx; ++j)
+          xi[j] -= lik*xk[j];
+      }
+      double lii = li[i];
+      for (int j=0; j<nx; ++j)
+        xi[j] /= lii;
+    }
+
+    // Solve L'*X = Y.
+    for (int i=n-1; i>=0; --i) {
+      double[] li = l[i];
+      double[] xi = x[i];
+      double lii = li[i];
+      for (int j=0; j<nx; ++j)
+        xi[j] /= lii;
+      for (int k=0; k<i; ++k) {
+        double lik = li[k];
+        double[] xk = x[k];
+        for (int j=0; j<nx; ++j)
+          xk[j] -= lik*xi[j];
+      }
+    }
+    return new DMatrix(n,nx,x);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NB = 64; // number of columns in each panel
+
+  private int _n; // number of rows equals number of columns
+  private double[][] _l; // factor L
+  private double _det; // determinant
+  private boolean _pd; // true, if A is positive-definite
+
+  /**
+   * Decomposes the diagonal block for columns j0 to j1-1.
+   * Returns true, if positive-definite; false, otherwise.
+   */
+  private boolean decomposeDiagonal(int j0, int j1) {
+    double[][] l = _l;
+    for (int j=j0; j<j1; ++j) {
+      double[] lj = l[j];
+      double d = lj[j];
+      for (int k=j0; k<j; ++k)
+        d -= lj[k]*lj[k];
+      if (d<=0.0)
+        return false;
+      lj[j] = sqrt(d);
+      for (int i=j+1; i<j1; ++i)
+        solveRow(l[i],lj,j0,j);
+    }
+    return true;
+  }
+
+  /**
+   * Computes L21 = A21*inv(L11') for the rows below the diagonal block
+   * for columns j0 to j1-1. Rows are computed in parallel.
+   */
+  private void solveBelowDiagonal(final int j0, final int j1) {
+    final double[][] l = _l;
+    Parallel.loop(j1,_n,new Parallel.LoopInt() {
+      public void compute(int i) {
+        double[] li = l[i];
+        for (int j=j0; j<j1; ++j)
+          solveRow(li,l[j],j0,j);
+      }
+    });
+  }
+
+  /**
+   * Computes element j of a row li below the diagonal, using elements
+   * j0 to j-1 of that row and row lj of the factor L.
+   */
+  private static void solveRow(double[] li, double[] lj, int j0, int j) {
+    double s = li[j];
+    for (int k=j0; k<j; ++k)
+      s -= li[k]*lj[k];
+    li[j] = s/lj[j];
+  }
+
+  /**
+   * Updates the lower triangle of the trailing submatrix, A22 =
+   * A22-L21*L21', one panel of columns at a time. Elements above
+   * the diagonal in each panel are updated as well, but not used.
+   */
+  private void updateTrailing(int j0, int j1) {
+    double[][] l = _l;
+    int n = _n;
+    int nt = n-j1;
+    int nb = j1-j0;
+    double[][] lt = new double[nb][nt];
+    for (int i=j1; i<n; ++i) {
+      double[] li = l[i];
+      for (int j=j0; j<j1; ++j)
+        lt[j-j0][i-j1] = li[j];
+    }
+    for (int k0=j1; k0<n; k0+=NB) {
+      int k1 = min(k0+NB,n);
+      Gemm.gemm(n-k0,k1-k0,nb,-1.0,l,k0,j0,lt,0,k0-j1,1.0,l,k0,k0);
+    }
+  }
+}
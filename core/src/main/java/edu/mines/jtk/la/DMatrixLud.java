@@ -31,6 +31,10 @@ import edu.mines.jtk.util.Check;
  * square systems of simultaneous linear equations. These solutions will
  * fila if the matrix A is singular.
  * <p>
+ * For large matrices, the decomposition is computed with a blocked,
+ * right-looking algorithm, in which most of the work is performed by
+ * multi-threaded matrix-matrix multiplications.
+ * <p>
  * This class was adapted from the package Jama, which was developed by 
  * Joe Hicklin, Cleve Moler, and Peter Webb of The MathWorks, Inc., and by
  * Ronald Boisvert, Bruce Miller, Roldan Pozo, and Karin Remington of the
@@ -47,56 +51,15 @@ public class DMatrixLud {
   public DMatrixLud(DMatrix a) {
     int m = _m = a.getM();
     int n = _n = a.getN();
-    double[][] lu = _lu = a.get();
+    _lu = a.get();
     _piv = new int[m];
     for (int i=0; i<m; ++i)
       _piv[i] = i;
     _pivsign = 1;
-    double[] lurowi;
-    double[] lucolj = new double[m];
-
-    // A left-looking, dot-product, Crout/Doolittle algorithm.
-    for (int j=0; j<n; ++j) {
-
-      // Copy the j'th column to reduce cost in inner dot-product loop.
-      for (int i=0; i<m; ++i)
-        lucolj[i] = lu[i][j];
-
-      // Apply previous transformations
-      for (int i=0; i<m; ++i) {
-        lurowi = lu[i];
-
-        // Dot product.
-        int kmax = min(i,j);
-        double s = 0.0;
-        for (int k=0; k<kmax; ++k)
-          s += lurowi[k]*lucolj[k];
-        lurowi[j] = lucolj[i] -= s;
-      }
-
-      // Find pivot and exchange if necessary.
-      int p = j;
-      for (int i=j+1; i<m; ++i) {
-        if (abs(lucolj[i])>abs(lucolj[p]))
-          p = i;
-      }
-      if (p!=j) {
-        for (int k=0; k<n; ++k) {
-          double t = lu[p][k];
-          lu[p][k] = lu[j][k];
-          lu[j][k] = t;
-        }
-        int k = _piv[p];
-        _piv[p] = _piv[j];
-        _piv[j] = k;
-        _pivsign = -_pivsign;
-      }
-
-      // Compute multipliers.
-      if (j<m && lu[j][j]!=0.0) {
-        for (int i=j+1; i<m; ++i)
-          lu[i][j] /= lu[j][j];
-      }
+    if (min(m,n)<BLOCKED_MIN) {
+      decomposeUnblocked();
+    } else {
+      decomposeBlocked();
     }
   }
 
@@ -227,8 +190,128 @@ public class DMatrixLud {
   ///////////////////////////////////////////////////////////////////////////
   // private
 
+  private static final int NB = 64; // number of columns in each panel
+  private static final int BLOCKED_MIN = 2*NB; // min m,n for blocked
+
   int _m,_n;
   double[][] _lu;
   int[] _piv;
   int _pivsign;
+
+  /**
+   * A left-looking, dot-product, Crout/Doolittle algorithm.
+   */
+  private void decomposeUnblocked() {
+    int m = _m;
+    int n = _n;
+    double[][] lu = _lu;
+    double[] lurowi;
+    double[] lucolj = new double[m];
+    for (int j=0; j<n; ++j) {
+
+      // Copy the j'th column to reduce cost in inner dot-product loop.
+      for (int i=0; i<m; ++i)
+        lucolj[i] = lu[i][j];
+
+      // Apply previous transformations
+      for (int i=0; i<m; ++i) {
+        lurowi = lu[i];
+
+        // Dot product.
+        int kmax = min(i,j);
+        double s = 0.0;
+        for (int k=0; k<kmax; ++k)
+          s += lurowi[k]*lucolj[k];
+        lurowi[j] = lucolj[i] -= s;
+      }
+
+      // Find pivot and exchange if necessary.
+      int p = j;
+      for (int i=j+1; i<m; ++i) {
+        if (abs(lucolj[i])>abs(lucolj[p]))
+          p = i;
+      }
+      if (p!=j) {
+        for (int k=0; k<n; ++k) {
+          double t = lu[p][k];
+          lu[p][k] = lu[j][k];
+          lu[j][k] = t;
+        }
+        int k = _piv[p];
+        _piv[p] = _piv[j];
+        _piv[j] = k;
+        _pivsign = -_pivsign;
+      }
+
+      // Compute multipliers.
+      if (j<m && lu[j][j]!=0.0) {
+        for (int i=j+1; i<m; ++i)
+          lu[i][j] /= lu[j][j];
+      }
+    }
+  }
+
+  /**
+   * A right-looking, blocked algorithm. For each panel of NB columns,
+   * computes multipliers with partial pivoting, solves for the block
+   * row of U, and updates the trailing submatrix with one matrix-matrix
+   * multiplication. Rows are exchanged by exchanging array references.
+   */
+  private void decomposeBlocked() {
+    int m = _m;
+    int n = _n;
+    double[][] lu = _lu;
+    int mn = min(m,n);
+    for (int j0=0; j0<mn; j0+=NB) {
+      int j1 = min(j0+NB,mn);
+
+      // Factor the panel of columns j0 to j1-1.
+      for (int j=j0; j<j1; ++j) {
+
+        // Find pivot and exchange rows if necessary.
+        int p = j;
+        for (int i=j+1; i<m; ++i) {
+          if (abs(lu[i][j])>abs(lu[p][j]))
+            p = i;
+        }
+        if (p!=j) {
+          double[] t = lu[p];
+          lu[p] = lu[j];
+          lu[j] = t;
+          int k = _piv[p];
+          _piv[p] = _piv[j];
+          _piv[j] = k;
+          _pivsign = -_pivsign;
+        }
+
+        // Compute multipliers and update remaining columns in panel.
+        double[] luj = lu[j];
+        double ljj = luj[j];
+        if (ljj!=0.0) {
+          for (int i=j+1; i<m; ++i) {
+            double[] lui = lu[i];
+            double lij = lui[j] /= ljj;
+            for (int k=j+1; k<j1; ++k)
+              lui[k] -= lij*luj[k];
+          }
+        }
+      }
+
+      // Solve L11*U12 = A12 for the block row U12, and then update
+      // the trailing submatrix A22 = A22-L21*U12.
+      if (j1<n) {
+        for (int i=j0+1; i<j1; ++i) {
+          double[] lui = lu[i];
+          for (int k=j0; k<i; ++k) {
+            double lik = lui[k];
+            double[] luk = lu[k];
+            for (int j=j1; j<n; ++j)
+              lui[j] -= lik*luk[j];
+          }
+        }
+        if (j1<m)
+          Gemm.gemm(m-j1,n-j1,j1-j0,-1.0,lu,j1,j0,lu,j0,j1,1.0,lu,j1,j1);
+      }
+    }
+  }
 }
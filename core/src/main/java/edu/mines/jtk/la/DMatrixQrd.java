@@ -15,6 +15,7 @@ limitations under the License.
 package edu.mines.jtk.la;
 
 import static java.lang.Math.hypot;
+import static java.lang.Math.min;
 
 import edu.mines.jtk.util.Check;
 
@@ -29,6 +30,12 @@ import edu.mines.jtk.util.Check;
  * least-squares solutions of non-square systems of linear equations, 
  * and such solutions are feasible only if the matrix A is of full rank.
  * <p>
+ * For large matrices, the decomposition is computed with a blocked
+ * algorithm. Householder transformations for each panel of columns
+ * are accumulated in the compact WY representation I-V*T*V', and then
+ * applied to the trailing columns by multi-threaded matrix-matrix
+ * multiplications.
+ * <p>
  * This class was adapted from the package Jama, which was developed by 
  * Joe Hicklin, Cleve Moler, and Peter Webb of The MathWorks, Inc., and by
  * Ronald Boisvert, Bruce Miller, Roldan Pozo, and Karin Remington of the
@@ -46,39 +53,19 @@ public class DMatrixQrd {
    */
   public DMatrixQrd(DMatrix a) {
     Check.argument(a.getM()>=a.getN(),"m >= n");
-    int m = _m = a.getM();
+    _m = a.getM();
     int n = _n = a.getN();
     _qr = a.get();
     _rdiag = new double[_n];
-
-    // Main loop.
-    for (int k=0; k<n; ++k) {
-
-      // Compute 2-norm of k-th column without under/overflow.
-      double nrm = 0;
-      for (int i=k; i<m; ++i)
-        nrm = hypot(nrm,_qr[i][k]);
-
-      if (nrm!=0.0) {
-
-        // Form k-th Householder vector.
-        if (_qr[k][k]<0.0)
-          nrm = -nrm;
-        for (int i=k; i<m; ++i)
-          _qr[i][k] /= nrm;
-        _qr[k][k] += 1.0;
-
-        // Apply transformation to remaining columns.
-        for (int j=k+1; j<n; ++j) {
-          double s = 0.0; 
-          for (int i=k; i<m; ++i)
-            s += _qr[i][k]*_qr[i][j];
-          s = -s/_qr[k][k];
-          for (int i=k; i<m; ++i)
-            _qr[i][j] += s*_qr[i][k];
-        }
+    if (n<BLOCKED_MIN) {
+      decompose(0,n);
+    } else {
+      for (int k0=0; k0<n; k0+=NB) {
+        int k1 = min(k0+NB,n);
+        decompose(k0,k1);
+        if (k1<n)
+          update(k0,k1);
       }
-      _rdiag[k] = -nrm;
     }
   }
 
@@ -183,7 +170,109 @@ public class DMatrixQrd {
   ///////////////////////////////////////////////////////////////////////////
   // private
 
+  private static final int NB = 64; // number of columns in each panel
+  private static final int BLOCKED_MIN = 2*NB; // min n for blocked
+
   int _m,_n;
   double[][] _qr;
   double[] _rdiag;
+
+  /**
+   * Computes Householder transformations for columns k0 to k1-1, and
+   * applies them to those same columns only.
+   */
+  private void decompose(int k0, int k1) {
+    int m = _m;
+    for (int k=k0; k<k1; ++k) {
+
+      // Compute 2-norm of k-th column without under/overflow.
+      double nrm = 0;
+      for (int i=k; i<m; ++i)
+        nrm = hypot(nrm,_qr[i][k]);
+
+      if (nrm!=0.0) {
+
+        // Form k-th Householder vector.
+        if (_qr[k][k]<0.0)
+          nrm = -nrm;
+        for (int i=k; i<m; ++i)
+          _qr[i][k] /= nrm;
+        _qr[k][k] += 1.0;
+
+        // Apply transformation to remaining columns.
+        for (int j=k+1; j<k1; ++j) {
+          double s = 0.0;
+          for (int i=k; i<m; ++i)
+            s += _qr[i][k]*_qr[i][j];
+          s = -s/_qr[k][k];
+          for (int i=k; i<m; ++i)
+            _qr[i][j] += s*_qr[i][k];
+        }
+      }
+      _rdiag[k] = -nrm;
+    }
+  }
+
+  /**
+   * Applies the Householder transformations for columns k0 to k1-1 to
+   * all columns k1 to n-1. Each transformation is I-v*v'/v(k), so the
+   * product of transformations is Q = I-V*T*V', where T is upper
+   * triangular. Computes A = Q'*A = A-V*(T'*(V'*A)).
+   */
+  private void update(int k0, int k1) {
+    int m = _m;
+    int n = _n;
+    int mv = m-k0;
+    int nv = k1-k0;
+    int na = n-k1;
+
+    // V' and V, with zeros above the diagonal.
+    double[][] vt = new double[nv][mv];
+    double[][] v = new double[mv][nv];
+    for (int j=0; j<nv; ++j) {
+      int k = k0+j;
+      for (int i=k; i<m; ++i)
+        v[i-k0][j] = vt[j][i-k0] = _qr[i][k];
+    }
+
+    // Upper triangular T.
+    double[][] t = new double[nv][nv];
+    for (int j=0; j<nv; ++j) {
+      int k = k0+j;
+      double tau = (_rdiag[k]!=0.0)?1.0/_qr[k][k]:0.0;
+      double[] vj = vt[j];
+      double[] w = new double[j];
+      for (int i=0; i<j; ++i) {
+        double[] vi = vt[i];
+        double s = 0.0;
+        for (int p=j; p<mv; ++p)
+          s += vi[p]*vj[p];
+        w[i] = s;
+      }
+      for (int i=0; i<j; ++i) {
+        double s = 0.0;
+        for (int p=i; p<j; ++p)
+          s += t[i][p]*w[p];
+        t[i][j] = -tau*s;
+      }
+      t[j][j] = tau;
+    }
+
+    // W = V'*A, W = T'*W, and A = A-V*W.
+    double[][] w = new double[nv][na];
+    Gemm.gemm(nv,na,mv,1.0,vt,0,0,_qr,k0,k1,0.0,w,0,0);
+    for (int i=nv-1; i>=0; --i) {
+      double[] wi = w[i];
+      double tii = t[i][i];
+      for (int j=0; j<na; ++j)
+        wi[j] *= tii;
+      for (int p=0; p<i; ++p) {
+        double tpi = t[p][i];
+        double[] wp = w[p];
+        for (int j=0; j<na; ++j)
+          wi[j] += tpi*wp[j];
+      }
+    }
+    Gemm.gemm(mv,na,nv,-1.0,v,0,0,w,0,0,1.0,_qr,k0,k1);
+  }
 }
@@ -0,0 +1,248 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import java.util.Random;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Truncated singular value decomposition by randomized range finding.
+ * For an m-by-n matrix A, this decomposition approximates the k largest
+ * singular values and corresponding singular vectors, such that
+ * A ~ U*S*V', where U is m-by-k, S is k-by-k and diagonal, and V is
+ * n-by-k. The columns of U and V are orthonormal, and the singular
+ * values s[0] &gt;= s[1] &gt;= ... &gt;= s[k-1] are in decreasing order.
+ * <p>
+ * The range of A is sampled by applying A to k+p random vectors, where
+ * p is a small number of oversampling vectors. Sampling is sharpened by
+ * q power iterations with A*A', with orthonormalization after each
+ * product. The k+p samples span a subspace in which a small dense
+ * singular value decomposition is computed. Cost is dominated by
+ * 2*(q+1) products of A or A' with blocks of k+p vectors, which are
+ * computed in parallel. For matrices with slowly decaying singular
+ * values, one or two power iterations are usually sufficient.
+ * <p>
+ * The matrix A may be a dense matrix or a matrix-free operator, in
+ * which case both A and its transpose A' must be specified. Operators
+ * are applied to multiple vectors concurrently, and so must be
+ * thread-safe. Random vectors are generated with a fixed seed, so that
+ * results are reproducible.
+ * <p>
+ * Reference: Halko, N., Martinsson, P.G., and Tropp, J.A., 2011, Finding
+ * structure with randomness: probabilistic algorithms for constructing
+ * approximate matrix decompositions: SIAM Review, 53, 217-288.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.22
+ */
+public class DMatrixRsvd {
+
+  /**
+   * Constructs a truncated decomposition of a matrix A, with ten
+   * oversampling vectors and two power iterations.
+   * @param a the matrix A.
+   * @param k the number of singular values.
+   */
+  public DMatrixRsvd(DMatrix a, int k) {
+    this(a,k,10,2);
+  }
+
+  /**
+   * Constructs a truncated decomposition of a matrix A.
+   * @param a the matrix A.
+   * @param k the number of singular values.
+   * @param p the number of oversampling vectors.
+   * @param q the number of power iterations.
+   */
+  public DMatrixRsvd(DMatrix a, int k, int p, int q) {
+    this(a.getM(),a.getN(),
+      RowBlocks.operator(a),RowBlocks.transposeOperator(a),k,p,q);
+  }
+
+  /**
+   * Constructs a truncated decomposition of an operator A.
+   * @param m the number of rows in A.
+   * @param n the number of columns in A.
+   * @param a the operator A, which maps arrays of n to m doubles.
+   * @param at the transpose A', which maps arrays of m to n doubles.
+   * @param k the number of singular values.
+   * @param p the number of oversampling vectors.
+   * @param q the number of power iterations.
+   */
+  public DMatrixRsvd(
+    int m, int n, DOperator a, DOperator at, int k, int p, int q)
+  {
+    this(m,n,RowBlocks.operator(m,a),RowBlocks.operator(n,at),k,p,q);
+  }
+
+  /**
+   * Gets the m-by-k matrix U of left singular vectors.
+   * @return the matrix U.
+   */
+  public DMatrix getU() {
+    return new DMatrix(_u);
+  }
+
+  /**
+   * Gets the k-by-k diagonal matrix S of singular values.
+   * @return the matrix S.
+   */
+  public DMatrix getS() {
+    DMatrix s = new DMatrix(_k,_k);
+    for (int i=0; i<_k; ++i)
+      s.set(i,i,_s[i]);
+    return s;
+  }
+
+  /**
+   * Gets the singular values, in decreasing order.
+   * @return array of singular values = diag(S).
+   */
+  public double[] getSingularValues() {
+    return _s.clone();
+  }
+
+  /**
+   * Gets the n-by-k matrix V of right singular vectors.
+   * @return the matrix V.
+   */
+  public DMatrix getV() {
+    return new DMatrix(_v);
+  }
+
+  /**
+   * Gets the k-by-n transposed matrix V'.
+   * @return the matrix V'.
+   */
+  public DMatrix getVTranspose() {
+    return _v.transpose();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final long SEED = 20170422L;
+  private static final double EPSILON = 0.5*Math.ulp(1.0);
+  private static final int NSWEEP_MAX = 60;
+
+  private int _k; // number of singular values
+  private double[] _s; // singular values
+  private DMatrix _u; // left singular vectors
+  private DMatrix _v; // right singular vectors
+
+  private DMatrixRsvd(
+    int m, int n, RowBlocks.Operator a, RowBlocks.Operator at,
+    int k, int p, int q)
+  {
+    int mn = min(m,n);
+    Check.argument(0<k && k<=mn,"0 < k <= min(m,n)");
+    Check.argument(p>=0,"p is non-negative");
+    Check.argument(q>=0,"q is non-negative");
+    int l = min(k+p,mn);
+    _k = k;
+
+    // Orthonormal basis Y (rows) for the sampled range of A.
+    Random r = new Random(SEED);
+    DMatrix y = RowBlocks.orthonormalize(
+      a.apply(RowBlocks.gaussian(l,n,r)));
+    for (int iq=0; iq<q; ++iq) {
+      DMatrix z = RowBlocks.orthonormalize(at.apply(y));
+      y = RowBlocks.orthonormalize(a.apply(z));
+    }
+
+    // Rows of B = Y*A are A'*y, so that A ~ Y'*B. With B' = W*R,
+    // A ~ Y'*C*W' with C = R', and an SVD of the small matrix C.
+    DMatrix b = at.apply(y);
+    DMatrixQrd qrd = new DMatrixQrd(b.transpose());
+    DMatrix w = qrd.getQ();
+    double[][] c = qrd.getR().transpose().getArray();
+    double[][] v = DMatrix.identity(l,l).getArray();
+    double[] s = new double[l];
+    jacobi(c,v,s);
+
+    // Select the k largest singular values.
+    int[] index = RowBlocks.decreasing(s);
+    _s = new double[k];
+    DMatrix uc = new DMatrix(l,k);
+    DMatrix vc = new DMatrix(l,k);
+    for (int j=0; j<k; ++j) {
+      int jj = index[j];
+      _s[j] = s[jj];
+      for (int i=0; i<l; ++i) {
+        uc.set(i,j,c[i][jj]);
+        vc.set(i,j,v[i][jj]);
+      }
+    }
+    _u = y.transposeTimes(uc);
+    _v = w.times(vc);
+  }
+
+  /**
+   * One-sided Jacobi SVD of a small square matrix C, by rotations that
+   * orthogonalize its columns. On return, columns of c are the left
+   * singular vectors, columns of v are accumulated rotations (the right
+   * singular vectors), and s contains the unsorted singular values.
+   */
+  private static void jacobi(double[][] c, double[][] v, double[] s) {
+    int n = s.length;
+    boolean rotated = true;
+    for (int sweep=0; sweep<NSWEEP_MAX && rotated; ++sweep) {
+      rotated = false;
+      for (int p=0; p<n-1; ++p) {
+        for (int q=p+1; q<n; ++q) {
+          double alpha = 0.0, beta = 0.0, gamma = 0.0;
+          for (int i=0; i<n; ++i) {
+            double cp = c[i][p];
+            double cq = c[i][q];
+            alpha += cp*cp;
+            beta += cq*cq;
+            gamma += cp*cq;
+          }
+          if (abs(gamma)<=EPSILON*sqrt(alpha*beta))
+            continue;
+          rotated = true;
+          double zeta = (beta-alpha)/(2.0*gamma);
+          double t = ((zeta>=0.0)?1.0:-1.0)/(abs(zeta)+sqrt(1.0+zeta*zeta));
+          double cs = 1.0/sqrt(1.0+t*t);
+          double sn = cs*t;
+          for (int i=0; i<n; ++i) {
+            double cp = c[i][p];
+            double cq = c[i][q];
+            c[i][p] = cs*cp-sn*cq;
+            c[i][q] = sn*cp+cs*cq;
+            double vp = v[i][p];
+            double vq = v[i][q];
+            v[i][p] = cs*vp-sn*vq;
+            v[i][q] = sn*vp+cs*vq;
+          }
+        }
+      }
+    }
+    for (int j=0; j<n; ++j) {
+      double sj = 0.0;
+      for (int i=0; i<n; ++i)
+        sj += c[i][j]*c[i][j];
+      sj = sqrt(sj);
+      s[j] = sj;
+      double scale = (sj>0.0)?1.0/sj:0.0;
+      for (int i=0; i<n; ++i)
+        c[i][j] *= scale;
+    }
+  }
+}
@@ -0,0 +1,34 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+/**
+ * A linear operator that computes y = A*x for arrays of doubles.
+ * The operator A may be a sparse matrix, a preconditioner that applies
+ * an approximate inverse of a matrix, or any function that is linear in
+ * its input x, such as a finite-difference stencil that is never stored
+ * as a matrix.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public interface DOperator {
+
+  /**
+   * Applies this operator. Computes y = A*x.
+   * @param x input array; must not be the same as the output array y.
+   * @param y output array.
+   */
+  public void apply(double[] x, double[] y);
+}
@@ -0,0 +1,465 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.max;
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import java.util.Random;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Truncated eigensolvers for large symmetric matrices A*x = lambda*x.
+ * <ul>
+ * <li>Lanczos: thick-restart Lanczos with full reorthogonalization.</li>
+ * <li>LOBPCG: locally optimal block preconditioned conjugate gradients.
+ * </li>
+ * </ul>
+ * Both methods compute only k eigenvalues, either the largest or the
+ * smallest, and the corresponding eigenvectors, for which they require
+ * O(k*n) memory, far less than the O(n*n) required for a full
+ * decomposition. The matrix A may be a dense matrix or a matrix-free
+ * operator. Products of a dense matrix with vectors are computed in
+ * parallel, and LOBPCG applies operators to blocks of vectors
+ * concurrently, so that matrix-free operators must be thread-safe.
+ * <p>
+ * Lanczos requires only products A*x. It is usually the method of choice
+ * for extreme eigenvalues that are well separated. LOBPCG works with a
+ * block of k vectors and may use a preconditioner M, a symmetric and
+ * positive-definite approximation to the inverse of A (or of a shifted A),
+ * which can greatly accelerate convergence to the smallest eigenvalues.
+ * <p>
+ * Iterations end when, for each of the k eigenvalues, the norm of the
+ * residual A*x-lambda*x is not greater than a specified fraction of the
+ * largest absolute eigenvalue computed, or when the number of iterations
+ * exceeds a specified maximum. For Lanczos, an iteration is one restart
+ * cycle. Initial vectors are random with a fixed seed, so that results
+ * are reproducible.
+ * <p>
+ * References: Wu, K., and Simon, H., 2000, Thick-restart Lanczos method
+ * for large symmetric eigenvalue problems: SIAM Journal on Matrix
+ * Analysis and Applications, 22, 602-616; Knyazev, A.V., 2001, Toward
+ * the optimal preconditioned eigensolver: locally optimal block
+ * preconditioned conjugate gradient method: SIAM Journal on Scientific
+ * Computing, 23, 517-541.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.22
+ */
+public class EigenSolver {
+
+  /**
+   * The result of computing eigenvalues and eigenvectors.
+   */
+  public static class Result {
+
+    /**
+     * The eigenvalues, largest first if computing the largest eigenvalues,
+     * or smallest first if computing the smallest eigenvalues.
+     */
+    public final double[] values;
+
+    /**
+     * The n-by-k matrix of orthonormal eigenvectors, one per column, in
+     * the same order as the eigenvalues.
+     */
+    public final DMatrix vectors;
+
+    /**
+     * The number of iterations performed.
+     */
+    public final int niter;
+
+    /**
+     * Determines whether the iterations converged.
+     * @return true, if converged; false, otherwise.
+     */
+    public boolean converged() {
+      return _converged;
+    }
+
+    private final boolean _converged;
+    private Result(
+      double[] values, DMatrix vectors, int niter, boolean converged)
+    {
+      this.values = values;
+      this.vectors = vectors;
+      this.niter = niter;
+      _converged = converged;
+    }
+  }
+
+  /**
+   * Constructs a solver with specified parameters.
+   * @param small stop when norms of residuals are less than
+   *  small times the largest absolute eigenvalue.
+   * @param niter maximum number of iterations.
+   */
+  public EigenSolver(double small, int niter) {
+    Check.argument(small>=0.0,"small is non-negative");
+    Check.argument(niter>0,"niter is positive");
+    _small = small;
+    _niter = niter;
+  }
+
+  /**
+   * Computes eigenvalues of a symmetric matrix by the Lanczos method.
+   * @param a the symmetric matrix A.
+   * @param k the number of eigenvalues; less than the order of A.
+   * @param largest true, for the largest eigenvalues; false, for the
+   *  smallest eigenvalues.
+   * @return the result.
+   */
+  public Result lanczos(DMatrix a, int k, boolean largest) {
+    Check.argument(a.isSquare(),"A is square");
+    return lanczos(a.getN(),RowBlocks.operator(a),k,largest);
+  }
+
+  /**
+   * Computes eigenvalues of a symmetric operator by the Lanczos method.
+   * @param n the order of the operator A.
+   * @param a the symmetric operator A.
+   * @param k the number of eigenvalues; less than n.
+   * @param largest true, for the largest eigenvalues; false, for the
+   *  smallest eigenvalues.
+   * @return the result.
+   */
+  public Result lanczos(int n, DOperator a, int k, boolean largest) {
+    return lanczos(n,RowBlocks.operator(n,a),k,largest);
+  }
+
+  /**
+   * Computes eigenvalues of a symmetric matrix by the LOBPCG method.
+   * @param a the symmetric matrix A.
+   * @param m the preconditioner M; null, for no preconditioner.
+   * @param k the number of eigenvalues; not greater than one third of
+   *  the order of A.
+   * @param largest true, for the largest eigenvalues; false, for the
+   *  smallest eigenvalues.
+   * @return the result.
+   */
+  public Result lobpcg(DMatrix a, DOperator m, int k, boolean largest) {
+    Check.argument(a.isSquare(),"A is square");
+    return lobpcg(a.getN(),RowBlocks.operator(a),m,k,largest);
+  }
+
+  /**
+   * Computes eigenvalues of a symmetric operator by the LOBPCG method.
+   * @param n the order of the operator A.
+   * @param a the symmetric operator A.
+   * @param m the preconditioner M; null, for no preconditioner.
+   * @param k the number of eigenvalues; not greater than n/3.
+   * @param largest true, for the largest eigenvalues; false, for the
+   *  smallest eigenvalues.
+   * @return the result.
+   */
+  public Result lobpcg(
+    int n, DOperator a, DOperator m, int k, boolean largest)
+  {
+    return lobpcg(n,RowBlocks.operator(n,a),m,k,largest);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final long SEED = 20170422L;
+  private static final double EPSILON = 0.5*Math.ulp(1.0);
+
+  private double _small; // fraction of largest eigenvalue for residuals
+  private int _niter; // maximum number of iterations
+
+  // Operator that negates the product, so that the largest eigenvalues
+  // of the negated operator are the smallest eigenvalues of A.
+  private static RowBlocks.Operator negate(final RowBlocks.Operator a) {
+    return new RowBlocks.Operator() {
+      public DMatrix apply(DMatrix x) {
+        return a.apply(x).timesEquals(-1.0);
+      }
+    };
+  }
+
+  private Result lanczos(
+    int n, RowBlocks.Operator a, int k, boolean largest)
+  {
+    Check.argument(0<k && k<n,"0 < k < n");
+    if (!largest)
+      a = negate(a);
+    int ncv = min(n,max(2*k,k+20)); // number of Lanczos vectors
+    Random r = new Random(SEED);
+    double[][] v = new double[ncv][];
+    double[][] t = new double[ncv][ncv];
+    double[] h = new double[ncv];
+    double[] h2 = new double[ncv];
+    v[0] = unit(n,null,0,r);
+    int nkeep = 0;
+    for (int iter=1; ; ++iter) {
+
+      // Extend the basis from nkeep to ncv vectors, with full (twice
+      // repeated) reorthogonalization. The projection T = V*A*V' is
+      // computed from the same dot products.
+      double[] w = null;
+      double wnorm = 0.0;
+      double beta = 0.0;
+      for (int j=nkeep; j<ncv; ++j) {
+        w = a.apply(new DMatrix(new double[][]{v[j]})).getArray()[0];
+        wnorm = sqrt(RowBlocks.dot(n,w,w));
+        RowBlocks.dots(j+1,v,w,h);
+        RowBlocks.subtract(j+1,v,h,w);
+        RowBlocks.dots(j+1,v,w,h2);
+        RowBlocks.subtract(j+1,v,h2,w);
+        for (int i=0; i<=j; ++i)
+          t[i][j] = t[j][i] = h[i]+h2[i];
+        beta = sqrt(RowBlocks.dot(n,w,w));
+        if (j<ncv-1)
+          v[j+1] = next(n,w,beta,wnorm,j+1,v,r);
+      }
+
+      // Ritz values and vectors, largest first, and residual norms.
+      DMatrixEvd evd = new DMatrixEvd(new DMatrix(t));
+      double[] d = evd.getRealEigenvalues();
+      double[][] y = evd.getV().getArray();
+      int[] index = RowBlocks.decreasing(d);
+      double scale = 0.0;
+      for (int i=0; i<ncv; ++i)
+        scale = max(scale,abs(d[i]));
+      boolean converged = true;
+      for (int i=0; i<k && converged; ++i)
+        converged = beta*abs(y[ncv-1][index[i]])<=_small*scale;
+
+      // Restart with the nkeep best Ritz vectors, or return k of them.
+      boolean done = converged || iter==_niter;
+      if (!done)
+        nkeep = max(k,min(k+(ncv-k)/2,ncv-1));
+      int nx = done?k:nkeep;
+      DMatrix yt = new DMatrix(nx,ncv);
+      double[] theta = new double[nx];
+      for (int i=0; i<nx; ++i) {
+        theta[i] = d[index[i]];
+        for (int j=0; j<ncv; ++j)
+          yt.set(i,j,y[j][index[i]]);
+      }
+      double[][] x = yt.times(new DMatrix(v)).getArray();
+      if (done) {
+        if (!largest) {
+          for (int i=0; i<k; ++i)
+            theta[i] = -theta[i];
+        }
+        return new Result(theta,new DMatrix(x).transpose(),iter,converged);
+      }
+      for (int i=0; i<ncv; ++i) {
+        for (int j=0; j<ncv; ++j)
+          t[i][j] = 0.0;
+      }
+      for (int i=0; i<nkeep; ++i) {
+        v[i] = x[i];
+        t[i][i] = theta[i];
+      }
+      v[nkeep] = next(n,w,beta,wnorm,nkeep,v,r);
+    }
+  }
+
+  private Result lobpcg(
+    int n, RowBlocks.Operator a, DOperator m, int k, boolean largest)
+  {
+    Check.argument(0<k && 3*k<=n,"0 < k <= n/3");
+    if (!largest)
+      a = negate(a);
+    RowBlocks.Operator pm = (m!=null)?RowBlocks.operator(n,m):null;
+
+    // Initial Rayleigh-Ritz for a random block X.
+    Random r = new Random(SEED);
+    DMatrix x = RowBlocks.orthonormalize(RowBlocks.gaussian(k,n,r));
+    DMatrix ax = a.apply(x);
+    DMatrix[] xax = rayleighRitz(x,ax,k,0);
+    x = xax[0];
+    ax = xax[1];
+    double[] theta = xax[2].getArray()[0];
+    DMatrix p = null, ap = null;
+
+    int iter = 0;
+    boolean converged = false;
+    for (; iter<_niter; ++iter) {
+
+      // Residuals R = A*X-X*Theta, for vectors not yet converged.
+      double[][] xa = x.getArray();
+      double[][] axa = ax.getArray();
+      double scale = 0.0;
+      for (int i=0; i<k; ++i)
+        scale = max(scale,abs(theta[i]));
+      double[][] ra = new double[k][];
+      int nr = 0;
+      for (int i=0; i<k; ++i) {
+        double[] ri = new double[n];
+        for (int j=0; j<n; ++j)
+          ri[j] = axa[i][j]-theta[i]*xa[i][j];
+        double rnorm = sqrt(RowBlocks.dot(n,ri,ri));
+        if (rnorm>_small*scale)
+          ra[nr++] = ri;
+      }
+      if (nr==0) {
+        converged = true;
+        break;
+      }
+      DMatrix w = new DMatrix(copyRows(ra,nr));
+      if (pm!=null)
+        w = pm.apply(w);
+      normalizeRows(w.getArray(),null);
+      DMatrix aw = a.apply(w);
+
+      // Rayleigh-Ritz for the subspace spanned by [X; W; P]. If that
+      // basis is too ill-conditioned, P is dropped.
+      DMatrix[] result = null;
+      if (p!=null)
+        result = rayleighRitz(stack(x,w,p),stack(ax,aw,ap),k,k);
+      if (result==null)
+        result = rayleighRitz(stack(x,w,null),stack(ax,aw,null),k,k);
+      if (result==null)
+        break;
+      x = result[0];
+      ax = result[1];
+      theta = result[2].getArray()[0];
+      p = result[3];
+      ap = result[4];
+      normalizeRows(p.getArray(),ap.getArray());
+    }
+    if (!largest) {
+      for (int i=0; i<k; ++i)
+        theta[i] = -theta[i];
+    }
+    return new Result(theta,x.transpose(),iter,converged);
+  }
+
+  // Rayleigh-Ritz for the subspace spanned by rows of S with products AS.
+  // Returns {X, AX, theta, P, AP}, where the k rows of X are the largest
+  // Ritz vectors and rows of P are their components in all but the first
+  // nx rows of S. Returns null, if S is numerically rank deficient.
+  private static DMatrix[] rayleighRitz(
+    DMatrix s, DMatrix as, int k, int nx)
+  {
+    DMatrix g = s.timesTranspose(s);
+    DMatrixChd chd = new DMatrixChd(g);
+    if (!chd.isPositiveDefinite())
+      return null;
+    DMatrix l = chd.getL();
+    int ns = s.getM();
+    double lmin = Double.MAX_VALUE, lmax = 0.0;
+    for (int i=0; i<ns; ++i) {
+      lmin = min(lmin,l.get(i,i));
+      lmax = max(lmax,l.get(i,i));
+    }
+    if (lmin<=sqrt(EPSILON)*lmax)
+      return null;
+    DMatrix linv = RowBlocks.lowerInverse(l);
+    DMatrix q = linv.times(s);
+    DMatrix aq = linv.times(as);
+    DMatrix hq = q.timesTranspose(aq);
+    double[][] ha = hq.getArray();
+    for (int i=0; i<ns; ++i) {
+      for (int j=0; j<i; ++j)
+        ha[i][j] = ha[j][i] = 0.5*(ha[i][j]+ha[j][i]);
+    }
+    DMatrixEvd evd = new DMatrixEvd(hq);
+    double[] d = evd.getRealEigenvalues();
+    double[][] y = evd.getV().getArray();
+    int[] index = RowBlocks.decreasing(d);
+    DMatrix ct = new DMatrix(k,ns);
+    DMatrix pt = new DMatrix(k,ns);
+    double[] theta = new double[k];
+    for (int i=0; i<k; ++i) {
+      theta[i] = d[index[i]];
+      for (int j=0; j<ns; ++j) {
+        ct.set(i,j,y[j][index[i]]);
+        if (j>=nx)
+          pt.set(i,j,y[j][index[i]]);
+      }
+    }
+    DMatrix[] result = new DMatrix[5];
+    result[0] = ct.times(q);
+    result[1] = ct.times(aq);
+    result[2] = new DMatrix(new double[][]{theta});
+    if (nx>0) {
+      result[3] = pt.times(q);
+      result[4] = pt.times(aq);
+    }
+    return result;
+  }
+
+  // Returns a matrix with rows of x, w and p (if not null), not copied.
+  private static DMatrix stack(DMatrix x, DMatrix w, DMatrix p) {
+    int nx = x.getM(), nw = w.getM(), np = (p!=null)?p.getM():0;
+    double[][] s = new double[nx+nw+np][];
+    System.arraycopy(x.getArray(),0,s,0,nx);
+    System.arraycopy(w.getArray(),0,s,nx,nw);
+    if (p!=null)
+      System.arraycopy(p.getArray(),0,s,nx+nw,np);
+    return new DMatrix(s);
+  }
+
+  private static double[][] copyRows(double[][] a, int n) {
+    double[][] b = new double[n][];
+    System.arraycopy(a,0,b,0,n);
+    return b;
+  }
+
+  // Scales rows of x (and the same rows of ax, if not null) to unit length.
+  private static void normalizeRows(double[][] x, double[][] ax) {
+    for (int i=0; i<x.length; ++i) {
+      double xnorm = sqrt(RowBlocks.dot(x[i].length,x[i],x[i]));
+      if (xnorm>0.0) {
+        double scale = 1.0/xnorm;
+        for (int j=0; j<x[i].length; ++j) {
+          x[i][j] *= scale;
+          if (ax!=null)
+            ax[i][j] *= scale;
+        }
+      }
+    }
+  }
+
+  // Returns a new unit vector that is random and orthogonal to the
+  // first nv rows of v.
+  private static double[] unit(int n, double[][] v, int nv, Random r) {
+    double[] u = new double[n];
+    for (int j=0; j<n; ++j)
+      u[j] = r.nextGaussian();
+    double[] h = new double[nv];
+    for (int pass=0; pass<2; ++pass) {
+      RowBlocks.dots(nv,v,u,h);
+      RowBlocks.subtract(nv,v,h,u);
+    }
+    double unorm = sqrt(RowBlocks.dot(n,u,u));
+    for (int j=0; j<n; ++j)
+      u[j] /= unorm;
+    return u;
+  }
+
+  // Returns the next Lanczos vector w/beta, or a random unit vector
+  // orthogonal to the first nv rows of v, if beta is negligible compared
+  // to the norm of w before orthogonalization, as when the Krylov
+  // subspace is invariant.
+  private static double[] next(
+    int n, double[] w, double beta, double wnorm,
+    int nv, double[][] v, Random r)
+  {
+    if (beta<=n*EPSILON*wnorm)
+      return unit(n,v,nv,r);
+    double[] u = new double[n];
+    for (int j=0; j<n; ++j)
+      u[j] = w[j]/beta;
+    return u;
+  }
+}
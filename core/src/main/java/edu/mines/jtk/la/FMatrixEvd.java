@@ -0,0 +1,289 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static edu.mines.jtk.util.ArrayMath.*;
+import edu.mines.jtk.util.Check;
+
+/**
+ * Eigenvalue and eigenvector decomposition of a symmetric matrix A.
+ * The decomposition is A = V*D*V', where the matrix of eigenvalues D
+ * is diagonal and the matrix of eigenvectors V is orthogonal (V*V' = I).
+ * Eigenvalues are sorted in increasing order.
+ * <p>
+ * This class is a single-precision version of the symmetric part of
+ * {@link DMatrixEvd}. Only symmetric matrices are supported.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixEvd {
+
+  /**
+   * Constructs an eigenvalue decomposition for the specified matrix.
+   * @param a the symmetric matrix.
+   */
+  public FMatrixEvd(FMatrix a) {
+    Check.argument(a.isSymmetric(),"matrix a is symmetric");
+    int n = a.getN();
+    _n = n;
+    _v = a.get();
+    _d = new float[n];
+    _e = new float[n];
+    tred2(); // tridiagonalize
+    tql2(); // diagonalize
+  }
+
+  /**
+   * Gets the matrix of eigenvectors V.
+   * @return the matrix V.
+   */
+  public FMatrix getV() {
+    return new FMatrix(_n,_n,copy(_v));
+  }
+
+  /**
+   * Gets the diagonal matrix of eigenvalues D.
+   * @return the matrix D.
+   */
+  public FMatrix getD() {
+    FMatrix d = new FMatrix(_n,_n);
+    float[][] da = d.getArray();
+    for (int i=0; i<_n; ++i)
+      da[i][i] = _d[i];
+    return d;
+  }
+
+  /**
+   * Gets the eigenvalues, which are all real.
+   * @return array of eigenvalues = diag(D).
+   */
+  public float[] getRealEigenvalues() {
+    return copy(_d);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private int _n; // row and column dimensions for square matrix V
+  private float[][] _v; // eigenvectors V
+  private float[] _d, _e; // eigenvalues and off-diagonal elements
+
+  // Symmetric Householder reduction to tridiagonal form.
+  // This is derived from the Algol procedures tred2 by
+  // Bowdler, Martin, Reinsch, and Wilkinson, Handbook for
+  // Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
+  // Fortran subroutine in EISPACK.
+  private void tred2() {
+    int n = _n;
+    for (int j=0; j<n; ++j)
+      _d[j] = _v[n-1][j];
+
+    // Householder reduction to tridiagonal form.
+    for (int i=n-1; i>0; --i) {
+
+      // Scale to avoid under/overflow.
+      float scale = 0.0f;
+      float h = 0.0f;
+      for (int k=0; k<i; ++k)
+        scale += abs(_d[k]);
+      if (scale==0.0f) {
+        _e[i] = _d[i-1];
+        for (int j=0; j<i; ++j) {
+          _d[j] = _v[i-1][j];
+          _v[i][j] = 0.0f;
+          _v[j][i] = 0.0f;
+        }
+      } else {
+
+        // Generate Householder vector.
+        for (int k=0; k<i; ++k) {
+          _d[k] /= scale;
+          h += _d[k]*_d[k];
+        }
+        float f = _d[i-1];
+        float g = sqrt(h);
+        if (f>0.0f)
+          g = -g;
+        _e[i] = scale*g;
+        h -= f * g;
+        _d[i-1] = f-g;
+        for (int j=0; j<i; ++j)
+          _e[j] = 0.0f;
+
+        // Apply similarity transformation to remaining columns.
+        for (int j=0; j<i; ++j) {
+          f = _d[j];
+          _v[j][i] = f;
+          g = _e[j]+_v[j][j]*f;
+          for (int k = j+1; k<=i-1; ++k) {
+            g += _v[k][j]*_d[k];
+            _e[k] += _v[k][j]*f;
+          }
+          _e[j] = g;
+        }
+        f = 0.0f;
+        for (int j=0; j<i; ++j) {
+          _e[j] /= h;
+          f += _e[j]*_d[j];
+        }
+        float hh = f/(h+h);
+        for (int j=0; j<i; ++j) {
+          _e[j] -= hh*_d[j];
+        }
+        for (int j=0; j<i; ++j) {
+          f = _d[j];
+          g = _e[j];
+          for (int k=j; k<=i-1; ++k) {
+            _v[k][j] -= f*_e[k]+g*_d[k];
+          }
+          _d[j] = _v[i-1][j];
+          _v[i][j] = 0.0f;
+        }
+      }
+      _d[i] = h;
+    }
+
+    // Accumulate transformations.
+    for (int i=0; i<n-1; ++i) {
+      _v[n-1][i] = _v[i][i];
+      _v[i][i] = 1.0f;
+      float h = _d[i+1];
+      if (h!=0.0f) {
+        for (int k=0; k<=i; ++k)
+          _d[k] = _v[k][i+1]/h;
+        for (int j=0; j<=i; ++j) {
+          float g = 0.0f;
+          for (int k=0; k<=i; ++k)
+            g += _v[k][i+1]*_v[k][j];
+          for (int k=0; k<=i; ++k)
+            _v[k][j] -= g*_d[k];
+        }
+      }
+      for (int k=0; k<=i; ++k)
+        _v[k][i+1] = 0.0f;
+    }
+    for (int j=0; j<n; ++j) {
+      _d[j] = _v[n-1][j];
+      _v[n-1][j] = 0.0f;
+    }
+    _v[n-1][n-1] = 1.0f;
+    _e[0] = 0.0f;
+  }
+
+  // Symmetric tridiagonal QL algorithm.
+  // This is derived from the Algol procedures tql2, by
+  // Bowdler, Martin, Reinsch, and Wilkinson, Handbook for
+  // Auto. Comp., Vol.ii-Linear Algebra, and the corresponding
+  // Fortran subroutine in EISPACK.
+  private void tql2() {
+    int n = _n;
+    for (int i=1; i<n; ++i)
+      _e[i-1] = _e[i];
+    _e[n-1] = 0.0f;
+    float f = 0.0f;
+    float tst1 = 0.0f;
+    float eps = pow(2.0f,-23.0f);
+    for (int l=0; l<n; ++l) {
+
+      // Find small subdiagonal element.
+      tst1 = max(tst1,abs(_d[l])+abs(_e[l]));
+      int m = l;
+      while (m<n) {
+        if (abs(_e[m])<=eps*tst1)
+          break;
+        ++m;
+      }
+
+      // If m==l, d[l] is an eigenvalue; otherwise, iterate.
+      if (m>l) {
+        //int iter = 0;
+        do {
+          //++iter;  // (Could check iteration count here.)
+
+          // Compute implicit shift
+          float g = _d[l];
+          float p = (_d[l+1] - g) / (2.0f * _e[l]);
+          float r = hypot(p,1.0f);
+          if (p<0)
+            r = -r;
+          _d[l] = _e[l]/(p+r);
+          _d[l+1] = _e[l]*(p+r);
+          float dl1 = _d[l+1];
+          float h = g-_d[l];
+          for (int i=l+2; i<n; ++i)
+            _d[i] -= h;
+          f += h;
+
+          // Implicit QL transformation.
+          p = _d[m];
+          float c = 1.0f;
+          float c2 = c;
+          float c3 = c;
+          float el1 = _e[l+1];
+          float s = 0.0f;
+          float s2 = 0.0f;
+          for (int i=m-1; i>=l; --i) {
+            c3 = c2;
+            c2 = c;
+            s2 = s;
+            g = c * _e[i];
+            h = c * p;
+            r = hypot(p,_e[i]);
+            _e[i+1] = s*r;
+            s = _e[i]/r;
+            c = p/r;
+            p = c*_d[i]-s*g;
+            _d[i+1] = h+s*(c*g+s*_d[i]);
+
+            // Accumulate transformation.
+            for (int k=0; k<n; ++k) {
+              h = _v[k][i+1];
+              _v[k][i+1] = s*_v[k][i]+c*h;
+              _v[k][i] = c*_v[k][i]-s*h;
+            }
+          }
+          p = -s*s2*c3*el1*_e[l]/dl1;
+          _e[l] = s*p;
+          _d[l] = c*p;
+
+          // Check for convergence.
+        } while (abs(_e[l])>eps*tst1);
+      }
+      _d[l] += f;
+      _e[l] = 0.0f;
+    }
+
+    // Sort eigenvalues and corresponding vectors.
+    for (int i=0; i<n-1; ++i) {
+      int k = i;
+      float p = _d[i];
+      for (int j = i+1; j<n; ++j) {
+        if (_d[j]<p) {
+          k = j;
+          p = _d[j];
+        }
+      }
+      if (k!=i) {
+        _d[k] = _d[i];
+        _d[i] = p;
+        for (int j=0; j<n; ++j) {
+          p = _v[j][i];
+          _v[j][i] = _v[j][k];
+          _v[j][k] = p;
+        }
+      }
+    }
+  }
+}
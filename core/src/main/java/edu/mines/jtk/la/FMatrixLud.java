@@ -0,0 +1,344 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.min;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * LU decomposition (with pivoting) of a matrix A.
+ * For an m-by-n matrix A, with m&gt;=n, the LU decomposition is
+ * A(piv,:) = L*U, where L is an m-by-n unit lower triangular matrix,
+ * U is an n-by-n upper-triangular matrix, and piv is a permutation
+ * vector of length m.
+ * <p>
+ * The LU decomposition with pivoting always exists, even for singular
+ * matrices A. The primary use of LU decomposition is in the solution of
+ * square systems of simultaneous linear equations. These solutions will
+ * fila if the matrix A is singular.
+ * <p>
+ * For large matrices, the decomposition is computed with a blocked,
+ * right-looking algorithm, in which most of the work is performed by
+ * multi-threaded matrix-matrix multiplications.
+ * <p>
+ * This class is a single-precision version of {@link DMatrixLud}.
+ * Solutions computed with it may be improved to double-precision
+ * accuracy by mixed-precision iterative refinement.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixLud {
+
+  /**
+   * Constructs an LU decomposition for the specified matrix A.
+   * @param a the matrix A.
+   */
+  public FMatrixLud(FMatrix a) {
+    int m = _m = a.getM();
+    int n = _n = a.getN();
+    _lu = a.get();
+    _piv = new int[m];
+    for (int i=0; i<m; ++i)
+      _piv[i] = i;
+    _pivsign = 1;
+    if (min(m,n)<BLOCKED_MIN) {
+      decomposeUnblocked();
+    } else {
+      decomposeBlocked();
+    }
+  }
+
+  /**
+   * Determines whether the matrix A is non-singular.
+   * @return true, if non-singular; false, otherwise.
+   */
+  public boolean isNonSingular() {
+    for (int j=0; j<_n; ++j) {
+      if (_lu[j][j]==0.0f)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Determines whether the matrix A is singular.
+   * @return true, if singular; false, otherwise.
+   */
+  public boolean isSingular() {
+    return !isNonSingular();
+  }
+
+  /**
+   * Gets the m-by-n unit lower triangular matrix factor L.
+   * @return the m-by-n factor L.
+   */
+  public FMatrix getL() {
+    float[][] l = new float[_m][_n];
+    for (int i=0; i<_m; ++i) {
+      for (int j=0; j<_n; ++j) {
+        if (i>j) {
+          l[i][j] = _lu[i][j];
+        } else if (i==j) {
+          l[i][j] = 1.0f;
+        } else {
+          l[i][j] = 0.0f;
+        }
+      }
+    }
+    return new FMatrix(_m,_n,l);
+  }
+
+  /**
+   * Gets the n-by-n upper triangular matrix factor U.
+   * @return the n-by-n matrix factor U.
+   */
+  public FMatrix getU() {
+    float[][] u = new float[_n][_n];
+    for (int i=0; i<_n; ++i) {
+      for (int j=0; j<_n; ++j) {
+        if (i<=j) {
+          u[i][j] = _lu[i][j];
+        } else {
+          u[i][j] = 0.0f;
+        }
+      }
+    }
+    return new FMatrix(_n,_n,u);
+  }
+
+  /**
+   * Gets the pivot vector, an array of length m.
+   * @return the pivot vector.
+   */
+  public int[] getPivot() {
+    int[] p = new int[_m];
+    for (int i=0; i<_m; ++i)
+      p[i] = _piv[i];
+    return p;
+  }
+
+  /**
+   * Returns the solution X of the system A*X = B.
+   * This solution exists only if the matrix A is non-singular.
+   * @param b a matrix of right-hand-side vectors. This matrix must
+   *  have the same number (m) of rows as the matrix A, but may have
+   *  any number of columns.
+   * @return the matrix solution X.
+   * @exception IllegalStateException if A is singular.
+   */
+  public FMatrix solve(FMatrix b) {
+    Check.argument(b.getM()==_m,"A and B have the same number of rows");
+    Check.state(this.isNonSingular(),"A is non-singular");
+
+    // Copy of right-hand side with pivoting.
+    int nx = b.getN();
+    FMatrix xx = b.get(_piv,0,nx-1);
+    float[][] x = xx.getArray();
+
+    // Solve L*Y = B(piv,:).
+    for (int k=0; k<_n; ++k) {
+      for (int i=k+1; i<_n; ++i) {
+        for (int j=0; j<nx; ++j) {
+          x[i][j] -= x[k][j]*_lu[i][k];
+        }
+      }
+    }
+
+    // Solve U*X = Y.
+    for (int k=_n-1; k>=0; --k) {
+      for (int j=0; j<nx; ++j) {
+        x[k][j] /= _lu[k][k];
+      }
+      for (int i=0; i<k; ++i) {
+        for (int j=0; j<nx; ++j) {
+          x[i][j] -= x[k][j]*_lu[i][k];
+        }
+      }
+    }
+    return xx;
+  }
+
+  /**
+   * Returns the solution X of the system A*X = B, refined to double-precision
+   * accuracy. This decomposition of a single-precision copy of A is used to
+   * compute an initial solution and corrections for residuals R = B-A*X
+   * that are computed in double precision. If the single-precision copy
+   * of A is singular, or if this iterative refinement fails to
+   * converge, because A is too ill-conditioned, then X is computed with
+   * a double-precision decomposition of A.
+   * @param a the double-precision matrix A, which must be non-singular,
+   *  and from which the matrix for this decomposition was rounded.
+   * @param b the double-precision right-hand-side matrix B.
+   * @return the double-precision solution matrix X.
+   */
+  public DMatrix solve(DMatrix a, DMatrix b) {
+    Check.argument(_m==_n,"A is square");
+    Check.argument(a.getN()==_n,"A and this decomposition have same size");
+    if (isSingular())
+      return new DMatrixLud(a).solve(b);
+    DMatrix x = Refinement.solve(a,b,new Refinement.Solver() {
+      public FMatrix solve(FMatrix r) {
+        return FMatrixLud.this.solve(r);
+      }
+    });
+    if (x==null)
+      x = new DMatrixLud(a).solve(b);
+    return x;
+  }
+
+  /**
+   * Returns the determinant of the  matrix A.
+   * @return the the determinant.
+   * @exception IllegalStateException if A is not square.
+   */
+  public float det() {
+    Check.state(_m==_n,"A is square");
+    float d = _pivsign;
+    for (int j=0; j<_n; ++j)
+      d *= _lu[j][j];
+    return d;
+  }
+
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NB = 64; // number of columns in each panel
+  private static final int BLOCKED_MIN = 2*NB; // min m,n for blocked
+
+  int _m,_n;
+  float[][] _lu;
+  int[] _piv;
+  int _pivsign;
+
+  /**
+   * A left-looking, dot-product, Crout/Doolittle algorithm.
+   */
+  private void decomposeUnblocked() {
+    int m = _m;
+    int n = _n;
+    float[][] lu = _lu;
+    float[] lurowi;
+    float[] lucolj = new float[m];
+    for (int j=0; j<n; ++j) {
+
+      // Copy the j'th column to reduce cost in inner dot-product loop.
+      for (int i=0; i<m; ++i)
+        lucolj[i] = lu[i][j];
+
+      // Apply previous transformations
+      for (int i=0; i<m; ++i) {
+        lurowi = lu[i];
+
+        // Dot product.
+        int kmax = min(i,j);
+        float s = 0.0f;
+        for (int k=0; k<kmax; ++k)
+          s += lurowi[k]*lucolj[k];
+        lurowi[j] = lucolj[i] -= s;
+      }
+
+      // Find pivot and exchange if necessary.
+      int p = j;
+      for (int i=j+1; i<m; ++i) {
+        if (abs(lucolj[i])>abs(lucolj[p]))
+          p = i;
+      }
+      if (p!=j) {
+        for (int k=0; k<n; ++k) {
+          float t = lu[p][k];
+          lu[p][k] = lu[j][k];
+          lu[j][k] = t;
+        }
+        int k = _piv[p];
+        _piv[p] = _piv[j];
+        _piv[j] = k;
+        _pivsign = -_pivsign;
+      }
+
+      // Compute multipliers.
+      if (j<m && lu[j][j]!=0.0f) {
+        for (int i=j+1; i<m; ++i)
+          lu[i][j] /= lu[j][j];
+      }
+    }
+  }
+
+  /**
+   * A right-looking, blocked algorithm. For each panel of NB columns,
+   * computes multipliers with partial pivoting, solves for the block
+   * row of U, and updates the trailing submatrix with one matrix-matrix
+   * multiplication. Rows are exchanged by exchanging array references.
+   */
+  private void decomposeBlocked() {
+    int m = _m;
+    int n = _n;
+    float[][] lu = _lu;
+    int mn = min(m,n);
+    for (int j0=0; j0<mn; j0+=NB) {
+      int j1 = min(j0+NB,mn);
+
+      // Factor the panel of columns j0 to j1-1.
+      for (int j=j0; j<j1; ++j) {
+
+        // Find pivot and exchange rows if necessary.
+        int p = j;
+        for (int i=j+1; i<m; ++i) {
+          if (abs(lu[i][j])>abs(lu[p][j]))
+            p = i;
+        }
+        if (p!=j) {
+          float[] t = lu[p];
+          lu[p] = lu[j];
+          lu[j] = t;
+          int k = _piv[p];
+          _piv[p] = _piv[j];
+          _piv[j] = k;
+          _pivsign = -_pivsign;
+        }
+
+        // Compute multipliers and update remaining columns in panel.
+        float[] luj = lu[j];
+        float ljj = luj[j];
+        if (ljj!=0.0f) {
+          for (int i=j+1; i<m; ++i) {
+            float[] lui = lu[i];
+            float lij = lui[j] /= ljj;
+            for (int k=j+1; k<j1; ++k)
+              lui[k] -= lij*luj[k];
+          }
+        }
+      }
+
+      // Solve L11*U12 = A12 for the block row U12, and then update
+      // the trailing submatrix A22 = A22-L21*U12.
+      if (j1<n) {
+        for (int i=j0+1; i<j1; ++i) {
+          float[] lui = lu[i];
+          for (int k=j0; k<i; ++k) {
+            float lik = lui[k];
+            float[] luk = lu[k];
+            for (int j=j1; j<n; ++j)
+              lui[j] -= lik*luk[j];
+          }
+        }
+        if (j1<m)
+          Gemm.gemm(m-j1,n-j1,j1-j0,-1.0f,lu,j1,j0,lu,j0,j1,1.0f,lu,j1,j1);
+      }
+    }
+  }
+}
@@ -0,0 +1,275 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.hypot;
+import static java.lang.Math.min;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * QR decomposition of a matrix A.
+ * For an m-by-n matrix A, with m&gt;=n, the QR decomposition is A = Q*R,
+ * where Q is an m-by-n orthogonal matrix, and R is an n-by-n upper-triangular
+ * matrix.
+ * <p>
+ * The QR decomposition is constructed even if the matrix A is rank
+ * deficient. However, the primary use of the QR decomposition is for
+ * least-squares solutions of non-square systems of linear equations,
+ * and such solutions are feasible only if the matrix A is of full rank.
+ * <p>
+ * For large matrices, the decomposition is computed with a blocked
+ * algorithm. Householder transformations for each panel of columns
+ * are accumulated in the compact WY representation I-V*T*V', and then
+ * applied to the trailing columns by multi-threaded matrix-matrix
+ * multiplications.
+ * <p>
+ * This class is a single-precision version of {@link DMatrixQrd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixQrd {
+
+  /**
+   * Constructs an QR decomposition for the specified matrix A.
+   * The matrix A must not have more columns than rows.
+   * If A is m-by-n, then, m&gt;=n is required.
+   * @param a the matrix A.
+   */
+  public FMatrixQrd(FMatrix a) {
+    Check.argument(a.getM()>=a.getN(),"m >= n");
+    _m = a.getM();
+    int n = _n = a.getN();
+    _qr = a.get();
+    _rdiag = new float[_n];
+    if (n<BLOCKED_MIN) {
+      decompose(0,n);
+    } else {
+      for (int k0=0; k0<n; k0+=NB) {
+        int k1 = min(k0+NB,n);
+        decompose(k0,k1);
+        if (k1<n)
+          update(k0,k1);
+      }
+    }
+  }
+
+  /**
+   * Determines whether the matrix A = Q*R is of full rank.
+   * @return true, if full rank; false, otherwise.
+   */
+  public boolean isFullRank() {
+    for (int j=0; j<_n; ++j) {
+      if (_rdiag[j]==0.0f)
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Gets the m-by-n matrix factor Q.
+   * @return the m-by-n matrix factor Q.
+   */
+  public FMatrix getQ() {
+    float[][] q = new float[_m][_n];
+    for (int k=_n-1; k>=0; --k) {
+      for (int i=0; i<_m; ++i) {
+        q[i][k] = 0.0f;
+      }
+      q[k][k] = 1.0f;
+      for (int j=k; j<_n; ++j) {
+        if (_qr[k][k]!=0.0f) {
+          float s = 0.0f;
+          for (int i=k; i<_m; ++i) {
+            s += _qr[i][k]*q[i][j];
+          }
+          s = -s/_qr[k][k];
+          for (int i=k; i<_m; ++i) {
+            q[i][j] += s*_qr[i][k];
+          }
+        }
+      }
+    }
+    return new FMatrix(_m,_n,q);
+  }
+
+  /**
+   * Gets the n-by-n upper triangular matrix factor R.
+   * @return the n-by-n matrix factor R.
+   */
+  public FMatrix getR() {
+    float[][] r = new float[_n][_n];
+    for (int i=0; i<_n; ++i) {
+      r[i][i] = _rdiag[i];
+      for (int j=i+1; j<_n; ++j) {
+        r[i][j] = _qr[i][j];
+      }
+    }
+    return new FMatrix(_n,_n,r);
+  }
+
+  /**
+   * Returns the least-squares solution X of the system A*X = B.
+   * This solution exists only if the matrix A is of full rank.
+   * @param b a matrix of right-hand-side vectors. This matrix must
+   *  have the same number (m) of rows as the matrix A, but may have
+   *  any number of columns.
+   * @return the matrix X that minimizes the two-norm of A*X-B.
+   * @exception IllegalStateException if A is rank-deficient.
+   */
+  public FMatrix solve(FMatrix b) {
+    Check.argument(b.getM()==_m,"A and B have the same number of rows");
+    Check.state(this.isFullRank(),"A is of full rank");
+
+    // Copy the right hand side.
+    int nx = b.getN();
+    float[][] x = b.get();
+
+    // Compute Y = transpose(Q)*B.
+    for (int k=0; k<_n; ++k) {
+      for (int j=0; j<nx; ++j) {
+        float s = 0.0f;
+        for (int i=k; i<_m; ++i) {
+          s += _qr[i][k]*x[i][j];
+        }
+        s = -s/_qr[k][k];
+        for (int i=k; i<_m; ++i) {
+          x[i][j] += s*_qr[i][k];
+        }
+      }
+    }
+
+    // Solve R*X = Y.
+    for (int k=_n-1; k>=0; --k) {
+      for (int j=0; j<nx; ++j)
+        x[k][j] /= _rdiag[k];
+      for (int i=0; i<k; ++i) {
+        for (int j=0; j<nx; ++j) {
+          x[i][j] -= x[k][j]*_qr[i][k];
+        }
+      }
+    }
+    return new FMatrix(_m,nx,x).get(0,_n-1,null);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NB = 64; // number of columns in each panel
+  private static final int BLOCKED_MIN = 2*NB; // min n for blocked
+
+  int _m,_n;
+  float[][] _qr;
+  float[] _rdiag;
+
+  /**
+   * Computes Householder transformations for columns k0 to k1-1, and
+   * applies them to those same columns only.
+   */
+  private void decompose(int k0, int k1) {
+    int m = _m;
+    for (int k=k0; k<k1; ++k) {
+
+      // Compute 2-norm of k-th column without under/overflow.
+      float nrm = 0;
+      for (int i=k; i<m; ++i)
+        nrm = (float)hypot(nrm,_qr[i][k]);
+
+      if (nrm!=0.0f) {
+
+        // Form k-th Householder vector.
+        if (_qr[k][k]<0.0f)
+          nrm = -nrm;
+        for (int i=k; i<m; ++i)
+          _qr[i][k] /= nrm;
+        _qr[k][k] += 1.0f;
+
+        // Apply transformation to remaining columns.
+        for (int j=k+1; j<k1; ++j) {
+          float s = 0.0f;
+          for (int i=k; i<m; ++i)
+            s += _qr[i][k]*_qr[i][j];
+          s = -s/_qr[k][k];
+          for (int i=k; i<m; ++i)
+            _qr[i][j] += s*_qr[i][k];
+        }
+      }
+      _rdiag[k] = -nrm;
+    }
+  }
+
+  /**
+   * Applies the Householder transformations for columns k0 to k1-1 to
+   * all columns k1 to n-1. Each transformation is I-v*v'/v(k), so the
+   * product of transformations is Q = I-V*T*V', where T is upper
+   * triangular. Computes A = Q'*A = A-V*(T'*(V'*A)).
+   */
+  private void update(int k0, int k1) {
+    int m = _m;
+    int n = _n;
+    int mv = m-k0;
+    int nv = k1-k0;
+    int na = n-k1;
+
+    // V' and V, with zeros above the diagonal.
+    float[][] vt = new float[nv][mv];
+    float[][] v = new float[mv][nv];
+    for (int j=0; j<nv; ++j) {
+      int k = k0+j;
+      for (int i=k; i<m; ++i)
+        v[i-k0][j] = vt[j][i-k0] = _qr[i][k];
+    }
+
+    // Upper triangular T.
+    float[][] t = new float[nv][nv];
+    for (int j=0; j<nv; ++j) {
+      int k = k0+j;
+      float tau = (_rdiag[k]!=0.0f)?1.0f/_qr[k][k]:0.0f;
+      float[] vj = vt[j];
+      float[] w = new float[j];
+      for (int i=0; i<j; ++i) {
+        float[] vi = vt[i];
+        float s = 0.0f;
+        for (int p=j; p<mv; ++p)
+          s += vi[p]*vj[p];
+        w[i] = s;
+      }
+      for (int i=0; i<j; ++i) {
+        float s = 0.0f;
+        for (int p=i; p<j; ++p)
+          s += t[i][p]*w[p];
+        t[i][j] = -tau*s;
+      }
+      t[j][j] = tau;
+    }
+
+    // W = V'*A, W = T'*W, and A = A-V*W.
+    float[][] w = new float[nv][na];
+    Gemm.gemm(nv,na,mv,1.0f,vt,0,0,_qr,k0,k1,0.0f,w,0,0);
+    for (int i=nv-1; i>=0; --i) {
+      float[] wi = w[i];
+      float tii = t[i][i];
+      for (int j=0; j<na; ++j)
+        wi[j] *= tii;
+      for (int p=0; p<i; ++p) {
+        float tpi = t[p][i];
+        float[] wp = w[p];
+        for (int j=0; j<na; ++j)
+          wi[j] += tpi*wp[j];
+      }
+    }
+    Gemm.gemm(mv,na,nv,-1.0f,v,0,0,w,0,0,1.0f,_qr,k0,k1);
+  }
+}
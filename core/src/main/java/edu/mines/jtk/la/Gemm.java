@@ -0,0 +1,311 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.min;
+
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Blocked and multi-threaded general matrix-matrix multiplication.
+ * Computes C = beta*C + alpha*A*B for submatrices of arrays of arrays
+ * of doubles or floats, as used by {@link DMatrix}, {@link FMatrix}
+ * and their decompositions.
+ * <p>
+ * For large products, C is partitioned into tiles that are computed
+ * by multiple threads. Within each tile, rows of B are multiplied in
+ * panels with KC rows and NC columns, each packed into a contiguous
+ * array that fits in cache. Rows of C are then updated with contiguous
+ * inner loops that the compiler can vectorize. Small products are
+ * computed serially.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.14
+ */
+final class Gemm {
+
+  /**
+   * Computes C = beta*C + alpha*A*B for specified submatrices.
+   * A is the m-by-k submatrix a[ia:ia+m-1][ja:ja+k-1], B is the
+   * k-by-n submatrix b[ib:ib+k-1][jb:jb+n-1], and C is the m-by-n
+   * submatrix c[ic:ic+m-1][jc:jc+n-1]. The submatrix C must not
+   * overlap the submatrices A and B, but the arrays a, b and c may
+   * be the same array.
+   * @param m number of rows in A and C.
+   * @param n number of columns in B and C.
+   * @param k number of columns in A and rows in B.
+   * @param alpha scale factor for A*B.
+   * @param a array of elements of A.
+   * @param ia row index of first element of A.
+   * @param ja column index of first element of A.
+   * @param b array of elements of B.
+   * @param ib row index of first element of B.
+   * @param jb column index of first element of B.
+   * @param beta scale factor for C; if zero, C is not read.
+   * @param c array of elements of C.
+   * @param ic row index of first element of C.
+   * @param jc column index of first element of C.
+   */
+  static void gemm(
+    final int m, final int n, final int k, final double alpha,
+    final double[][] a, final int ia, final int ja,
+    final double[][] b, final int ib, final int jb, final double beta,
+    final double[][] c, final int ic, final int jc)
+  {
+    if (m==0 || n==0)
+      return;
+    final int mt = (m+MT-1)/MT;
+    final int nt = (n+NT-1)/NT;
+    if ((double)m*n*k<PARALLEL_MIN || mt*nt<2) {
+      gemmSerial(m,n,k,alpha,a,ia,ja,b,ib,jb,beta,c,ic,jc);
+    } else {
+      Parallel.loop(mt*nt,new Parallel.LoopInt() {
+        public void compute(int it) {
+          int i0 = (it/nt)*MT, j0 = (it%nt)*NT;
+          int mi = min(MT,m-i0), nj = min(NT,n-j0);
+          gemmSerial(mi,nj,k,alpha,
+                     a,ia+i0,ja,
+                     b,ib,jb+j0,beta,
+                     c,ic+i0,jc+j0);
+        }
+      });
+    }
+  }
+
+  /**
+   * Computes C = beta*C + alpha*A*B for specified submatrices of
+   * arrays of floats. This method is the single-precision version
+   * of the method above.
+   */
+  static void gemm(
+    final int m, final int n, final int k, final float alpha,
+    final float[][] a, final int ia, final int ja,
+    final float[][] b, final int ib, final int jb, final float beta,
+    final float[][] c, final int ic, final int jc)
+  {
+    if (m==0 || n==0)
+      return;
+    final int mt = (m+MT-1)/MT;
+    final int nt = (n+NT-1)/NT;
+    if ((double)m*n*k<PARALLEL_MIN || mt*nt<2) {
+      gemmSerial(m,n,k,alpha,a,ia,ja,b,ib,jb,beta,c,ic,jc);
+    } else {
+      Parallel.loop(mt*nt,new Parallel.LoopInt() {
+        public void compute(int it) {
+          int i0 = (it/nt)*MT, j0 = (it%nt)*NT;
+          int mi = min(MT,m-i0), nj = min(NT,n-j0);
+          gemmSerial(mi,nj,k,alpha,
+                     a,ia+i0,ja,
+                     b,ib,jb+j0,beta,
+                     c,ic+i0,jc+j0);
+        }
+      });
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int KC = 256; // rows in packed panel of B
+  private static final int NC = 512; // columns in packed panel of B
+  private static final int MT = 64; // rows in tile of C
+  private static final int NT = 256; // columns in tile of C
+  private static final double PARALLEL_MIN = 64.0*64.0*64.0; // m*n*k
+
+  private static void gemmSerial(
+    int m, int n, int k, double alpha,
+    double[][] a, int ia, int ja,
+    double[][] b, int ib, int jb, double beta,
+    double[][] c, int ic, int jc)
+  {
+    if (k==0 || alpha==0.0) {
+      for (int i=0; i<m; ++i)
+        scale(beta,c[ic+i],jc,n);
+      return;
+    }
+    double[] bp = new double[min(k,KC)*min(n,NC)];
+    for (int jj=0; jj<n; jj+=NC) {
+      int nb = min(NC,n-jj);
+      for (int kk=0; kk<k; kk+=KC) {
+        int kb = min(KC,k-kk);
+        pack(alpha,b,ib+kk,jb+jj,kb,nb,bp);
+        double betak = (kk==0)?beta:1.0;
+        multiply(m,nb,kb,a,ia,ja+kk,bp,betak,c,ic,jc+jj);
+      }
+    }
+  }
+
+  /**
+   * Packs alpha times the kb-by-nb submatrix of B, beginning at
+   * b[ib][jb], into the array bp, one row after another.
+   */
+  private static void pack(
+    double alpha, double[][] b, int ib, int jb, int kb, int nb, double[] bp)
+  {
+    for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+      double[] bi = b[ib+p];
+      if (alpha==1.0) {
+        System.arraycopy(bi,jb,bp,ip,nb);
+      } else {
+        for (int j=0; j<nb; ++j)
+          bp[ip+j] = alpha*bi[jb+j];
+      }
+    }
+  }
+
+  /**
+   * Scales the n elements of the array c, beginning at index jc.
+   */
+  private static void scale(double beta, double[] c, int jc, int n) {
+    if (beta==0.0) {
+      for (int j=0; j<n; ++j)
+        c[jc+j] = 0.0;
+    } else if (beta!=1.0) {
+      for (int j=0; j<n; ++j)
+        c[jc+j] *= beta;
+    }
+  }
+
+  /**
+   * Updates m rows of C with the product of A and a packed panel of B.
+   * Rows are updated in pairs, so that each element of the packed panel
+   * loaded is used twice.
+   */
+  private static void multiply(
+    int m, int nb, int kb,
+    double[][] a, int ia, int ja, double[] bp, double beta,
+    double[][] c, int ic, int jc)
+  {
+    int i = 0;
+    for (; i+1<m; i+=2) {
+      double[] a0 = a[ia+i];
+      double[] a1 = a[ia+i+1];
+      double[] c0 = c[ic+i];
+      double[] c1 = c[ic+i+1];
+      scale(beta,c0,jc,nb);
+      scale(beta,c1,jc,nb);
+      for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+        double a0p = a0[ja+p];
+        double a1p = a1[ja+p];
+        if (a0p==0.0 && a1p==0.0)
+          continue;
+        for (int j=0; j<nb; ++j) {
+          double bpj = bp[ip+j];
+          c0[jc+j] += a0p*bpj;
+          c1[jc+j] += a1p*bpj;
+        }
+      }
+    }
+    if (i<m) {
+      double[] a0 = a[ia+i];
+      double[] c0 = c[ic+i];
+      scale(beta,c0,jc,nb);
+      for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+        double a0p = a0[ja+p];
+        if (a0p==0.0)
+          continue;
+        for (int j=0; j<nb; ++j)
+          c0[jc+j] += a0p*bp[ip+j];
+      }
+    }
+  }
+
+  // Single-precision versions of the methods above.
+
+  private static void gemmSerial(
+    int m, int n, int k, float alpha,
+    float[][] a, int ia, int ja,
+    float[][] b, int ib, int jb, float beta,
+    float[][] c, int ic, int jc)
+  {
+    if (k==0 || alpha==0.0f) {
+      for (int i=0; i<m; ++i)
+        scale(beta,c[ic+i],jc,n);
+      return;
+    }
+    float[] bp = new float[min(k,KC)*min(n,NC)];
+    for (int jj=0; jj<n; jj+=NC) {
+      int nb = min(NC,n-jj);
+      for (int kk=0; kk<k; kk+=KC) {
+        int kb = min(KC,k-kk);
+        pack(alpha,b,ib+kk,jb+jj,kb,nb,bp);
+        float betak = (kk==0)?beta:1.0f;
+        multiply(m,nb,kb,a,ia,ja+kk,bp,betak,c,ic,jc+jj);
+      }
+    }
+  }
+
+  private static void pack(
+    float alpha, float[][] b, int ib, int jb, int kb, int nb, float[] bp)
+  {
+    for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+      float[] bi = b[ib+p];
+      if (alpha==1.0f) {
+        System.arraycopy(bi,jb,bp,ip,nb);
+      } else {
+        for (int j=0; j<nb; ++j)
+          bp[ip+j] = alpha*bi[jb+j];
+      }
+    }
+  }
+
+  private static void scale(float beta, float[] c, int jc, int n) {
+    if (beta==0.0f) {
+      for (int j=0; j<n; ++j)
+        c[jc+j] = 0.0f;
+    } else if (beta!=1.0f) {
+      for (int j=0; j<n; ++j)
+        c[jc+j] *= beta;
+    }
+  }
+
+  private static void multiply(
+    int m, int nb, int kb,
+    float[][] a, int ia, int ja, float[] bp, float beta,
+    float[][] c, int ic, int jc)
+  {
+    int i = 0;
+    for (; i+1<m; i+=2) {
+      float[] a0 = a[ia+i];
+      float[] a1 = a[ia+i+1];
+      float[] c0 = c[ic+i];
+      float[] c1 = c[ic+i+1];
+      scale(beta,c0,jc,nb);
+      scale(beta,c1,jc,nb);
+      for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+        float a0p = a0[ja+p];
+        float a1p = a1[ja+p];
+        if (a0p==0.0f && a1p==0.0f)
+          continue;
+        for (int j=0; j<nb; ++j) {
+          float bpj = bp[ip+j];
+          c0[jc+j] += a0p*bpj;
+          c1[jc+j] += a1p*bpj;
+        }
+      }
+    }
+    if (i<m) {
+      float[] a0 = a[ia+i];
+      float[] c0 = c[ic+i];
+      scale(beta,c0,jc,nb);
+      for (int p=0,ip=0; p<kb; ++p,ip+=nb) {
+        float a0p = a0[ja+p];
+        if (a0p==0.0f)
+          continue;
+        for (int j=0; j<nb; ++j)
+          c0[jc+j] += a0p*bp[ip+j];
+      }
+    }
+  }
+}
@@ -0,0 +1,373 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.min;
+import static java.lang.Math.sqrt;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Krylov subspace methods for solving sparse linear systems A*x = b.
+ * <ul>
+ * <li>CG: conjugate gradients, for symmetric positive-definite A.</li>
+ * <li>BiCGSTAB: stabilized bi-conjugate gradients, for general A.</li>
+ * <li>GMRES: restarted generalized minimal residuals, for general A.</li>
+ * </ul>
+ * The matrix A and an optional preconditioner M, an approximation to the
+ * inverse of A, are specified as operators, so that these methods may be
+ * used with sparse matrices or with matrix-free operators. Preconditioners
+ * for CG must be symmetric and positive-definite. BiCGSTAB and GMRES use
+ * right preconditioning, so that their residuals are those for the
+ * original system A*x = b.
+ * <p>
+ * Iterations end when the norm of the residual r = b-A*x is not greater
+ * than a specified fraction of the norm of b, or when the number of
+ * iterations exceeds a specified maximum. Dot products and other vector
+ * operations are computed in parallel for long vectors.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class KrylovSolver {
+
+  /**
+   * The result of solving A*x = b.
+   */
+  public static class Result {
+
+    /**
+     * The number of iterations performed.
+     */
+    public final int niter;
+
+    /**
+     * The norm of the residual b-A*x divided by the norm of b.
+     */
+    public final double rnorm;
+
+    /**
+     * Determines whether the iterations converged.
+     * @return true, if converged; false, otherwise.
+     */
+    public boolean converged() {
+      return _converged;
+    }
+
+    private final boolean _converged;
+    private Result(int niter, double rnorm, boolean converged) {
+      this.niter = niter;
+      this.rnorm = rnorm;
+      _converged = converged;
+    }
+  }
+
+  /**
+   * Constructs a solver with specified parameters.
+   * @param small stop when norm of residual is less than small*norm(b).
+   * @param niter maximum number of iterations.
+   */
+  public KrylovSolver(double small, int niter) {
+    Check.argument(small>=0.0,"small is non-negative");
+    Check.argument(niter>=0,"niter is non-negative");
+    _small = small;
+    _niter = niter;
+  }
+
+  /**
+   * Solves A*x = b by preconditioned conjugate gradients.
+   * @param a the operator A, symmetric and positive-definite.
+   * @param m the preconditioner M; null, for no preconditioner.
+   * @param b the right-hand-side vector b.
+   * @param x on input, initial guess; on output, the solution x.
+   * @return the result.
+   */
+  public Result cg(DOperator a, DOperator m, double[] b, double[] x) {
+    int n = b.length;
+    double[] r = new double[n];
+    double[] z = new double[n];
+    double[] q = new double[n];
+    a.apply(x,q);
+    update(1.0,b,0.0,r);
+    update(-1.0,q,1.0,r);
+    double bnorm = norm(b);
+    double rtol = _small*bnorm;
+    double rnorm = norm(r);
+    precondition(m,r,z);
+    double[] p = z.clone();
+    double rz = dot(r,z);
+    int iter = 0;
+    for (; iter<_niter && rnorm>rtol; ++iter) {
+      a.apply(p,q);
+      double pq = dot(p,q);
+      if (pq==0.0)
+        break;
+      double alpha = rz/pq;
+      update(alpha,p,1.0,x);
+      update(-alpha,q,1.0,r);
+      rnorm = norm(r);
+      precondition(m,r,z);
+      double rznew = dot(r,z);
+      double beta = rznew/rz;
+      rz = rznew;
+      update(1.0,z,beta,p);
+    }
+    return result(iter,rnorm,bnorm);
+  }
+
+  /**
+   * Solves A*x = b by right-preconditioned BiCGSTAB.
+   * @param a the operator A.
+   * @param m the preconditioner M; null, for no preconditioner.
+   * @param b the right-hand-side vector b.
+   * @param x on input, initial guess; on output, the solution x.
+   * @return the result.
+   */
+  public Result bicgstab(DOperator a, DOperator m, double[] b, double[] x) {
+    int n = b.length;
+    double[] r = new double[n];
+    double[] p = new double[n];
+    double[] v = new double[n];
+    double[] s = new double[n];
+    double[] t = new double[n];
+    double[] ph = new double[n];
+    double[] sh = new double[n];
+    a.apply(x,t);
+    update(1.0,b,0.0,r);
+    update(-1.0,t,1.0,r);
+    double[] rh = r.clone();
+    double bnorm = norm(b);
+    double rtol = _small*bnorm;
+    double rnorm = norm(r);
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    int iter = 0;
+    for (; iter<_niter && rnorm>rtol; ++iter) {
+      double rhonew = dot(rh,r);
+      if (rhonew==0.0)
+        break;
+      if (iter==0) {
+        update(1.0,r,0.0,p);
+      } else {
+        double beta = (rhonew/rho)*(alpha/omega);
+        update(-omega,v,1.0,p);
+        update(1.0,r,beta,p);
+      }
+      rho = rhonew;
+      precondition(m,p,ph);
+      a.apply(ph,v);
+      double rhv = dot(rh,v);
+      if (rhv==0.0)
+        break;
+      alpha = rho/rhv;
+      update(1.0,r,0.0,s);
+      update(-alpha,v,1.0,s);
+      update(alpha,ph,1.0,x);
+      double snorm = norm(s);
+      if (snorm<=rtol) {
+        update(1.0,s,0.0,r);
+        rnorm = snorm;
+        ++iter;
+        break;
+      }
+      precondition(m,s,sh);
+      a.apply(sh,t);
+      double tt = dot(t,t);
+      omega = (tt>0.0)?dot(t,s)/tt:0.0;
+      update(omega,sh,1.0,x);
+      update(1.0,s,0.0,r);
+      update(-omega,t,1.0,r);
+      rnorm = norm(r);
+      if (omega==0.0) {
+        ++iter;
+        break;
+      }
+    }
+    return result(iter,rnorm,bnorm);
+  }
+
+  /**
+   * Solves A*x = b by right-preconditioned restarted GMRES.
+   * @param a the operator A.
+   * @param m the preconditioner M; null, for no preconditioner.
+   * @param b the right-hand-side vector b.
+   * @param x on input, initial guess; on output, the solution x.
+   * @param restart number of iterations between restarts.
+   * @return the result.
+   */
+  public Result gmres(
+    DOperator a, DOperator m, double[] b, double[] x, int restart)
+  {
+    Check.argument(restart>0,"restart is positive");
+    int n = b.length;
+    int k = restart;
+    double[][] v = new double[k+1][n];
+    double[][] h = new double[k+1][k];
+    double[] c = new double[k];
+    double[] s = new double[k];
+    double[] g = new double[k+1];
+    double[] y = new double[k];
+    double[] w = new double[n];
+    double[] z = new double[n];
+    double bnorm = norm(b);
+    double rtol = _small*bnorm;
+    double rnorm = 0.0;
+    int iter = 0;
+    for (;;) {
+
+      // Residual r = b-A*x, in first basis vector.
+      a.apply(x,w);
+      update(1.0,b,0.0,v[0]);
+      update(-1.0,w,1.0,v[0]);
+      rnorm = norm(v[0]);
+      if (rnorm<=rtol || iter>=_niter || rnorm==0.0)
+        break;
+      update(1.0/rnorm,v[0],0.0,v[0]);
+      Arrays.fill(g,0.0);
+      g[0] = rnorm;
+
+      // Arnoldi with modified Gram-Schmidt and Givens rotations.
+      int j = 0;
+      for (; j<k && iter<_niter; ++iter) {
+        precondition(m,v[j],z);
+        a.apply(z,w);
+        for (int i=0; i<=j; ++i) {
+          h[i][j] = dot(w,v[i]);
+          update(-h[i][j],v[i],1.0,w);
+        }
+        h[j+1][j] = norm(w);
+        if (h[j+1][j]>0.0)
+          update(1.0/h[j+1][j],w,0.0,v[j+1]);
+        for (int i=0; i<j; ++i) {
+          double hij = h[i][j];
+          h[i][j] = c[i]*hij+s[i]*h[i+1][j];
+          h[i+1][j] = -s[i]*hij+c[i]*h[i+1][j];
+        }
+        double hjj = h[j][j], hj1 = h[j+1][j];
+        double d = sqrt(hjj*hjj+hj1*hj1);
+        c[j] = (d>0.0)?hjj/d:1.0;
+        s[j] = (d>0.0)?hj1/d:0.0;
+        h[j][j] = d;
+        h[j+1][j] = 0.0;
+        g[j+1] = -s[j]*g[j];
+        g[j] = c[j]*g[j];
+        ++j;
+        if (abs(g[j])<=rtol || hj1==0.0) {
+          ++iter;
+          break;
+        }
+      }
+
+      // Solve H*y = g and update x = x+M*V*y.
+      for (int i=j-1; i>=0; --i) {
+        double yi = g[i];
+        for (int l=i+1; l<j; ++l)
+          yi -= h[i][l]*y[l];
+        y[i] = (h[i][i]!=0.0)?yi/h[i][i]:0.0;
+      }
+      Arrays.fill(w,0.0);
+      for (int i=0; i<j; ++i)
+        update(y[i],v[i],1.0,w);
+      precondition(m,w,z);
+      update(1.0,z,1.0,x);
+    }
+    return result(iter,rnorm,bnorm);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int CHUNK = 8192; // vector elements per task
+
+  private double _small;
+  private int _niter;
+
+  private Result result(int niter, double rnorm, double bnorm) {
+    double rrel = (bnorm>0.0)?rnorm/bnorm:rnorm;
+    return new Result(niter,rrel,rnorm<=_small*bnorm);
+  }
+
+  private static void precondition(DOperator m, double[] x, double[] y) {
+    if (m!=null) {
+      m.apply(x,y);
+    } else {
+      System.arraycopy(x,0,y,0,x.length);
+    }
+  }
+
+  private static double norm(double[] x) {
+    return sqrt(dot(x,x));
+  }
+
+  private static double dot(final double[] x, final double[] y) {
+    final int n = x.length;
+    int nc = (n+CHUNK-1)/CHUNK;
+    if (nc<=1)
+      return dot(0,n,x,y);
+    return Parallel.reduce(nc,new Parallel.ReduceInt<Double>() {
+      public Double compute(int ic) {
+        int i0 = ic*CHUNK;
+        int i1 = min(n,i0+CHUNK);
+        return dot(i0,i1,x,y);
+      }
+      public Double combine(Double d1, Double d2) {
+        return d1+d2;
+      }
+    });
+  }
+
+  private static double dot(int i0, int i1, double[] x, double[] y) {
+    double d = 0.0;
+    for (int i=i0; i<i1; ++i)
+      d += x[i]*y[i];
+    return d;
+  }
+
+  // y = a*x+b*y. If b is zero, y = a*x, even if y has NaNs.
+  private static void update(
+    final double a, final double[] x, final double b, final double[] y)
+  {
+    final int n = y.length;
+    int nc = (n+CHUNK-1)/CHUNK;
+    if (nc<=1) {
+      update(0,n,a,x,b,y);
+    } else {
+      Parallel.loop(nc,new Parallel.LoopInt() {
+        public void compute(int ic) {
+          int i0 = ic*CHUNK;
+          int i1 = min(n,i0+CHUNK);
+          update(i0,i1,a,x,b,y);
+        }
+      });
+    }
+  }
+
+  private static void update(
+    int i0, int i1, double a, double[] x, double b, double[] y)
+  {
+    if (b==0.0) {
+      for (int i=i0; i<i1; ++i)
+        y[i] = a*x[i];
+    } else if (b==1.0) {
+      for (int i=i0; i<i1; ++i)
+        y[i] += a*x[i];
+    } else {
+      for (int i=i0; i<i1; ++i)
+        y[i] = a*x[i]+b*y[i];
+    }
+  }
+}
@@ -0,0 +1,266 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.sqrt;
+
+import java.util.Arrays;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Preconditioners for iterative solutions of sparse linear systems.
+ * Each preconditioner is an operator that applies an approximate inverse
+ * of a sparse matrix A, and can be used with a {@link KrylovSolver}.
+ * <ul>
+ * <li>Jacobi: the inverse of the diagonal of A.</li>
+ * <li>IC(0): an incomplete Cholesky decomposition A ~ L*L' of a symmetric
+ * positive-definite matrix A, in which L has the same non-zero pattern as
+ * the lower triangle of A.</li>
+ * <li>ILU(0): an incomplete LU decomposition A ~ L*U of a matrix A, in
+ * which L and U together have the same non-zero pattern as A.</li>
+ * </ul>
+ * Incomplete Cholesky decompositions may break down, with non-positive
+ * pivots, even for positive-definite matrices. In that case, the
+ * decomposition is recomputed with a shifted diagonal, A+alpha*diag(A),
+ * for alpha = 0.001, 0.002, 0.004, and so on. If pivots are not all
+ * positive after 20 shifts, construction of the preconditioner fails
+ * with an exception.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class Preconditioners {
+
+  /**
+   * Returns a Jacobi preconditioner for the specified matrix.
+   * @param a the matrix, which must have non-zero diagonal elements.
+   * @return the preconditioner.
+   */
+  public static DOperator jacobi(CsrDMatrix a) {
+    Check.argument(a.getM()==a.getN(),"A is square");
+    final double[] d = a.getDiagonal();
+    for (int i=0; i<d.length; ++i) {
+      Check.argument(d[i]!=0.0,"diagonal elements are non-zero");
+      d[i] = 1.0/d[i];
+    }
+    return new DOperator() {
+      public void apply(double[] x, double[] y) {
+        for (int i=0; i<d.length; ++i)
+          y[i] = d[i]*x[i];
+      }
+    };
+  }
+
+  /**
+   * Returns an IC(0) preconditioner for the specified matrix.
+   * Only the lower triangle of the matrix is used; the matrix
+   * is assumed to be symmetric and positive-definite. If the incomplete
+   * factorization fails, it is recomputed with a bounded number of
+   * increasing shifts of the diagonal of the matrix.
+   * @param a the matrix, which must have positive diagonal elements.
+   * @return the preconditioner.
+   * @throws IllegalStateException if no shifted factorization succeeds.
+   */
+  public static DOperator ic0(CsrDMatrix a) {
+    return new Ic0(a);
+  }
+
+  /**
+   * Returns an ILU(0) preconditioner for the specified matrix.
+   * @param a the matrix, which must have non-zero diagonal elements.
+   * @return the preconditioner.
+   */
+  public static DOperator ilu0(CsrDMatrix a) {
+    return new Ilu0(a);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private Preconditioners() {
+  }
+
+  /**
+   * Incomplete Cholesky decomposition. Rows of L are stored in CSR
+   * format, with the diagonal element last in each row.
+   */
+  private static class Ic0 implements DOperator {
+    Ic0(CsrDMatrix a) {
+      Check.argument(a.getM()==a.getN(),"A is square");
+      int n = _n = a.getN();
+      int[] arp = a.getRowPointers();
+      int[] aci = a.getColumnIndices();
+      double[] av = a.getValues();
+      _lp = new int[n+1];
+      for (int i=0; i<n; ++i) {
+        int nl = 0;
+        for (int p=arp[i]; p<arp[i+1] && aci[p]<=i; ++p)
+          ++nl;
+        _lp[i+1] = _lp[i]+nl;
+      }
+      _lj = new int[_lp[n]];
+      double[] al = new double[_lp[n]];
+      for (int i=0; i<n; ++i) {
+        int q = _lp[i];
+        for (int p=arp[i]; p<arp[i+1] && aci[p]<=i; ++p,++q) {
+          _lj[q] = aci[p];
+          al[q] = av[p];
+        }
+        Check.argument(q>_lp[i] && _lj[q-1]==i,"diagonal elements exist");
+        Check.argument(al[q-1]>0.0,"diagonal elements are positive");
+      }
+      double alpha = 0.0;
+      for (int itry=0; itry<=SHIFT_TRIES && _lv==null; ++itry) {
+        _lv = decompose(al,alpha);
+        alpha = (alpha==0.0)?SHIFT_MIN:2.0*alpha;
+      }
+      Check.state(_lv!=null,"shifted incomplete factorization succeeded");
+    }
+    public void apply(double[] x, double[] y) {
+      int n = _n;
+      int[] lp = _lp;
+      int[] lj = _lj;
+      double[] lv = _lv;
+
+      // Solve L*z = x.
+      for (int i=0; i<n; ++i) {
+        double s = x[i];
+        int pd = lp[i+1]-1;
+        for (int p=lp[i]; p<pd; ++p)
+          s -= lv[p]*y[lj[p]];
+        y[i] = s/lv[pd];
+      }
+
+      // Solve L'*y = z.
+      for (int i=n-1; i>=0; --i) {
+        int pd = lp[i+1]-1;
+        double yi = y[i] /= lv[pd];
+        for (int p=lp[i]; p<pd; ++p)
+          y[lj[p]] -= lv[p]*yi;
+      }
+    }
+    private int _n;
+    private int[] _lp,_lj;
+    private double[] _lv;
+
+    // If the factorization of A fails, it is retried for A+alpha*diag(A),
+    // doubling alpha from its minimum value. The maximum alpha, about
+    // 500, shifts any matrix with positive diagonal elements far enough
+    // toward diag(A) that this factorization succeeds in practice.
+    private static final double SHIFT_MIN = 0.001;
+    private static final int SHIFT_TRIES = 20;
+
+    // Returns the factor L for A+alpha*diag(A), or null, if not positive.
+    private double[] decompose(double[] al, double alpha) {
+      int[] lp = _lp;
+      int[] lj = _lj;
+      double[] lv = Arrays.copyOf(al,al.length);
+      for (int i=0; i<_n; ++i) {
+        int pd = lp[i+1]-1;
+        lv[pd] *= 1.0+alpha;
+        for (int p=lp[i]; p<=pd; ++p) {
+          int k = lj[p];
+          int kd = lp[k+1]-1;
+
+          // Sparse dot product of rows i and k, for columns less than k.
+          double s = lv[p];
+          for (int q=lp[i],r=lp[k]; q<p && r<kd;) {
+            int jq = lj[q], jr = lj[r];
+            if (jq==jr) {
+              s -= lv[q++]*lv[r++];
+            } else if (jq<jr) {
+              ++q;
+            } else {
+              ++r;
+            }
+          }
+          if (p<pd) {
+            lv[p] = s/lv[kd];
+          } else {
+            if (!(s>0.0))
+              return null;
+            lv[p] = sqrt(s);
+          }
+        }
+      }
+      return lv;
+    }
+  }
+
+  /**
+   * Incomplete LU decomposition. Factors L and U are stored in CSR
+   * format, overwriting the values of A. The unit diagonal of L is
+   * not stored.
+   */
+  private static class Ilu0 implements DOperator {
+    Ilu0(CsrDMatrix a) {
+      Check.argument(a.getM()==a.getN(),"A is square");
+      int n = _n = a.getN();
+      int[] rp = _rp = a.getRowPointers();
+      int[] ci = _ci = a.getColumnIndices();
+      double[] v = _v = Arrays.copyOf(a.getValues(),rp[n]);
+      int[] pd = _pd = new int[n];
+      for (int i=0; i<n; ++i) {
+        pd[i] = a.find(i,i);
+        Check.argument(pd[i]>=0 && v[pd[i]]!=0.0,
+          "diagonal elements are non-zero");
+      }
+      int[] iw = new int[n];
+      Arrays.fill(iw,-1);
+      for (int i=0; i<n; ++i) {
+        for (int q=rp[i]; q<rp[i+1]; ++q)
+          iw[ci[q]] = q;
+        for (int p=rp[i]; p<pd[i]; ++p) {
+          int k = ci[p];
+          double lik = v[p] /= v[pd[k]];
+          for (int r=pd[k]+1; r<rp[k+1]; ++r) {
+            int q = iw[ci[r]];
+            if (q>=0)
+              v[q] -= lik*v[r];
+          }
+        }
+        for (int q=rp[i]; q<rp[i+1]; ++q)
+          iw[ci[q]] = -1;
+        Check.state(v[pd[i]]!=0.0,"ILU(0) pivots are non-zero");
+      }
+    }
+    public void apply(double[] x, double[] y) {
+      int n = _n;
+      int[] rp = _rp;
+      int[] ci = _ci;
+      int[] pd = _pd;
+      double[] v = _v;
+
+      // Solve L*z = x.
+      for (int i=0; i<n; ++i) {
+        double s = x[i];
+        for (int p=rp[i]; p<pd[i]; ++p)
+          s -= v[p]*y[ci[p]];
+        y[i] = s;
+      }
+
+      // Solve U*y = z.
+      for (int i=n-1; i>=0; --i) {
+        double s = y[i];
+        for (int p=pd[i]+1; p<rp[i+1]; ++p)
+          s -= v[p]*y[ci[p]];
+        y[i] = s/v[pd[i]];
+      }
+    }
+    private int _n;
+    private int[] _rp,_ci,_pd;
+    private double[] _v;
+  }
+}
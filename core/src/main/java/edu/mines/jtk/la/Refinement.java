@@ -0,0 +1,103 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.abs;
+import static java.lang.Math.sqrt;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Mixed-precision iterative refinement of solutions to A*X = B.
+ * A single-precision solver computes an initial solution X and then
+ * corrections D from residuals R = B-A*X that are computed in double
+ * precision, so that X = X+D converges to a solution with double-precision
+ * accuracy, if A is not too ill-conditioned.
+ * <p>
+ * Refinement stops when the largest residual is less than
+ * sqrt(n)*eps*|A|*|X|, where eps is the double-precision machine epsilon
+ * and |.| denotes the largest absolute value. This is the test used in
+ * LAPACK's dsgesv.
+ * <p>
+ * Single-precision decompositions such as {@link FMatrixLud} use this
+ * class, as do those in the package edu.mines.jtk.lapack.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public final class Refinement {
+
+  /**
+   * A single-precision solver for A*X = B.
+   */
+  public interface Solver {
+
+    /**
+     * Returns the single-precision solution X of A*X = B.
+     * @param b the right-hand-side matrix B.
+     * @return the solution matrix X.
+     */
+    public FMatrix solve(FMatrix b);
+  }
+
+  /**
+   * Returns the refined solution X of A*X = B, or null, if refinement
+   * fails to converge.
+   * @param a the double-precision matrix A.
+   * @param b the double-precision matrix B.
+   * @param s the single-precision solver for A.
+   * @return the solution X; null, if refinement does not converge.
+   */
+  public static DMatrix solve(DMatrix a, DMatrix b, Solver s) {
+    Check.argument(a.isSquare(),"A is square");
+    Check.argument(a.getM()==b.getM(),"A and B have same number of rows");
+    int n = a.getN();
+    double anorm = maxAbs(a);
+    double rtol = sqrt(n)*EPSILON*anorm;
+    DMatrix x = s.solve(new FMatrix(b)).toDMatrix();
+    for (int iter=0; iter<=NITER_MAX; ++iter) {
+      DMatrix r = b.minus(a.times(x));
+      double rnorm = maxAbs(r);
+      double xnorm = maxAbs(x);
+      if (rnorm<=rtol*xnorm)
+        return x;
+      if (!(rnorm<=Double.MAX_VALUE) || iter==NITER_MAX)
+        break;
+      x.plusEquals(s.solve(new FMatrix(r)).toDMatrix());
+    }
+    return null;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final double EPSILON = 0.5*Math.ulp(1.0);
+  private static final int NITER_MAX = 30;
+
+  private Refinement() {
+  }
+
+  private static double maxAbs(DMatrix x) {
+    double[][] xa = x.getArray();
+    double xmax = 0.0;
+    for (double[] xi:xa) {
+      for (double xij:xi) {
+        double axij = abs(xij);
+        if (xmax<axij || axij!=axij)
+          xmax = axij;
+      }
+    }
+    return xmax;
+  }
+}
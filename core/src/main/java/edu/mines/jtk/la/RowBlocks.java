@@ -0,0 +1,243 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.min;
+
+import java.util.Random;
+
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Operations on blocks of vectors stored as rows of a matrix, for the
+ * truncated decompositions {@link DMatrixRsvd} and {@link EigenSolver}.
+ * An operator applied to a block computes A*x for each row x, either
+ * with parallel products of rows of a dense matrix A or with parallel
+ * applications of a {@link DOperator}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.22
+ */
+final class RowBlocks {
+
+  /**
+   * An operator applied to each row of a block.
+   */
+  interface Operator {
+
+    /**
+     * Returns the block Y with rows y = A*x for rows x of X.
+     * @param x the block X.
+     * @return the block Y.
+     */
+    DMatrix apply(DMatrix x);
+  }
+
+  /**
+   * Returns an operator that computes A*x for a dense matrix A.
+   * Each thread computes dot products of a range of rows of A.
+   * @param a the matrix A.
+   * @return the operator.
+   */
+  static Operator operator(final DMatrix a) {
+    return new Operator() {
+      public DMatrix apply(DMatrix x) {
+        final double[][] aa = a.getArray();
+        final double[][] xa = x.getArray();
+        final int m = a.getM();
+        final int n = a.getN();
+        final int nx = x.getM();
+        DMatrix y = new DMatrix(nx,m);
+        final double[][] ya = y.getArray();
+        Parallel.loop(0,m,1,ROWS,new Parallel.LoopInt() {
+          public void compute(int i) {
+            double[] ai = aa[i];
+            for (int k=0; k<nx; ++k)
+              ya[k][i] = dot(n,ai,xa[k]);
+          }
+        });
+        return y;
+      }
+    };
+  }
+
+  /**
+   * Returns an operator that computes A'*x for a dense matrix A.
+   * @param a the matrix A.
+   * @return the operator.
+   */
+  static Operator transposeOperator(final DMatrix a) {
+    return new Operator() {
+      public DMatrix apply(DMatrix x) {
+        return x.times(a);
+      }
+    };
+  }
+
+  /**
+   * Returns an operator that applies a matrix-free operator A to each
+   * row in parallel. The operator A must be thread-safe.
+   * @param m the length of outputs of A.
+   * @param a the operator A.
+   * @return the operator.
+   */
+  static Operator operator(final int m, final DOperator a) {
+    return new Operator() {
+      public DMatrix apply(DMatrix x) {
+        final double[][] xa = x.getArray();
+        DMatrix y = new DMatrix(x.getM(),m);
+        final double[][] ya = y.getArray();
+        Parallel.loop(xa.length,new Parallel.LoopInt() {
+          public void compute(int k) {
+            a.apply(xa[k],ya[k]);
+          }
+        });
+        return y;
+      }
+    };
+  }
+
+  /**
+   * Returns a block of independent standard normal random numbers.
+   * @param m number of rows.
+   * @param n number of columns.
+   * @param r the random number generator.
+   * @return the block.
+   */
+  static DMatrix gaussian(int m, int n, Random r) {
+    DMatrix x = new DMatrix(m,n);
+    double[][] xa = x.getArray();
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        xa[i][j] = r.nextGaussian();
+    return x;
+  }
+
+  /**
+   * Returns a block with orthonormal rows that span the rows of X.
+   * Uses a Householder QR decomposition, which is stable even if X
+   * is rank deficient; in that case, the span includes other rows.
+   * @param x the block X, with no more rows than columns.
+   * @return the block Q.
+   */
+  static DMatrix orthonormalize(DMatrix x) {
+    return new DMatrixQrd(x.transpose()).getQ().transpose();
+  }
+
+  /**
+   * Returns the inverse of a lower-triangular matrix L.
+   * @param l the matrix L, with non-zero diagonal elements.
+   * @return the inverse of L, also lower-triangular.
+   */
+  static DMatrix lowerInverse(DMatrix l) {
+    int n = l.getN();
+    double[][] la = l.getArray();
+    DMatrix t = new DMatrix(n,n);
+    double[][] ta = t.getArray();
+    for (int j=0; j<n; ++j) {
+      ta[j][j] = 1.0/la[j][j];
+      for (int i=j+1; i<n; ++i) {
+        double s = 0.0;
+        for (int k=j; k<i; ++k)
+          s -= la[i][k]*ta[k][j];
+        ta[i][j] = s/la[i][i];
+      }
+    }
+    return t;
+  }
+
+  /**
+   * Computes h[i] = v[i]'*w for rows i = 0, ..., nv-1 of V, in parallel.
+   * @param nv number of rows.
+   * @param v array of rows of V.
+   * @param w the vector w.
+   * @param h output array of dot products.
+   */
+  static void dots(
+    int nv, final double[][] v, final double[] w, final double[] h)
+  {
+    if (nv==0)
+      return;
+    final int n = w.length;
+    Parallel.loop(nv,new Parallel.LoopInt() {
+      public void compute(int i) {
+        h[i] = dot(n,v[i],w);
+      }
+    });
+  }
+
+  /**
+   * Computes w = w-V'*h, for rows i = 0, ..., nv-1 of V, in parallel.
+   * @param nv number of rows.
+   * @param v array of rows of V.
+   * @param h array of coefficients.
+   * @param w the vector w, updated.
+   */
+  static void subtract(
+    final int nv, final double[][] v, final double[] h, final double[] w)
+  {
+    if (nv==0 || w.length==0)
+      return;
+    final int n = w.length;
+    int nc = (n+CHUNK-1)/CHUNK;
+    Parallel.loop(nc,new Parallel.LoopInt() {
+      public void compute(int ic) {
+        int j0 = ic*CHUNK;
+        int j1 = min(n,j0+CHUNK);
+        for (int i=0; i<nv; ++i) {
+          double hi = h[i];
+          double[] vi = v[i];
+          for (int j=j0; j<j1; ++j)
+            w[j] -= hi*vi[j];
+        }
+      }
+    });
+  }
+
+  /**
+   * Returns indices that sort the specified values in decreasing order.
+   * @param d array of values.
+   * @return array of indices.
+   */
+  static int[] decreasing(double[] d) {
+    int n = d.length;
+    int[] index = new int[n];
+    for (int j=0; j<n; ++j)
+      index[j] = j;
+    for (int i=1; i<n; ++i) {
+      int t = index[i];
+      int j = i;
+      for (; j>0 && d[index[j-1]]<d[t]; --j)
+        index[j] = index[j-1];
+      index[j] = t;
+    }
+    return index;
+  }
+
+  /**
+   * Returns the dot product of the first n elements of x and y.
+   */
+  static double dot(int n, double[] x, double[] y) {
+    double s = 0.0;
+    for (int j=0; j<n; ++j)
+      s += x[j]*y[j];
+    return s;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int ROWS = 16; // rows of a dense matrix per task
+  private static final int CHUNK = 8192; // vector elements per task
+}
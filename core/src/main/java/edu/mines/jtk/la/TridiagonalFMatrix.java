@@ -14,6 +14,11 @@ limitations under the License.
 ****************************************************************************/
 package edu.mines.jtk.la;
 
+import static java.lang.Math.min;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
 /**
  * A tridiagonal matrix is a square matrix specified by three diagonals.
  * All elements except for those on the diagonal, lower sub-diagonal, and
@@ -27,8 +32,18 @@ package edu.mines.jtk.la;
  *  | 0       0      a[3]    b[3]| |u[3]|     |r[3]|
  * </code></pre>
  * The values a[0] and c[n-1] are ignored.
+ * <p>
+ * Systems with many right-hand-side vectors may be solved with one call,
+ * so that the factorization of this matrix is computed only once. Those
+ * right-hand-side vectors may be stored in either the 1st dimension of
+ * a 2D array (one vector per array) or the 2nd dimension (one vector
+ * element per array); in the latter case loops over vectors are innermost
+ * and may be vectorized. Many different tridiagonal systems of the same
+ * size may likewise be solved with one call to
+ * {@link #solveBatch(float[][],float[][],float[][],float[][],float[][])}.
+ * All of these methods solve systems in parallel.
  * @author Dave Hale, Colorado School of Mines
- * @version 2006.12.12
+ * @version 2006.12.12, 2017.04.20
  */
 public class TridiagonalFMatrix {
 
@@ -109,6 +124,146 @@ public class TridiagonalFMatrix {
       u[j-1] -= _w[j]*u[j];
   }
 
+  /**
+   * Solves this tridiagonal system for many right-hand-side vectors
+   * stored in the 1st dimension of 2D arrays. Uses Gaussian elimination
+   * without pivoting, and assumes that this matrix is non-singular.
+   * @param r input array[m][n] containing m right-hand-side vectors.
+   * @param u output array[m][n] containing m vectors of unknowns;
+   *  may be the same as the array r.
+   */
+  public void solve1(final float[][] r, final float[][] u) {
+    Check.argument(r.length==u.length,"r and u have same number of vectors");
+    final float[] w = new float[_n];
+    final float[] t = new float[_n];
+    factor(w,t);
+    Parallel.loop(r.length,new Parallel.LoopInt() {
+      public void compute(int i) {
+        solve(w,t,r[i],u[i]);
+      }
+    });
+  }
+
+  /**
+   * Solves this tridiagonal system for many right-hand-side vectors
+   * stored in the 2nd dimension of 2D arrays. Uses Gaussian elimination
+   * without pivoting, and assumes that this matrix is non-singular.
+   * @param r input array[n][m] containing m right-hand-side vectors.
+   * @param u output array[n][m] containing m vectors of unknowns;
+   *  may be the same as the array r.
+   */
+  public void solve2(final float[][] r, final float[][] u) {
+    Check.argument(r.length==_n,"r.length equals n");
+    Check.argument(u.length==_n,"u.length equals n");
+    final int m = r[0].length;
+    final float[] w = new float[_n];
+    final float[] t = new float[_n];
+    factor(w,t);
+    int nc = (m+CHUNK-1)/CHUNK;
+    Parallel.loop(nc,new Parallel.LoopInt() {
+      public void compute(int ic) {
+        int k0 = ic*CHUNK;
+        int k1 = min(k0+CHUNK,m);
+        solve2(k0,k1,w,t,r,u);
+      }
+    });
+  }
+
+  /**
+   * Solves this tridiagonal system for a specified right-hand-side, using
+   * parallel cyclic reduction. Cyclic reduction requires about twice as
+   * many operations as the serial Gaussian elimination of the method
+   * {@link #solve(float[],float[])}, but those operations are performed
+   * in parallel for each of about log2(n) levels of reduction. It is most
+   * useful for large diagonally dominant systems with one right-hand-side
+   * vector. Assumes that this matrix is non-singular.
+   * @param r input array containing the right-hand-side column vector.
+   * @param u output array containing the left-hand-side vector of unknowns.
+   */
+  public void solveParallel(float[] r, final float[] u) {
+    final int n = _n;
+    final float[] a = copy(_a,n);
+    final float[] b = copy(_b,n);
+    final float[] c = copy(_c,n);
+    final float[] y = copy(r,n);
+    a[0] = 0.0f;
+    c[n-1] = 0.0f;
+
+    // Forward reduction. At each level, equations i = 2s-1, 4s-1, ...
+    // are combined with equations i-s and i+s to eliminate unknowns
+    // i-s and i+s, so that they are coupled to unknowns i-2s and i+2s.
+    int stop = 1;
+    for (int s=1; 2*s<=n; s*=2) {
+      final int sl = s;
+      Parallel.loop(2*s-1,n,2*s,new Parallel.LoopInt() {
+        public void compute(int i) {
+          float alpha = -a[i]/b[i-sl];
+          b[i] += alpha*c[i-sl];
+          y[i] += alpha*y[i-sl];
+          a[i] = alpha*a[i-sl];
+          if (i+sl<n) {
+            float gamma = -c[i]/b[i+sl];
+            b[i] += gamma*a[i+sl];
+            y[i] += gamma*y[i+sl];
+            c[i] = gamma*c[i+sl];
+          } else {
+            c[i] = 0.0f;
+          }
+        }
+      });
+      stop = 2*s;
+    }
+
+    // Back substitution, beginning with the one equation that remains.
+    for (int s=stop; s>=1; s/=2) {
+      final int sl = s;
+      Parallel.loop(s-1,n,2*s,new Parallel.LoopInt() {
+        public void compute(int i) {
+          float ui = y[i];
+          if (i-sl>=0)
+            ui -= a[i]*u[i-sl];
+          if (i+sl<n)
+            ui -= c[i]*u[i+sl];
+          u[i] = ui/b[i];
+        }
+      });
+    }
+  }
+
+  /**
+   * Solves many different tridiagonal systems of the same size. Elements
+   * of the diagonals and vectors for the different systems are stored in
+   * the 2nd dimension of 2D arrays, so that loops over the systems are
+   * innermost and may be vectorized. Uses Gaussian elimination without
+   * pivoting, and assumes that all matrices are non-singular.
+   * @param a array[n][m] of lower sub-diagonal elements; a[0] is ignored.
+   * @param b array[n][m] of diagonal elements.
+   * @param c array[n][m] of upper super-diagonal elements; c[n-1] is
+   *  ignored.
+   * @param r input array[n][m] containing the right-hand-side vectors.
+   * @param u output array[n][m] containing the vectors of unknowns;
+   *  may be the same as the array r.
+   */
+  public static void solveBatch(
+    final float[][] a, final float[][] b, final float[][] c,
+    final float[][] r, final float[][] u)
+  {
+    int n = b.length;
+    Check.argument(a.length==n,"a.length equals b.length");
+    Check.argument(c.length==n,"c.length equals b.length");
+    Check.argument(r.length==n,"r.length equals b.length");
+    Check.argument(u.length==n,"u.length equals b.length");
+    final int m = b[0].length;
+    int nc = (m+CHUNK-1)/CHUNK;
+    Parallel.loop(nc,new Parallel.LoopInt() {
+      public void compute(int ic) {
+        int k0 = ic*CHUNK;
+        int k1 = min(k0+CHUNK,m);
+        solveBatch(k0,k1,a,b,c,r,u);
+      }
+    });
+  }
+
   /**
    * Multiplies this matrix by the specified column vector.
    * @param x input array containing the column vector.
@@ -146,7 +301,100 @@ public class TridiagonalFMatrix {
     }
   }
 
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int CHUNK = 256; // vectors or systems per task
+
   private int _n; // number of rows and columns
   private float[] _a,_b,_c; // the three diagonals
   private float[] _w; // work array
+
+  private static float[] copy(float[] x, int n) {
+    float[] y = new float[n];
+    System.arraycopy(x,0,y,0,n);
+    return y;
+  }
+
+  /**
+   * Computes the ratios w[j] = c[j-1]/t[j-1] and the reciprocals t[j]
+   * of pivots for Gaussian elimination.
+   */
+  private void factor(float[] w, float[] t) {
+    float tj = _b[0];
+    t[0] = 1.0f/tj;
+    for (int j=1; j<_n; ++j) {
+      w[j] = _c[j-1]*t[j-1];
+      tj = _b[j]-_a[j]*w[j];
+      t[j] = 1.0f/tj;
+    }
+  }
+
+  private void solve(float[] w, float[] t, float[] r, float[] u) {
+    u[0] = r[0]*t[0];
+    for (int j=1; j<_n; ++j)
+      u[j] = (r[j]-_a[j]*u[j-1])*t[j];
+    for (int j=_n-1; j>0; --j)
+      u[j-1] -= w[j]*u[j];
+  }
+
+  private void solve2(
+    int k0, int k1, float[] w, float[] t, float[][] r, float[][] u)
+  {
+    float[] r0 = r[0];
+    float[] u0 = u[0];
+    float t0 = t[0];
+    for (int k=k0; k<k1; ++k)
+      u0[k] = r0[k]*t0;
+    for (int j=1; j<_n; ++j) {
+      float aj = _a[j];
+      float tj = t[j];
+      float[] rj = r[j];
+      float[] uj = u[j];
+      float[] ujm1 = u[j-1];
+      for (int k=k0; k<k1; ++k)
+        uj[k] = (rj[k]-aj*ujm1[k])*tj;
+    }
+    for (int j=_n-1; j>0; --j) {
+      float wj = w[j];
+      float[] uj = u[j];
+      float[] ujm1 = u[j-1];
+      for (int k=k0; k<k1; ++k)
+        ujm1[k] -= wj*uj[k];
+    }
+  }
+
+  private static void solveBatch(
+    int k0, int k1, float[][] a, float[][] b, float[][] c,
+    float[][] r, float[][] u)
+  {
+    int n = b.length;
+    float[][] w = new float[n][k1-k0];
+    float[] t = new float[k1-k0];
+    for (int k=k0; k<k1; ++k) {
+      t[k-k0] = b[0][k];
+      u[0][k] = r[0][k]/t[k-k0];
+    }
+    for (int j=1; j<n; ++j) {
+      float[] aj = a[j];
+      float[] bj = b[j];
+      float[] cjm1 = c[j-1];
+      float[] rj = r[j];
+      float[] uj = u[j];
+      float[] ujm1 = u[j-1];
+      float[] wj = w[j];
+      for (int k=k0; k<k1; ++k) {
+        float wjk = wj[k-k0] = cjm1[k]/t[k-k0];
+        float tk = t[k-k0] = bj[k]-aj[k]*wjk;
+        uj[k] = (rj[k]-aj[k]*ujm1[k])/tk;
+      }
+    }
+    for (int j=n-1; j>0; --j) {
+      float[] wj = w[j];
+      float[] uj = u[j];
+      float[] ujm1 = u[j-1];
+      for (int k=k0; k<k1; ++k)
+        ujm1[k] -= wj[k-k0]*uj[k];
+    }
+  }
 }
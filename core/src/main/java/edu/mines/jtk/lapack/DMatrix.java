@@ -854,7 +854,7 @@ public class DMatrix {
     Check.argument(_n==b._n,
       "number of columns in A equals number of columns in B");
     DMatrix c = new DMatrix(_m,b._m);
-    _blas.dgemm("N","T",_m,b._n,_n,1.0,_a,_m,b._a,b._m,1.0,c._a,c._m);
+    _blas.dgemm("N","T",_m,b._m,_n,1.0,_a,_m,b._a,b._m,1.0,c._a,c._m);
     return c;
   }
 
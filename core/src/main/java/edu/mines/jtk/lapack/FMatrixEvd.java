@@ -0,0 +1,103 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.lapack;
+
+import org.netlib.util.intW;
+import org.netlib.lapack.LAPACK;
+import static edu.mines.jtk.util.ArrayMath.*;
+import edu.mines.jtk.la.FMatrix;
+import edu.mines.jtk.util.Check;
+
+/**
+ * Eigenvalue and eigenvector decomposition of a symmetric matrix A.
+ * The decomposition is A = V*D*V', where the matrix of eigenvalues D
+ * is diagonal and the matrix of eigenvectors V is orthogonal (V*V' = I).
+ * Eigenvalues are sorted in increasing order.
+ * <p>
+ * This class is a single-precision version of the symmetric part of
+ * {@link DMatrixEvd}, for matrices {@link edu.mines.jtk.la.FMatrix}.
+ * Only symmetric matrices are supported.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixEvd {
+
+  /**
+   * Constructs an eigenvalue decomposition for the specified matrix.
+   * @param a the symmetric matrix.
+   */
+  public FMatrixEvd(FMatrix a) {
+    Check.argument(a.isSymmetric(),"A is symmetric");
+    _n = a.getN();
+    _v = new float[_n*_n];
+    _d = new float[_n];
+    float[] aa = a.getPackedColumns();
+    LapackInfo li = new LapackInfo();
+    intW mW = new intW(0);
+    int[] isuppz = new int[2*_n]; // not used
+    float[] work = new float[1];
+    int[] iwork = new int[1];
+    _lapack.ssyevr("V","A","L",
+      _n,aa,_n,0.0f,0.0f,0,0,0.0f,mW,_d,_v,_n,isuppz,
+      work,-1,iwork,-1,li);
+    if (li.get("ssyevr")>0)
+      throw new RuntimeException("internal error in LAPACK ssyevr");
+    int lwork = (int)work[0];
+    work = new float[lwork];
+    int liwork = iwork[0];
+    iwork = new int[liwork];
+    _lapack.ssyevr("V","A","L",
+      _n,aa,_n,0.0f,0.0f,0,0,0.0f,mW,_d,_v,_n,isuppz,
+      work,lwork,iwork,liwork,li);
+    if (li.get("ssyevr")>0)
+      throw new RuntimeException("internal error in LAPACK ssyevr");
+  }
+
+  /**
+   * Gets the matrix of eigenvectors V.
+   * @return the matrix V.
+   */
+  public FMatrix getV() {
+    return FMatrixLud.packed(_n,_n,copy(_v));
+  }
+
+  /**
+   * Gets the diagonal matrix of eigenvalues D.
+   * @return the matrix D.
+   */
+  public FMatrix getD() {
+    FMatrix d = new FMatrix(_n,_n);
+    for (int i=0; i<_n; ++i)
+      d.set(i,i,_d[i]);
+    return d;
+  }
+
+  /**
+   * Gets the eigenvalues, which are all real.
+   * @return array of eigenvalues = diag(D).
+   */
+  public float[] getRealEigenvalues() {
+    return copy(_d);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final LAPACK _lapack = LAPACK.getInstance();
+
+  private int _n; // row and column dimensions for square matrix V
+  private float[] _v; // eigenvectors V
+  private float[] _d; // eigenvalues
+}
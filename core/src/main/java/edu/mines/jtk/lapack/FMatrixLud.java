@@ -0,0 +1,233 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.lapack;
+
+import static java.lang.Math.min;
+
+import org.netlib.lapack.LAPACK;
+import static edu.mines.jtk.util.ArrayMath.*;
+import edu.mines.jtk.la.DMatrix;
+import edu.mines.jtk.la.FMatrix;
+import edu.mines.jtk.la.Refinement;
+import edu.mines.jtk.util.Check;
+
+/**
+ * LU decomposition of a matrix A.
+ * For an m-by-n matrix A, the LU decomposition is A = P*L*U or A(p,:) =
+ * L*U, where P is an m-by-m row permutation matrix, p is a corresponding
+ * array of m row permutation indices, L is an m-by-min(m,n) lower
+ * triangular or trapezoidal matrix with unit diagonal elements, and
+ * U is a min(m,n)-by-n upper triangular or trapezoidal matrix.
+ * <p>
+ * The LU decomposition with pivoting never fails, even if the matrix
+ * A is singular. However, the primary use of LU decomposition is in the
+ * solution of square systems of linear equations, which will fail if A
+ * is singular (or not square).
+ * <p>
+ * This class is a single-precision version of {@link DMatrixLud}, for
+ * matrices {@link edu.mines.jtk.la.FMatrix}. Solutions computed with it
+ * may be improved to double-precision accuracy by mixed-precision
+ * iterative refinement, with {@link edu.mines.jtk.la.Refinement}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixLud {
+
+  /**
+   * Constructs an LU decomposition of the specified matrix A.
+   * @param a the matrix.
+   */
+  public FMatrixLud(FMatrix a) {
+    _m = a.getM();
+    _n = a.getN();
+    _lu = a.getPackedColumns();
+    _npiv = min(_m,_n);
+    _ipiv = new int[_npiv];
+    LapackInfo li = new LapackInfo();
+    _lapack.sgetrf(_m,_n,_lu,_m,_ipiv,li);
+    int info = li.get("sgetrf");
+    _p = new int[_m];
+    for (int i=0; i<_m; ++i)
+      _p[i] = i;
+    _det = 1.0f;
+    for (int i=0; i<_m; ++i) {
+      if (i<_npiv) {
+        int j = _ipiv[i]-1;
+        _det *= _lu[i+i*_m];
+        if (j!=i) {
+          int pi = _p[i];
+          _p[i] = _p[j];
+          _p[j] = pi;
+          _det = -_det;
+        }
+      }
+    }
+    _singular = info>0;
+  }
+
+  /**
+   * Determines whether the matrix A is singular. If singular, then this
+   * decomposition cannot be used to solve systems of linear equations.
+   * @return true, if singular; false, otherwise.
+   */
+  public boolean isSingular() {
+    return _singular;
+  }
+
+  /**
+   * Gets the lower triangular (or lower trapezoidal) factor L.
+   * The matrix L has dimensions m-by-min(m,n) and unit diagonal elements.
+   * @return the factor L.
+   */
+  public FMatrix getL() {
+    int m = _m;
+    int n = min(_m,_n);
+    float[] l = new float[m*n];
+    for (int j=0; j<n; ++j) {
+      l[j+j*m] = 1.0f;
+      for (int i=j+1; i<m; ++i) {
+        l[i+j*m] = _lu[i+j*_m];
+      }
+    }
+    return packed(m,n,l);
+  }
+
+  /**
+   * Gets the upper triangular (or upper trapezoidal) factor U.
+   * The matrix U has dimensions min(m,n)-by-n.
+   * @return the factor L.
+   */
+  public FMatrix getU() {
+    int m = min(_m,_n);
+    int n = _n;
+    float[] u = new float[m*n];
+    for (int j=0; j<n; ++j) {
+      int imax = min(m-1,j);
+      for (int i=0; i<=imax; ++i) {
+        u[i+j*m] = _lu[i+j*_m];
+      }
+    }
+    return packed(m,n,u);
+  }
+
+  /**
+   * Gets the row permutation matrix P.
+   * The matrix P has dimensions m-by-m.
+   * @return the permutation matrix P.
+   */
+  public FMatrix getP() {
+    int m = _m;
+    int n = _m;
+    float[] p = new float[m*n];
+    for (int i=0; i<m; ++i) {
+      p[_p[i]+i*m] = 1.0f;
+    }
+    return packed(m,n,p);
+  }
+
+  /**
+   * Gets the array of row permutation (pivot) indices p. In this
+   * decomposition of the m-by-n matrix A, row i was interchanged
+   * with row p[i], for i = 0, 1, 2, ..., m-1.
+   * @return the pivot indices p.
+   */
+  public int[] getPivotIndices() {
+    return copy(_p);
+  }
+
+  /**
+   * Returns the determinant of the square matrix A.
+   * The determinant exists only for square matrices A.
+   * @return the determinant.
+   */
+  public float det() {
+    Check.argument(_m==_n,"A is square");
+    return _det;
+  }
+
+  /**
+   * Returns the solution X of the linear system A*X = B.
+   * The matrix A must be square and non singular.
+   * Also, the matrices A and B must have the same number of rows.
+   * @param b the right-hand-side matrix B.
+   * @return the solution matrix X.
+   */
+  public FMatrix solve(FMatrix b) {
+    Check.argument(_m==_n,"A is square");
+    Check.argument(_m==b.getM(),"A and B have same number of rows");
+    Check.state(!_singular,"A is not singular");
+    int n = _n;
+    int nrhs = b.getN();
+    float[] aa = _lu;
+    int lda = _m;
+    int[] ipiv = _ipiv;
+    float[] ba = b.getPackedColumns();
+    int ldb = _m;
+    LapackInfo li = new LapackInfo();
+    _lapack.sgetrs("N",n,nrhs,aa,lda,ipiv,ba,ldb,li);
+    li.check("sgetrs");
+    return packed(_m,nrhs,ba);
+  }
+
+  /**
+   * Returns the solution X of the system A*X = B, refined to double-precision
+   * accuracy. This decomposition of a single-precision copy of A is used to
+   * compute an initial solution and corrections for residuals R = B-A*X
+   * that are computed in double precision. If the single-precision copy
+   * of A is singular, or if this iterative refinement fails to
+   * converge, because A is too ill-conditioned, then X is computed with
+   * a double-precision decomposition {@link edu.mines.jtk.la.DMatrixLud}.
+   * @param a the double-precision matrix A, which must be non-singular,
+   *  and from which the matrix for this decomposition was rounded.
+   * @param b the double-precision right-hand-side matrix B.
+   * @return the double-precision solution matrix X.
+   */
+  public DMatrix solve(DMatrix a, DMatrix b) {
+    Check.argument(_m==_n,"A is square");
+    Check.argument(a.getN()==_n,"A and this decomposition have same size");
+    if (isSingular())
+      return new edu.mines.jtk.la.DMatrixLud(a).solve(b);
+    DMatrix x = Refinement.solve(a,b,new Refinement.Solver() {
+      public FMatrix solve(FMatrix r) {
+        return FMatrixLud.this.solve(r);
+      }
+    });
+    if (x==null)
+      x = new edu.mines.jtk.la.DMatrixLud(a).solve(b);
+    return x;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final LAPACK _lapack = LAPACK.getInstance();
+
+  private int _m; // number of rows
+  private int _n; // number of columns
+  private float[] _lu; // factors L and U
+  private int _npiv; // _ipiv.length = min(_m,_n)
+  private int[] _ipiv; // one-based pivot indices returned by sgetrf
+  private int[] _p; // zero-based pivot indices
+  private float _det; // determinant
+  private boolean _singular; // true, if A is singular
+
+  // Returns a matrix with the specified packed columns. Also used by the
+  // other single-precision decompositions in this package.
+  static FMatrix packed(int m, int n, float[] c) {
+    FMatrix a = new FMatrix(m,n);
+    a.setPackedColumns(c);
+    return a;
+  }
+}
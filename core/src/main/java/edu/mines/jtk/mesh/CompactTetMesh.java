@@ -0,0 +1,557 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Arrays;
+import java.util.Random;
+
+import edu.mines.jtk.util.Check;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * A compact and immutable tetrahedral mesh.
+ * <p>
+ * Nodes and tets are represented by integer indices. Node coordinates
+ * are stored in arrays of floats, and the nodes and tet nabors of each
+ * tet are stored in arrays of ints. This representation requires much
+ * less memory than that of a {@link TetMesh}, in which nodes and tets
+ * are objects that reference each other. For example, a compact mesh
+ * with 10 million tets requires about 350 MB.
+ * <p>
+ * As in a tet mesh, the four nodes A, B, C and D of each tet are ordered
+ * such that node D is left of the plane ABC, and the tet nabor with local
+ * index k (A, B, C or D) is opposite the node with that same local index.
+ * Indices of null tet nabors are -1.
+ * <p>
+ * A compact mesh cannot be modified after it is constructed. Therefore,
+ * all methods, including those for point location and natural neighbors,
+ * are thread-safe. Iterations over nodes and tets are simply loops over
+ * their indices.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.28
+ */
+public final class CompactTetMesh {
+
+  /**
+   * Constructs a compact copy of the specified tet mesh. Nodes are
+   * indexed in the order of iteration by {@link TetMesh#getNodes()}.
+   * Construction clears all node and tet marks in the specified mesh.
+   * @param mesh the tet mesh.
+   */
+  public CompactTetMesh(TetMesh mesh) {
+    this(arrays(mesh));
+  }
+
+  /**
+   * Constructs a Delaunay tetrahedralization of specified points. Nodes
+   * are indexed in the order of the specified points. Any node with the
+   * same coordinates as a node with a smaller index is in no tets.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   */
+  public CompactTetMesh(float[] x, float[] y, float[] z) {
+    this(arrays(x,y,z));
+  }
+
+  /**
+   * Constructs a mesh with specified nodes and tets. Nabors of tets are
+   * computed from their nodes. Nodes A, B, C and D of each tet must be
+   * ordered such that node D is left of the plane ABC.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @param tn array[4*ntet] of indices of nodes A, B, C and D.
+   */
+  public CompactTetMesh(float[] x, float[] y, float[] z, int[] tn) {
+    this(arrays(x,y,z,tn));
+  }
+
+  /**
+   * Returns the number of nodes in this mesh.
+   * @return the number of nodes.
+   */
+  public int countNodes() {
+    return _nnode;
+  }
+
+  /**
+   * Returns the number of tets in this mesh.
+   * @return the number of tets.
+   */
+  public int countTets() {
+    return _ntet;
+  }
+
+  /**
+   * Returns the x coordinate of the specified node.
+   * @param node the node index.
+   * @return the x coordinate.
+   */
+  public float x(int node) {
+    return _x[node];
+  }
+
+  /**
+   * Returns the y coordinate of the specified node.
+   * @param node the node index.
+   * @return the y coordinate.
+   */
+  public float y(int node) {
+    return _y[node];
+  }
+
+  /**
+   * Returns the z coordinate of the specified node.
+   * @param node the node index.
+   * @return the z coordinate.
+   */
+  public float z(int node) {
+    return _z[node];
+  }
+
+  /**
+   * Returns the index of a tet that references the specified node.
+   * @param node the node index.
+   * @return the tet index; -1, if the node is in no tets.
+   */
+  public int tet(int node) {
+    return _nt[node];
+  }
+
+  /**
+   * Returns the index of a node of the specified tet.
+   * @param tet the tet index.
+   * @param k local index, 0, 1, 2 or 3, of node A, B, C or D.
+   * @return the node index.
+   */
+  public int tetNode(int tet, int k) {
+    return _tn[4*tet+k];
+  }
+
+  /**
+   * Returns the index of a tet nabor of the specified tet.
+   * @param tet the tet index.
+   * @param k local index, 0, 1, 2 or 3, of the node opposite the nabor.
+   * @return the nabor tet index; -1, if the nabor is null.
+   */
+  public int tetNabor(int tet, int k) {
+    return _tt[4*tet+k];
+  }
+
+  /**
+   * Gets a copy of the array of node x coordinates.
+   * @return array[nnode] of x coordinates.
+   */
+  public float[] getX() {
+    return copy(_x);
+  }
+
+  /**
+   * Gets a copy of the array of node y coordinates.
+   * @return array[nnode] of y coordinates.
+   */
+  public float[] getY() {
+    return copy(_y);
+  }
+
+  /**
+   * Gets a copy of the array of node z coordinates.
+   * @return array[nnode] of z coordinates.
+   */
+  public float[] getZ() {
+    return copy(_z);
+  }
+
+  /**
+   * Gets a copy of the array of indices of tet nodes.
+   * @return array[4*ntet] of indices of nodes A, B, C and D.
+   */
+  public int[] getTetNodes() {
+    return copy(_tn);
+  }
+
+  /**
+   * Gets a copy of the array of indices of tet nabors.
+   * @return array[4*ntet] of indices of tet nabors A, B, C and D.
+   */
+  public int[] getTetTets() {
+    return copy(_tt);
+  }
+
+  /**
+   * Finds the tet that contains the specified point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @param z z coordinate of the point.
+   * @return the tet index; -1, if the point is outside the mesh.
+   */
+  public int findTet(float x, float y, float z) {
+    if (_ntet==0)
+      return -1;
+    int tet = _nt[findSampleNearest(x,y,z)];
+    for (int nstep=0; nstep<=_ntet; ++nstep) {
+      int k = exitFace(tet,x,y,z);
+      if (k<0)
+        return tet;
+      tet = _tt[4*tet+k];
+      if (tet<0)
+        return -1;
+    }
+    return findTetSlow(x,y,z);
+  }
+
+  /**
+   * Finds the node nearest to the specified point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @param z z coordinate of the point.
+   * @return the node index; -1, if the mesh has no tets.
+   */
+  public int findNodeNearest(float x, float y, float z) {
+    if (_ntet==0)
+      return -1;
+
+    // Walk from a sampled node to the nearest node. Where the mesh is
+    // Delaunay, any node that is not nearest has a nearer node nabor.
+    int node = findSampleNearest(x,y,z);
+    double dmin = distanceSquared(node,x,y,z);
+    for (boolean nearer=true; nearer; ) {
+      nearer = false;
+      int[] nabors = getNodeNabors(node);
+      for (int nabor:nabors) {
+        double d = distanceSquared(nabor,x,y,z);
+        if (d<dmin) {
+          dmin = d;
+          node = nabor;
+          nearer = true;
+        }
+      }
+    }
+    return node;
+  }
+
+  /**
+   * Gets the tets that reference the specified node.
+   * @param node the node index.
+   * @return array of tet indices.
+   */
+  public int[] getTetNabors(int node) {
+    IntList tets = new IntList();
+    int tet = _nt[node];
+    if (tet>=0)
+      tets.add(tet);
+    for (int i=0; i<tets.size(); ++i) {
+      int j = 4*tets.get(i);
+      for (int k=0; k<4; ++k) {
+        int nabor = _tt[j+k];
+        if (_tn[j+k]!=node && nabor>=0 && !tets.contains(nabor))
+          tets.add(nabor);
+      }
+    }
+    return tets.trim();
+  }
+
+  /**
+   * Gets the nodes that share an edge with the specified node.
+   * @param node the node index.
+   * @return array of node indices.
+   */
+  public int[] getNodeNabors(int node) {
+    IntList nodes = new IntList();
+    int[] tets = getTetNabors(node);
+    for (int tet:tets) {
+      for (int k=0,j=4*tet; k<4; ++k,++j) {
+        int nabor = _tn[j];
+        if (nabor!=node && !nodes.contains(nabor))
+          nodes.add(nabor);
+      }
+    }
+    return nodes.trim();
+  }
+
+  /**
+   * Gets the natural neighbor tets of the specified point. These are the
+   * tets with circumspheres that contain the point, which would be
+   * removed if a node were inserted at that point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @param z z coordinate of the point.
+   * @return array of tet indices; empty, if the point is outside the mesh.
+   */
+  public int[] getNaturalNaborTets(float x, float y, float z) {
+    IntList tets = new IntList();
+    int tet = findTet(x,y,z);
+    if (tet>=0)
+      tets.add(tet);
+    for (int i=0; i<tets.size(); ++i) {
+      int j = 4*tets.get(i);
+      for (int k=0; k<4; ++k) {
+        int nabor = _tt[j+k];
+        if (nabor>=0 && !tets.contains(nabor) && inSphere(nabor,x,y,z))
+          tets.add(nabor);
+      }
+    }
+    return tets.trim();
+  }
+
+  /**
+   * Gets the natural neighbor nodes of the specified point. These are the
+   * nodes of the natural neighbor tets of that point, the nodes used in
+   * Sibson's natural neighbor interpolation.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @param z z coordinate of the point.
+   * @return array of node indices; empty, if the point is outside the mesh.
+   */
+  public int[] getNaturalNaborNodes(float x, float y, float z) {
+    IntList nodes = new IntList();
+    int[] tets = getNaturalNaborTets(x,y,z);
+    for (int tet:tets) {
+      for (int k=0,j=4*tet; k<4; ++k,++j) {
+        int node = _tn[j];
+        if (!nodes.contains(node))
+          nodes.add(node);
+      }
+    }
+    return nodes.trim();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private final int _nnode; // number of nodes
+  private final int _ntet; // number of tets
+  private final float[] _x,_y,_z; // node coordinates
+  private final int[] _tn; // tet nodes
+  private final int[] _tt; // tet nabors
+  private final int[] _nt; // for each node, one tet that references it
+  private final int[] _ns; // sampled nodes, where walks begin
+
+  /**
+   * Arrays from which a mesh is constructed.
+   */
+  private static class MeshArrays {
+    float[] x,y,z;
+    int[] tn,tt;
+  }
+
+  /**
+   * Constructs a mesh from arrays of nodes and tets, without copying them.
+   */
+  CompactTetMesh(float[] x, float[] y, float[] z, int[] tn, int[] tt) {
+    this(arrays(x,y,z,tn,tt));
+  }
+
+  private CompactTetMesh(MeshArrays a) {
+    _x = a.x;
+    _y = a.y;
+    _z = a.z;
+    _tn = a.tn;
+    _tt = a.tt;
+    _nnode = _x.length;
+    _ntet = _tn.length/4;
+    _nt = fillint(-1,_nnode);
+    for (int j=0; j<4*_ntet; ++j)
+      _nt[_tn[j]] = j/4;
+    _ns = sampleNodes(_nt);
+  }
+
+  private static MeshArrays arrays(TetMesh mesh) {
+    MeshArrays a = new MeshArrays();
+    synchronized (mesh) {
+      int nnode = mesh.countNodes();
+      int ntet = mesh.countTets();
+      TetMesh.Node[] nodes = new TetMesh.Node[nnode];
+      TetMesh.NodeIterator ni = mesh.getNodes();
+      for (int inode=0; inode<nnode; ++inode)
+        nodes[inode] = ni.next();
+      a.x = new float[nnode];
+      a.y = new float[nnode];
+      a.z = new float[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        a.x[inode] = nodes[inode].x();
+        a.y[inode] = nodes[inode].y();
+        a.z[inode] = nodes[inode].z();
+      }
+      a.tn = new int[4*ntet];
+      a.tt = new int[4*ntet];
+      mesh.getIndices(nodes,a.tn,a.tt);
+    }
+    return a;
+  }
+
+  private static MeshArrays arrays(float[] x, float[] y, float[] z) {
+    Check.argument(x.length==y.length,"x.length==y.length");
+    Check.argument(x.length==z.length,"x.length==z.length");
+
+    // Only the first of any duplicate points, the one with the smallest
+    // index, is added to the mesh; others are in no tets.
+    int nnode = x.length;
+    int[] first = SpatialOrder.duplicates(x,y,z);
+    int nu = 0;
+    for (int inode=0; inode<nnode; ++inode)
+      if (first[inode]==inode)
+        ++nu;
+    float[] xu = new float[nu];
+    float[] yu = new float[nu];
+    float[] zu = new float[nu];
+    for (int inode=0,ju=0; inode<nnode; ++inode) {
+      if (first[inode]==inode) {
+        xu[ju] = x[inode];
+        yu[ju] = y[inode];
+        zu[ju] = z[inode];
+        ++ju;
+      }
+    }
+    TetMesh mesh = new TetMesh();
+    TetMesh.Node[] nodesu = mesh.addNodesParallel(xu,yu,zu);
+    TetMesh.Node[] nodes = new TetMesh.Node[nnode];
+    for (int inode=0,ju=0; inode<nnode; ++inode)
+      if (first[inode]==inode)
+        nodes[inode] = nodesu[ju++];
+    int ntet = mesh.countTets();
+    MeshArrays a = new MeshArrays();
+    a.x = copy(x);
+    a.y = copy(y);
+    a.z = copy(z);
+    a.tn = new int[4*ntet];
+    a.tt = new int[4*ntet];
+    mesh.getIndices(nodes,a.tn,a.tt);
+    return a;
+  }
+
+  private static MeshArrays arrays(
+    float[] x, float[] y, float[] z, int[] tn)
+  {
+    Check.argument(x.length==y.length,"x.length==y.length");
+    Check.argument(x.length==z.length,"x.length==z.length");
+    Check.argument(tn.length%4==0,"tn.length is a multiple of 4");
+    int nnode = x.length;
+    for (int j=0; j<tn.length; ++j)
+      Check.argument(0<=tn[j] && tn[j]<nnode,"valid node indices");
+    int[] tt = ParallelDelaunay.nabors(nnode,4,tn);
+    Check.argument(tt!=null,"no face is shared by more than two tets");
+    MeshArrays a = new MeshArrays();
+    a.x = copy(x);
+    a.y = copy(y);
+    a.z = copy(z);
+    a.tn = copy(tn);
+    a.tt = tt;
+    return a;
+  }
+
+  private static MeshArrays arrays(
+    float[] x, float[] y, float[] z, int[] tn, int[] tt)
+  {
+    MeshArrays a = new MeshArrays();
+    a.x = x;
+    a.y = y;
+    a.z = z;
+    a.tn = tn;
+    a.tt = tt;
+    return a;
+  }
+
+  /**
+   * Randomly samples nodes that are in tets. As in a tet mesh, the
+   * number of samples grows slowly with the number of nodes.
+   */
+  private static int[] sampleNodes(int[] nt) {
+    int nnode = nt.length;
+    IntList nodes = new IntList();
+    for (int inode=0; inode<nnode; ++inode)
+      if (nt[inode]>=0)
+        nodes.add(inode);
+    int[] ns = nodes.trim();
+    int nmesh = ns.length;
+    int nsamp = Math.min(nmesh,1+(int)(Math.pow(nmesh,0.25)/0.45));
+    Random random = new Random(nmesh);
+    for (int isamp=0; isamp<nsamp; ++isamp) {
+      int jsamp = isamp+random.nextInt(nmesh-isamp);
+      int nsave = ns[isamp];
+      ns[isamp] = ns[jsamp];
+      ns[jsamp] = nsave;
+    }
+    return Arrays.copyOf(ns,nsamp);
+  }
+
+  private int findSampleNearest(float x, float y, float z) {
+    int nmin = _ns[0];
+    double dmin = distanceSquared(nmin,x,y,z);
+    for (int node:_ns) {
+      double d = distanceSquared(node,x,y,z);
+      if (d<dmin) {
+        dmin = d;
+        nmin = node;
+      }
+    }
+    return nmin;
+  }
+
+  private double distanceSquared(int node, float x, float y, float z) {
+    double dx = x-_x[node];
+    double dy = y-_y[node];
+    double dz = z-_z[node];
+    return dx*dx+dy*dy+dz*dz;
+  }
+
+  /**
+   * Returns the local index of the node opposite a face through which
+   * the specified point is visible from outside the tet; -1, if none.
+   * The faces tested are the same as those tested in a tet mesh.
+   */
+  private int exitFace(int tet, double x, double y, double z) {
+    int j = 4*tet;
+    int n0 = _tn[j], n1 = _tn[j+1], n2 = _tn[j+2], n3 = _tn[j+3];
+    double x0 = _x[n0], y0 = _y[n0], z0 = _z[n0];
+    double x1 = _x[n1], y1 = _y[n1], z1 = _z[n1];
+    double x2 = _x[n2], y2 = _y[n2], z2 = _z[n2];
+    double x3 = _x[n3], y3 = _y[n3], z3 = _z[n3];
+    if (Geometry.leftOfPlane(x1,y1,z1,x2,y2,z2,x3,y3,z3,x,y,z)>0.0)
+      return 0;
+    if (Geometry.leftOfPlane(x3,y3,z3,x2,y2,z2,x0,y0,z0,x,y,z)>0.0)
+      return 1;
+    if (Geometry.leftOfPlane(x3,y3,z3,x0,y0,z0,x1,y1,z1,x,y,z)>0.0)
+      return 2;
+    if (Geometry.leftOfPlane(x0,y0,z0,x2,y2,z2,x1,y1,z1,x,y,z)>0.0)
+      return 3;
+    return -1;
+  }
+
+  /**
+   * Finds a tet that contains the specified point, by testing all tets.
+   * Used only if walking fails, which is possible only if the mesh is
+   * not Delaunay.
+   */
+  private int findTetSlow(float x, float y, float z) {
+    for (int tet=0; tet<_ntet; ++tet)
+      if (exitFace(tet,x,y,z)<0)
+        return tet;
+    return -1;
+  }
+
+  private boolean inSphere(int tet, double x, double y, double z) {
+    int j = 4*tet;
+    int na = _tn[j], nb = _tn[j+1], nc = _tn[j+2], nd = _tn[j+3];
+    return Geometry.inSphere(
+      _x[na],_y[na],_z[na],
+      _x[nb],_y[nb],_z[nb],
+      _x[nc],_y[nc],_z[nc],
+      _x[nd],_y[nd],_z[nd],
+      x,y,z)>0.0;
+  }
+}
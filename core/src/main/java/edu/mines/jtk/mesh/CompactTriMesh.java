@@ -0,0 +1,516 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Arrays;
+import java.util.Random;
+
+import edu.mines.jtk.util.Check;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * A compact and immutable triangular mesh.
+ * <p>
+ * Nodes and tris are represented by integer indices. Node coordinates
+ * are stored in arrays of floats, and the nodes and tri nabors of each
+ * tri are stored in arrays of ints. This representation requires much
+ * less memory than that of a {@link TriMesh}, in which nodes and tris
+ * are objects that reference each other.
+ * <p>
+ * As in a tri mesh, the three nodes A, B and C of each tri are in
+ * counter-clockwise order, and the tri nabor with local index k (A, B
+ * or C) is opposite the node with that same local index. Indices of
+ * null tri nabors are -1.
+ * <p>
+ * A compact mesh cannot be modified after it is constructed. Therefore,
+ * all methods, including those for point location and natural neighbors,
+ * are thread-safe. Iterations over nodes and tris are simply loops over
+ * their indices.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.28
+ */
+public final class CompactTriMesh {
+
+  /**
+   * Constructs a compact copy of the specified tri mesh. Nodes are
+   * indexed in the order of iteration by {@link TriMesh#getNodes()}.
+   * Construction clears all node and tri marks in the specified mesh.
+   * @param mesh the tri mesh.
+   */
+  public CompactTriMesh(TriMesh mesh) {
+    this(arrays(mesh));
+  }
+
+  /**
+   * Constructs a Delaunay triangulation of specified points. Nodes are
+   * indexed in the order of the specified points. Any node with the
+   * same coordinates as a node with a smaller index is in no tris.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   */
+  public CompactTriMesh(float[] x, float[] y) {
+    this(arrays(x,y));
+  }
+
+  /**
+   * Constructs a mesh with specified nodes and tris. Nabors of tris are
+   * computed from their nodes. Nodes A, B and C of each tri must be in
+   * counter-clockwise order.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param tn array[3*ntri] of indices of nodes A, B and C.
+   */
+  public CompactTriMesh(float[] x, float[] y, int[] tn) {
+    this(arrays(x,y,tn));
+  }
+
+  /**
+   * Returns the number of nodes in this mesh.
+   * @return the number of nodes.
+   */
+  public int countNodes() {
+    return _nnode;
+  }
+
+  /**
+   * Returns the number of tris in this mesh.
+   * @return the number of tris.
+   */
+  public int countTris() {
+    return _ntri;
+  }
+
+  /**
+   * Returns the x coordinate of the specified node.
+   * @param node the node index.
+   * @return the x coordinate.
+   */
+  public float x(int node) {
+    return _x[node];
+  }
+
+  /**
+   * Returns the y coordinate of the specified node.
+   * @param node the node index.
+   * @return the y coordinate.
+   */
+  public float y(int node) {
+    return _y[node];
+  }
+
+  /**
+   * Returns the index of a tri that references the specified node.
+   * @param node the node index.
+   * @return the tri index; -1, if the node is in no tris.
+   */
+  public int tri(int node) {
+    return _nt[node];
+  }
+
+  /**
+   * Returns the index of a node of the specified tri.
+   * @param tri the tri index.
+   * @param k local index, 0, 1 or 2, of node A, B or C.
+   * @return the node index.
+   */
+  public int triNode(int tri, int k) {
+    return _tn[3*tri+k];
+  }
+
+  /**
+   * Returns the index of a tri nabor of the specified tri.
+   * @param tri the tri index.
+   * @param k local index, 0, 1 or 2, of the node opposite the nabor.
+   * @return the nabor tri index; -1, if the nabor is null.
+   */
+  public int triNabor(int tri, int k) {
+    return _tt[3*tri+k];
+  }
+
+  /**
+   * Gets a copy of the array of node x coordinates.
+   * @return array[nnode] of x coordinates.
+   */
+  public float[] getX() {
+    return copy(_x);
+  }
+
+  /**
+   * Gets a copy of the array of node y coordinates.
+   * @return array[nnode] of y coordinates.
+   */
+  public float[] getY() {
+    return copy(_y);
+  }
+
+  /**
+   * Gets a copy of the array of indices of tri nodes.
+   * @return array[3*ntri] of indices of nodes A, B and C.
+   */
+  public int[] getTriNodes() {
+    return copy(_tn);
+  }
+
+  /**
+   * Gets a copy of the array of indices of tri nabors.
+   * @return array[3*ntri] of indices of tri nabors A, B and C.
+   */
+  public int[] getTriTris() {
+    return copy(_tt);
+  }
+
+  /**
+   * Finds the tri that contains the specified point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @return the tri index; -1, if the point is outside the mesh.
+   */
+  public int findTri(float x, float y) {
+    if (_ntri==0)
+      return -1;
+    int tri = _nt[findSampleNearest(x,y)];
+    for (int nstep=0; nstep<=_ntri; ++nstep) {
+      int k = exitEdge(tri,x,y);
+      if (k<0)
+        return tri;
+      tri = _tt[3*tri+k];
+      if (tri<0)
+        return -1;
+    }
+    return findTriSlow(x,y);
+  }
+
+  /**
+   * Finds the node nearest to the specified point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @return the node index; -1, if the mesh has no tris.
+   */
+  public int findNodeNearest(float x, float y) {
+    if (_ntri==0)
+      return -1;
+
+    // Walk from a sampled node to the nearest node. Where the mesh is
+    // Delaunay, any node that is not nearest has a nearer node nabor.
+    int node = findSampleNearest(x,y);
+    double dmin = distanceSquared(node,x,y);
+    for (boolean nearer=true; nearer; ) {
+      nearer = false;
+      int[] nabors = getNodeNabors(node);
+      for (int nabor:nabors) {
+        double d = distanceSquared(nabor,x,y);
+        if (d<dmin) {
+          dmin = d;
+          node = nabor;
+          nearer = true;
+        }
+      }
+    }
+    return node;
+  }
+
+  /**
+   * Gets the tris that reference the specified node.
+   * @param node the node index.
+   * @return array of tri indices.
+   */
+  public int[] getTriNabors(int node) {
+    IntList tris = new IntList();
+    int tri = _nt[node];
+    if (tri>=0)
+      tris.add(tri);
+    for (int i=0; i<tris.size(); ++i) {
+      int j = 3*tris.get(i);
+      for (int k=0; k<3; ++k) {
+        int nabor = _tt[j+k];
+        if (_tn[j+k]!=node && nabor>=0 && !tris.contains(nabor))
+          tris.add(nabor);
+      }
+    }
+    return tris.trim();
+  }
+
+  /**
+   * Gets the nodes that share an edge with the specified node.
+   * @param node the node index.
+   * @return array of node indices.
+   */
+  public int[] getNodeNabors(int node) {
+    IntList nodes = new IntList();
+    int[] tris = getTriNabors(node);
+    for (int tri:tris) {
+      for (int k=0,j=3*tri; k<3; ++k,++j) {
+        int nabor = _tn[j];
+        if (nabor!=node && !nodes.contains(nabor))
+          nodes.add(nabor);
+      }
+    }
+    return nodes.trim();
+  }
+
+  /**
+   * Gets the natural neighbor tris of the specified point. These are the
+   * tris with circumcircles that contain the point, which would be
+   * removed if a node were inserted at that point.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @return array of tri indices; empty, if the point is outside the mesh.
+   */
+  public int[] getNaturalNaborTris(float x, float y) {
+    IntList tris = new IntList();
+    int tri = findTri(x,y);
+    if (tri>=0)
+      tris.add(tri);
+    for (int i=0; i<tris.size(); ++i) {
+      int j = 3*tris.get(i);
+      for (int k=0; k<3; ++k) {
+        int nabor = _tt[j+k];
+        if (nabor>=0 && !tris.contains(nabor) && inCircle(nabor,x,y))
+          tris.add(nabor);
+      }
+    }
+    return tris.trim();
+  }
+
+  /**
+   * Gets the natural neighbor nodes of the specified point. These are the
+   * nodes of the natural neighbor tris of that point, the nodes used in
+   * Sibson's natural neighbor interpolation.
+   * @param x x coordinate of the point.
+   * @param y y coordinate of the point.
+   * @return array of node indices; empty, if the point is outside the mesh.
+   */
+  public int[] getNaturalNaborNodes(float x, float y) {
+    IntList nodes = new IntList();
+    int[] tris = getNaturalNaborTris(x,y);
+    for (int tri:tris) {
+      for (int k=0,j=3*tri; k<3; ++k,++j) {
+        int node = _tn[j];
+        if (!nodes.contains(node))
+          nodes.add(node);
+      }
+    }
+    return nodes.trim();
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private final int _nnode; // number of nodes
+  private final int _ntri; // number of tris
+  private final float[] _x,_y; // node coordinates
+  private final int[] _tn; // tri nodes
+  private final int[] _tt; // tri nabors
+  private final int[] _nt; // for each node, one tri that references it
+  private final int[] _ns; // sampled nodes, where walks begin
+
+  /**
+   * Arrays from which a mesh is constructed.
+   */
+  private static class MeshArrays {
+    float[] x,y;
+    int[] tn,tt;
+  }
+
+  /**
+   * Constructs a mesh from arrays of nodes and tris, without copying them.
+   */
+  CompactTriMesh(float[] x, float[] y, int[] tn, int[] tt) {
+    this(arrays(x,y,tn,tt));
+  }
+
+  private CompactTriMesh(MeshArrays a) {
+    _x = a.x;
+    _y = a.y;
+    _tn = a.tn;
+    _tt = a.tt;
+    _nnode = _x.length;
+    _ntri = _tn.length/3;
+    _nt = fillint(-1,_nnode);
+    for (int j=0; j<3*_ntri; ++j)
+      _nt[_tn[j]] = j/3;
+    _ns = sampleNodes(_nt);
+  }
+
+  private static MeshArrays arrays(TriMesh mesh) {
+    MeshArrays a = new MeshArrays();
+    synchronized (mesh) {
+      int nnode = mesh.countNodes();
+      int ntri = mesh.countTris();
+      TriMesh.Node[] nodes = new TriMesh.Node[nnode];
+      TriMesh.NodeIterator ni = mesh.getNodes();
+      for (int inode=0; inode<nnode; ++inode)
+        nodes[inode] = ni.next();
+      a.x = new float[nnode];
+      a.y = new float[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        a.x[inode] = nodes[inode].x();
+        a.y[inode] = nodes[inode].y();
+      }
+      a.tn = new int[3*ntri];
+      a.tt = new int[3*ntri];
+      mesh.getIndices(nodes,a.tn,a.tt);
+    }
+    return a;
+  }
+
+  private static MeshArrays arrays(float[] x, float[] y) {
+    Check.argument(x.length==y.length,"x.length==y.length");
+
+    // Only the first of any duplicate points, the one with the smallest
+    // index, is added to the mesh; others are in no tris.
+    int nnode = x.length;
+    int[] first = SpatialOrder.duplicates(x,y);
+    int nu = 0;
+    for (int inode=0; inode<nnode; ++inode)
+      if (first[inode]==inode)
+        ++nu;
+    float[] xu = new float[nu];
+    float[] yu = new float[nu];
+    for (int inode=0,ju=0; inode<nnode; ++inode) {
+      if (first[inode]==inode) {
+        xu[ju] = x[inode];
+        yu[ju] = y[inode];
+        ++ju;
+      }
+    }
+    TriMesh mesh = new TriMesh();
+    TriMesh.Node[] nodesu = mesh.addNodesParallel(xu,yu);
+    TriMesh.Node[] nodes = new TriMesh.Node[nnode];
+    for (int inode=0,ju=0; inode<nnode; ++inode)
+      if (first[inode]==inode)
+        nodes[inode] = nodesu[ju++];
+    int ntri = mesh.countTris();
+    MeshArrays a = new MeshArrays();
+    a.x = copy(x);
+    a.y = copy(y);
+    a.tn = new int[3*ntri];
+    a.tt = new int[3*ntri];
+    mesh.getIndices(nodes,a.tn,a.tt);
+    return a;
+  }
+
+  private static MeshArrays arrays(float[] x, float[] y, int[] tn) {
+    Check.argument(x.length==y.length,"x.length==y.length");
+    Check.argument(tn.length%3==0,"tn.length is a multiple of 3");
+    int nnode = x.length;
+    for (int j=0; j<tn.length; ++j)
+      Check.argument(0<=tn[j] && tn[j]<nnode,"valid node indices");
+    int[] tt = ParallelDelaunay.nabors(nnode,3,tn);
+    Check.argument(tt!=null,"no edge is shared by more than two tris");
+    MeshArrays a = new MeshArrays();
+    a.x = copy(x);
+    a.y = copy(y);
+    a.tn = copy(tn);
+    a.tt = tt;
+    return a;
+  }
+
+  private static MeshArrays arrays(
+    float[] x, float[] y, int[] tn, int[] tt)
+  {
+    MeshArrays a = new MeshArrays();
+    a.x = x;
+    a.y = y;
+    a.tn = tn;
+    a.tt = tt;
+    return a;
+  }
+
+  /**
+   * Randomly samples nodes that are in tris. As in a tri mesh, the
+   * number of samples grows slowly with the number of nodes.
+   */
+  private static int[] sampleNodes(int[] nt) {
+    int nnode = nt.length;
+    IntList nodes = new IntList();
+    for (int inode=0; inode<nnode; ++inode)
+      if (nt[inode]>=0)
+        nodes.add(inode);
+    int[] ns = nodes.trim();
+    int nmesh = ns.length;
+    int nsamp = Math.min(nmesh,1+(int)(Math.pow(nmesh,0.33)/0.45));
+    Random random = new Random(nmesh);
+    for (int isamp=0; isamp<nsamp; ++isamp) {
+      int jsamp = isamp+random.nextInt(nmesh-isamp);
+      int nsave = ns[isamp];
+      ns[isamp] = ns[jsamp];
+      ns[jsamp] = nsave;
+    }
+    return Arrays.copyOf(ns,nsamp);
+  }
+
+  private int findSampleNearest(float x, float y) {
+    int nmin = _ns[0];
+    double dmin = distanceSquared(nmin,x,y);
+    for (int node:_ns) {
+      double d = distanceSquared(node,x,y);
+      if (d<dmin) {
+        dmin = d;
+        nmin = node;
+      }
+    }
+    return nmin;
+  }
+
+  private double distanceSquared(int node, float x, float y) {
+    double dx = x-_x[node];
+    double dy = y-_y[node];
+    return dx*dx+dy*dy;
+  }
+
+  /**
+   * Returns the local index of the node opposite an edge through which
+   * the specified point is visible from outside the tri; -1, if none.
+   * The edges tested are the same as those tested in a tri mesh.
+   */
+  private int exitEdge(int tri, double x, double y) {
+    int j = 3*tri;
+    int n0 = _tn[j], n1 = _tn[j+1], n2 = _tn[j+2];
+    double x0 = _x[n0], y0 = _y[n0];
+    double x1 = _x[n1], y1 = _y[n1];
+    double x2 = _x[n2], y2 = _y[n2];
+    if (Geometry.leftOfLine(x2,y2,x1,y1,x,y)>0.0)
+      return 0;
+    if (Geometry.leftOfLine(x0,y0,x2,y2,x,y)>0.0)
+      return 1;
+    if (Geometry.leftOfLine(x1,y1,x0,y0,x,y)>0.0)
+      return 2;
+    return -1;
+  }
+
+  /**
+   * Finds a tri that contains the specified point, by testing all tris.
+   * Used only if walking fails, which is possible only if the mesh is
+   * not Delaunay.
+   */
+  private int findTriSlow(float x, float y) {
+    for (int tri=0; tri<_ntri; ++tri)
+      if (exitEdge(tri,x,y)<0)
+        return tri;
+    return -1;
+  }
+
+  private boolean inCircle(int tri, double x, double y) {
+    int j = 3*tri;
+    int na = _tn[j], nb = _tn[j+1], nc = _tn[j+2];
+    return Geometry.inCircle(
+      _x[na],_y[na],
+      _x[nb],_y[nb],
+      _x[nc],_y[nc],
+      x,y)>0.0;
+  }
+}
@@ -36,6 +36,13 @@ package edu.mines.jtk.mesh;
  * Mellon University. (Currently, the methods here do not use Shewchuk's 
  * adaptive four-stage pipeline. Instead, only two - the fastest and the 
  * exact stages - are used.)
+ * <p>
+ * Filtered methods, such as {@link #leftOfPlaneFiltered}, use simpler
+ * semi-static error bounds computed from maximum absolute differences
+ * of coordinates, as in the CGAL library. These methods evaluate the
+ * same formulas as the fast stages of the adaptive methods, and return
+ * values with signs exactly the same as those returned by the adaptive
+ * methods, which they call only when their error bounds are exceeded.
  *
  * @author Dave Hale, Colorado School of Mines
  * @version 2001.04.03, 2006.08.02
@@ -1191,6 +1198,143 @@ public final class Geometry {
       pe[0],pe[1],pe[2],pe[3]);
   }
 
+  /**
+   * Determines if a point d is left of the plane defined by the
+   * points a, b, and c, using a semi-static filter. This method returns
+   * the same sign as the method {@link #leftOfPlane}, but is typically
+   * faster. Instead of the permanent used in that method, the error bound
+   * here is computed from only the maximum absolute coordinate differences.
+   * Only if that bound is exceeded (rarely) does this method call the
+   * slower adaptive method.
+   * @param xa x coordinate of point a.
+   * @param ya y coordinate of point a.
+   * @param za z coordinate of point a.
+   * @param xb x coordinate of point b.
+   * @param yb y coordinate of point b.
+   * @param zb z coordinate of point b.
+   * @param xc x coordinate of point c.
+   * @param yc y coordinate of point c.
+   * @param zc z coordinate of point c.
+   * @param xd x coordinate of point d.
+   * @param yd y coordinate of point d.
+   * @param zd z coordinate of point d.
+   * @return positive, if left of plane;
+   *         negative, if right of plane;
+   *         zero, otherwise.
+   */
+  public static double leftOfPlaneFiltered(
+    double xa, double ya, double za,
+    double xb, double yb, double zb,
+    double xc, double yc, double zc,
+    double xd, double yd, double zd)
+  {
+    double adx = xa - xd;
+    double bdx = xb - xd;
+    double cdx = xc - xd;
+    double ady = ya - yd;
+    double bdy = yb - yd;
+    double cdy = yc - yd;
+    double adz = za - zd;
+    double bdz = zb - zd;
+    double cdz = zc - zd;
+
+    double det = adz * (bdx * cdy - cdx * bdy)
+               + bdz * (cdx * ady - adx * cdy)
+               + cdz * (adx * bdy - bdx * ady);
+
+    double maxx = max3abs(adx,bdx,cdx);
+    double maxy = max3abs(ady,bdy,cdy);
+    double maxz = max3abs(adz,bdz,cdz);
+    double errbound = O3DSTATICBOUND * maxx * maxy * maxz;
+    if (O3DSTATICMIN<maxx && O3DSTATICMIN<maxy && O3DSTATICMIN<maxz &&
+        maxx<O3DSTATICMAX && maxy<O3DSTATICMAX && maxz<O3DSTATICMAX &&
+        ((det > errbound) || (-det > errbound))) {
+      return det;
+    }
+
+    return leftOfPlane(xa,ya,za,xb,yb,zb,xc,yc,zc,xd,yd,zd);
+  }
+
+  /**
+   * Determines if a point e is inside the sphere defined by the points
+   * a, b, c, and d, using a semi-static filter. This method returns the
+   * same sign as the method {@link #inSphere}, but is typically faster.
+   * Instead of the permanent used in that method, the error bound here
+   * is computed from only the maximum absolute coordinate differences.
+   * Only if that bound is exceeded (rarely) does this method call the
+   * slower adaptive method.
+   * @param xa x coordinate of point a.
+   * @param ya y coordinate of point a.
+   * @param za z coordinate of point a.
+   * @param xb x coordinate of point b.
+   * @param yb y coordinate of point b.
+   * @param zb z coordinate of point b.
+   * @param xc x coordinate of point c.
+   * @param yc y coordinate of point c.
+   * @param zc z coordinate of point c.
+   * @param xd x coordinate of point d.
+   * @param yd y coordinate of point d.
+   * @param zd z coordinate of point d.
+   * @param xe x coordinate of point e.
+   * @param ye y coordinate of point e.
+   * @param ze z coordinate of point e.
+   * @return positive, if inside the sphere;
+   *         negative, if outside the sphere;
+   *         zero, otherwise.
+   */
+  public static double inSphereFiltered(
+    double xa, double ya, double za,
+    double xb, double yb, double zb,
+    double xc, double yc, double zc,
+    double xd, double yd, double zd,
+    double xe, double ye, double ze)
+  {
+    double aex = xa - xe;
+    double bex = xb - xe;
+    double cex = xc - xe;
+    double dex = xd - xe;
+    double aey = ya - ye;
+    double bey = yb - ye;
+    double cey = yc - ye;
+    double dey = yd - ye;
+    double aez = za - ze;
+    double bez = zb - ze;
+    double cez = zc - ze;
+    double dez = zd - ze;
+
+    double ab = aex * bey - bex * aey;
+    double bc = bex * cey - cex * bey;
+    double cd = cex * dey - dex * cey;
+    double da = dex * aey - aex * dey;
+    double ac = aex * cey - cex * aey;
+    double bd = bex * dey - dex * bey;
+
+    double abc = aez * bc - bez * ac + cez * ab;
+    double bcd = bez * cd - cez * bd + dez * bc;
+    double cda = cez * da + dez * ac + aez * cd;
+    double dab = dez * ab + aez * bd + bez * da;
+
+    double alift = aex * aex + aey * aey + aez * aez;
+    double blift = bex * bex + bey * bey + bez * bez;
+    double clift = cex * cex + cey * cey + cez * cez;
+    double dlift = dex * dex + dey * dey + dez * dez;
+
+    double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+
+    double maxx = max4abs(aex,bex,cex,dex);
+    double maxy = max4abs(aey,bey,cey,dey);
+    double maxz = max4abs(aez,bez,cez,dez);
+    double maxm = Math.max(maxx,Math.max(maxy,maxz));
+    double errbound = INSSTATICBOUND * maxx * maxy * maxz * maxm * maxm;
+    if (INSSTATICMIN<maxx && INSSTATICMIN<maxy && INSSTATICMIN<maxz &&
+        maxm<INSSTATICMAX &&
+        ((det > errbound) || (-det > errbound))) {
+      return det;
+    }
+
+    return inSphere(xa,ya,za,xb,yb,zb,xc,yc,zc,xd,yd,zd,xe,ye,ze);
+  }
+
   /**
    * Computes the center of the circle defined by the points a, b, and c.
    * The latter are assumed to be in CCW order, such that the method 
@@ -1492,6 +1636,8 @@ public final class Geometry {
   private static final double INCERRBOUND;
   private static final double INSERRBOUND;
   private static final double IOSERRBOUND;
+  private static final double O3DSTATICBOUND;
+  private static final double INSSTATICBOUND;
   static {
     double epsilon = 1.0;
     double splitter = 1.0;
@@ -1510,6 +1656,36 @@ public final class Geometry {
     INCERRBOUND = 11.0*EPSILON;
     INSERRBOUND = 17.0*EPSILON;
     IOSERRBOUND = 19.0*EPSILON;
+    // Semi-static bounds for the filtered methods, which evaluate the
+    // same formulas as the fast stages above. With mx, my, and mz the
+    // maximum absolute differences in x, y, and z, and m the largest of
+    // these, the permanent for leftOfPlane is not greater than 6*mx*my*mz,
+    // and that for inSphere is not greater than 4*(3*m*m)*(6*mx*my*mz).
+    // The bounds 8*6 = 48 and 17*72 = 1224 are then rounded up to powers
+    // of two, which also covers rounding in the products of maxima.
+    O3DSTATICBOUND = 64.0*EPSILON;
+    INSSTATICBOUND = 2048.0*EPSILON;
+  }
+
+  /**
+   * Semi-static error bounds are products of maximum absolute coordinate
+   * differences. Outside these ranges, those products may underflow or
+   * overflow, and the filtered methods defer to the adaptive methods.
+   */
+  private static final double O3DSTATICMIN = 1.0e-97;
+  private static final double O3DSTATICMAX = 1.0e102;
+  private static final double INSSTATICMIN = 1.0e-58;
+  private static final double INSSTATICMAX = 1.0e61;
+
+  /**
+   * Returns the maximum of absolute values for semi-static filters.
+   */
+  private static double max3abs(double a, double b, double c) {
+    return Math.max(Math.abs(a),Math.max(Math.abs(b),Math.abs(c)));
+  }
+  private static double max4abs(double a, double b, double c, double d) {
+    return Math.max(Math.max(Math.abs(a),Math.abs(b)),
+                    Math.max(Math.abs(c),Math.abs(d)));
   }
 
   /**
@@ -0,0 +1,100 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Arrays;
+
+/**
+ * A growable array of ints, used to collect indices of nodes, tets
+ * and tris in compact meshes and parallel construction of meshes.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.21
+ */
+final class IntList {
+
+  /**
+   * Appends the specified int.
+   * @param i the int.
+   */
+  void add(int i) {
+    if (_n==_a.length)
+      _a = Arrays.copyOf(_a,2*_n);
+    _a[_n++] = i;
+  }
+
+  /**
+   * Appends ints a[j], a[j+1], ..., a[j+m-1].
+   * @param a the array of ints.
+   * @param j the index of the first int to append.
+   * @param m the number of ints to append.
+   */
+  void add(int[] a, int j, int m) {
+    for (int k=0; k<m; ++k)
+      add(a[j+k]);
+  }
+
+  /**
+   * Gets the int with specified index.
+   * @param index the index.
+   * @return the int.
+   */
+  int get(int index) {
+    return _a[index];
+  }
+
+  /**
+   * Returns the number of ints in this list.
+   * @return the number of ints.
+   */
+  int size() {
+    return _n;
+  }
+
+  /**
+   * Determines whether this list contains the specified int. Lists of
+   * nodes, tets or tris near a point are short, so this linear search
+   * is fast, and avoids marks that would not be thread-safe.
+   * @param i the int.
+   * @return true, if this list contains the int; false, otherwise.
+   */
+  boolean contains(int i) {
+    for (int j=0; j<_n; ++j)
+      if (_a[j]==i) return true;
+    return false;
+  }
+
+  /**
+   * Returns the array of ints in this list, which may be longer than
+   * the number of ints in the list. The array is not copied.
+   * @return the array.
+   */
+  int[] array() {
+    return _a;
+  }
+
+  /**
+   * Returns a copy of the ints in this list.
+   * @return array of ints, with length equal to the size of this list.
+   */
+  int[] trim() {
+    return Arrays.copyOf(_a,_n);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private int _n = 0;
+  private int[] _a = new int[32];
+}
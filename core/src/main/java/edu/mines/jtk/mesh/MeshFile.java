@@ -0,0 +1,418 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.io.IOException;
+
+import edu.mines.jtk.io.ArrayInput;
+import edu.mines.jtk.io.ArrayOutput;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * Reads and writes meshes in a compact binary format.
+ * <p>
+ * Meshes are written as arrays of node coordinates and of indices of
+ * nodes and nabors for tets (or tris), for input and output with an
+ * {@link edu.mines.jtk.io.ArrayFile} or any other array input/output.
+ * Reading a mesh does not recompute it, and is much faster than either
+ * constructing the mesh or deserializing it with an object stream.
+ * For example,
+ * <pre><code>
+ *   ArrayFile af = new ArrayFile("mesh.dat","rw");
+ *   MeshFile.write(af,mesh);
+ *   af.seek(0);
+ *   CompactTetMesh cm = MeshFile.readCompactTetMesh(af);
+ *   af.close();
+ * </code></pre>
+ * <p>
+ * The format begins with five ints: a magic number, the format version,
+ * the number nv of nodes per tet (4) or tri (3), the number of nodes,
+ * and the number ns of tets or tris. These are followed by arrays of
+ * node coordinates x, y and (if nv is 4) z, an array of node indices,
+ * an array[nv*ns] of indices of nodes of tets or tris, an array[nv*ns]
+ * of indices of nabors of tets or tris (-1 for null nabors), and an
+ * array of tet or tri indices. Node and tet (or tri) indices are the
+ * public index fields of nodes and tets (or tris), which are otherwise
+ * unused by meshes. Because the offset of every array is known after
+ * reading the header, the arrays may be memory-mapped.
+ * <p>
+ * Files written for tet meshes, compact tet meshes and surfaces have
+ * the same format, so that any of these may be read from any such file.
+ * For a surface, only its Delaunay tet mesh is written; when read, the
+ * surface is reconstructed from that mesh, which is not recomputed.
+ * Node property maps and data objects are not written.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.04
+ */
+public class MeshFile {
+
+  /**
+   * Writes a tet mesh. Writing clears all node and tet marks in
+   * the specified mesh.
+   * @param ao the array output.
+   * @param mesh the tet mesh.
+   * @throws IOException if unable to write.
+   */
+  public static void write(ArrayOutput ao, TetMesh mesh)
+    throws IOException
+  {
+    synchronized (mesh) {
+      int nnode = mesh.countNodes();
+      int ntet = mesh.countTets();
+      TetMesh.Node[] nodes = new TetMesh.Node[nnode];
+      TetMesh.NodeIterator ni = mesh.getNodes();
+      for (int inode=0; inode<nnode; ++inode)
+        nodes[inode] = ni.next();
+      float[] x = new float[nnode];
+      float[] y = new float[nnode];
+      float[] z = new float[nnode];
+      int[] in = new int[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        TetMesh.Node node = nodes[inode];
+        x[inode] = node.x();
+        y[inode] = node.y();
+        z[inode] = node.z();
+        in[inode] = node.index;
+      }
+      int[] tn = new int[4*ntet];
+      int[] tt = new int[4*ntet];
+      TetMesh.Tet[] tets = mesh.getIndices(nodes,tn,tt);
+      int[] it = new int[ntet];
+      for (int itet=0; itet<ntet; ++itet)
+        it[itet] = tets[itet].index;
+      write(ao,4,new float[][]{x,y,z},in,tn,tt,it);
+    }
+  }
+
+  /**
+   * Writes a tri mesh. Writing clears all node and tri marks in
+   * the specified mesh.
+   * @param ao the array output.
+   * @param mesh the tri mesh.
+   * @throws IOException if unable to write.
+   */
+  public static void write(ArrayOutput ao, TriMesh mesh)
+    throws IOException
+  {
+    synchronized (mesh) {
+      int nnode = mesh.countNodes();
+      int ntri = mesh.countTris();
+      TriMesh.Node[] nodes = new TriMesh.Node[nnode];
+      TriMesh.NodeIterator ni = mesh.getNodes();
+      for (int inode=0; inode<nnode; ++inode)
+        nodes[inode] = ni.next();
+      float[] x = new float[nnode];
+      float[] y = new float[nnode];
+      int[] in = new int[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        TriMesh.Node node = nodes[inode];
+        x[inode] = node.x();
+        y[inode] = node.y();
+        in[inode] = node.index;
+      }
+      int[] tn = new int[3*ntri];
+      int[] tt = new int[3*ntri];
+      TriMesh.Tri[] tris = mesh.getIndices(nodes,tn,tt);
+      int[] it = new int[ntri];
+      for (int itri=0; itri<ntri; ++itri)
+        it[itri] = tris[itri].index;
+      write(ao,3,new float[][]{x,y},in,tn,tt,it);
+    }
+  }
+
+  /**
+   * Writes a surface, as its Delaunay tet mesh.
+   * @param ao the array output.
+   * @param surf the surface.
+   * @throws IOException if unable to write.
+   */
+  public static void write(ArrayOutput ao, TriSurf surf)
+    throws IOException
+  {
+    synchronized (surf) {
+      int nnode = surf.countNodes();
+      int ntet = surf.countTets();
+      TriSurf.Node[] nodes = new TriSurf.Node[nnode];
+      TriSurf.NodeIterator ni = surf.getNodes();
+      for (int inode=0; inode<nnode; ++inode)
+        nodes[inode] = ni.next();
+      float[] x = new float[nnode];
+      float[] y = new float[nnode];
+      float[] z = new float[nnode];
+      int[] in = new int[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        TriSurf.Node node = nodes[inode];
+        x[inode] = node.x();
+        y[inode] = node.y();
+        z[inode] = node.z();
+        in[inode] = node.index;
+      }
+      int[] tn = new int[4*ntet];
+      int[] tt = new int[4*ntet];
+      surf.getIndices(nodes,tn,tt);
+      write(ao,4,new float[][]{x,y,z},in,tn,tt,new int[ntet]);
+    }
+  }
+
+  /**
+   * Writes a compact tet mesh. Node and tet indices written are the
+   * indices of nodes and tets in the compact mesh.
+   * @param ao the array output.
+   * @param mesh the compact tet mesh.
+   * @throws IOException if unable to write.
+   */
+  public static void write(ArrayOutput ao, CompactTetMesh mesh)
+    throws IOException
+  {
+    int nnode = mesh.countNodes();
+    int ntet = mesh.countTets();
+    float[][] c = {mesh.getX(),mesh.getY(),mesh.getZ()};
+    write(ao,4,c,rampint(0,1,nnode),
+          mesh.getTetNodes(),mesh.getTetTets(),rampint(0,1,ntet));
+  }
+
+  /**
+   * Writes a compact tri mesh. Node and tri indices written are the
+   * indices of nodes and tris in the compact mesh.
+   * @param ao the array output.
+   * @param mesh the compact tri mesh.
+   * @throws IOException if unable to write.
+   */
+  public static void write(ArrayOutput ao, CompactTriMesh mesh)
+    throws IOException
+  {
+    int nnode = mesh.countNodes();
+    int ntri = mesh.countTris();
+    float[][] c = {mesh.getX(),mesh.getY()};
+    write(ao,3,c,rampint(0,1,nnode),
+          mesh.getTriNodes(),mesh.getTriTris(),rampint(0,1,ntri));
+  }
+
+  /**
+   * Reads a tet mesh. Nodes that are in no tets, as in some compact
+   * meshes, are not added to the tet mesh.
+   * @param ai the array input.
+   * @return the tet mesh.
+   * @throws IOException if unable to read, or if the input
+   *  is not a valid mesh file.
+   */
+  public static TetMesh readTetMesh(ArrayInput ai) throws IOException {
+    MeshArrays a = read(ai,4);
+    int[] map = nodesInMesh(a);
+    int nnode = a.in.length;
+    TetMesh.Node[] nodes = new TetMesh.Node[count(map)];
+    for (int inode=0; inode<nnode; ++inode) {
+      if (map[inode]>=0) {
+        TetMesh.Node node =
+          new TetMesh.Node(a.x[inode],a.y[inode],a.z[inode]);
+        node.index = a.in[inode];
+        nodes[map[inode]] = node;
+      }
+    }
+    TetMesh mesh = new TetMesh();
+    TetMesh.Tet[] tets = mesh.build(nodes,a.tn,a.tt);
+    for (int itet=0; itet<tets.length; ++itet)
+      tets[itet].index = a.it[itet];
+    return mesh;
+  }
+
+  /**
+   * Reads a tri mesh. Nodes that are in no tris, as in some compact
+   * meshes, are not added to the tri mesh.
+   * @param ai the array input.
+   * @return the tri mesh.
+   * @throws IOException if unable to read, or if the input
+   *  is not a valid mesh file.
+   */
+  public static TriMesh readTriMesh(ArrayInput ai) throws IOException {
+    MeshArrays a = read(ai,3);
+    int[] map = nodesInMesh(a);
+    int nnode = a.in.length;
+    TriMesh.Node[] nodes = new TriMesh.Node[count(map)];
+    for (int inode=0; inode<nnode; ++inode) {
+      if (map[inode]>=0) {
+        TriMesh.Node node = new TriMesh.Node(a.x[inode],a.y[inode]);
+        node.index = a.in[inode];
+        nodes[map[inode]] = node;
+      }
+    }
+    TriMesh mesh = new TriMesh();
+    TriMesh.Tri[] tris = mesh.build(nodes,a.tn,a.tt);
+    for (int itri=0; itri<tris.length; ++itri)
+      tris[itri].index = a.it[itri];
+    return mesh;
+  }
+
+  /**
+   * Reads a surface, reconstructed from its Delaunay tet mesh. Nodes
+   * that are in no tets are not added to the surface.
+   * @param ai the array input.
+   * @return the surface.
+   * @throws IOException if unable to read, or if the input
+   *  is not a valid mesh file.
+   */
+  public static TriSurf readTriSurf(ArrayInput ai) throws IOException {
+    MeshArrays a = read(ai,4);
+    int[] map = nodesInMesh(a);
+    int nnode = a.in.length;
+    TriSurf.Node[] nodes = new TriSurf.Node[count(map)];
+    for (int inode=0; inode<nnode; ++inode) {
+      if (map[inode]>=0) {
+        TriSurf.Node node =
+          new TriSurf.Node(a.x[inode],a.y[inode],a.z[inode]);
+        node.index = a.in[inode];
+        nodes[map[inode]] = node;
+      }
+    }
+    TriSurf surf = new TriSurf();
+    surf.build(nodes,a.tn,a.tt);
+    return surf;
+  }
+
+  /**
+   * Reads a compact tet mesh. Nodes and tets in the compact mesh are
+   * indexed in the order in which they were written; node and tet
+   * indices read are ignored.
+   * @param ai the array input.
+   * @return the compact tet mesh.
+   * @throws IOException if unable to read, or if the input
+   *  is not a valid mesh file.
+   */
+  public static CompactTetMesh readCompactTetMesh(ArrayInput ai)
+    throws IOException
+  {
+    MeshArrays a = read(ai,4);
+    return new CompactTetMesh(a.x,a.y,a.z,a.tn,a.tt);
+  }
+
+  /**
+   * Reads a compact tri mesh. Nodes and tris in the compact mesh are
+   * indexed in the order in which they were written; node and tri
+   * indices read are ignored.
+   * @param ai the array input.
+   * @return the compact tri mesh.
+   * @throws IOException if unable to read, or if the input
+   *  is not a valid mesh file.
+   */
+  public static CompactTriMesh readCompactTriMesh(ArrayInput ai)
+    throws IOException
+  {
+    MeshArrays a = read(ai,3);
+    return new CompactTriMesh(a.x,a.y,a.tn,a.tt);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int MAGIC = 0x4d455348; // "MESH"
+  private static final int FORMAT = 1;
+
+  /**
+   * Arrays read from a mesh file.
+   */
+  private static class MeshArrays {
+    float[] x,y,z;
+    int[] in,tn,tt,it;
+  }
+
+  private MeshFile() {
+  }
+
+  private static void write(
+    ArrayOutput ao, int nv, float[][] c,
+    int[] in, int[] tn, int[] tt, int[] it)
+    throws IOException
+  {
+    ao.writeInt(MAGIC);
+    ao.writeInt(FORMAT);
+    ao.writeInt(nv);
+    ao.writeInt(in.length);
+    ao.writeInt(it.length);
+    for (float[] ci:c)
+      ao.writeFloats(ci);
+    ao.writeInts(in);
+    ao.writeInts(tn);
+    ao.writeInts(tt);
+    ao.writeInts(it);
+  }
+
+  private static MeshArrays read(ArrayInput ai, int nv) throws IOException {
+    int magic = ai.readInt();
+    if (magic==Integer.reverseBytes(MAGIC))
+      throw new IOException("mesh file has a different byte order");
+    if (magic!=MAGIC)
+      throw new IOException("not a mesh file");
+    int format = ai.readInt();
+    if (format!=FORMAT)
+      throw new IOException("unknown mesh file format "+format);
+    int nvread = ai.readInt();
+    if (nvread!=nv)
+      throw new IOException("mesh file has "+nvread+" nodes per element");
+    int nnode = ai.readInt();
+    int ns = ai.readInt();
+    if (nnode<0 || ns<0)
+      throw new IOException("invalid numbers of nodes or elements");
+    MeshArrays a = new MeshArrays();
+    a.x = new float[nnode];
+    a.y = new float[nnode];
+    ai.readFloats(a.x);
+    ai.readFloats(a.y);
+    if (nv==4) {
+      a.z = new float[nnode];
+      ai.readFloats(a.z);
+    }
+    a.in = new int[nnode];
+    a.tn = new int[nv*ns];
+    a.tt = new int[nv*ns];
+    a.it = new int[ns];
+    ai.readInts(a.in);
+    ai.readInts(a.tn);
+    ai.readInts(a.tt);
+    ai.readInts(a.it);
+    for (int j=0; j<nv*ns; ++j) {
+      if (a.tn[j]<0 || a.tn[j]>=nnode || a.tt[j]<-1 || a.tt[j]>=ns)
+        throw new IOException("invalid index of node or element");
+    }
+    return a;
+  }
+
+  /**
+   * Returns indices of nodes in a mesh. If the mesh has any tets or
+   * tris, nodes in none of them are excluded, and node indices in the
+   * array of tet or tri nodes are modified accordingly.
+   */
+  private static int[] nodesInMesh(MeshArrays a) {
+    int nnode = a.in.length;
+    int[] map = rampint(0,1,nnode);
+    if (a.tn.length>0) {
+      fill(-1,map);
+      for (int j=0; j<a.tn.length; ++j)
+        map[a.tn[j]] = 0;
+      for (int inode=0,jnode=0; inode<nnode; ++inode)
+        if (map[inode]>=0) map[inode] = jnode++;
+      for (int j=0; j<a.tn.length; ++j)
+        a.tn[j] = map[a.tn[j]];
+    }
+    return map;
+  }
+
+  private static int count(int[] map) {
+    int n = 0;
+    for (int i:map)
+      if (i>=0) ++n;
+    return n;
+  }
+}
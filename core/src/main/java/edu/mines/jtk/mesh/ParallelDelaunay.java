@@ -0,0 +1,929 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.ArrayList;
+import java.util.HashSet;
+
+import edu.mines.jtk.util.Parallel;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * Parallel Delaunay construction by spatial partitioning.
+ * <p>
+ * Points are partitioned into spatial regions, one for each of several
+ * threads. For each region, a sub-mesh is constructed from the points
+ * inside the bounding box of that region, expanded by a halo. A tet
+ * (or tri) in a sub-mesh is certainly Delaunay in the complete mesh if
+ * its circumsphere (or circumcircle) lies inside the expanded box,
+ * because the sub-mesh contains all points inside that box. A point in
+ * a region is safe if all tets in its sub-mesh star are certainly
+ * Delaunay; the star of a safe point is then its star in the complete
+ * mesh.
+ * <p>
+ * Tets with at least one safe node are taken from the sub-meshes.
+ * All other tets have only unsafe nodes, and are taken from a serially
+ * constructed mesh of only the unsafe points. These unsafe points lie
+ * mostly near the convex hull of all points, and are typically few.
+ * The tets taken from the mesh of unsafe points are found by stitching,
+ * beginning with tets adjacent to faces on the boundary of the tets
+ * taken from sub-meshes.
+ * <p>
+ * For points in general position, the resulting mesh is exactly the mesh
+ * that would be constructed by adding the same points serially. When
+ * points are cospherical (or cocircular), as for points on a regular grid,
+ * the Delaunay mesh is not unique, and different sub-meshes may break ties
+ * differently, so that their stars overlap or leave holes. The combined
+ * simplices are therefore always checked: all must be positively oriented,
+ * each shared face must separate its two simplices, and the sum of their
+ * volumes (or areas) must equal that of the convex hull. If any check
+ * fails, the points are instead added serially.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.21
+ */
+final class ParallelDelaunay {
+
+  /**
+   * Adds nodes with specified coordinates to an empty tet mesh.
+   * @param mesh the tet mesh, which must be empty.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of nodes constructed; null for duplicate nodes.
+   */
+  static TetMesh.Node[] addNodes(
+    TetMesh mesh, float[] x, float[] y, float[] z)
+  {
+    int n = x.length;
+    int[] iu = unique(SpatialOrder.duplicates(x,y,z));
+    int nu = iu.length;
+    int[][] tnt = tets(x,y,z,iu);
+    if (tnt==null)
+      return mesh.addNodes(x,y,z);
+    int[] tn = tnt[0];
+    int[] tt = tnt[1];
+
+    // Build the mesh from all nodes and tets.
+    TetMesh.Node[] nodes = new TetMesh.Node[n];
+    TetMesh.Node[] nodesm = new TetMesh.Node[nu];
+    for (int j=0; j<nu; ++j) {
+      int i = iu[j];
+      nodes[i] = nodesm[j] = new TetMesh.Node(x[i],y[i],z[i]);
+    }
+    mesh.build(nodesm,tn,tt);
+    return nodes;
+  }
+
+  /**
+   * Adds the specified nodes to an empty tet mesh. Nodes with the same
+   * coordinates as nodes with smaller indices are not added.
+   * @param mesh the tet mesh, which must be empty.
+   * @param nodes array of nodes to add.
+   * @return the number of nodes added.
+   */
+  static int addNodes(TetMesh mesh, TetMesh.Node[] nodes) {
+    int n = nodes.length;
+    float[] x = new float[n];
+    float[] y = new float[n];
+    float[] z = new float[n];
+    for (int i=0; i<n; ++i) {
+      x[i] = nodes[i].x();
+      y[i] = nodes[i].y();
+      z[i] = nodes[i].z();
+    }
+    int[] iu = unique(SpatialOrder.duplicates(x,y,z));
+    int nu = iu.length;
+    int[][] tnt = tets(x,y,z,iu);
+    if (tnt==null)
+      return mesh.addNodes(nodes);
+    int[] tn = tnt[0];
+    int[] tt = tnt[1];
+    TetMesh.Node[] nodesm = new TetMesh.Node[nu];
+    for (int j=0; j<nu; ++j)
+      nodesm[j] = nodes[iu[j]];
+    mesh.build(nodesm,tn,tt);
+    return nu;
+  }
+
+  /**
+   * Returns indices {tn,tt} of nodes and nabors of all tets in the Delaunay
+   * mesh of unique points with specified indices. Returns null if too few
+   * points for parallel construction, or if the tets taken from sub-meshes
+   * are not a valid tetrahedralization.
+   */
+  private static int[][] tets(
+    final float[] x, final float[] y, final float[] z, final int[] iu)
+  {
+    int n = x.length;
+    int nu = iu.length;
+    int nregion = countRegions(nu);
+    if (nregion<2)
+      return null;
+
+    // Partition unique points into regions.
+    final int[][] cores = partition(iu,new float[][]{x,y,z},nregion);
+    final int[] region = fillint(-1,n);
+    for (int ir=0; ir<nregion; ++ir)
+      for (int i:cores[ir])
+        region[i] = ir;
+
+    // In parallel, construct sub-meshes, find safe points, and get the
+    // tets in the stars of those safe points.
+    final boolean[] safe = new boolean[n];
+    final int[][] stars = new int[nregion][];
+    Parallel.loop(nregion,new Parallel.LoopInt() {
+      public void compute(int ir) {
+        stars[ir] = safeStars(x,y,z,iu,cores[ir],ir,region,safe);
+      }
+    });
+
+    // Tets with at least one safe node. Each such tet is taken from the
+    // region of its safe node with smallest index.
+    IntList ta = new IntList();
+    for (int ir=0; ir<nregion; ++ir) {
+      int[] s = stars[ir];
+      for (int j=0; j<s.length; j+=4) {
+        int m = n;
+        for (int k=j; k<j+4; ++k)
+          if (safe[s[k]] && s[k]<m) m = s[k];
+        if (region[m]==ir)
+          ta.add(s,j,4);
+      }
+      stars[ir] = null;
+    }
+
+    // Faces with only unsafe nodes on the boundary of those tets.
+    HashSet<Face> faces = new HashSet<Face>();
+    int[] a = ta.array();
+    for (int j=0; j<ta.size(); j+=4) {
+      int na = a[j], nb = a[j+1], nc = a[j+2], nd = a[j+3];
+      addFace(faces,safe,na,nb,nc);
+      addFace(faces,safe,nb,nd,nc);
+      addFace(faces,safe,nc,nd,na);
+      addFace(faces,safe,nd,nb,na);
+    }
+
+    // Serially mesh the unsafe points.
+    TetMesh mu = new TetMesh();
+    ArrayList<TetMesh.Node> nodesu = new ArrayList<TetMesh.Node>();
+    for (int i:iu) {
+      if (!safe[i]) {
+        TetMesh.Node node = new TetMesh.Node(x[i],y[i],z[i]);
+        node.index = i;
+        nodesu.add(node);
+      }
+    }
+    mu.addNodes(nodesu.toArray(new TetMesh.Node[0]));
+
+    // Stitch the tets with only unsafe nodes. Starting with tets that
+    // are opposite boundary faces, visit tets without crossing those
+    // faces. If no tets have safe nodes, then take all tets.
+    IntList tb = new IntList();
+    boolean all = ta.size()==0;
+    ArrayList<TetMesh.Tet> stack = new ArrayList<TetMesh.Tet>();
+    TetMesh.TetIterator ti = mu.getTets();
+    while (ti.hasNext()) {
+      TetMesh.Tet tet = ti.next();
+      if (tet.index==0 && (all || isSeed(faces,tet))) {
+        tet.index = 1;
+        stack.add(tet);
+      }
+    }
+    while (!stack.isEmpty()) {
+      TetMesh.Tet tet = stack.remove(stack.size()-1);
+      int na = tet.nodeA().index;
+      int nb = tet.nodeB().index;
+      int nc = tet.nodeC().index;
+      int nd = tet.nodeD().index;
+      tb.add(na);
+      tb.add(nb);
+      tb.add(nc);
+      tb.add(nd);
+      stackNabor(faces,stack,tet.tetD(),na,nb,nc);
+      stackNabor(faces,stack,tet.tetA(),nb,nd,nc);
+      stackNabor(faces,stack,tet.tetB(),nc,nd,na);
+      stackNabor(faces,stack,tet.tetC(),nd,nb,na);
+    }
+
+    // Indices of nodes and nabors of all tets, in the array of unique
+    // points, if those tets are a valid tetrahedralization. The convex
+    // hull of the unsafe points is that of all points, because points on
+    // the hull are never safe.
+    int[] index = new int[n];
+    for (int j=0; j<nu; ++j)
+      index[iu[j]] = j;
+    int[] tn = concat(ta,tb,index);
+    int[] tt = nabors(nu,4,tn);
+    if (tt==null || !isValid(new float[][]{x,y,z},iu,4,tn,tt,volume(mu)))
+      return null;
+    return new int[][]{tn,tt};
+  }
+
+  /**
+   * Adds nodes with specified coordinates to an empty tri mesh.
+   * @param mesh the tri mesh, which must be empty.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @return array of nodes constructed; null for duplicate nodes.
+   */
+  static TriMesh.Node[] addNodes(
+    TriMesh mesh, final float[] x, final float[] y)
+  {
+    int n = x.length;
+    int[] first = SpatialOrder.duplicates(x,y);
+    final int[] iu = unique(first);
+    int nu = iu.length;
+    int nregion = countRegions(nu);
+    if (nregion<2)
+      return mesh.addNodes(x,y);
+
+    // Partition unique points into regions.
+    final int[][] cores = partition(iu,new float[][]{x,y},nregion);
+    final int[] region = fillint(-1,n);
+    for (int ir=0; ir<nregion; ++ir)
+      for (int i:cores[ir])
+        region[i] = ir;
+
+    // In parallel, construct sub-meshes, find safe points, and get the
+    // tris in the stars of those safe points.
+    final boolean[] safe = new boolean[n];
+    final int[][] stars = new int[nregion][];
+    Parallel.loop(nregion,new Parallel.LoopInt() {
+      public void compute(int ir) {
+        stars[ir] = safeStars(x,y,iu,cores[ir],ir,region,safe);
+      }
+    });
+
+    // Tris with at least one safe node. Each such tri is taken from the
+    // region of its safe node with smallest index.
+    IntList ta = new IntList();
+    for (int ir=0; ir<nregion; ++ir) {
+      int[] s = stars[ir];
+      for (int j=0; j<s.length; j+=3) {
+        int m = n;
+        for (int k=j; k<j+3; ++k)
+          if (safe[s[k]] && s[k]<m) m = s[k];
+        if (region[m]==ir)
+          ta.add(s,j,3);
+      }
+      stars[ir] = null;
+    }
+
+    // Edges with only unsafe nodes on the boundary of those tris.
+    HashSet<Long> edges = new HashSet<Long>();
+    int[] a = ta.array();
+    for (int j=0; j<ta.size(); j+=3) {
+      int na = a[j], nb = a[j+1], nc = a[j+2];
+      addEdge(edges,safe,nb,nc);
+      addEdge(edges,safe,nc,na);
+      addEdge(edges,safe,na,nb);
+    }
+
+    // Serially mesh the unsafe points.
+    TriMesh mu = new TriMesh();
+    ArrayList<TriMesh.Node> nodesu = new ArrayList<TriMesh.Node>();
+    for (int i:iu) {
+      if (!safe[i]) {
+        TriMesh.Node node = new TriMesh.Node(x[i],y[i]);
+        node.index = i;
+        nodesu.add(node);
+      }
+    }
+    mu.addNodes(nodesu.toArray(new TriMesh.Node[0]));
+
+    // Stitch the tris with only unsafe nodes.
+    IntList tb = new IntList();
+    boolean all = ta.size()==0;
+    ArrayList<TriMesh.Tri> stack = new ArrayList<TriMesh.Tri>();
+    TriMesh.TriIterator ti = mu.getTris();
+    while (ti.hasNext()) {
+      TriMesh.Tri tri = ti.next();
+      if (tri.index==0 && (all || isSeed(edges,tri))) {
+        tri.index = 1;
+        stack.add(tri);
+      }
+    }
+    while (!stack.isEmpty()) {
+      TriMesh.Tri tri = stack.remove(stack.size()-1);
+      int na = tri.nodeA().index;
+      int nb = tri.nodeB().index;
+      int nc = tri.nodeC().index;
+      tb.add(na);
+      tb.add(nb);
+      tb.add(nc);
+      stackNabor(edges,stack,tri.triA(),nb,nc);
+      stackNabor(edges,stack,tri.triB(),nc,na);
+      stackNabor(edges,stack,tri.triC(),na,nb);
+    }
+
+    // Build the mesh from all nodes and tris.
+    TriMesh.Node[] nodes = new TriMesh.Node[n];
+    TriMesh.Node[] nodesm = new TriMesh.Node[nu];
+    int[] index = new int[n];
+    for (int j=0; j<nu; ++j) {
+      int i = iu[j];
+      nodes[i] = nodesm[j] = new TriMesh.Node(x[i],y[i]);
+      index[i] = j;
+    }
+    int[] tn = concat(ta,tb,index);
+    int[] tt = nabors(nu,3,tn);
+    if (tt==null || !isValid(new float[][]{x,y},iu,3,tn,tt,area(mu)))
+      return mesh.addNodes(x,y);
+    mesh.build(nodesm,tn,tt);
+    return nodes;
+  }
+
+  /**
+   * Computes nabors of simplices (tris or tets) specified by node indices.
+   * For each simplex s, the nabor opposite the node with local index k
+   * is tt[s*nv+k], which is -1 for faces on the mesh boundary.
+   * @param nnode the number of nodes.
+   * @param nv the number of nodes per simplex, 3 or 4.
+   * @param tn array[nv*nsimplex] of node indices.
+   * @return array[nv*nsimplex] of nabor indices; null, if any face is
+   *  shared by more than two simplices.
+   */
+  static int[] nabors(int nnode, int nv, int[] tn) {
+    int nf = tn.length;
+
+    // Bucket faces by the smallest node index in each face. For each
+    // face, a key contains the other node indices, in sorted order.
+    int[] count = new int[nnode+1];
+    int[] fn = new int[nv-1];
+    for (int f=0; f<nf; ++f) {
+      faceNodes(nv,tn,f,fn);
+      ++count[fn[0]+1];
+    }
+    for (int i=0; i<nnode; ++i)
+      count[i+1] += count[i];
+    int[] next = copy(count);
+    int[] ff = new int[nf];
+    long[] fk = new long[nf];
+    for (int f=0; f<nf; ++f) {
+      faceNodes(nv,tn,f,fn);
+      int p = next[fn[0]]++;
+      ff[p] = f;
+      fk[p] = (nv==4)?((long)fn[1]<<32)|fn[2]:fn[1];
+    }
+
+    // Within each bucket, sort faces by key, and link matching faces.
+    int[] tt = fillint(-1,nf);
+    for (int i=0; i<nnode; ++i) {
+      int p = count[i];
+      int q = count[i+1];
+      for (int j=p+1; j<q; ++j) {
+        long kj = fk[j];
+        int fj = ff[j];
+        int k = j;
+        for (; k>p && fk[k-1]>kj; --k) {
+          fk[k] = fk[k-1];
+          ff[k] = ff[k-1];
+        }
+        fk[k] = kj;
+        ff[k] = fj;
+      }
+      for (int j=p; j<q; ) {
+        int k = j+1;
+        while (k<q && fk[k]==fk[j])
+          ++k;
+        if (k-j==2) {
+          tt[ff[j]] = ff[j+1]/nv;
+          tt[ff[j+1]] = ff[j]/nv;
+        } else if (k-j>2) {
+          return null;
+        }
+        j = k;
+      }
+    }
+    return tt;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Minimum number of points per region.
+  private static final int NREGION_MIN = 10000;
+
+  // Width of halo, in units of average point spacing.
+  private static final double HALO = 4.0;
+
+  // Circumcenters of simplices with lower quality are not trusted.
+  private static final double QUALITY_MIN = 1.0e-6;
+
+  // Relative margin for tests of circumspheres inside boxes.
+  private static final double MARGIN = 1.0e-6;
+
+  // Relative tolerance for the sum of volumes (or areas) of simplices.
+  private static final double VOLUME_TOLERANCE = 1.0e-9;
+
+  // Bits in indices of simplices in sub-meshes.
+  private static final int TESTED = 1;
+  private static final int INSIDE = 2;
+  private static final int STARRED = 4;
+
+  // Number of threads, if positive; otherwise, the number of processors.
+  private static volatile int _nthread = 0;
+
+  private ParallelDelaunay() {
+  }
+
+  /**
+   * Sets the number of threads for which points are partitioned, so that
+   * parallel construction can be tested on machines with one processor.
+   * @param nthread the number of threads; zero, for the number of
+   *  available processors.
+   */
+  static void setThreadCount(int nthread) {
+    _nthread = nthread;
+  }
+
+  /**
+   * Determines whether simplices specified by node indices are a valid
+   * triangulation of the convex hull of their nodes. All simplices must
+   * be positively oriented, each face shared by two simplices must have
+   * their other nodes on opposite sides, and the sum of volumes (or areas)
+   * of simplices must equal the specified volume (or area) of the hull.
+   * Together, these conditions exclude both overlaps and holes.
+   * Volumes and areas here are scaled by 6 and 2, respectively.
+   */
+  private static boolean isValid(
+    float[][] c, int[] iu, int nv, int[] tn, int[] tt, double vhull)
+  {
+    int ns = tn.length/nv;
+    int[] p = new int[nv];
+    double vsum = 0.0;
+    for (int s=0,j=0; s<ns; ++s,j+=nv) {
+      for (int k=0; k<nv; ++k)
+        p[k] = iu[tn[j+k]];
+      double v = orient(c,p);
+      if (!(v>0.0))
+        return false;
+      vsum += v;
+      for (int k=0; k<nv; ++k) {
+        int t = tt[j+k];
+        if (t>s) {
+          p[k] = iu[apex(nv,tn,t,j,k)];
+          boolean opposite = orient(c,p)<0.0;
+          p[k] = iu[tn[j+k]];
+          if (!opposite)
+            return false;
+        }
+      }
+    }
+    return Math.abs(vsum-vhull)<=VOLUME_TOLERANCE*vhull;
+  }
+
+  /**
+   * Returns the node of simplex t that is not in the face of simplex
+   * (with first index j) opposite its node with local index k.
+   */
+  private static int apex(int nv, int[] tn, int t, int j, int k) {
+    for (int m=t*nv; m<t*nv+nv; ++m) {
+      boolean inFace = false;
+      for (int l=0; l<nv && !inFace; ++l)
+        inFace = l!=k && tn[j+l]==tn[m];
+      if (!inFace)
+        return tn[m];
+    }
+    return tn[j+k];
+  }
+
+  /**
+   * Returns the orientation of a simplex with specified nodes, which is
+   * 6 times the volume of a tet or 2 times the area of a tri.
+   */
+  private static double orient(float[][] c, int[] p) {
+    if (p.length==4) {
+      return Geometry.leftOfPlane(
+        c[0][p[0]],c[1][p[0]],c[2][p[0]],
+        c[0][p[1]],c[1][p[1]],c[2][p[1]],
+        c[0][p[2]],c[1][p[2]],c[2][p[2]],
+        c[0][p[3]],c[1][p[3]],c[2][p[3]]);
+    } else {
+      return Geometry.leftOfLine(
+        c[0][p[0]],c[1][p[0]],
+        c[0][p[1]],c[1][p[1]],
+        c[0][p[2]],c[1][p[2]]);
+    }
+  }
+
+  /**
+   * Returns 6 times the sum of volumes of tets in a mesh.
+   */
+  private static double volume(TetMesh mesh) {
+    double v = 0.0;
+    TetMesh.TetIterator ti = mesh.getTets();
+    while (ti.hasNext()) {
+      TetMesh.Tet tet = ti.next();
+      TetMesh.Node a = tet.nodeA(), b = tet.nodeB();
+      TetMesh.Node c = tet.nodeC(), d = tet.nodeD();
+      v += Geometry.leftOfPlane(
+        a.x(),a.y(),a.z(),b.x(),b.y(),b.z(),
+        c.x(),c.y(),c.z(),d.x(),d.y(),d.z());
+    }
+    return v;
+  }
+
+  /**
+   * Returns 2 times the sum of areas of tris in a mesh.
+   */
+  private static double area(TriMesh mesh) {
+    double v = 0.0;
+    TriMesh.TriIterator ti = mesh.getTris();
+    while (ti.hasNext()) {
+      TriMesh.Tri tri = ti.next();
+      TriMesh.Node a = tri.nodeA(), b = tri.nodeB(), c = tri.nodeC();
+      v += Geometry.leftOfLine(a.x(),a.y(),b.x(),b.y(),c.x(),c.y());
+    }
+    return v;
+  }
+
+  /**
+   * Returns the number of regions, a power of two, for parallel meshing.
+   */
+  private static int countRegions(int n) {
+    int nthread = _nthread;
+    if (nthread<=0)
+      nthread = Runtime.getRuntime().availableProcessors();
+    int nregion = 1;
+    while (nregion<nthread && n/(2*nregion)>=NREGION_MIN)
+      nregion *= 2;
+    return nregion;
+  }
+
+  /**
+   * Returns indices of points that are not duplicates.
+   */
+  private static int[] unique(int[] first) {
+    int n = first.length;
+    int nu = 0;
+    for (int i=0; i<n; ++i)
+      if (first[i]==i) ++nu;
+    int[] iu = new int[nu];
+    for (int i=0,j=0; i<n; ++i)
+      if (first[i]==i) iu[j++] = i;
+    return iu;
+  }
+
+  /**
+   * Recursively splits points at the median of their widest coordinate.
+   */
+  private static int[][] partition(int[] index, float[][] c, int nregion) {
+    if (nregion==1)
+      return new int[][]{index};
+    int n = index.length;
+    int m = c.length;
+    int jmax = 0;
+    float wmax = -1.0f;
+    for (int j=0; j<m; ++j) {
+      float cmin = Float.MAX_VALUE;
+      float cmax = -Float.MAX_VALUE;
+      for (int i:index) {
+        float ci = c[j][i];
+        if (ci<cmin) cmin = ci;
+        if (ci>cmax) cmax = ci;
+      }
+      if (cmax-cmin>wmax) {
+        wmax = cmax-cmin;
+        jmax = j;
+      }
+    }
+    int[] i = copy(index);
+    int k = n/2;
+    quickPartialIndexSort(k,c[jmax],i);
+    int[][] ra = partition(copy(k,0,i),c,nregion/2);
+    int[][] rb = partition(copy(n-k,k,i),c,nregion/2);
+    int[][] r = new int[nregion][];
+    System.arraycopy(ra,0,r,0,nregion/2);
+    System.arraycopy(rb,0,r,nregion/2,nregion/2);
+    return r;
+  }
+
+  /**
+   * Returns {min,max} for the bounding box of a region, expanded by a
+   * halo with width proportional to the average spacing of its points.
+   */
+  private static double[][] box(int[] core, float[][] c) {
+    int m = c.length;
+    double[] cmin = new double[m];
+    double[] cmax = new double[m];
+    double wmax = 0.0;
+    for (int j=0; j<m; ++j) {
+      cmin[j] = Double.MAX_VALUE;
+      cmax[j] = -Double.MAX_VALUE;
+      for (int i:core) {
+        double ci = c[j][i];
+        if (ci<cmin[j]) cmin[j] = ci;
+        if (ci>cmax[j]) cmax[j] = ci;
+      }
+      wmax = Math.max(wmax,cmax[j]-cmin[j]);
+    }
+    double v = 1.0;
+    for (int j=0; j<m; ++j)
+      v *= Math.max(cmax[j]-cmin[j],1.0e-3*wmax);
+    double h = HALO*Math.pow(v/core.length,1.0/m);
+    for (int j=0; j<m; ++j) {
+      cmin[j] -= h;
+      cmax[j] += h;
+    }
+    return new double[][]{cmin,cmax};
+  }
+
+  /**
+   * Returns indices of all unique points inside the specified box.
+   */
+  private static int[] inside(int[] iu, float[][] c, double[][] box) {
+    int m = c.length;
+    IntList list = new IntList();
+    for (int i:iu) {
+      boolean in = true;
+      for (int j=0; j<m && in; ++j)
+        in = box[0][j]<=c[j][i] && c[j][i]<=box[1][j];
+      if (in)
+        list.add(i);
+    }
+    return copy(list.size(),list.array());
+  }
+
+  /**
+   * Determines whether the sphere with center c and radius r is inside
+   * the specified box, with a small margin for rounding errors.
+   */
+  private static boolean inside(double[] c, double r, double[][] box) {
+    int m = c.length;
+    double e = 0.0;
+    for (int j=0; j<m; ++j)
+      e = Math.max(e,Math.max(Math.abs(box[0][j]),Math.abs(box[1][j])));
+    e = MARGIN*(r+e);
+    for (int j=0; j<m; ++j) {
+      if (c[j]-r-e<box[0][j] || c[j]+r+e>box[1][j])
+        return false;
+    }
+    return true;
+  }
+
+  /**
+   * Meshes one region in 3D, marks its safe points, and returns the
+   * tets in the stars of those safe points.
+   */
+  private static int[] safeStars(
+    float[] x, float[] y, float[] z, int[] iu,
+    int[] core, int ir, int[] region, boolean[] safe)
+  {
+    float[][] c = {x,y,z};
+    double[][] box = box(core,c);
+    int[] ib = inside(iu,c,box);
+    int nb = ib.length;
+    TetMesh.Node[] nodes = new TetMesh.Node[nb];
+    for (int j=0; j<nb; ++j) {
+      int i = ib[j];
+      nodes[j] = new TetMesh.Node(x[i],y[i],z[i]);
+      nodes[j].index = i;
+    }
+    TetMesh mesh = new TetMesh();
+    mesh.addNodes(nodes);
+    double[] cs = new double[3];
+    IntList list = new IntList();
+    for (TetMesh.Node node:nodes) {
+      if (region[node.index]!=ir || node.tet()==null)
+        continue;
+      TetMesh.Tet[] tets = mesh.getTetNabors(node);
+      boolean ok = true;
+      for (int j=0; j<tets.length && ok; ++j) {
+        TetMesh.Tet tet = tets[j];
+        if ((tet.index&TESTED)==0) {
+          tet.index |= TESTED;
+          if (tet.quality()>QUALITY_MIN) {
+            double r = Math.sqrt(tet.centerSphere(cs));
+            if (inside(cs,r,box))
+              tet.index |= INSIDE;
+          }
+        }
+        ok = (tet.index&INSIDE)!=0 && !onHull(tet,node);
+      }
+      if (ok) {
+        safe[node.index] = true;
+        for (TetMesh.Tet tet:tets) {
+          if ((tet.index&STARRED)==0) {
+            tet.index |= STARRED;
+            list.add(tet.nodeA().index);
+            list.add(tet.nodeB().index);
+            list.add(tet.nodeC().index);
+            list.add(tet.nodeD().index);
+          }
+        }
+      }
+    }
+    return copy(list.size(),list.array());
+  }
+
+  /**
+   * Meshes one region in 2D, marks its safe points, and returns the
+   * tris in the stars of those safe points.
+   */
+  private static int[] safeStars(
+    float[] x, float[] y, int[] iu,
+    int[] core, int ir, int[] region, boolean[] safe)
+  {
+    float[][] c = {x,y};
+    double[][] box = box(core,c);
+    int[] ib = inside(iu,c,box);
+    int nb = ib.length;
+    TriMesh.Node[] nodes = new TriMesh.Node[nb];
+    for (int j=0; j<nb; ++j) {
+      int i = ib[j];
+      nodes[j] = new TriMesh.Node(x[i],y[i]);
+      nodes[j].index = i;
+    }
+    TriMesh mesh = new TriMesh();
+    mesh.addNodes(nodes);
+    double[] cc = new double[2];
+    IntList list = new IntList();
+    for (TriMesh.Node node:nodes) {
+      if (region[node.index]!=ir || node.tri()==null)
+        continue;
+      TriMesh.Tri[] tris = mesh.getTriNabors(node);
+      boolean ok = true;
+      for (int j=0; j<tris.length && ok; ++j) {
+        TriMesh.Tri tri = tris[j];
+        if ((tri.index&TESTED)==0) {
+          tri.index |= TESTED;
+          if (tri.quality()>QUALITY_MIN) {
+            double r = Math.sqrt(tri.centerCircle(cc));
+            if (inside(cc,r,box))
+              tri.index |= INSIDE;
+          }
+        }
+        ok = (tri.index&INSIDE)!=0 && !onHull(tri,node);
+      }
+      if (ok) {
+        safe[node.index] = true;
+        for (TriMesh.Tri tri:tris) {
+          if ((tri.index&STARRED)==0) {
+            tri.index |= STARRED;
+            list.add(tri.nodeA().index);
+            list.add(tri.nodeB().index);
+            list.add(tri.nodeC().index);
+          }
+        }
+      }
+    }
+    return copy(list.size(),list.array());
+  }
+
+  /**
+   * Determines whether any face of a tet that contains a node is on
+   * the mesh hull. Faces that contain the node are opposite other nodes.
+   */
+  private static boolean onHull(TetMesh.Tet tet, TetMesh.Node node) {
+    return node!=tet.nodeA() && tet.tetA()==null ||
+           node!=tet.nodeB() && tet.tetB()==null ||
+           node!=tet.nodeC() && tet.tetC()==null ||
+           node!=tet.nodeD() && tet.tetD()==null;
+  }
+  private static boolean onHull(TriMesh.Tri tri, TriMesh.Node node) {
+    return node!=tri.nodeA() && tri.triA()==null ||
+           node!=tri.nodeB() && tri.triB()==null ||
+           node!=tri.nodeC() && tri.triC()==null;
+  }
+
+  /**
+   * An oriented face with three node indices, for hashing. Indices are
+   * rotated so that the first is smallest, and orientation is preserved.
+   */
+  private static class Face {
+    Face(int a, int b, int c) {
+      if (a<b && a<c) {
+        _a = a; _b = b; _c = c;
+      } else if (b<c) {
+        _a = b; _b = c; _c = a;
+      } else {
+        _a = c; _b = a; _c = b;
+      }
+    }
+    public boolean equals(Object object) {
+      Face face = (Face)object;
+      return _a==face._a && _b==face._b && _c==face._c;
+    }
+    public int hashCode() {
+      return _a^(_b*31)^(_c*961);
+    }
+    private int _a,_b,_c;
+  }
+
+  /**
+   * Adds an oriented face with only unsafe nodes to a set of faces,
+   * unless its mate is in the set, in which case the mate is removed.
+   */
+  private static void addFace(
+    HashSet<Face> faces, boolean[] safe, int a, int b, int c)
+  {
+    if (safe[a] || safe[b] || safe[c])
+      return;
+    if (!faces.remove(new Face(a,c,b)))
+      faces.add(new Face(a,b,c));
+  }
+  private static void addEdge(
+    HashSet<Long> edges, boolean[] safe, int a, int b)
+  {
+    if (safe[a] || safe[b])
+      return;
+    if (!edges.remove(edge(b,a)))
+      edges.add(edge(a,b));
+  }
+  private static Long edge(int a, int b) {
+    return ((long)a<<32)|b;
+  }
+
+  /**
+   * Determines whether the mate of any face of a tet is a boundary face.
+   */
+  private static boolean isSeed(HashSet<Face> faces, TetMesh.Tet tet) {
+    int na = tet.nodeA().index;
+    int nb = tet.nodeB().index;
+    int nc = tet.nodeC().index;
+    int nd = tet.nodeD().index;
+    return faces.contains(new Face(na,nc,nb)) ||
+           faces.contains(new Face(nb,nc,nd)) ||
+           faces.contains(new Face(nc,na,nd)) ||
+           faces.contains(new Face(nd,na,nb));
+  }
+  private static boolean isSeed(HashSet<Long> edges, TriMesh.Tri tri) {
+    int na = tri.nodeA().index;
+    int nb = tri.nodeB().index;
+    int nc = tri.nodeC().index;
+    return edges.contains(edge(nc,nb)) ||
+           edges.contains(edge(na,nc)) ||
+           edges.contains(edge(nb,na));
+  }
+
+  /**
+   * Stacks a tet nabor opposite the oriented face abc, unless that
+   * nabor is null or already stacked, or the mate of the face is a
+   * boundary face.
+   */
+  private static void stackNabor(
+    HashSet<Face> faces, ArrayList<TetMesh.Tet> stack, TetMesh.Tet tet,
+    int a, int b, int c)
+  {
+    if (tet!=null && tet.index==0 && !faces.contains(new Face(a,c,b))) {
+      tet.index = 1;
+      stack.add(tet);
+    }
+  }
+  private static void stackNabor(
+    HashSet<Long> edges, ArrayList<TriMesh.Tri> stack, TriMesh.Tri tri,
+    int a, int b)
+  {
+    if (tri!=null && tri.index==0 && !edges.contains(edge(b,a))) {
+      tri.index = 1;
+      stack.add(tri);
+    }
+  }
+
+  /**
+   * Gets the sorted node indices for the face f, which is opposite the
+   * node with local index f%nv in the simplex f/nv.
+   */
+  private static void faceNodes(int nv, int[] tn, int f, int[] fn) {
+    int s = f-f%nv;
+    for (int k=0,j=0; k<nv; ++k)
+      if (s+k!=f) fn[j++] = tn[s+k];
+    for (int j=1; j<nv-1; ++j) {
+      int t = fn[j];
+      int k = j;
+      for (; k>0 && fn[k-1]>t; --k)
+        fn[k] = fn[k-1];
+      fn[k] = t;
+    }
+  }
+
+  /**
+   * Returns concatenated arrays of global indices, mapped to mesh indices.
+   */
+  private static int[] concat(IntList ta, IntList tb, int[] index) {
+    int na = ta.size();
+    int nb = tb.size();
+    int[] a = ta.array();
+    int[] b = tb.array();
+    int[] t = new int[na+nb];
+    for (int j=0; j<na; ++j)
+      t[j] = index[a[j]];
+    for (int j=0; j<nb; ++j)
+      t[na+j] = index[b[j]];
+    return t;
+  }
+}
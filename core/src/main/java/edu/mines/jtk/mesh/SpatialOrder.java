@@ -0,0 +1,287 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Arrays;
+import java.util.Random;
+
+/**
+ * Orders points for efficient incremental Delaunay construction.
+ * <p>
+ * Points are ordered with a biased randomized insertion order (BRIO),
+ * as described by Amenta, N., Choi, S., and Rote, G., 2003, Incremental
+ * constructions con BRIO: Proceedings of the 19th Annual Symposium on
+ * Computational Geometry, 211-219. Points are randomly assigned to rounds
+ * of roughly doubling size. Within each round, points are sorted along
+ * a Morton (Z-order) space-filling curve, so that consecutive points
+ * are near each other and point location from the most recently
+ * inserted point is fast.
+ * <p>
+ * Randomness of rounds preserves the expected-case bounds of randomized
+ * incremental construction. Spatial sorting within rounds reduces the
+ * lengths of walks used to locate points, and improves memory locality.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.14
+ */
+final class SpatialOrder {
+
+  /**
+   * Returns a biased randomized insertion order for 2D points.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param random random number generator used to assign rounds.
+   * @return array of point indices in insertion order.
+   */
+  static int[] brio(float[] x, float[] y, Random random) {
+    return brio(mortonCodes(x,y),random);
+  }
+
+  /**
+   * Returns a biased randomized insertion order for 3D points.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @param random random number generator used to assign rounds.
+   * @return array of point indices in insertion order.
+   */
+  static int[] brio(float[] x, float[] y, float[] z, Random random) {
+    return brio(mortonCodes(x,y,z),random);
+  }
+
+  /**
+   * Returns an order of 2D points along a Morton curve.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @return array of point indices in Morton order.
+   */
+  static int[] morton(float[] x, float[] y) {
+    return sort(mortonCodes(x,y));
+  }
+
+  /**
+   * Returns an order of 3D points along a Morton curve.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of point indices in Morton order.
+   */
+  static int[] morton(float[] x, float[] y, float[] z) {
+    return sort(mortonCodes(x,y,z));
+  }
+
+  /**
+   * Finds duplicate 2D points, those with equal coordinates.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @return array of indices; for each point, the smallest index of
+   *  any point with equal coordinates, which may be the point itself.
+   */
+  static int[] duplicates(float[] x, float[] y) {
+    return duplicates(mortonCodes(x,y),new float[][]{x,y});
+  }
+
+  /**
+   * Finds duplicate 3D points, those with equal coordinates.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of indices; for each point, the smallest index of
+   *  any point with equal coordinates, which may be the point itself.
+   */
+  static int[] duplicates(float[] x, float[] y, float[] z) {
+    return duplicates(mortonCodes(x,y,z),new float[][]{x,y,z});
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Size of the first (smallest) round of insertions.
+  private static final int ROUND_MIN = 64;
+
+  // Bits per coordinate used in Morton codes, such that the codes and
+  // point indices together fit in the 63 non-sign bits of a long.
+  private static final int BITS2 = 16;
+  private static final int BITS3 = 10;
+
+  private SpatialOrder() {
+  }
+
+  /**
+   * Assigns points to random rounds, then sorts the points in each
+   * round by their Morton codes.
+   */
+  private static int[] brio(int[] code, Random random) {
+    int n = code.length;
+
+    // Number of rounds, such that the first round has ROUND_MIN points.
+    int nround = 1;
+    for (int m=n; m>=2*ROUND_MIN; m/=2)
+      ++nround;
+
+    // Each point is in the last round with probability 1/2, in the
+    // next-to-last round with probability 1/4, and so on.
+    byte[] round = new byte[n];
+    int[] count = new int[nround+1];
+    for (int i=0; i<n; ++i) {
+      int r = nround-1;
+      while (r>0 && random.nextBoolean())
+        --r;
+      round[i] = (byte)r;
+      ++count[r+1];
+    }
+    for (int r=0; r<nround; ++r)
+      count[r+1] += count[r];
+
+    // Keys contain both Morton code (high bits) and index (low bits).
+    // Sort keys within each round, and then extract the indices.
+    long[] key = new long[n];
+    int[] next = Arrays.copyOf(count,nround);
+    for (int i=0; i<n; ++i)
+      key[next[round[i]]++] = key(code[i],i);
+    for (int r=0; r<nround; ++r)
+      Arrays.sort(key,count[r],count[r+1]);
+    return indices(key);
+  }
+
+  /**
+   * Sorts all points by their Morton codes.
+   */
+  private static int[] sort(int[] code) {
+    int n = code.length;
+    long[] key = new long[n];
+    for (int i=0; i<n; ++i)
+      key[i] = key(code[i],i);
+    Arrays.sort(key);
+    return indices(key);
+  }
+
+  /**
+   * Equal points have equal Morton codes, so we need compare only points
+   * in runs of equal codes. Within each run, points are in index order.
+   */
+  private static int[] duplicates(int[] code, float[][] c) {
+    int n = code.length;
+    int m = c.length;
+    int[] index = sort(code);
+    int[] first = new int[n];
+    for (int i=0; i<n; ++i)
+      first[i] = i;
+    for (int j=0,k; j<n; j=k) {
+      for (k=j+1; k<n && code[index[k]]==code[index[j]]; ++k)
+        ;
+      for (int p=j; p<k; ++p) {
+        int ip = index[p];
+        if (first[ip]!=ip)
+          continue;
+        for (int q=p+1; q<k; ++q) {
+          int iq = index[q];
+          boolean equal = true;
+          for (int l=0; l<m && equal; ++l)
+            equal = c[l][ip]==c[l][iq];
+          if (equal)
+            first[iq] = ip;
+        }
+      }
+    }
+    return first;
+  }
+
+  private static long key(int code, int i) {
+    return ((code&0xffffffffL)<<31)|i;
+  }
+
+  private static int[] indices(long[] key) {
+    int n = key.length;
+    int[] index = new int[n];
+    for (int i=0; i<n; ++i)
+      index[i] = (int)(key[i]&0x7fffffffL);
+    return index;
+  }
+
+  private static int[] mortonCodes(float[] x, float[] y) {
+    int n = x.length;
+    int imax = (1<<BITS2)-1;
+    float[] xs = scale(x,imax);
+    float[] ys = scale(y,imax);
+    int[] code = new int[n];
+    for (int i=0; i<n; ++i) {
+      int ix = quantize(x[i],xs,imax);
+      int iy = quantize(y[i],ys,imax);
+      code[i] = spread2(ix)|(spread2(iy)<<1);
+    }
+    return code;
+  }
+
+  private static int[] mortonCodes(float[] x, float[] y, float[] z) {
+    int n = x.length;
+    int imax = (1<<BITS3)-1;
+    float[] xs = scale(x,imax);
+    float[] ys = scale(y,imax);
+    float[] zs = scale(z,imax);
+    int[] code = new int[n];
+    for (int i=0; i<n; ++i) {
+      int ix = quantize(x[i],xs,imax);
+      int iy = quantize(y[i],ys,imax);
+      int iz = quantize(z[i],zs,imax);
+      code[i] = spread3(ix)|(spread3(iy)<<1)|(spread3(iz)<<2);
+    }
+    return code;
+  }
+
+  /**
+   * Returns {min,scale} that maps the range of x to [0,imax].
+   */
+  private static float[] scale(float[] x, int imax) {
+    int n = x.length;
+    float xmin = Float.MAX_VALUE;
+    float xmax = -Float.MAX_VALUE;
+    for (int i=0; i<n; ++i) {
+      if (x[i]<xmin) xmin = x[i];
+      if (x[i]>xmax) xmax = x[i];
+    }
+    float s = (xmax>xmin)?imax/(xmax-xmin):0.0f;
+    return new float[]{xmin,s};
+  }
+
+  private static int quantize(float x, float[] xs, int imax) {
+    int i = (int)((x-xs[0])*xs[1]);
+    return (i<0)?0:(i>imax)?imax:i;
+  }
+
+  /**
+   * Spreads the low 16 bits of i into the even bits of an int.
+   */
+  private static int spread2(int i) {
+    i &= 0x0000ffff;
+    i = (i|(i<<8))&0x00ff00ff;
+    i = (i|(i<<4))&0x0f0f0f0f;
+    i = (i|(i<<2))&0x33333333;
+    i = (i|(i<<1))&0x55555555;
+    return i;
+  }
+
+  /**
+   * Spreads the low 10 bits of i into every third bit of an int.
+   */
+  private static int spread3(int i) {
+    i &= 0x000003ff;
+    i = (i|(i<<16))&0x030000ff;
+    i = (i|(i<< 8))&0x0300f00f;
+    i = (i|(i<< 4))&0x030c30c3;
+    i = (i|(i<< 2))&0x09249249;
+    return i;
+  }
+}
@@ -1246,7 +1246,7 @@ public class TetMesh implements Serializable {
      * @return true, if visible; false, otherwise.
      */
     public boolean isVisibleFromPoint(double x, double y, double z) {
-      return Geometry.leftOfPlane(
+      return Geometry.leftOfPlaneFiltered(
         _a._x,_a._y,_a._z,
         _b._x,_b._y,_b._z,
         _c._x,_c._y,_c._z,
@@ -2019,84 +2019,109 @@ public class TetMesh implements Serializable {
     // Where is the point?
     PointLocation pl = locatePoint(node._x,node._y,node._z);
 
-    // Cannot have two nodes with the same coordinates.
-    if (pl.isOnNode())
-      return false;
-
-    // Tell listeners that node will be added.
-    fireNodeWillBeAdded(node);
-
-    // The new node becomes the root node.
-    if (_nroot==null) {
-      _nroot = node;
-      _nroot._prev = _nroot._next = _nroot;
-    } else {
-      node._next = _nroot;
-      node._prev = _nroot._prev;
-      _nroot._prev._next = node;
-      _nroot._prev = node;
-      _nroot = node;
-    }
-    ++_nnode;
-
-    // Update node property values so they are consistent with this mesh.
-    updatePropertyValues(node);
-
-    // Maintain adequate sampling of O(N^(1/4)) nodes for fast point location.
-    // The scale factor 0.5 was used by Mucke et al., 1996.
-    double factor = 0.5*_sampledNodes.size();
-    if (factor*factor*factor*factor<_nnode) {
-      _sampledNodes.add(node);
-      //trace("addNode: sampling "+_sampledNodes.size()+" nodes");
-    }
-
-    // If we do not yet have a tet, perhaps we have enough nodes to make one.
-    if (pl.isOutside() && _nnode<=4) {
-      if (_nnode==4)
-        createFirstTet();
-
-    // Otherwise, if we have at least one tet, ...
-    } else {
-
-      // Get the set of Delaunay faces that bound the star-shaped 
-      // polyhedron containing all tets that are not Delaunay with 
-      // respect to the new node.
-      clearTetMarks();
-      _faceSet.clear();
-      if (pl.isInside()) {
-        getDelaunayFacesInside(node,pl.tet());
-      } else {
-        getDelaunayFacesOutside(node,pl.tet());
-      }
-
-      // With each Delaunay face in the set, create a new tet with 
-      // the new node. Use an edge set to link tets when a tet and 
-      // its nabor have been created.
-      _edgeSet.clear();
-      for (boolean more=_faceSet.first(); more; more=_faceSet.next()) {
-        Node a = _faceSet.a;
-        Node b = _faceSet.b;
-        Node c = _faceSet.c;
-        Node d = _faceSet.d;
-        Tet abcd = _faceSet.abcd;
-        Tet nabc = makeTet(node,a,b,c);
-        linkTets(nabc,node,abcd,d);
-        if (!_edgeSet.add(a,b,c,nabc))
-          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,c);
-        if (!_edgeSet.add(b,c,a,nabc))
-          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,a);
-        if (!_edgeSet.add(c,a,b,nabc))
-          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,b);
-      }
-    }
-
-    if (DEBUG)
-      validate();
+    // Add the node at that location.
+    return addNode(node,pl);
+  }
 
-    // Tell listeners that node has been added.
-    fireNodeAdded(node);
+  /**
+   * Adds the specified nodes to the mesh. Nodes with (x,y,z) coordinates
+   * equal to those of nodes already in the mesh are not added.
+   * <p>
+   * This method is much faster than adding the nodes one at a time with
+   * {@link #addNode(Node)}. Nodes are added in a biased randomized
+   * insertion order, with nodes in each round of insertions sorted along
+   * a space-filling curve, so that each node is located by a short walk
+   * from the tet most recently created. The mesh is locked only once for
+   * all nodes. Node listeners, if any, are notified as each node is added.
+   * @param nodes array of nodes to add.
+   * @return the number of nodes added.
+   */
+  public synchronized int addNodes(Node[] nodes) {
+    int n = nodes.length;
+    float[] x = new float[n];
+    float[] y = new float[n];
+    float[] z = new float[n];
+    for (int i=0; i<n; ++i) {
+      x[i] = nodes[i].x();
+      y[i] = nodes[i].y();
+      z[i] = nodes[i].z();
+    }
+    int[] order = SpatialOrder.brio(x,y,z,new Random(n));
+    int nadded = 0;
+    for (int i=0; i<n; ++i) {
+      Node node = nodes[order[i]];
+      PointLocation pl = (_troot!=null) ?
+        locatePoint(_troot,node._x,node._y,node._z) :
+        locatePoint(node._x,node._y,node._z);
+      if (addNode(node,pl))
+        ++nadded;
+    }
+    return nadded;
+  }
+
+  /**
+   * Adds nodes with specified coordinates to the mesh.
+   * Like the method {@link #addNodes(Node[])}, but constructs the nodes.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of nodes constructed; null elements correspond to
+   *  nodes not added, because the mesh already contained a node with
+   *  the same coordinates.
+   */
+  public synchronized Node[] addNodes(float[] x, float[] y, float[] z) {
+    int n = x.length;
+    Check.argument(y.length==n,"y.length equals x.length");
+    Check.argument(z.length==n,"z.length equals x.length");
+    Node[] nodes = new Node[n];
+    for (int i=0; i<n; ++i)
+      nodes[i] = new Node(x[i],y[i],z[i]);
+    addNodes(nodes);
+    for (int i=0; i<n; ++i) {
+      if (nodes[i]._next==null)
+        nodes[i] = null;
+    }
+    return nodes;
+  }
+
+  /**
+   * Adds nodes with specified coordinates to this mesh, using multiple
+   * threads. Points are partitioned into spatial regions, which are
+   * meshed in parallel, and then stitched together. For points in
+   * general position, the resulting mesh is the same as that constructed
+   * by {@link #addNodes(float[], float[], float[])}.
+   * For degenerate (e.g., cospherical) points, for which the Delaunay mesh
+   * is not unique, the stitched mesh is checked for overlaps and holes,
+   * and if any are found the nodes are instead added serially.
+   * <p>
+   * Parallel construction is used only if this mesh is empty and the
+   * number of nodes is large enough to benefit from multiple threads.
+   * Otherwise, this method is equivalent to that method. Node listeners,
+   * if any, are notified before and after all nodes are added.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of nodes constructed; null elements correspond to
+   *  nodes not added, because another node had the same coordinates.
+   */
+  public synchronized Node[] addNodesParallel(float[] x, float[] y, float[] z) {
+    if (_nnode>0)
+      return addNodes(x,y,z);
+    return ParallelDelaunay.addNodes(this,x,y,z);
+  }
 
-    return true;
+  /**
+   * Adds the specified nodes to this mesh, using multiple threads.
+   * Like the method {@link #addNodesParallel(float[],float[],float[])},
+   * but for nodes already constructed. The resulting mesh is the same
+   * as that constructed by {@link #addNodes(Node[])}.
+   * @param nodes array of nodes to add.
+   * @return the number of nodes added.
+   */
+  public synchronized int addNodesParallel(Node[] nodes) {
+    if (_nnode>0)
+      return addNodes(nodes);
+    return ParallelDelaunay.addNodes(this,nodes);
   }
 
   /**
@@ -2244,6 +2269,36 @@ public class TetMesh implements Serializable {
     return false;
   }
 
+  /**
+   * Improves the quality of tets in this mesh by moving nodes.
+   * Equivalent to {@link #improveQuality(double,int)} with at most
+   * three passes over all tets.
+   * @param qualityMin tets with quality less than this are improved.
+   * @return the number of tets with quality less than the minimum.
+   */
+  public synchronized int improveQuality(double qualityMin) {
+    return improveQuality(qualityMin,3);
+  }
+
+  /**
+   * Improves the quality of tets in this mesh by moving nodes.
+   * Because this mesh is always Delaunay, tets are improved only by
+   * moving nodes of tets with quality less than the specified minimum.
+   * A node is moved only if doing so increases the minimum quality of
+   * the tets that reference it. Nodes on the convex hull are never moved,
+   * so the hull is unchanged. Tet qualities are computed in parallel.
+   * <p>
+   * Nodes that are moved remain in the mesh, but with new coordinates.
+   * Therefore, any values associated with those nodes, such as samples
+   * of a function, may also need to be updated.
+   * @param qualityMin tets with quality less than this are improved.
+   * @param npass maximum number of passes over all tets.
+   * @return the number of tets with quality less than the minimum.
+   */
+  public synchronized int improveQuality(double qualityMin, int npass) {
+    return TetMeshImprover.improve(this,qualityMin,npass);
+  }
+
   /**
    * Finds the node nearest to the point with specified coordinates.
    * @param x the x coordinate.
@@ -3521,6 +3576,27 @@ public class TetMesh implements Serializable {
     _nnodeValues = 0;
     _lnodeValues = 0;
     _nodePropertyMaps = new HashMap<String,NodePropertyMap>();
+
+    // A node grid for this mesh remains, but now contains no nodes.
+    if (_nodeGrid!=null) {
+      _nodeGrid.clear();
+      addNodeListener(_nodeGrid);
+    }
+  }
+
+  /**
+   * Sets the node grid used to find nearest nodes; null, for none.
+   * Called only by {@link TetMeshNodeGrid}.
+   */
+  void setNodeGrid(TetMeshNodeGrid nodeGrid) {
+    _nodeGrid = nodeGrid;
+  }
+
+  /**
+   * Gets the node grid used to find nearest nodes; null, if none.
+   */
+  TetMeshNodeGrid getNodeGrid() {
+    return _nodeGrid;
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -3558,6 +3634,7 @@ public class TetMesh implements Serializable {
   private int _nnodeValues; // number of internal node prop values
   private int _lnodeValues; // length of internal node prop arrays
   private Map<String,NodePropertyMap> _nodePropertyMaps; // node property maps
+  private TetMeshNodeGrid _nodeGrid; // optional grid for nearest nodes
 
   /**
    * Internal node property map uses the array of values in each node.
@@ -3654,6 +3731,191 @@ public class TetMesh implements Serializable {
     };
   }
 
+  /**
+   * Builds this empty mesh from nodes and tets specified by indices.
+   * For each tet, the array tn contains indices of its nodes A, B, C and D,
+   * and the array tt contains indices of its tet nabors A, B, C and D, with
+   * -1 for null nabors. Nodes are linked in the order specified.
+   * Returns the tets, in the order specified.
+   */
+  Tet[] build(Node[] nodes, int[] tn, int[] tt) {
+    Check.state(_nnode==0,"mesh is empty");
+    int nnode = nodes.length;
+    int ntet = tn.length/4;
+    for (int inode=0; inode<nnode; ++inode)
+      fireNodeWillBeAdded(nodes[inode]);
+    for (int inode=0; inode<nnode; ++inode) {
+      Node node = nodes[inode];
+      node._prev = nodes[(inode+nnode-1)%nnode];
+      node._next = nodes[(inode+1)%nnode];
+      updatePropertyValues(node);
+    }
+    _nroot = (nnode>0)?nodes[0]:null;
+    _nnode = nnode;
+    Tet[] tets = new Tet[ntet];
+    for (int itet=0,j=0; itet<ntet; ++itet,j+=4)
+      tets[itet] = new Tet(nodes[tn[j]],nodes[tn[j+1]],
+                           nodes[tn[j+2]],nodes[tn[j+3]]);
+    for (int itet=0,j=0; itet<ntet; ++itet,j+=4) {
+      Tet tet = tets[itet];
+      tet._t0 = (tt[j  ]>=0)?tets[tt[j  ]]:null;
+      tet._t1 = (tt[j+1]>=0)?tets[tt[j+1]]:null;
+      tet._t2 = (tt[j+2]>=0)?tets[tt[j+2]]:null;
+      tet._t3 = (tt[j+3]>=0)?tets[tt[j+3]]:null;
+    }
+    _ntet = ntet;
+    _troot = (ntet>0)?tets[0]:null;
+    if (nnode<16) {
+      for (int inode=0; inode<nnode; ++inode)
+        _sampledNodes.add(nodes[inode]);
+    } else {
+      sampleNodes();
+    }
+    if (DEBUG)
+      validate();
+    for (int inode=0; inode<nnode; ++inode)
+      fireNodeAdded(nodes[inode]);
+    return tets;
+  }
+
+  /**
+   * Gets indices of tet nodes and tet nabors, the inverse of building.
+   * Nodes are indexed by their positions in the specified array, which
+   * must contain all nodes in this mesh. Tets are indexed in the order
+   * in which they are visited by an iterator from {@link #getTets()}.
+   * Like that iterator, this method clears all node and tet marks.
+   * @param nodes array of nodes; null elements are ignored.
+   * @param tn array[4*ntet] of indices of nodes A, B, C and D.
+   * @param tt array[4*ntet] of indices of tet nabors A, B, C and D;
+   *  -1 for null nabors.
+   * @return array of tets, in the order indexed.
+   */
+  synchronized Tet[] getIndices(Node[] nodes, int[] tn, int[] tt) {
+
+    // Temporarily use node and tet marks as indices.
+    int nnode = nodes.length;
+    for (int inode=0; inode<nnode; ++inode)
+      if (nodes[inode]!=null)
+        nodes[inode]._mark = inode;
+    Tet[] tets = new Tet[_ntet];
+    TetIterator ti = getTetsInternal();
+    for (int itet=0; ti.hasNext(); ++itet) {
+      tets[itet] = ti.next();
+      tets[itet]._mark = itet;
+    }
+    for (int itet=0,j=0; itet<_ntet; ++itet,j+=4) {
+      Tet tet = tets[itet];
+      tn[j  ] = tet._n0._mark;
+      tn[j+1] = tet._n1._mark;
+      tn[j+2] = tet._n2._mark;
+      tn[j+3] = tet._n3._mark;
+      tt[j  ] = (tet._t0!=null)?tet._t0._mark:-1;
+      tt[j+1] = (tet._t1!=null)?tet._t1._mark:-1;
+      tt[j+2] = (tet._t2!=null)?tet._t2._mark:-1;
+      tt[j+3] = (tet._t3!=null)?tet._t3._mark:-1;
+    }
+
+    // Zero all marks, as when marks overflow, and then clear them.
+    for (int inode=0; inode<nnode; ++inode)
+      if (nodes[inode]!=null)
+        nodes[inode]._mark = 0;
+    for (int itet=0; itet<_ntet; ++itet)
+      tets[itet]._mark = 0;
+    _nodeMarkRed = 0;
+    _nodeMarkBlue = 0;
+    clearNodeMarks();
+    _tetMarkRed = 0;
+    _tetMarkBlue = 0;
+    clearTetMarks();
+    return tets;
+  }
+
+  /**
+   * Adds a node at the specified location, which must be the location
+   * of that node with respect to the current mesh.
+   */
+  private boolean addNode(Node node, PointLocation pl) {
+
+    // Cannot have two nodes with the same coordinates.
+    if (pl.isOnNode())
+      return false;
+
+    // Tell listeners that node will be added.
+    fireNodeWillBeAdded(node);
+
+    // The new node becomes the root node.
+    if (_nroot==null) {
+      _nroot = node;
+      _nroot._prev = _nroot._next = _nroot;
+    } else {
+      node._next = _nroot;
+      node._prev = _nroot._prev;
+      _nroot._prev._next = node;
+      _nroot._prev = node;
+      _nroot = node;
+    }
+    ++_nnode;
+
+    // Update node property values so they are consistent with this mesh.
+    updatePropertyValues(node);
+
+    // Maintain adequate sampling of O(N^(1/4)) nodes for fast point location.
+    // The scale factor 0.5 was used by Mucke et al., 1996.
+    double factor = 0.5*_sampledNodes.size();
+    if (factor*factor*factor*factor<_nnode) {
+      _sampledNodes.add(node);
+      //trace("addNode: sampling "+_sampledNodes.size()+" nodes");
+    }
+
+    // If we do not yet have a tet, perhaps we have enough nodes to make one.
+    if (pl.isOutside() && _nnode<=4) {
+      if (_nnode==4)
+        createFirstTet();
+
+    // Otherwise, if we have at least one tet, ...
+    } else {
+
+      // Get the set of Delaunay faces that bound the star-shaped
+      // polyhedron containing all tets that are not Delaunay with
+      // respect to the new node.
+      clearTetMarks();
+      _faceSet.clear();
+      if (pl.isInside()) {
+        getDelaunayFacesInside(node,pl.tet());
+      } else {
+        getDelaunayFacesOutside(node,pl.tet());
+      }
+
+      // With each Delaunay face in the set, create a new tet with
+      // the new node. Use an edge set to link tets when a tet and
+      // its nabor have been created.
+      _edgeSet.clear();
+      for (boolean more=_faceSet.first(); more; more=_faceSet.next()) {
+        Node a = _faceSet.a;
+        Node b = _faceSet.b;
+        Node c = _faceSet.c;
+        Node d = _faceSet.d;
+        Tet abcd = _faceSet.abcd;
+        Tet nabc = makeTet(node,a,b,c);
+        linkTets(nabc,node,abcd,d);
+        if (!_edgeSet.add(a,b,c,nabc))
+          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,c);
+        if (!_edgeSet.add(b,c,a,nabc))
+          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,a);
+        if (!_edgeSet.add(c,a,b,nabc))
+          linkTets(_edgeSet.nabc,_edgeSet.c,nabc,b);
+      }
+    }
+
+    if (DEBUG)
+      validate();
+
+    // Tell listeners that node has been added.
+    fireNodeAdded(node);
+
+    return true;
+  }
+
   /**
    * Returns a new tet, possibly one resurrected from the dead.
    * Resurrection reduces the need for garbage collection of dead tets.
@@ -3752,7 +4014,7 @@ public class TetMesh implements Serializable {
    * Perturbation of coordinates ensures that the node is not in the plane.
    */
   private static boolean leftOfPlane(Node a, Node b, Node c, Node n) {
-    return Geometry.leftOfPlane(
+    return Geometry.leftOfPlaneFiltered(
       a._x,a._y,a._z,
       b._x,b._y,b._z,
       c._x,c._y,c._z,
@@ -3766,7 +4028,7 @@ public class TetMesh implements Serializable {
     Node a, Node b, Node c,
     double x, double y, double z)
   {
-    return Geometry.leftOfPlane(
+    return Geometry.leftOfPlaneFiltered(
       a._x,a._y,a._z,
       b._x,b._y,b._z,
       c._x,c._y,c._z,
@@ -3780,7 +4042,7 @@ public class TetMesh implements Serializable {
   private static boolean inSphere(
     Node a, Node b, Node c, Node d, Node n)
   {
-    return Geometry.inSphere(
+    return Geometry.inSphereFiltered(
       a._x,a._y,a._z,
       b._x,b._y,b._z,
       c._x,c._y,c._z,
@@ -3796,7 +4058,7 @@ public class TetMesh implements Serializable {
     Node a, Node b, Node c, Node d, 
     double x, double y, double z)
   {
-    return Geometry.inSphere(
+    return Geometry.inSphereFiltered(
       a._x,a._y,a._z,
       b._x,b._y,b._z,
       c._x,c._y,c._z,
@@ -4478,6 +4740,10 @@ public class TetMesh implements Serializable {
     if (_nnode==0)
       return null;
 
+    // If a node grid exists, use it.
+    if (_nodeGrid!=null)
+      return _nodeGrid.findNodeNearest((float)x,(float)y,(float)z);
+
     // If fewer than 20 nodes, simply check all of them.
     if (_nnode<20) {
       _nmin = _nroot;
@@ -4592,6 +4858,10 @@ public class TetMesh implements Serializable {
    */
   private Node findNodeNearestPlane(double a, double b, double c, double d) {
 
+    // If a node grid exists, use it.
+    if (_nodeGrid!=null)
+      return _nodeGrid.findNodeNearestPlane(a,b,c,d);
+
     // First, find the nearest node among the sampled nodes.
     _nmin = _nroot;
     _dmin = distanceToPlaneSquared(_nmin,a,b,c,d);
@@ -4764,7 +5034,7 @@ public class TetMesh implements Serializable {
     // on the convex hull and is visible from the search point.
     // TODO: experiment to determine whether it is more efficient to
     // go through the face with the most positive left-of-plane test.
-    double d0 = Geometry.leftOfPlane(x1,y1,z1,x2,y2,z2,x3,y3,z3,x,y,z);
+    double d0 = Geometry.leftOfPlaneFiltered(x1,y1,z1,x2,y2,z2,x3,y3,z3,x,y,z);
     if (d0>0.0) {
       Tet tetNabor = tet.tetNabor(n0);
       if (tetNabor!=null) {
@@ -4773,7 +5043,7 @@ public class TetMesh implements Serializable {
         return new PointLocation(tet,false);
       }
     }
-    double d1 = Geometry.leftOfPlane(x3,y3,z3,x2,y2,z2,x0,y0,z0,x,y,z);
+    double d1 = Geometry.leftOfPlaneFiltered(x3,y3,z3,x2,y2,z2,x0,y0,z0,x,y,z);
     if (d1>0.0) {
       Tet tetNabor = tet.tetNabor(n1);
       if (tetNabor!=null) {
@@ -4782,7 +5052,7 @@ public class TetMesh implements Serializable {
         return new PointLocation(tet,false);
       }
     }
-    double d2 = Geometry.leftOfPlane(x3,y3,z3,x0,y0,z0,x1,y1,z1,x,y,z);
+    double d2 = Geometry.leftOfPlaneFiltered(x3,y3,z3,x0,y0,z0,x1,y1,z1,x,y,z);
     if (d2>0.0) {
       Tet tetNabor = tet.tetNabor(n2);
       if (tetNabor!=null) {
@@ -4791,7 +5061,7 @@ public class TetMesh implements Serializable {
         return new PointLocation(tet,false);
       }
     }
-    double d3 = Geometry.leftOfPlane(x0,y0,z0,x2,y2,z2,x1,y1,z1,x,y,z);
+    double d3 = Geometry.leftOfPlaneFiltered(x0,y0,z0,x2,y2,z2,x1,y1,z1,x,y,z);
     if (d3>0.0) {
       Tet tetNabor = tet.tetNabor(n3);
       if (tetNabor!=null) {
@@ -0,0 +1,280 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.ArrayList;
+import java.util.HashSet;
+import java.util.Random;
+
+import edu.mines.jtk.util.Parallel;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * Improves the quality of tets in a tet mesh by moving nodes.
+ * <p>
+ * Because a tet mesh is always a Delaunay tetrahedralization of its
+ * nodes, tets cannot be improved by flipping faces or edges, which would
+ * make the mesh not Delaunay. Instead, nodes of low-quality tets (slivers)
+ * are moved, and the mesh is updated to remain Delaunay. For each such
+ * node, several trial positions are considered. The first trial positions
+ * lie between the node and the centroid of its node nabors, as in Laplacian
+ * smoothing. Other trial positions are random perturbations of the node,
+ * as in the sliver removal method of Edelsbrunner and Guoy (2002). A trial
+ * position is accepted only if the minimum quality of tets created by the
+ * move exceeds the minimum quality of tets destroyed by it. Otherwise,
+ * the node is moved back, which restores the mesh exactly.
+ * <p>
+ * The qualities of all tets are computed in parallel. Because each node
+ * is moved at most once in each pass, and each move changes only a few
+ * tets, the cost of each pass is proportional to the number of tets.
+ * <p>
+ * Nodes on the convex hull of the mesh are never moved, and no node is
+ * moved outside the hull. Therefore, the hull is unchanged.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.06
+ */
+final class TetMeshImprover {
+
+  /**
+   * Improves the quality of tets in the specified mesh.
+   * @param mesh the tet mesh.
+   * @param qualityMin tets with quality less than this are improved.
+   * @param npass maximum number of passes over all tets.
+   * @return the number of tets with quality less than the minimum.
+   */
+  static int improve(TetMesh mesh, double qualityMin, int npass) {
+    TetMeshImprover tmi = new TetMeshImprover(mesh,qualityMin);
+    mesh.addTetListener(tmi._tracker);
+    try {
+      for (int ipass=0; ipass<npass; ++ipass) {
+        TetMesh.Node[] nodes = tmi.sliverNodes();
+        if (nodes.length==0 || tmi.improve(nodes)==0)
+          break;
+      }
+    } finally {
+      mesh.removeTetListener(tmi._tracker);
+    }
+    tmi.sliverNodes();
+    return tmi._nsliver;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Random trial positions for each node are within this fraction of
+  // the length of the shortest edge that references the node.
+  private static final float[] SCALES = {0.1f,0.2f,0.3f};
+
+  // Number of random trial positions for each scale.
+  private static final int NRANDOM = 4;
+
+  // Steps toward the centroid of node nabors.
+  private static final float[] STEPS = {1.0f,0.5f,0.25f};
+
+  private TetMesh _mesh; // the mesh being improved
+  private double _qmin; // tets with quality less than this are slivers
+  private HashSet<TetMesh.Node> _hull; // nodes on the hull are not moved
+  private Tracker _tracker; // tracks tets added and removed by moves
+  private Random _random = new Random(314159); // for trial positions
+  private int _nsliver; // number of slivers found in the last pass
+
+  private TetMeshImprover(TetMesh mesh, double qualityMin) {
+    _mesh = mesh;
+    _qmin = qualityMin;
+    _hull = new HashSet<TetMesh.Node>();
+    TetMesh.FaceIterator fi = mesh.getFacesOnHull();
+    while (fi.hasNext()) {
+      TetMesh.Face face = fi.next();
+      _hull.add(face.nodeA());
+      _hull.add(face.nodeB());
+      _hull.add(face.nodeC());
+    }
+    _tracker = new Tracker();
+  }
+
+  /**
+   * Keeps track of tets added to and removed from the mesh as a node is
+   * moved. Tets removed that were not added by the same move existed
+   * before the move. Tets added and not removed exist after the move.
+   */
+  private static class Tracker implements TetMesh.TetListener {
+    public void tetAdded(TetMesh mesh, TetMesh.Tet tet) {
+      _added.add(tet);
+    }
+    public void tetRemoved(TetMesh mesh, TetMesh.Tet tet) {
+      int n = _added.size();
+      for (int i=0; i<n; ++i) {
+        if (_added.get(i)==tet) {
+          _added.set(i,_added.get(n-1));
+          _added.remove(n-1);
+          return;
+        }
+      }
+      double q = tet.quality();
+      if (q<_qremoved)
+        _qremoved = q;
+    }
+    void clear() {
+      _added.clear();
+      _qremoved = Double.MAX_VALUE;
+    }
+    double qualityRemoved() {
+      return _qremoved;
+    }
+    double qualityAdded() {
+      double qadded = Double.MAX_VALUE;
+      for (TetMesh.Tet tet:_added)
+        qadded = Math.min(qadded,tet.quality());
+      return qadded;
+    }
+    private ArrayList<TetMesh.Tet> _added = new ArrayList<TetMesh.Tet>();
+    private double _qremoved = Double.MAX_VALUE;
+  }
+
+  /**
+   * Returns nodes that may be moved to improve slivers, beginning with
+   * nodes of the worst slivers. Qualities are computed in parallel.
+   */
+  private TetMesh.Node[] sliverNodes() {
+    ArrayList<TetMesh.Tet> tetList = new ArrayList<TetMesh.Tet>();
+    TetMesh.TetIterator ti = _mesh.getTets();
+    while (ti.hasNext())
+      tetList.add(ti.next());
+    final TetMesh.Tet[] tets = tetList.toArray(new TetMesh.Tet[0]);
+    int ntet = tets.length;
+    final double[] q = new double[ntet];
+    Parallel.loop(ntet,new Parallel.LoopInt() {
+      public void compute(int itet) {
+        q[itet] = tets[itet].quality();
+      }
+    });
+    int[] i = rampint(0,1,ntet);
+    quickIndexSort(q,i);
+    ArrayList<TetMesh.Node> nodeList = new ArrayList<TetMesh.Node>();
+    HashSet<TetMesh.Node> nodeSet = new HashSet<TetMesh.Node>();
+    _nsliver = 0;
+    for (int itet=0; itet<ntet && q[i[itet]]<_qmin; ++itet) {
+      TetMesh.Tet tet = tets[i[itet]];
+      TetMesh.Node[] tetNodes = {
+        tet.nodeA(),tet.nodeB(),tet.nodeC(),tet.nodeD()
+      };
+      for (TetMesh.Node node:tetNodes) {
+        if (!_hull.contains(node) && nodeSet.add(node))
+          nodeList.add(node);
+      }
+      ++_nsliver;
+    }
+    return nodeList.toArray(new TetMesh.Node[0]);
+  }
+
+  /**
+   * Moves the specified nodes, if doing so improves the mesh.
+   * Returns the number of nodes moved.
+   */
+  private int improve(TetMesh.Node[] nodes) {
+    int nmoved = 0;
+    for (TetMesh.Node node:nodes) {
+      if (minQuality(node)<_qmin && improve(node))
+        ++nmoved;
+    }
+    return nmoved;
+  }
+
+  /**
+   * Returns the minimum quality of tets that reference the specified node.
+   */
+  private double minQuality(TetMesh.Node node) {
+    double qmin = Double.MAX_VALUE;
+    TetMesh.Tet[] tets = _mesh.getTetNabors(node);
+    for (TetMesh.Tet tet:tets)
+      qmin = Math.min(qmin,tet.quality());
+    return qmin;
+  }
+
+  /**
+   * Tries to move the specified node to improve the mesh.
+   * Returns true, if the node was moved; false, otherwise.
+   */
+  private boolean improve(TetMesh.Node node) {
+    float x = node.x();
+    float y = node.y();
+    float z = node.z();
+
+    // Centroid of node nabors and length of shortest edge.
+    TetMesh.Node[] nabors = _mesh.getNodeNabors(node);
+    int nnabor = nabors.length;
+    if (nnabor==0)
+      return false;
+    float xc = 0.0f, yc = 0.0f, zc = 0.0f;
+    float dmin = Float.MAX_VALUE;
+    for (TetMesh.Node nabor:nabors) {
+      float xn = nabor.x();
+      float yn = nabor.y();
+      float zn = nabor.z();
+      xc += xn;
+      yc += yn;
+      zc += zn;
+      float dx = xn-x;
+      float dy = yn-y;
+      float dz = zn-z;
+      dmin = Math.min(dmin,dx*dx+dy*dy+dz*dz);
+    }
+    xc /= nnabor;
+    yc /= nnabor;
+    zc /= nnabor;
+    dmin = (float)Math.sqrt(dmin);
+
+    // Steps toward the centroid.
+    for (float step:STEPS) {
+      if (tryMove(node,x,y,z,x+step*(xc-x),y+step*(yc-y),z+step*(zc-z)))
+        return true;
+    }
+
+    // Random perturbations.
+    for (float scale:SCALES) {
+      for (int irandom=0; irandom<NRANDOM; ++irandom) {
+        float dx = 2.0f*_random.nextFloat()-1.0f;
+        float dy = 2.0f*_random.nextFloat()-1.0f;
+        float dz = 2.0f*_random.nextFloat()-1.0f;
+        float ds = scale*dmin/(float)Math.sqrt(dx*dx+dy*dy+dz*dz);
+        if (tryMove(node,x,y,z,x+ds*dx,y+ds*dy,z+ds*dz))
+          return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * Moves a node from (x,y,z) to (xt,yt,zt), and keeps the move only if
+   * the minimum quality of tets changed increases. Returns true, if the
+   * node was moved; false, otherwise.
+   */
+  private boolean tryMove(
+    TetMesh.Node node,
+    float x, float y, float z,
+    float xt, float yt, float zt)
+  {
+    if (_mesh.locatePoint(xt,yt,zt).isOutside())
+      return false;
+    _tracker.clear();
+    if (!_mesh.moveNode(node,xt,yt,zt))
+      return false;
+    if (_tracker.qualityAdded()>_tracker.qualityRemoved())
+      return true;
+    _mesh.moveNode(node,x,y,z);
+    return false;
+  }
+}
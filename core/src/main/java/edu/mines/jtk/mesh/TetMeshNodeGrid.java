@@ -0,0 +1,440 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.ArrayList;
+import java.util.concurrent.atomic.AtomicReferenceArray;
+
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A uniform grid of cells that contain the nodes of a tet mesh.
+ * A node grid accelerates searches for nodes nearest to points and
+ * planes. Searches do not lock the mesh, and may be performed by
+ * multiple threads concurrently.
+ * <p>
+ * A node grid is a node listener for its tet mesh, and is updated
+ * incrementally as nodes are added to, removed from, or moved within
+ * the mesh. While the mesh is being modified, searches may return
+ * nodes that are no longer in the mesh, or may overlook nodes that
+ * have just been added. After modifications are complete, searches
+ * return the same nodes as the corresponding methods of the mesh.
+ * <p>
+ * While a node grid exists for a tet mesh, the mesh methods
+ * {@link TetMesh#findNodeNearest(float,float,float)} and
+ * {@link TetMesh#getNodesNearestPlane(double,double,double,double)}
+ * use the grid. The method {@link #dispose()} removes the grid from
+ * the mesh.
+ * <p>
+ * Cells are sized so that each contains a few nodes, on average.
+ * When the number of nodes grows or a node lies outside the bounds
+ * of the grid, cells are recomputed for all nodes.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.10
+ */
+public class TetMeshNodeGrid implements TetMesh.NodeListener {
+
+  /**
+   * Constructs a node grid for the specified tet mesh.
+   * The grid contains all nodes currently in the mesh.
+   * @param mesh the tet mesh.
+   */
+  public TetMeshNodeGrid(TetMesh mesh) {
+    synchronized (mesh) {
+      _mesh = mesh;
+      ArrayList<TetMesh.Node> nodes = new ArrayList<TetMesh.Node>();
+      TetMesh.NodeIterator ni = mesh.getNodes();
+      while (ni.hasNext())
+        nodes.add(ni.next());
+      _nnode = nodes.size();
+      _grid = (_nnode>0)?new Grid(nodes):null;
+      mesh.addNodeListener(this);
+      mesh.setNodeGrid(this);
+    }
+  }
+
+  /**
+   * Removes this grid from its tet mesh.
+   * After this method is called, this grid is no longer updated.
+   */
+  public void dispose() {
+    synchronized (_mesh) {
+      _mesh.removeNodeListener(this);
+      if (_mesh.getNodeGrid()==this)
+        _mesh.setNodeGrid(null);
+    }
+  }
+
+  /**
+   * Returns the tet mesh for this grid.
+   * @return the tet mesh.
+   */
+  public TetMesh getMesh() {
+    return _mesh;
+  }
+
+  /**
+   * Finds the node nearest to the point with specified coordinates.
+   * @param x the x coordinate.
+   * @param y the y coordinate.
+   * @param z the z coordinate.
+   * @return the nearest node; null, if the mesh has no nodes.
+   */
+  public TetMesh.Node findNodeNearest(float x, float y, float z) {
+    Grid grid = _grid;
+    return (grid!=null)?grid.findNodeNearest(x,y,z):null;
+  }
+
+  /**
+   * Finds nodes nearest to the points with specified coordinates.
+   * Uses multiple threads to search for nodes.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @param z array of z coordinates.
+   * @return array of nearest nodes.
+   */
+  public TetMesh.Node[] findNodeNearest(
+    final float[] x, final float[] y, final float[] z)
+  {
+    int n = x.length;
+    final TetMesh.Node[] nodes = new TetMesh.Node[n];
+    final Grid grid = _grid;
+    if (grid!=null) {
+      Parallel.loop(n,new Parallel.LoopInt() {
+        public void compute(int i) {
+          nodes[i] = grid.findNodeNearest(x[i],y[i],z[i]);
+        }
+      });
+    }
+    return nodes;
+  }
+
+  /**
+   * Finds the node nearest to the plane with specified coefficients.
+   * The plane satisfies the equation a*x+b*y+c*z+d = 0.
+   * @param a the coefficient a in the equation for the plane.
+   * @param b the coefficient b in the equation for the plane.
+   * @param c the coefficient c in the equation for the plane.
+   * @param d the coefficient d in the equation for the plane.
+   * @return the nearest node; null, if the mesh has no nodes.
+   */
+  public TetMesh.Node findNodeNearestPlane(
+    double a, double b, double c, double d)
+  {
+    Grid grid = _grid;
+    return (grid!=null)?grid.findNodeNearestPlane(a,b,c,d):null;
+  }
+
+  public void nodeWillBeAdded(TetMesh mesh, TetMesh.Node node) {
+  }
+  public synchronized void nodeAdded(TetMesh mesh, TetMesh.Node node) {
+    ++_nnode;
+    Grid grid = _grid;
+    if (grid==null ||
+        !grid.contains(node) ||
+        _nnode>NODES_PER_CELL_MAX*grid.ncell) {
+      ArrayList<TetMesh.Node> nodes = (grid!=null) ?
+        grid.nodes() :
+        new ArrayList<TetMesh.Node>();
+      nodes.add(node);
+      _grid = new Grid(nodes);
+    } else {
+      grid.add(node);
+    }
+  }
+  public void nodeWillBeRemoved(TetMesh mesh, TetMesh.Node node) {
+  }
+  public synchronized void nodeRemoved(TetMesh mesh, TetMesh.Node node) {
+    --_nnode;
+    Grid grid = _grid;
+    if (_nnode==0) {
+      _grid = null;
+    } else if (grid!=null) {
+      grid.remove(node);
+    }
+  }
+
+  /**
+   * Removes all nodes from this grid. Called only by {@link TetMesh},
+   * when that mesh is initialized.
+   */
+  synchronized void clear() {
+    _nnode = 0;
+    _grid = null;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Average number of nodes per cell when cells are computed, and
+  // maximum average number of nodes per cell before they are recomputed.
+  private static final int NODES_PER_CELL = 2;
+  private static final int NODES_PER_CELL_MAX = 8;
+
+  private TetMesh _mesh; // the tet mesh
+  private int _nnode; // number of nodes in the grid
+  private volatile Grid _grid; // the grid; null, if no nodes
+
+  /**
+   * The cells of a node grid. Bounds and dimensions of the grid never
+   * change. The arrays of nodes in cells are replaced, never modified,
+   * so that cells may be searched while nodes are added and removed.
+   */
+  private static class Grid {
+    final int nx,ny,nz,ncell;
+    final double xmin,ymin,zmin;
+    final double xmax,ymax,zmax;
+    final double dx,dy,dz;
+    final AtomicReferenceArray<TetMesh.Node[]> cells;
+
+    Grid(ArrayList<TetMesh.Node> nodes) {
+
+      // Bounds of nodes, expanded so that nodes added later are likely
+      // to lie inside the grid.
+      double xn = Double.MAX_VALUE, xx = -Double.MAX_VALUE;
+      double yn = Double.MAX_VALUE, yx = -Double.MAX_VALUE;
+      double zn = Double.MAX_VALUE, zx = -Double.MAX_VALUE;
+      for (TetMesh.Node node:nodes) {
+        double x = node.x(), y = node.y(), z = node.z();
+        xn = Math.min(xn,x);  xx = Math.max(xx,x);
+        yn = Math.min(yn,y);  yx = Math.max(yx,y);
+        zn = Math.min(zn,z);  zx = Math.max(zx,z);
+      }
+      double size = Math.max(xx-xn,Math.max(yx-yn,zx-zn));
+      if (size==0.0)
+        size = Math.max(1.0,Math.max(Math.abs(xn),
+                            Math.max(Math.abs(yn),Math.abs(zn))));
+      double margin = 0.125*size;
+      xmin = xn-margin;  xmax = xx+margin;
+      ymin = yn-margin;  ymax = yx+margin;
+      zmin = zn-margin;  zmax = zx+margin;
+
+      // Cubic cells, with a few nodes per cell, on average.
+      int nnode = nodes.size();
+      double volume = (xmax-xmin)*(ymax-ymin)*(zmax-zmin);
+      double d = Math.cbrt(volume*NODES_PER_CELL/Math.max(1,nnode));
+      nx = Math.max(1,Math.min(1024,(int)Math.ceil((xmax-xmin)/d)));
+      ny = Math.max(1,Math.min(1024,(int)Math.ceil((ymax-ymin)/d)));
+      nz = Math.max(1,Math.min(1024,(int)Math.ceil((zmax-zmin)/d)));
+      ncell = nx*ny*nz;
+      dx = (xmax-xmin)/nx;
+      dy = (ymax-ymin)/ny;
+      dz = (zmax-zmin)/nz;
+
+      // Nodes in cells.
+      int[] counts = new int[ncell];
+      int[] icells = new int[nnode];
+      for (int inode=0; inode<nnode; ++inode) {
+        TetMesh.Node node = nodes.get(inode);
+        int icell = cell(node.x(),node.y(),node.z());
+        icells[inode] = icell;
+        ++counts[icell];
+      }
+      TetMesh.Node[][] cellNodes = new TetMesh.Node[ncell][];
+      for (int icell=0; icell<ncell; ++icell) {
+        cellNodes[icell] = new TetMesh.Node[counts[icell]];
+        counts[icell] = 0;
+      }
+      for (int inode=0; inode<nnode; ++inode) {
+        int icell = icells[inode];
+        cellNodes[icell][counts[icell]++] = nodes.get(inode);
+      }
+      cells = new AtomicReferenceArray<TetMesh.Node[]>(cellNodes);
+    }
+
+    boolean contains(TetMesh.Node node) {
+      double x = node.x(), y = node.y(), z = node.z();
+      return xmin<=x && x<=xmax &&
+             ymin<=y && y<=ymax &&
+             zmin<=z && z<=zmax;
+    }
+
+    ArrayList<TetMesh.Node> nodes() {
+      ArrayList<TetMesh.Node> nodes = new ArrayList<TetMesh.Node>();
+      for (int icell=0; icell<ncell; ++icell) {
+        for (TetMesh.Node node:cells.get(icell))
+          nodes.add(node);
+      }
+      return nodes;
+    }
+
+    void add(TetMesh.Node node) {
+      int icell = cell(node.x(),node.y(),node.z());
+      TetMesh.Node[] a = cells.get(icell);
+      int n = a.length;
+      TetMesh.Node[] b = new TetMesh.Node[n+1];
+      System.arraycopy(a,0,b,0,n);
+      b[n] = node;
+      cells.set(icell,b);
+    }
+
+    void remove(TetMesh.Node node) {
+      int icell = cell(node.x(),node.y(),node.z());
+      TetMesh.Node[] a = cells.get(icell);
+      int n = a.length;
+      for (int i=0; i<n; ++i) {
+        if (a[i]==node) {
+          TetMesh.Node[] b = new TetMesh.Node[n-1];
+          System.arraycopy(a,0,b,0,i);
+          System.arraycopy(a,i+1,b,i,n-1-i);
+          cells.set(icell,b);
+          return;
+        }
+      }
+    }
+
+    TetMesh.Node findNodeNearest(double x, double y, double z) {
+      int ic = index(x,xmin,dx,nx);
+      int jc = index(y,ymin,dy,ny);
+      int kc = index(z,zmin,dz,nz);
+      TetMesh.Node nmin = null;
+      double dmin = Double.MAX_VALUE;
+
+      // Search shells of cells centered on the cell that contains
+      // the point, until the nearest node found is nearer than any
+      // cell not yet searched.
+      for (int r=0; ; ++r) {
+        int i0 = ic-r, i1 = ic+r;
+        int j0 = jc-r, j1 = jc+r;
+        int k0 = kc-r, k1 = kc+r;
+        int ilo = Math.max(i0,0), ihi = Math.min(i1,nx-1);
+        int jlo = Math.max(j0,0), jhi = Math.min(j1,ny-1);
+        int klo = Math.max(k0,0), khi = Math.min(k1,nz-1);
+        for (int k=klo; k<=khi; ++k) {
+          for (int j=jlo; j<=jhi; ++j) {
+            boolean face = k==k0 || k==k1 || j==j0 || j==j1;
+            int istep = (face)?1:Math.max(1,i1-i0);
+            for (int i=(face)?ilo:i0; i<=ihi; i+=istep) {
+              if (i<0)
+                continue;
+              for (TetMesh.Node node:cells.get(i+nx*(j+ny*k))) {
+                double xd = x-node.x();
+                double yd = y-node.y();
+                double zd = z-node.z();
+                double ds = xd*xd+yd*yd+zd*zd;
+                if (ds<dmin) {
+                  dmin = ds;
+                  nmin = node;
+                }
+              }
+            }
+          }
+        }
+
+        // Lower bound on distance to cells not yet searched.
+        boolean more = false;
+        double dlow = Double.MAX_VALUE;
+        if (i0>0)    { more = true; dlow = Math.min(dlow,x-xmin-i0*dx); }
+        if (i1<nx-1) { more = true; dlow = Math.min(dlow,xmin+(i1+1)*dx-x); }
+        if (j0>0)    { more = true; dlow = Math.min(dlow,y-ymin-j0*dy); }
+        if (j1<ny-1) { more = true; dlow = Math.min(dlow,ymin+(j1+1)*dy-y); }
+        if (k0>0)    { more = true; dlow = Math.min(dlow,z-zmin-k0*dz); }
+        if (k1<nz-1) { more = true; dlow = Math.min(dlow,zmin+(k1+1)*dz-z); }
+        if (!more || nmin!=null && dlow>0.0 && dlow*dlow>=dmin)
+          break;
+      }
+      return nmin;
+    }
+
+    TetMesh.Node findNodeNearestPlane(
+      double a, double b, double c, double d)
+    {
+      // Columns of cells are aligned with the axis w along which cells
+      // are most nearly perpendicular to the plane, so that the plane
+      // intersects only a few cells in each column.
+      int[] n = {nx,ny,nz};
+      double[] f = {xmin,ymin,zmin};
+      double[] e = {dx,dy,dz};
+      double[] p = {a,b,c};
+      int[] stride = {1,nx,nx*ny};
+      int w = 0;
+      for (int l=1; l<3; ++l) {
+        if (Math.abs(p[l])*e[l]>Math.abs(p[w])*e[w])
+          w = l;
+      }
+      int u = (w+1)%3, v = (w+2)%3;
+      int nu = n[u], nv = n[v], nw = n[w];
+
+      // In each column, the index of the cell that contains the plane
+      // at the center of the column, or of the nearest cell if the plane
+      // lies outside the grid. Distances from the plane to the centers of
+      // cells increase with distance in cells from this nearest cell.
+      int[] kc = new int[nu*nv];
+      double[] dc = new double[nu*nv];
+      for (int jv=0,m=0; jv<nv; ++jv) {
+        double xv = f[v]+(jv+0.5)*e[v];
+        for (int ju=0; ju<nu; ++ju,++m) {
+          double xu = f[u]+(ju+0.5)*e[u];
+          double xw = (p[w]!=0.0)?-(p[u]*xu+p[v]*xv+d)/p[w]:f[w];
+          kc[m] = index(xw,f[w],e[w],nw);
+          dc[m] = p[u]*xu+p[v]*xv+d;
+        }
+      }
+
+      // Half the extent of a cell in the direction normal to the plane.
+      double h = 0.5*(Math.abs(a)*dx+Math.abs(b)*dy+Math.abs(c)*dz);
+
+      // Search cells at distance r from the nearest cell in each column,
+      // for increasing r, until the nearest node found is nearer than
+      // any cell not yet searched.
+      TetMesh.Node nmin = null;
+      double dmin = Double.MAX_VALUE;
+      for (int r=0; ; ++r) {
+        boolean more = false;
+        for (int jv=0,m=0; jv<nv; ++jv) {
+          for (int ju=0; ju<nu; ++ju,++m) {
+            for (int side=-1; side<=1; side+=2) {
+              if (r==0 && side>0)
+                continue;
+              int k = kc[m]+side*r;
+              if (k<0 || k>=nw)
+                continue;
+              double xw = f[w]+(k+0.5)*e[w];
+              double ds = Math.abs(dc[m]+p[w]*xw)-h;
+              if (ds>0.0 && ds*ds>=dmin)
+                continue;
+              more = true;
+              int icell = ju*stride[u]+jv*stride[v]+k*stride[w];
+              for (TetMesh.Node node:cells.get(icell)) {
+                double dp = a*node.x()+b*node.y()+c*node.z()+d;
+                double dd = dp*dp;
+                if (dd<dmin) {
+                  dmin = dd;
+                  nmin = node;
+                }
+              }
+            }
+          }
+        }
+        if (!more)
+          break;
+      }
+      return nmin;
+    }
+
+    private int cell(double x, double y, double z) {
+      int i = index(x,xmin,dx,nx);
+      int j = index(y,ymin,dy,ny);
+      int k = index(z,zmin,dz,nz);
+      return i+nx*(j+ny*k);
+    }
+
+    private static int index(double x, double xmin, double dx, int nx) {
+      int i = (int)((x-xmin)/dx);
+      return (i<0)?0:(i>=nx)?nx-1:i;
+    }
+  }
+}
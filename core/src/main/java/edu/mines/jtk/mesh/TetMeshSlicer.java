@@ -0,0 +1,306 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Extracts plane sections and iso-surfaces from a tetrahedral mesh.
+ * <p>
+ * Sections and iso-surfaces are sets of triangles, with vertex
+ * coordinates packed into flat arrays of floats, three vertices per
+ * triangle and three coordinates per vertex. These arrays may be used
+ * directly to construct an {@link edu.mines.jtk.sgl.TriangleGroup}.
+ * Vertex values, such as those used to color sections, are likewise
+ * packed into arrays, one value per vertex.
+ * <p>
+ * A plane section is simply an iso-surface of a linear function of
+ * node coordinates. Within each tet, values are linearly interpolated
+ * from the values at its four nodes, and each tet contributes zero,
+ * one or two triangles. Triangles are oriented so that their normal
+ * vectors point in the direction of increasing values.
+ * <p>
+ * Triangles are extracted using multiple threads, in two passes over
+ * all tets. The first pass counts triangles; the second pass computes
+ * their vertices. Values of the linear function for a plane section are
+ * computed in double precision, so that sections are accurate for large
+ * coordinates, such as UTM coordinates, far from the origin. Node
+ * coordinates are copied once, when a slicer is
+ * constructed, so that sections may be recomputed quickly, as a plane
+ * is moved.
+ * <p>
+ * A slicer is constructed for a {@link CompactTetMesh}, which cannot be
+ * modified. After a {@link TetMesh} is modified, a new slicer should be
+ * constructed.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.12
+ */
+public class TetMeshSlicer {
+
+  /**
+   * Constructs a slicer for the specified tet mesh. Nodes are indexed
+   * in the order of iteration by {@link TetMesh#getNodes()}.
+   * @param mesh the tet mesh.
+   */
+  public TetMeshSlicer(TetMesh mesh) {
+    this(new CompactTetMesh(mesh));
+  }
+
+  /**
+   * Constructs a slicer for the specified compact tet mesh.
+   * @param mesh the compact tet mesh.
+   */
+  public TetMeshSlicer(CompactTetMesh mesh) {
+    _nnode = mesh.countNodes();
+    _ntet = mesh.countTets();
+    _x = mesh.getX();
+    _y = mesh.getY();
+    _z = mesh.getZ();
+    _tn = mesh.getTetNodes();
+  }
+
+  /**
+   * Returns the number of nodes in the mesh sliced.
+   * @return the number of nodes.
+   */
+  public int countNodes() {
+    return _nnode;
+  }
+
+  /**
+   * Gets triangles in the plane with specified coefficients.
+   * The plane satisfies the equation a*x+b*y+c*z+d = 0.
+   * @param a the coefficient a in the equation for the plane.
+   * @param b the coefficient b in the equation for the plane.
+   * @param c the coefficient c in the equation for the plane.
+   * @param d the coefficient d in the equation for the plane.
+   * @return array[9*ntri] of packed vertex coordinates.
+   */
+  public float[] slice(double a, double b, double c, double d) {
+    return slice(a,b,c,d,null)[0];
+  }
+
+  /**
+   * Gets triangles and interpolated values in the specified plane.
+   * The plane satisfies the equation a*x+b*y+c*z+d = 0.
+   * @param a the coefficient a in the equation for the plane.
+   * @param b the coefficient b in the equation for the plane.
+   * @param c the coefficient c in the equation for the plane.
+   * @param d the coefficient d in the equation for the plane.
+   * @param f array[nnode] of node values; null, for none.
+   * @return array {xyz,fv} of arrays, where xyz is array[9*ntri] of
+   *  packed vertex coordinates and fv is array[3*ntri] of values
+   *  interpolated from the specified node values. If the specified
+   *  node values are null, then fv is null.
+   */
+  public float[][] slice(
+    final double a, final double b, final double c, final double d,
+    float[] f)
+  {
+    final double[] g = new double[_nnode];
+    Parallel.loop(_nnode,new Parallel.LoopInt() {
+      public void compute(int i) {
+        g[i] = a*_x[i]+b*_y[i]+c*_z[i]+d;
+      }
+    });
+    return contour(g,0.0,f);
+  }
+
+  /**
+   * Gets triangles in the iso-surface with specified value.
+   * @param g array[nnode] of node values.
+   * @param giso the iso-surface value.
+   * @return array[9*ntri] of packed vertex coordinates.
+   */
+  public float[] isosurface(float[] g, float giso) {
+    return isosurface(g,giso,null)[0];
+  }
+
+  /**
+   * Gets triangles and interpolated values in the specified iso-surface.
+   * @param g array[nnode] of node values that define the iso-surface.
+   * @param giso the iso-surface value.
+   * @param f array[nnode] of node values to interpolate; null, for none.
+   * @return array {xyz,fv} of arrays, where xyz is array[9*ntri] of
+   *  packed vertex coordinates and fv is array[3*ntri] of values
+   *  interpolated from the specified node values f. If the specified
+   *  node values f are null, then fv is null.
+   */
+  public float[][] isosurface(final float[] g, float giso, float[] f) {
+    Check.argument(g.length==_nnode,"g.length equals number of nodes");
+    final double[] gd = new double[_nnode];
+    Parallel.loop(_nnode,new Parallel.LoopInt() {
+      public void compute(int i) {
+        gd[i] = g[i];
+      }
+    });
+    return contour(gd,giso,f);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NTET_CHUNK = 4096; // tets per parallel task
+
+  private int _nnode; // number of nodes
+  private int _ntet; // number of tets
+  private float[] _x,_y,_z; // node coordinates
+  private int[] _tn; // tet nodes
+
+  /**
+   * Contours node values g. In the first pass, counts triangles in each
+   * chunk of tets. In the second pass, computes triangles for each chunk,
+   * beginning at indices determined by the counts.
+   */
+  private float[][] contour(
+    final double[] g, final double giso, final float[] f)
+  {
+    Check.argument(f==null || f.length==_nnode,
+      "f.length equals number of nodes");
+    int nchunk = (_ntet+NTET_CHUNK-1)/NTET_CHUNK;
+    final int[] counts = new int[nchunk+1];
+    Parallel.loop(nchunk,new Parallel.LoopInt() {
+      public void compute(int ichunk) {
+        int jtet = ichunk*NTET_CHUNK;
+        int ktet = Math.min(jtet+NTET_CHUNK,_ntet);
+        int ntri = 0;
+        for (int itet=jtet; itet<ktet; ++itet)
+          ntri += countTriangles(g,giso,itet);
+        counts[ichunk+1] = ntri;
+      }
+    });
+    for (int ichunk=0; ichunk<nchunk; ++ichunk)
+      counts[ichunk+1] += counts[ichunk];
+    int ntri = counts[nchunk];
+    final float[] xyz = new float[9*ntri];
+    final float[] fv = (f!=null)?new float[3*ntri]:null;
+    Parallel.loop(nchunk,new Parallel.LoopInt() {
+      public void compute(int ichunk) {
+        int jtet = ichunk*NTET_CHUNK;
+        int ktet = Math.min(jtet+NTET_CHUNK,_ntet);
+        int itri = counts[ichunk];
+        int[] below = new int[4];
+        int[] above = new int[4];
+        for (int itet=jtet; itet<ktet; ++itet)
+          itri = makeTriangles(g,giso,f,itet,itri,below,above,xyz,fv);
+      }
+    });
+    return new float[][]{xyz,fv};
+  }
+
+  /**
+   * Returns the number of triangles, 0, 1 or 2, in the specified tet.
+   */
+  private int countTriangles(double[] g, double giso, int itet) {
+    int i = 4*itet;
+    int nabove = 0;
+    if (g[_tn[i  ]]>=giso) ++nabove;
+    if (g[_tn[i+1]]>=giso) ++nabove;
+    if (g[_tn[i+2]]>=giso) ++nabove;
+    if (g[_tn[i+3]]>=giso) ++nabove;
+    return (nabove==0 || nabove==4)?0:(nabove==2)?2:1;
+  }
+
+  /**
+   * Computes the triangles in the specified tet, beginning with the
+   * specified triangle index. Returns the index of the next triangle.
+   * The arrays below and above are work arrays, each with length 4.
+   */
+  private int makeTriangles(
+    double[] g, double giso, float[] f, int itet, int itri,
+    int[] below, int[] above, float[] xyz, float[] fv)
+  {
+    // Nodes below and above the iso-surface.
+    int nbelow = 0, nabove = 0;
+    for (int k=0; k<4; ++k) {
+      int j = _tn[4*itet+k];
+      if (g[j]>=giso) {
+        above[nabove++] = j;
+      } else {
+        below[nbelow++] = j;
+      }
+    }
+    if (nbelow==0 || nabove==0)
+      return itri;
+
+    // Triangles with vertices on edges between nodes below and above.
+    int b0 = below[0], b1 = below[1], b2 = below[2];
+    int a0 = above[0], a1 = above[1], a2 = above[2];
+    if (nbelow==1) {
+      makeTriangle(g,giso,f,b0,a0,b0,a1,b0,a2,itri++,xyz,fv);
+    } else if (nabove==1) {
+      makeTriangle(g,giso,f,b0,a0,b1,a0,b2,a0,itri++,xyz,fv);
+    } else {
+      makeTriangle(g,giso,f,b0,a0,b0,a1,b1,a1,itri++,xyz,fv);
+      makeTriangle(g,giso,f,b0,a0,b1,a1,b1,a0,itri++,xyz,fv);
+    }
+    return itri;
+  }
+
+  /**
+   * Computes one triangle with vertices on three edges, each specified
+   * by a node below and a node above the iso-surface. Vertices are
+   * ordered so that the triangle normal points from the node below to
+   * the node above on the first edge. Because values are linear within
+   * each tet, that is the direction in which values increase.
+   */
+  private void makeTriangle(
+    double[] g, double giso, float[] f,
+    int b0, int a0, int b1, int a1, int b2, int a2,
+    int itri, float[] xyz, float[] fv)
+  {
+    int i = 9*itri;
+    int j = 3*itri;
+    makeVertex(g,giso,f,b0,a0,i  ,j  ,xyz,fv);
+    makeVertex(g,giso,f,b1,a1,i+3,j+1,xyz,fv);
+    makeVertex(g,giso,f,b2,a2,i+6,j+2,xyz,fv);
+    float x0 = xyz[i  ], y0 = xyz[i+1], z0 = xyz[i+2];
+    float x1 = xyz[i+3], y1 = xyz[i+4], z1 = xyz[i+5];
+    float x2 = xyz[i+6], y2 = xyz[i+7], z2 = xyz[i+8];
+    float ux = x1-x0, uy = y1-y0, uz = z1-z0;
+    float vx = x2-x0, vy = y2-y0, vz = z2-z0;
+    float nx = uy*vz-uz*vy;
+    float ny = uz*vx-ux*vz;
+    float nz = ux*vy-uy*vx;
+    float dot = nx*(_x[a0]-_x[b0])+ny*(_y[a0]-_y[b0])+nz*(_z[a0]-_z[b0]);
+    if (dot<0.0f) {
+      xyz[i+3] = x2;  xyz[i+4] = y2;  xyz[i+5] = z2;
+      xyz[i+6] = x1;  xyz[i+7] = y1;  xyz[i+8] = z1;
+      if (fv!=null) {
+        float f1 = fv[j+1];
+        fv[j+1] = fv[j+2];
+        fv[j+2] = f1;
+      }
+    }
+  }
+
+  /**
+   * Computes the vertex where the iso-surface intersects the edge
+   * between nodes jb (below) and ja (above).
+   */
+  private void makeVertex(
+    double[] g, double giso, float[] f, int jb, int ja, int i, int j,
+    float[] xyz, float[] fv)
+  {
+    float t = (float)((giso-g[jb])/(g[ja]-g[jb]));
+    xyz[i  ] = _x[jb]+t*(_x[ja]-_x[jb]);
+    xyz[i+1] = _y[jb]+t*(_y[ja]-_y[jb]);
+    xyz[i+2] = _z[jb]+t*(_z[ja]-_z[jb]);
+    if (fv!=null)
+      fv[j] = f[jb]+t*(f[ja]-f[jb]);
+  }
+}
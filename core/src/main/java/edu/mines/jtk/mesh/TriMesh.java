@@ -1428,81 +1428,90 @@ public class TriMesh implements Serializable {
     // Where is the point?
     PointLocation pl = locatePoint(node._x,node._y);
 
-    // Cannot have two nodes with the same coordinates.
-    if (pl.isOnNode())
-      return false;
-
-    // Tell listeners that node will be added.
-    fireNodeWillBeAdded(node);
-
-    // The new node becomes the root node.
-    if (_nroot==null) {
-      _nroot = node;
-      _nroot._prev = _nroot._next = _nroot;
-    } else {
-      node._next = _nroot;
-      node._prev = _nroot._prev;
-      _nroot._prev._next = node;
-      _nroot._prev = node;
-      _nroot = node;
-    }
-    ++_nnode;
-
-    // Update node property values so they are consistent with this mesh.
-    updatePropertyValues(node);
-
-    // Maintain adequate sampling of O(N^(1/3)) nodes for fast point location.
-    // The scale factor 0.45 was used by Shewchuk, 1997.
-    double factor = 0.45*_sampledNodes.size();
-    if (factor*factor*factor<_nnode) {
-      _sampledNodes.add(node);
-      //trace("addNode: sampling "+_sampledNodes.size()+" nodes");
-    }
-
-    // If we do not yet have a tri, perhaps we have enough nodes to make one.
-    if (pl.isOutside() && _nnode<=3) {
-      if (_nnode==3)
-        createFirstTri();
-
-    // Otherwise, if we have at least one tri, ...
-    } else {
-
-      // Get the set of Delaunay edges that bound the star-shaped 
-      // polygon containing all tris that are not Delaunay with 
-      // respect to the new node.
-      clearTriMarks();
-      _edgeSet.clear();
-      if (pl.isInside()) {
-        getDelaunayEdgesInside(node,pl.tri());
-      } else {
-        getDelaunayEdgesOutside(node,pl.tri());
-      }
-
-      // With each Delaunay edge in the set, create a new tri with 
-      // the new node. Use a node set to link tris when a tri and 
-      // its nabor have been created.
-      _nodeSet.clear();
-      for (boolean more=_edgeSet.first(); more; more=_edgeSet.next()) {
-        Node a = _edgeSet.a;
-        Node b = _edgeSet.b;
-        Node c = _edgeSet.c;
-        Tri abc = _edgeSet.abc;
-        Tri nba = makeTri(node,b,a);
-        linkTris(nba,node,abc,c);
-        if (!_nodeSet.add(a,b,nba))
-          linkTris(_nodeSet.nba,_nodeSet.b,nba,b);
-        if (!_nodeSet.add(b,a,nba))
-          linkTris(_nodeSet.nba,_nodeSet.b,nba,a);
-      }
-    }
+    // Add the node at that location.
+    return addNode(node,pl);
+  }
 
-    if (DEBUG)
-      validate();
+  /**
+   * Adds the specified nodes to the mesh. Nodes with (x,y) coordinates
+   * equal to those of nodes already in the mesh are not added.
+   * <p>
+   * This method is much faster than adding the nodes one at a time with
+   * {@link #addNode(Node)}. Nodes are added in a biased randomized
+   * insertion order, with nodes in each round of insertions sorted along
+   * a space-filling curve, so that each node is located by a short walk
+   * from the tri most recently created. The mesh is locked only once for
+   * all nodes. Node listeners, if any, are notified as each node is added.
+   * @param nodes array of nodes to add.
+   * @return the number of nodes added.
+   */
+  public synchronized int addNodes(Node[] nodes) {
+    int n = nodes.length;
+    float[] x = new float[n];
+    float[] y = new float[n];
+    for (int i=0; i<n; ++i) {
+      x[i] = nodes[i].x();
+      y[i] = nodes[i].y();
+    }
+    int[] order = SpatialOrder.brio(x,y,new Random(n));
+    int nadded = 0;
+    for (int i=0; i<n; ++i) {
+      Node node = nodes[order[i]];
+      PointLocation pl = (_troot!=null) ?
+        locatePoint(_troot,node._x,node._y) :
+        locatePoint(node._x,node._y);
+      if (addNode(node,pl))
+        ++nadded;
+    }
+    return nadded;
+  }
 
-    // Tell listeners that node has been added.
-    fireNodeAdded(node);
+  /**
+   * Adds nodes with specified coordinates to the mesh.
+   * Like the method {@link #addNodes(Node[])}, but constructs the nodes.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @return array of nodes constructed; null elements correspond to
+   *  nodes not added, because the mesh already contained a node with
+   *  the same coordinates.
+   */
+  public synchronized Node[] addNodes(float[] x, float[] y) {
+    int n = x.length;
+    Check.argument(y.length==n,"y.length equals x.length");
+    Node[] nodes = new Node[n];
+    for (int i=0; i<n; ++i)
+      nodes[i] = new Node(x[i],y[i]);
+    addNodes(nodes);
+    for (int i=0; i<n; ++i) {
+      if (nodes[i]._next==null)
+        nodes[i] = null;
+    }
+    return nodes;
+  }
 
-    return true;
+  /**
+   * Adds nodes with specified coordinates to this mesh, using multiple
+   * threads. Points are partitioned into spatial regions, which are
+   * meshed in parallel, and then stitched together. For points in
+   * general position, the resulting mesh is the same as that constructed
+   * by {@link #addNodes(float[], float[])}.
+   * For degenerate (e.g., cocircular) points, for which the Delaunay mesh
+   * is not unique, the stitched mesh is checked for overlaps and holes,
+   * and if any are found the nodes are instead added serially.
+   * <p>
+   * Parallel construction is used only if this mesh is empty and the
+   * number of nodes is large enough to benefit from multiple threads.
+   * Otherwise, this method is equivalent to that method. Node listeners,
+   * if any, are notified before and after all nodes are added.
+   * @param x array of x coordinates.
+   * @param y array of y coordinates.
+   * @return array of nodes constructed; null elements correspond to
+   *  nodes not added, because another node had the same coordinates.
+   */
+  public synchronized Node[] addNodesParallel(float[] x, float[] y) {
+    if (_nnode>0)
+      return addNodes(x,y);
+    return ParallelDelaunay.addNodes(this,x,y);
   }
 
   /**
@@ -2474,6 +2483,184 @@ public class TriMesh implements Serializable {
   }
   */
 
+  /**
+   * Builds this empty mesh from nodes and tris specified by indices.
+   * For each tri, the array tn contains indices of its nodes A, B and C,
+   * and the array tt contains indices of its tri nabors A, B and C, with
+   * -1 for null nabors. Nodes are linked in the order specified.
+   * Returns the tris, in the order specified.
+   */
+  Tri[] build(Node[] nodes, int[] tn, int[] tt) {
+    Check.state(_nnode==0,"mesh is empty");
+    int nnode = nodes.length;
+    int ntri = tn.length/3;
+    for (int inode=0; inode<nnode; ++inode)
+      fireNodeWillBeAdded(nodes[inode]);
+    for (int inode=0; inode<nnode; ++inode) {
+      Node node = nodes[inode];
+      node._prev = nodes[(inode+nnode-1)%nnode];
+      node._next = nodes[(inode+1)%nnode];
+      updatePropertyValues(node);
+    }
+    _nroot = (nnode>0)?nodes[0]:null;
+    _nnode = nnode;
+    Tri[] tris = new Tri[ntri];
+    for (int itri=0,j=0; itri<ntri; ++itri,j+=3)
+      tris[itri] = new Tri(nodes[tn[j]],nodes[tn[j+1]],nodes[tn[j+2]]);
+    for (int itri=0,j=0; itri<ntri; ++itri,j+=3) {
+      Tri tri = tris[itri];
+      tri._t0 = (tt[j  ]>=0)?tris[tt[j  ]]:null;
+      tri._t1 = (tt[j+1]>=0)?tris[tt[j+1]]:null;
+      tri._t2 = (tt[j+2]>=0)?tris[tt[j+2]]:null;
+    }
+    _ntri = ntri;
+    _troot = (ntri>0)?tris[0]:null;
+    if (nnode<16) {
+      for (int inode=0; inode<nnode; ++inode)
+        _sampledNodes.add(nodes[inode]);
+    } else {
+      sampleNodes();
+    }
+    if (DEBUG)
+      validate();
+    for (int inode=0; inode<nnode; ++inode)
+      fireNodeAdded(nodes[inode]);
+    return tris;
+  }
+
+  /**
+   * Gets indices of tri nodes and tri nabors, the inverse of building.
+   * Nodes are indexed by their positions in the specified array, which
+   * must contain all nodes in this mesh. Tris are indexed in the order
+   * in which they are visited by an iterator from {@link #getTris()}.
+   * Like that iterator, this method clears all node and tri marks.
+   * @param nodes array of nodes; null elements are ignored.
+   * @param tn array[3*ntri] of indices of nodes A, B and C.
+   * @param tt array[3*ntri] of indices of tri nabors A, B and C;
+   *  -1 for null nabors.
+   * @return array of tris, in the order indexed.
+   */
+  synchronized Tri[] getIndices(Node[] nodes, int[] tn, int[] tt) {
+
+    // Temporarily use node and tri marks as indices.
+    int nnode = nodes.length;
+    for (int inode=0; inode<nnode; ++inode)
+      if (nodes[inode]!=null)
+        nodes[inode]._mark = inode;
+    Tri[] tris = new Tri[_ntri];
+    TriIterator ti = getTris();
+    for (int itri=0; ti.hasNext(); ++itri) {
+      tris[itri] = ti.next();
+      tris[itri]._mark = itri;
+    }
+    for (int itri=0,j=0; itri<_ntri; ++itri,j+=3) {
+      Tri tri = tris[itri];
+      tn[j  ] = tri._n0._mark;
+      tn[j+1] = tri._n1._mark;
+      tn[j+2] = tri._n2._mark;
+      tt[j  ] = (tri._t0!=null)?tri._t0._mark:-1;
+      tt[j+1] = (tri._t1!=null)?tri._t1._mark:-1;
+      tt[j+2] = (tri._t2!=null)?tri._t2._mark:-1;
+    }
+
+    // Zero all marks, as when marks overflow, and then clear them.
+    for (int inode=0; inode<nnode; ++inode)
+      if (nodes[inode]!=null)
+        nodes[inode]._mark = 0;
+    for (int itri=0; itri<_ntri; ++itri)
+      tris[itri]._mark = 0;
+    _nodeMarkRed = 0;
+    _nodeMarkBlue = 0;
+    clearNodeMarks();
+    _triMarkRed = 0;
+    _triMarkBlue = 0;
+    clearTriMarks();
+    return tris;
+  }
+
+  /**
+   * Adds a node at the specified location, which must be the location
+   * of that node with respect to the current mesh.
+   */
+  private boolean addNode(Node node, PointLocation pl) {
+
+    // Cannot have two nodes with the same coordinates.
+    if (pl.isOnNode())
+      return false;
+
+    // Tell listeners that node will be added.
+    fireNodeWillBeAdded(node);
+
+    // The new node becomes the root node.
+    if (_nroot==null) {
+      _nroot = node;
+      _nroot._prev = _nroot._next = _nroot;
+    } else {
+      node._next = _nroot;
+      node._prev = _nroot._prev;
+      _nroot._prev._next = node;
+      _nroot._prev = node;
+      _nroot = node;
+    }
+    ++_nnode;
+
+    // Update node property values so they are consistent with this mesh.
+    updatePropertyValues(node);
+
+    // Maintain adequate sampling of O(N^(1/3)) nodes for fast point location.
+    // The scale factor 0.45 was used by Shewchuk, 1997.
+    double factor = 0.45*_sampledNodes.size();
+    if (factor*factor*factor<_nnode) {
+      _sampledNodes.add(node);
+      //trace("addNode: sampling "+_sampledNodes.size()+" nodes");
+    }
+
+    // If we do not yet have a tri, perhaps we have enough nodes to make one.
+    if (pl.isOutside() && _nnode<=3) {
+      if (_nnode==3)
+        createFirstTri();
+
+    // Otherwise, if we have at least one tri, ...
+    } else {
+
+      // Get the set of Delaunay edges that bound the star-shaped
+      // polygon containing all tris that are not Delaunay with
+      // respect to the new node.
+      clearTriMarks();
+      _edgeSet.clear();
+      if (pl.isInside()) {
+        getDelaunayEdgesInside(node,pl.tri());
+      } else {
+        getDelaunayEdgesOutside(node,pl.tri());
+      }
+
+      // With each Delaunay edge in the set, create a new tri with
+      // the new node. Use a node set to link tris when a tri and
+      // its nabor have been created.
+      _nodeSet.clear();
+      for (boolean more=_edgeSet.first(); more; more=_edgeSet.next()) {
+        Node a = _edgeSet.a;
+        Node b = _edgeSet.b;
+        Node c = _edgeSet.c;
+        Tri abc = _edgeSet.abc;
+        Tri nba = makeTri(node,b,a);
+        linkTris(nba,node,abc,c);
+        if (!_nodeSet.add(a,b,nba))
+          linkTris(_nodeSet.nba,_nodeSet.b,nba,b);
+        if (!_nodeSet.add(b,a,nba))
+          linkTris(_nodeSet.nba,_nodeSet.b,nba,a);
+      }
+    }
+
+    if (DEBUG)
+      validate();
+
+    // Tell listeners that node has been added.
+    fireNodeAdded(node);
+
+    return true;
+  }
+
   /**
    * Returns a new tri, possibly one resurrected from the dead.
    * Resurrection reduces the need for garbage collection of dead tris.
@@ -18,6 +18,7 @@ import static java.lang.Math.*;
 import java.util.*;
 
 import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
 
 /** 
  * A 3-D triangulated manifold oriented surface, possibly with boundary.
@@ -204,6 +205,7 @@ public class TriSurf {
     }
 
     private TetMesh.Node _meshNode;
+    private int _vertex; // index used only when getting triangles
     private Face _face; // null if node not in surface
     private Edge _edgeBefore; // non-null if on surface boundary
     private Edge _edgeAfter; // non-null if on surface boundary
@@ -744,6 +746,43 @@ public class TriSurf {
     private Face[] _a = new Face[64];
   }
 
+  /**
+   * Packed arrays of vertex indices, coordinates, and normal vectors for
+   * all faces in a surface. These arrays may be used directly to construct
+   * a {@link edu.mines.jtk.sgl.TriangleGroup}.
+   */
+  public static class Triangles {
+
+    /**
+     * Array[nv] of nodes for the vertices referenced by the triangles.
+     */
+    public final Node[] nodes;
+
+    /**
+     * Array[3*nt] of packed vertex indices. Vertices of each triangle
+     * are in CCW order as viewed from the side to which it is facing.
+     */
+    public final int[] ijk;
+
+    /**
+     * Array[3*nv] of packed vertex coordinates.
+     */
+    public final float[] xyz;
+
+    /**
+     * Array[3*nv] of packed vertex normal vectors. These are the
+     * area-weighted average normal vectors computed for each node.
+     */
+    public final float[] uvw;
+
+    private Triangles(Node[] nodes, int[] ijk, float[] xyz, float[] uvw) {
+      this.nodes = nodes;
+      this.ijk = ijk;
+      this.xyz = xyz;
+      this.uvw = uvw;
+    }
+  }
+
   /**
    * Adds the specified node to this surface, if not already present.
    * @param node the node.
@@ -763,11 +802,25 @@ public class TriSurf {
    */
   public synchronized boolean addNodes(Node[] nodes) {
     int nnode = nodes.length;
-    int nadded = 0;
-    for (int inode=0; inode<nnode; ++inode) {
-      if (_mesh.addNode(nodes[inode]._meshNode))
-        ++nadded;
-    }
+    int nadded = _mesh.addNodes(meshNodes(nodes));
+    if (nadded>0)
+      rebuild();
+    return nadded==nnode;
+  }
+
+  /**
+   * Adds the specified nodes to this surface, using multiple threads.
+   * If this surface is empty, the Delaunay tet mesh from which the
+   * surface is reconstructed is constructed by partitioning the nodes
+   * into spatial regions that are meshed in parallel and then stitched
+   * together. The reconstructed surface is the same as that for the
+   * method {@link #addNodes(Node[])}.
+   * @param nodes the nodes.
+   * @return true, if all nodes were added; false, otherwise.
+   */
+  public synchronized boolean addNodesParallel(Node[] nodes) {
+    int nnode = nodes.length;
+    int nadded = _mesh.addNodesParallel(meshNodes(nodes));
     if (nadded>0)
       rebuild();
     return nadded==nnode;
@@ -971,6 +1024,90 @@ public class TriSurf {
     return edge;
   }
 
+  /**
+   * Gets packed arrays of vertex indices, coordinates, and normal vectors
+   * for all faces in this surface. Vertices are only those nodes that are
+   * in the surface. Coordinates and normal vectors are computed using
+   * multiple threads.
+   * @return the triangles.
+   */
+  public synchronized Triangles getTriangles() {
+    final Face[] faces = _faceMap.values().toArray(new Face[0]);
+    ArrayList<Node> nodeList = new ArrayList<Node>();
+    TetMesh.NodeIterator ni = _mesh.getNodes();
+    while (ni.hasNext()) {
+      Node node = (Node)ni.next().data;
+      if (node.isInSurface()) {
+        node._vertex = nodeList.size();
+        nodeList.add(node);
+      }
+    }
+    final Node[] nodes = nodeList.toArray(new Node[0]);
+    int nt = faces.length;
+    int nv = nodes.length;
+    final int[] ijk = new int[3*nt];
+    final float[] xyz = new float[3*nv];
+    final float[] uvw = new float[3*nv];
+    Parallel.loop(nt,new Parallel.LoopInt() {
+      public void compute(int it) {
+        Face face = faces[it];
+        ijk[3*it  ] = face.nodeA()._vertex;
+        ijk[3*it+1] = face.nodeB()._vertex;
+        ijk[3*it+2] = face.nodeC()._vertex;
+      }
+    });
+    Parallel.loop(nv,new Parallel.LoopInt() {
+      public void compute(int iv) {
+        Node node = nodes[iv];
+        float[] vn = new float[3];
+        node.normalVector(vn);
+        xyz[3*iv  ] = node.x();
+        xyz[3*iv+1] = node.y();
+        xyz[3*iv+2] = node.z();
+        uvw[3*iv  ] = vn[0];
+        uvw[3*iv+1] = vn[1];
+        uvw[3*iv+2] = vn[2];
+      }
+    });
+    return new Triangles(nodes,ijk,xyz,uvw);
+  }
+
+  /**
+   * Returns the number of tets in the Delaunay mesh of this surface.
+   */
+  int countTets() {
+    return _mesh.countTets();
+  }
+
+  /**
+   * Gets indices of tet nodes and tet nabors in the Delaunay mesh of
+   * this surface. Nodes are indexed by their positions in the specified
+   * array, which must contain all nodes in this surface.
+   */
+  synchronized void getIndices(Node[] nodes, int[] tn, int[] tt) {
+    int nnode = nodes.length;
+    TetMesh.Node[] meshNodes = new TetMesh.Node[nnode];
+    for (int inode=0; inode<nnode; ++inode)
+      if (nodes[inode]!=null)
+        meshNodes[inode] = nodes[inode]._meshNode;
+    _mesh.getIndices(meshNodes,tn,tt);
+  }
+
+  /**
+   * Builds this empty surface from nodes, and from tets of its Delaunay
+   * mesh specified by indices. The surface is then reconstructed from
+   * the faces of that mesh, without recomputing the mesh.
+   */
+  synchronized void build(Node[] nodes, int[] tn, int[] tt) {
+    int nnode = nodes.length;
+    TetMesh.Node[] meshNodes = new TetMesh.Node[nnode];
+    for (int inode=0; inode<nnode; ++inode)
+      meshNodes[inode] = nodes[inode]._meshNode;
+    _mesh.build(meshNodes,tn,tt);
+    if (nnode>0)
+      rebuild();
+  }
+
   ///////////////////////////////////////////////////////////////////////////
   // private
 
@@ -1006,6 +1143,17 @@ public class TriSurf {
 
   private static final int FACE_MARK_MAX = Integer.MAX_VALUE-1;
 
+  /**
+   * Returns the mesh nodes for the specified surface nodes.
+   */
+  private static TetMesh.Node[] meshNodes(Node[] nodes) {
+    int nnode = nodes.length;
+    TetMesh.Node[] meshNodes = new TetMesh.Node[nnode];
+    for (int inode=0; inode<nnode; ++inode)
+      meshNodes[inode] = nodes[inode]._meshNode;
+    return meshNodes;
+  }
+
   // tet mesh
   private TetMesh _mesh = new TetMesh();
 
@@ -17,7 +17,7 @@ package edu.mines.jtk.mosaic;
 import java.awt.*;
 import java.awt.image.IndexColorModel;
 import java.util.ArrayList;
-import java.util.Iterator;
+import java.util.Arrays;
 
 import edu.mines.jtk.awt.ColorMap;
 import edu.mines.jtk.awt.ColorMapListener;
@@ -25,6 +25,7 @@ import edu.mines.jtk.dsp.Sampling;
 import edu.mines.jtk.util.AxisTics;
 import edu.mines.jtk.util.Check;
 import edu.mines.jtk.util.Clips;
+import edu.mines.jtk.util.Parallel;
 import edu.mines.jtk.awt.ColorMapped;
 import static edu.mines.jtk.util.ArrayMath.*;
 
@@ -105,6 +106,7 @@ public class ContoursView extends TiledView implements ColorMapped {
     updateArraySampling();
     _cs = null;
     _cl = null;
+    repaint();
   }
 
  
@@ -256,6 +258,7 @@ public class ContoursView extends TiledView implements ColorMapped {
    */
   public float[] getContours() {
     updateContourSampling();
+    updateContours();
     float[] values = new float[_cs.getCount()];
     for (int n=0; n<values.length; n++)
       values[n] = _cl.get(n).fc;
@@ -345,14 +348,20 @@ public class ContoursView extends TiledView implements ColorMapped {
   }
 
   public void paint(Graphics2D g2d) {
-
-    updateContourSampling();
-    updateContours();
-
-    // Projectors and transcaler.
     Projector hp = getHorizontalProjector();
     Projector vp = getVerticalProjector();
     Transcaler ts = getTranscaler();
+    paint(g2d,hp,vp,ts);
+  }
+
+  /**
+   * Paints this view with specified projectors and transcaler. Used by
+   * tests, which have no tile to provide these.
+   */
+  void paint(Graphics2D g2d, Projector hp, Projector vp, Transcaler ts) {
+
+    updateContourSampling();
+    updateContours();
 
     // Compute the view rectangle in pixels (device coordinates). Each sample 
     // contributes a rectangle of pixels that corresponds to an area _dx*_dy 
@@ -476,12 +485,17 @@ public class ContoursView extends TiledView implements ColorMapped {
     
     IndexColorModel cm = _colorMap.getColorModel();
 
+    // Arrays for (x,y) coordinates of the longest segment.
+    int nmax = 0;
+    for (Contour c:_cl)
+      for (int js=0; js<c.ns; ++js)
+        nmax = max(nmax,c.is[js+1]-c.is[js]);
+    int[] xcon = new int[nmax];
+    int[] ycon = new int[nmax];
+
     for (int is=0; is<_cs.getCount(); ++is) {
-      float fc = _cl.get(is).fc;
-      ArrayList<float[]> cx1 = _cl.get(is).x1;
-      ArrayList<float[]> cx2 = _cl.get(is).x2;
-      Iterator<float[]> it1 = cx1.iterator();
-      Iterator<float[]> it2 = cx2.iterator();
+      Contour c = _cl.get(is);
+      float fc = c.fc;
       // If assigning a ColorMap to the contours, then assign the values
       // of the contours to their ColorMap equivalents within a 0-255 range.
       if (cm!=null) {
@@ -500,34 +514,80 @@ public class ContoursView extends TiledView implements ColorMapped {
         if (fc>=0.0f) gline.setStroke(bs);
       }
 
-      while (it1.hasNext()) {
-        float[] xc1 = it1.next();
-        float[] xc2 = it2.next();
-        int n = xc1.length;
-        int[] xcon = new int[xc1.length];
-        int[] ycon = new int[xc2.length];
-        computeXY(hp,vp,ts,n,xc1,xc2,xcon,ycon);
+      for (int js=0; js<c.ns; ++js) {
+        int j = c.is[js];
+        int n = c.is[js+1]-j;
+        computeXY(hp,vp,ts,j,n,c.x1,c.x2,xcon,ycon);
         if (gline!=null) 
           gline.drawPolyline(xcon,ycon,n);
       }
     }
   }
   
+  /**
+   * Gets the segments of the cached contour with specified index.
+   * @param ic the index of the contour value.
+   * @return array {x1,x2} of arrays[ns][] of segment coordinates.
+   */
+  float[][][] getContour(int ic) {
+    updateContourSampling();
+    updateContours();
+    return unpack(_cl.get(ic));
+  }
+
+  /**
+   * Gets the number of times that contours have been computed for this
+   * view. Contours are computed only when not already cached.
+   */
+  int getContoursUpdateCount() {
+    return _ncu;
+  }
+
+  /**
+   * Returns segments of a contour computed with serial marking of cell
+   * edges, as a reference for contours cached by this view.
+   * @return array {x1,x2} of arrays[ns][] of segment coordinates.
+   */
+  static float[][][] makeContourSerial(
+    float fc, Sampling s1, Sampling s2, float[][] f)
+  {
+    return unpack(makeContour(fc,s1,s2,f,false));
+  }
+
   ///////////////////////////////////////////////////////////////////////////
   // private
 
+  // Coordinates of all segments of one contour are packed into two arrays
+  // x1 and x2. Segment js has points with indices is[js] <= j < is[js+1].
   private static class Contour {
     float fc; // contoured function value
-    int ns = 0; // number of segments
-    ArrayList<float[]> x1 = new ArrayList<float[]>(); // x1[] per segment
-    ArrayList<float[]> x2 = new ArrayList<float[]>(); // x2[] per segment
-    Contour (float fc) {
+    int ns; // number of segments
+    int[] is; // array[ns+1] of indices of first points of segments
+    float[] x1; // x1 for all segments
+    float[] x2; // x2 for all segments
+    Contour(float fc, IntList is, FloatList x1, FloatList x2) {
       this.fc = fc;
+      this.ns = is.n-1;
+      this.is = is.trim();
+      this.x1 = x1.trim();
+      this.x2 = x2.trim();
     }
-    void append(FloatList x1List, FloatList x2List) {
-      ++this.ns;
-      this.x1.add(x1List.trim());
-      this.x2.add(x2List.trim());
+  }
+
+  private static class IntList {
+    public int n;
+    public int[] a = new int[16];
+    public void add(int i) {
+      if (n==a.length) {
+        int[] t = new int[2*a.length];
+        for (int j=0; j<n; ++j)
+          t[j] = a[j];
+        a = t;
+      }
+      a[n++] = i;
+    }
+    public int[] trim() {
+      return copy(n,a);
     }
   }
 
@@ -586,6 +646,7 @@ public class ContoursView extends TiledView implements ColorMapped {
   private boolean _readableContours = true; // true, for readable contour vals
   private Sampling _cs; // contour sampling
   private ArrayList<Contour> _cl; // list of contours
+  private int _ncu; // number of times contours were computed
   
   /**
    * Update the clips if necessary.
@@ -725,17 +786,28 @@ public class ContoursView extends TiledView implements ColorMapped {
   }
 
   /**
-   * Updates the contours for this view.
+   * Updates the contours for this view. Contours for different values are
+   * computed in parallel, and are then cached until the sampled function
+   * or contour values change.
    */
   private void updateContours() {
     if (_cl==null) {
-      int nc = _cs.getCount();
-      _cl = new ArrayList<Contour>();
-      for (int ic=0; ic<nc; ++ic) {
-        float fc = (float)_cs.getValue(ic);
-        Contour c = makeContour(fc,_s1,_s2,_f);
-        _cl.add(c);
+      final int nc = _cs.getCount();
+      final Sampling cs = _cs;
+      final Sampling s1 = _s1;
+      final Sampling s2 = _s2;
+      final float[][] f = _f;
+      final Contour[] cl = new Contour[nc];
+      if (nc>0) {
+        Parallel.loop(nc,new Parallel.LoopInt() {
+          public void compute(int ic) {
+            float fc = (float)cs.getValue(ic);
+            cl[ic] = makeContour(fc,s1,s2,f);
+          }
+        });
       }
+      _cl = new ArrayList<Contour>(Arrays.asList(cl));
+      ++_ncu;
     }
   }
 
@@ -744,7 +816,7 @@ public class ContoursView extends TiledView implements ColorMapped {
    */
   private void computeXY(
     Projector hp, Projector vp, Transcaler ts,
-    int n, float[] x1, float[] x2, int[] x, int[] y) 
+    int j, int n, float[] x1, float[] x2, int[] x, int[] y)
   {
     ts = ts.combineWith(hp,vp);
     float[] xv,yv;
@@ -755,9 +827,9 @@ public class ContoursView extends TiledView implements ColorMapped {
       xv = x1;
       yv = x2;
     }
-    for (int i=0; i<n; ++i) {
-      x[i] = ts.x(xv[i]);
-      y[i] = ts.y(yv[i]);
+    for (int i=0; i<n; ++i,++j) {
+      x[i] = ts.x(xv[j]);
+      y[i] = ts.y(yv[j]);
     }
   }
 
@@ -778,51 +850,66 @@ public class ContoursView extends TiledView implements ColorMapped {
   /**
    * Returns a new contour for one specified function value fc.
    */
-  private static Contour makeContour(float fc, 
-    Sampling s1, Sampling s2, float[][] f)
+  private static Contour makeContour(
+    float fc, Sampling s1, Sampling s2, float[][] f)
+  {
+    boolean parallel = (long)s1.getCount()*s2.getCount()>=MARK_PARALLEL_MIN;
+    return makeContour(fc,s1,s2,f,parallel);
+  }
+
+  /**
+   * Returns a new contour for one specified function value fc. If parallel,
+   * intersections with cell edges are marked in parallel.
+   */
+  private static Contour makeContour(final float fc,
+    Sampling s1, Sampling s2, final float[][] f, boolean parallel)
   {
     int n1 = s1.getCount();
     double d1 = s1.getDelta();
     double f1 = s1.getFirst();
-    int n2 = s2.getCount();
+    final int n2 = s2.getCount();
     double d2 = s2.getDelta();
     double f2 = s2.getFirst();
     int n1m1 = n1-1;
     int n2m1 = n2-1;
     int i1,i2,is,i;
     
-    // Mark and count intersections with west and south edges of cells.
-    byte[][] flags = new byte[n2][n1];
-    int ni = 0;
-    for (i2=0; i2<n2; ++i2) {
-      for (i1=0; i1<n1; ++i1) {
-        if (i2<n2m1 && between(fc,f[i2][i1],f[i2+1][i1])) {
-          setw(i1,i2,flags);
-          ++ni;
+    // Mark and count intersections with west and south edges of cells,
+    // in parallel for blocks of rows of large grids.
+    final byte[][] flags = new byte[n2][n1];
+    int ni;
+    if (!parallel) {
+      ni = mark(fc,0,n2,f,flags);
+    } else {
+      int nb = 1+(n2-1)/MARK_ROWS;
+      ni = Parallel.reduce(nb,new Parallel.ReduceInt<Integer>() {
+        public Integer compute(int ib) {
+          int j2 = ib*MARK_ROWS;
+          return mark(fc,j2,min(n2,j2+MARK_ROWS),f,flags);
         }
-        if (i1<n1m1 && between(fc,f[i2][i1],f[i2][i1+1])) {
-          sets(i1,i2,flags);
-          ++ni;
+        public Integer combine(Integer ni1, Integer ni2) {
+          return ni1+ni2;
         }
-      }
+      });
     }
 
-    // Construct new contour.
-    Contour c = new Contour(fc);
+    // Packed coordinates of contour segments.
+    IntList js = new IntList();
+    FloatList x1 = new FloatList();
+    FloatList x2 = new FloatList();
+    js.add(0);
 
     // Append contour segments intersecting north boundary of grid.
     i2 = n2m1;
     for (i1=0,is=i1+i2*n1; i1<n1m1 && ni>0; ++i1,is+=1) {
       if (sset(i1,i2,flags)) {
         float d = delta(fc,f[i2][i1],f[i2][i1+1]);
-        FloatList x1 = new FloatList();
-        FloatList x2 = new FloatList();
         x1.add(f1+(i1+d)*d1);
         x2.add(f2+(i2  )*d2);
         clrs(i1,i2,flags);
         for (i=is-n1; i>=0; i=connect(i,fc,n1,d1,f1,n2,d2,f2,f,flags,x1,x2))
           --ni;
-        c.append(x1,x2);
+        js.add(x1.n);
       }
     }
 
@@ -831,14 +918,12 @@ public class ContoursView extends TiledView implements ColorMapped {
     for (i2=0,is=i1+i2*n1; i2<n2m1 && ni>0; ++i2,is+=n1) {
       if (wset(i1,i2,flags)) {
         float d = delta(fc,f[i2][i1],f[i2+1][i1]);
-        FloatList x1 = new FloatList();
-        FloatList x2 = new FloatList();
         x1.add(f1+(i1  )*d1);
         x2.add(f2+(i2+d)*d2);
         clrw(i1,i2,flags);
         for (i=is-1; i>=0; i=connect(i,fc,n1,d1,f1,n2,d2,f2,f,flags,x1,x2))
           --ni;
-        c.append(x1,x2);
+        js.add(x1.n);
       }
     }
 
@@ -847,14 +932,12 @@ public class ContoursView extends TiledView implements ColorMapped {
     for (i1=0,is=i1+i2*n1; i1<n1m1 && ni>0; ++i1,is+=1) {
       if (sset(i1,i2,flags)) {
         float d = delta(fc,f[i2][i1],f[i2][i1+1]);
-        FloatList x1 = new FloatList();
-        FloatList x2 = new FloatList();
         x1.add(f1+(i1+d)*d1);
         x2.add(f2+(i2  )*d2);
         clrs(i1,i2,flags);
         for (i=is; i>=0; i=connect(i,fc,n1,d1,f1,n2,d2,f2,f,flags,x1,x2))
           --ni;
-        c.append(x1,x2);
+        js.add(x1.n);
       }
     }
 
@@ -863,14 +946,12 @@ public class ContoursView extends TiledView implements ColorMapped {
     for (i2=0,is=i1+i2*n1; i2<n2m1 && ni>0; ++i2,is+=n1) {
       if (wset(i1,i2,flags)) {
         float d = delta(fc,f[i2][i1],f[i2+1][i1]);
-        FloatList x1 = new FloatList();
-        FloatList x2 = new FloatList();
         x1.add(f1+(i1  )*d1);
         x2.add(f2+(i2+d)*d2);
         clrw(i1,i2,flags);
         for (i=is; i>=0; i=connect(i,fc,n1,d1,f1,n2,d2,f2,f,flags,x1,x2))
           --ni;
-        c.append(x1,x2);
+        js.add(x1.n);
       }
     }
 
@@ -879,22 +960,69 @@ public class ContoursView extends TiledView implements ColorMapped {
       for (i1=0,is=i1+i2*n1; i1<n1m1 && ni>0; ++i1,++is) {
         if (sset(i1,i2,flags)) {
           float d = delta(fc,f[i2][i1],f[i2][i1+1]);
-          FloatList x1 = new FloatList();
-          FloatList x2 = new FloatList();
           x1.add(f1+(i1+d)*d1);
           x2.add(f2+(i2  )*d2);
           clrs(i1,i2,flags);
           for (i=is; i>=0; i=connect(i,fc,n1,d1,f1,n2,d2,f2,f,flags,x1,x2))
             --ni;
           // Close the contours...
-          x1.add(x1.a[0]);
-          x2.add(x2.a[0]);
-          c.append(x1,x2);
+          int j = js.a[js.n-1];
+          x1.add(x1.a[j]);
+          x2.add(x2.a[j]);
+          js.add(x1.n);
         } 
       }
     }
 
-    return c;
+    return new Contour(fc,js,x1,x2);
+  }
+
+  /**
+   * Returns array {x1,x2} of arrays[ns][] of coordinates of the segments
+   * of a packed contour.
+   */
+  private static float[][][] unpack(Contour c) {
+    float[][] x1 = new float[c.ns][];
+    float[][] x2 = new float[c.ns][];
+    for (int js=0; js<c.ns; ++js) {
+      int j = c.is[js];
+      int n = c.is[js+1]-j;
+      x1[js] = copy(n,j,c.x1);
+      x2[js] = copy(n,j,c.x2);
+    }
+    return new float[][][]{x1,x2};
+  }
+
+  // Minimum number of samples for which intersections are marked in
+  // parallel, and number of rows of samples in each parallel block.
+  private static final int MARK_PARALLEL_MIN = 1<<18;
+  private static final int MARK_ROWS = 64;
+
+  /**
+   * Marks intersections with west and south edges of cells (i1,i2) for
+   * j2 &lt;= i2 &lt; k2. Returns the number of intersections marked.
+   */
+  private static int mark(
+    float fc, int j2, int k2, float[][] f, byte[][] flags)
+  {
+    int n1 = f[0].length;
+    int n2 = f.length;
+    int n1m1 = n1-1;
+    int n2m1 = n2-1;
+    int ni = 0;
+    for (int i2=j2; i2<k2; ++i2) {
+      for (int i1=0; i1<n1; ++i1) {
+        if (i2<n2m1 && between(fc,f[i2][i1],f[i2+1][i1])) {
+          setw(i1,i2,flags);
+          ++ni;
+        }
+        if (i1<n1m1 && between(fc,f[i2][i1],f[i2][i1+1])) {
+          sets(i1,i2,flags);
+          ++ni;
+        }
+      }
+    }
+    return ni;
   }
 
   /**
@@ -19,6 +19,7 @@ import java.awt.image.BufferedImage;
 import java.io.FileOutputStream;
 import java.io.IOException;
 import static java.lang.Math.*;
+import java.util.ArrayList;
 import java.util.Iterator;
 import javax.imageio.*;
 import javax.imageio.metadata.IIOMetadata;
@@ -155,6 +156,44 @@ public class IPanel extends JPanel {
     throws IOException 
   {
     BufferedImage image = paintToImage((int)ceil(dpi*win));
+    writePng(image,dpi,fileName);
+  }
+
+  /**
+   * Lays out this panel and all of its descendants for a specified size.
+   * Unlike validate, this method does not require that this panel be
+   * displayable, so that a panel that is never added to a window may be
+   * painted to an image, even without a display. Because the minimum
+   * sizes of some components, such as tile axes, depend on their bounds,
+   * layout is repeated until those bounds do not change.
+   * <p>
+   * This panel must not be displayed or laid out concurrently by the
+   * Swing event dispatch thread.
+   * @param width the panel width.
+   * @param height the panel height.
+   */
+  public void layoutToSize(int width, int height) {
+    setSize(width,height);
+    ArrayList<Rectangle> bounds = null;
+    for (int pass=0; pass<LAYOUT_PASSES_MAX; ++pass) {
+      ArrayList<Rectangle> boundsNew = new ArrayList<Rectangle>();
+      layoutTree(this,boundsNew);
+      if (boundsNew.equals(bounds))
+        break;
+      bounds = boundsNew;
+    }
+  }
+
+  /**
+   * Writes an image to a PNG file with specified resolution.
+   * @param image the image.
+   * @param dpi the image resolution, in dots per inch.
+   * @param fileName the name of the file to contain the PNG image.
+   * @throws IOException when unable to save to file.
+   */
+  public static void writePng(BufferedImage image, double dpi, String fileName)
+    throws IOException
+  {
     // The two lines below are simple, but do not write resolution info to 
     // the PNG file. We want that info, especially for high-res images.
     //File file = new File(fileName);
@@ -286,4 +325,22 @@ public class IPanel extends JPanel {
     lineWidth *= scale;
     g2d.setStroke(new BasicStroke(lineWidth));
   }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int LAYOUT_PASSES_MAX = 4;
+
+  // Lays out the specified container and, recursively, its children,
+  // while appending the bounds of all descendants to the specified list.
+  private static void layoutTree(Container c, ArrayList<Rectangle> bounds) {
+    c.doLayout();
+    int nc = c.getComponentCount();
+    for (int ic=0; ic<nc; ++ic) {
+      Component ci = c.getComponent(ic);
+      bounds.add(ci.getBounds());
+      if (ci instanceof Container)
+        layoutTree((Container)ci,bounds);
+    }
+  }
 }
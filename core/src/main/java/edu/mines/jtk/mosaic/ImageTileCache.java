@@ -0,0 +1,207 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.util.HashSet;
+import java.util.Iterator;
+import java.util.LinkedHashMap;
+import java.util.Map;
+import java.util.Set;
+
+/**
+ * A cache of rasterized screen tiles for a tiled view of an image.
+ * Tiles are square arrays of pixels, aligned with the rectangle that
+ * bounds the image in device coordinates. A tile is identified by the
+ * width and height of that rectangle, which change only when the view
+ * is zoomed, and by the column and row of the tile within the rectangle,
+ * which do not change when the view is panned. Tiles painted before a
+ * pan are therefore reused after the pan.
+ * <p>
+ * Clearing this cache starts a new generation. Tiles rasterized for an
+ * older generation, perhaps by a background thread, are ignored. The
+ * least recently used tiles are discarded when the total number of
+ * cached pixels exceeds a specified maximum.
+ * <p>
+ * All methods are synchronized, so that tiles may be rasterized in
+ * multiple threads.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.24
+ */
+final class ImageTileCache {
+
+  /**
+   * The width and height of tiles, in pixels.
+   */
+  static final int SIZE = 256;
+
+  /**
+   * Identifies a tile.
+   */
+  static final class Key {
+    final int generation; // generation of the cache when key was made
+    final int w,h; // width and height of the image rectangle
+    final int kx,ky; // column and row of the tile
+
+    public boolean equals(Object obj) {
+      if (this==obj)
+        return true;
+      if (!(obj instanceof Key))
+        return false;
+      Key that = (Key)obj;
+      return generation==that.generation &&
+             w==that.w && h==that.h && kx==that.kx && ky==that.ky;
+    }
+
+    public int hashCode() {
+      int h = generation;
+      h = 31*h+this.w;
+      h = 31*h+this.h;
+      h = 31*h+kx;
+      h = 31*h+ky;
+      return h;
+    }
+
+    private Key(int generation, int w, int h, int kx, int ky) {
+      this.generation = generation;
+      this.w = w;
+      this.h = h;
+      this.kx = kx;
+      this.ky = ky;
+    }
+  }
+
+  /**
+   * Constructs a cache with the specified maximum number of pixels.
+   * @param maxPixels the maximum number of pixels in cached tiles.
+   */
+  ImageTileCache(long maxPixels) {
+    _maxPixels = maxPixels;
+  }
+
+  /**
+   * Returns the key for a tile in the current generation.
+   * @param w the width of the image rectangle.
+   * @param h the height of the image rectangle.
+   * @param kx the column of the tile.
+   * @param ky the row of the tile.
+   * @return the key.
+   */
+  synchronized Key key(int w, int h, int kx, int ky) {
+    return new Key(_generation,w,h,kx,ky);
+  }
+
+  /**
+   * Gets the pixels for the specified tile, and counts a hit or a miss.
+   * @param key the key.
+   * @return the pixels; null, if not cached.
+   */
+  synchronized Object get(Key key) {
+    Entry e = _map.get(key);
+    if (e!=null) {
+      ++_nhit;
+      return e.pixels;
+    } else {
+      ++_nmiss;
+      return null;
+    }
+  }
+
+  /**
+   * Puts the pixels for the specified tile. Does nothing if the key is
+   * from an older generation.
+   * @param key the key.
+   * @param pixels the pixels.
+   * @param npixel the number of pixels.
+   */
+  synchronized void put(Key key, Object pixels, int npixel) {
+    _pending.remove(key);
+    if (key.generation!=_generation)
+      return;
+    Entry e = _map.put(key,new Entry(pixels,npixel));
+    if (e!=null)
+      _npixel -= e.npixel;
+    _npixel += npixel;
+    Iterator<Entry> ei = _map.values().iterator();
+    while (_npixel>_maxPixels && ei.hasNext()) {
+      Entry ej = ei.next();
+      if (ej.pixels==pixels)
+        break;
+      _npixel -= ej.npixel;
+      ei.remove();
+    }
+  }
+
+  /**
+   * Marks the specified tile as being rasterized.
+   * @param key the key.
+   * @return true, if newly marked; false, if already being rasterized.
+   */
+  synchronized boolean markPending(Key key) {
+    return _pending.add(key);
+  }
+
+  /**
+   * Removes all tiles and starts a new generation.
+   */
+  synchronized void clear() {
+    ++_generation;
+    _map.clear();
+    _pending.clear();
+    _npixel = 0;
+  }
+
+  /**
+   * Gets the number of tiles cached.
+   * @return the number of tiles.
+   */
+  synchronized int size() {
+    return _map.size();
+  }
+
+  /**
+   * Gets the number of calls to get that returned cached pixels.
+   * @return the number of hits.
+   */
+  synchronized int getHitCount() {
+    return _nhit;
+  }
+
+  /**
+   * Gets the number of calls to get that found no cached pixels.
+   * @return the number of misses.
+   */
+  synchronized int getMissCount() {
+    return _nmiss;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static class Entry {
+    Object pixels;
+    int npixel;
+    Entry(Object pixels, int npixel) {
+      this.pixels = pixels;
+      this.npixel = npixel;
+    }
+  }
+
+  private long _maxPixels;
+  private long _npixel;
+  private int _generation;
+  private int _nhit,_nmiss;
+  private Map<Key,Entry> _map = new LinkedHashMap<Key,Entry>(16,0.75f,true);
+  private Set<Key> _pending = new HashSet<Key>();
+}
@@ -0,0 +1,202 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.awt.image.BufferedImage;
+import java.io.IOException;
+import java.util.concurrent.*;
+
+import edu.mines.jtk.util.Check;
+
+/**
+ * Renders panels, such as plot panels and mosaics, to images without
+ * displaying them. Panels are laid out and painted without being added
+ * to any window, so that rendering requires no display and no Swing
+ * event dispatch thread. Multiple panels may be rendered concurrently
+ * in the worker threads of a renderer.
+ * <p>
+ * Each panel must be rendered by only one thread at a time. Panels should
+ * therefore be constructed for rendering and not also be displayed. For
+ * example, to render many plots to PNG files:
+ * <pre><code>
+ * PanelRenderer pr = new PanelRenderer();
+ * for (int i=0; i&lt;n; ++i) {
+ *   PlotPanel panel = new PlotPanel();
+ *   panel.addPoints(x[i]);
+ *   pr.submitPng(panel,800,600,300.0,6.0,"plot"+i+".png");
+ * }
+ * pr.finish();
+ * </code></pre>
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.25
+ */
+public class PanelRenderer {
+
+  /**
+   * Lays out the specified panel and paints it to a new image. The image
+   * has the same aspect ratio as the panel.
+   * @param panel the panel.
+   * @param width the panel width.
+   * @param height the panel height.
+   * @param wimage the image width, in pixels.
+   * @return the image.
+   */
+  public static BufferedImage paintToImage(
+    IPanel panel, int width, int height, int wimage)
+  {
+    Check.argument(width>0,"width>0");
+    Check.argument(height>0,"height>0");
+    Check.argument(wimage>0,"wimage>0");
+    panel.layoutToSize(width,height);
+    return panel.paintToImage(wimage);
+  }
+
+  /**
+   * Lays out the specified panel and paints it to a PNG image file. The
+   * image has the same aspect ratio as the panel.
+   * @param panel the panel.
+   * @param width the panel width.
+   * @param height the panel height.
+   * @param dpi the image resolution, in dots per inch.
+   * @param win the image width, in inches.
+   * @param fileName the name of the file to contain the PNG image.
+   * @throws IOException when unable to save to file.
+   */
+  public static void paintToPng(
+    IPanel panel, int width, int height,
+    double dpi, double win, String fileName)
+    throws IOException
+  {
+    int wimage = (int)Math.ceil(dpi*win);
+    BufferedImage image = paintToImage(panel,width,height,wimage);
+    IPanel.writePng(image,dpi,fileName);
+  }
+
+  /**
+   * Constructs a renderer with one thread for each available processor.
+   */
+  public PanelRenderer() {
+    this(Runtime.getRuntime().availableProcessors());
+  }
+
+  /**
+   * Constructs a renderer with the specified number of threads.
+   * @param nthread the number of threads.
+   */
+  public PanelRenderer(int nthread) {
+    Check.argument(nthread>0,"nthread>0");
+    _executor = Executors.newFixedThreadPool(nthread,new ThreadFactory() {
+      public Thread newThread(Runnable r) {
+        Thread t = new Thread(r,"PanelRenderer");
+        t.setDaemon(true);
+        return t;
+      }
+    });
+  }
+
+  /**
+   * Submits the specified panel for rendering to a new image.
+   * @param panel the panel.
+   * @param width the panel width.
+   * @param height the panel height.
+   * @param wimage the image width, in pixels.
+   * @return the future image.
+   */
+  public Future<BufferedImage> submitImage(
+    final IPanel panel, final int width, final int height, final int wimage)
+  {
+    return submit(new Callable<BufferedImage>() {
+      public BufferedImage call() {
+        return paintToImage(panel,width,height,wimage);
+      }
+    });
+  }
+
+  /**
+   * Submits the specified panel for rendering to a PNG image file.
+   * @param panel the panel.
+   * @param width the panel width.
+   * @param height the panel height.
+   * @param dpi the image resolution, in dots per inch.
+   * @param win the image width, in inches.
+   * @param fileName the name of the file to contain the PNG image.
+   * @return the future, which yields the file name.
+   */
+  public Future<String> submitPng(
+    final IPanel panel, final int width, final int height,
+    final double dpi, final double win, final String fileName)
+  {
+    return submit(new Callable<String>() {
+      public String call() throws IOException {
+        paintToPng(panel,width,height,dpi,win,fileName);
+        return fileName;
+      }
+    });
+  }
+
+  /**
+   * Waits for all submitted panels to be rendered, and then shuts down
+   * the threads of this renderer. No panels may be submitted after this
+   * method is called.
+   * @throws RuntimeException if rendering of any panel failed.
+   */
+  public synchronized void finish() {
+    _executor.shutdown();
+    try {
+      while (_npending>0)
+        wait();
+    } catch (InterruptedException ie) {
+      Thread.currentThread().interrupt();
+      throw new RuntimeException(ie);
+    }
+    if (_failure!=null)
+      throw new RuntimeException(_failure);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private ExecutorService _executor;
+  private int _npending; // number of panels not yet rendered
+  private Throwable _failure; // first failure, if any
+
+  // This renderer keeps no references to futures. Each task only counts
+  // itself when done, so that the images of completed panels may be
+  // collected as soon as callers no longer reference them.
+  private synchronized <T> Future<T> submit(Callable<T> task) {
+    FutureTask<T> future = new FutureTask<T>(task) {
+      protected void done() {
+        taskDone(this);
+      }
+    };
+    _executor.execute(future);
+    ++_npending;
+    return future;
+  }
+
+  private synchronized void taskDone(Future<?> future) {
+    if (_failure==null && !future.isCancelled()) {
+      try {
+        future.get();
+      } catch (InterruptedException ie) {
+        Thread.currentThread().interrupt();
+      } catch (ExecutionException ee) {
+        _failure = ee.getCause();
+      }
+    }
+    --_npending;
+    notifyAll();
+  }
+}
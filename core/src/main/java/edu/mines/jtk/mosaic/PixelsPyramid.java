@@ -0,0 +1,169 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * A multi-resolution pyramid of decimated images for a sampled function
+ * f(x1,x2). Level (l1,l2) of this pyramid has ceil(n1/2^l1) samples in
+ * the 1st dimension and ceil(n2/2^l2) samples in the 2nd dimension, each
+ * sample representing a block of up to 2^l1 by 2^l2 samples in the
+ * original image, which is level (0,0). Because the two dimensions are
+ * decimated independently, a level can match the screen resolution for
+ * both axes of a view, even when those resolutions differ greatly.
+ * <p>
+ * Decimated samples are either averages of blocks (computed by repeated
+ * averaging of pairs) or the values with largest magnitudes in blocks
+ * (peaks). Peaks preserve spikes and amplitudes that averages would
+ * smooth away.
+ * <p>
+ * Levels are built lazily, when first requested, each from the nearest
+ * finer level, by halving one dimension at a time in parallel. The total
+ * memory for all levels of one dimension is less than that of the
+ * original image, and levels not requested are never built.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.23
+ */
+final class PixelsPyramid {
+
+  /**
+   * Constructs a pyramid for the specified image.
+   * @param f array[n2][n1] of sampled function values; not copied.
+   * @param peak true, for peaks; false, for means.
+   */
+  PixelsPyramid(float[][] f, boolean peak) {
+    _n1 = f[0].length;
+    _n2 = f.length;
+    _peak = peak;
+    _levels = new float[levelCount(_n1)][levelCount(_n2)][][];
+    _levels[0][0] = f;
+  }
+
+  /**
+   * Returns the number of levels required to decimate n samples to one.
+   * @param n the number of samples.
+   * @return the number of levels, including the undecimated level 0.
+   */
+  static int levelCount(int n) {
+    int nl = 1;
+    while (n>1) {
+      n = (n+1)/2;
+      ++nl;
+    }
+    return nl;
+  }
+
+  /**
+   * Returns the number of samples at the specified level.
+   * @param n the number of samples at level 0.
+   * @param l the level.
+   * @return the number of samples.
+   */
+  static int sampleCount(int n, int l) {
+    return (int)((n+(1L<<l)-1)>>l);
+  }
+
+  /**
+   * Returns the finest level with at least one sample per pixel.
+   * @param samplesPerPixel the number of samples per pixel at level 0.
+   * @param n the number of samples at level 0.
+   * @return the level.
+   */
+  static int levelFor(double samplesPerPixel, int n) {
+    int l = 0;
+    int nl = levelCount(n);
+    while (samplesPerPixel>=2.0 && l<nl-1) {
+      samplesPerPixel *= 0.5;
+      ++l;
+    }
+    return l;
+  }
+
+  /**
+   * Gets the image for the specified level, building it if necessary.
+   * @param l1 the level for the 1st dimension.
+   * @param l2 the level for the 2nd dimension.
+   * @return array[ceil(n2/2^l2)][ceil(n1/2^l1)] of decimated values;
+   *  must not be modified.
+   */
+  synchronized float[][] get(int l1, int l2) {
+    float[][] f = _levels[l1][l2];
+    if (f==null) {
+      if (l1>0 && (_levels[l1-1][l2]!=null || l2==0)) {
+        f = decimate1(get(l1-1,l2));
+      } else {
+        f = decimate2(get(l1,l2-1));
+      }
+      _levels[l1][l2] = f;
+    }
+    return f;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private int _n1,_n2; // dimensions of image at level (0,0)
+  private boolean _peak; // true, for peaks; false, for means
+  private float[][][][] _levels; // levels [l1][l2]; null if not yet built
+
+  // Halves the 1st dimension.
+  private float[][] decimate1(final float[][] f) {
+    final int n1 = f[0].length;
+    final int m1 = (n1+1)/2;
+    int n2 = f.length;
+    final float[][] g = new float[n2][m1];
+    Parallel.loop(n2,new Parallel.LoopInt() {
+      public void compute(int i2) {
+        float[] fi = f[i2];
+        float[] gi = g[i2];
+        for (int j1=0,i1=0; j1<m1; ++j1,i1+=2)
+          gi[j1] = (i1+1<n1)?combine(fi[i1],fi[i1+1]):fi[i1];
+      }
+    });
+    return g;
+  }
+
+  // Halves the 2nd dimension.
+  private float[][] decimate2(final float[][] f) {
+    final int n1 = f[0].length;
+    final int n2 = f.length;
+    int m2 = (n2+1)/2;
+    final float[][] g = new float[m2][];
+    Parallel.loop(m2,new Parallel.LoopInt() {
+      public void compute(int j2) {
+        int i2 = 2*j2;
+        if (i2+1<n2) {
+          float[] fa = f[i2];
+          float[] fb = f[i2+1];
+          float[] gj = g[j2] = new float[n1];
+          for (int i1=0; i1<n1; ++i1)
+            gj[i1] = combine(fa[i1],fb[i1]);
+        } else {
+          g[j2] = f[i2].clone();
+        }
+      }
+    });
+    return g;
+  }
+
+  private float combine(float a, float b) {
+    if (_peak) {
+      return (a*a>=b*b)?a:b;
+    } else {
+      return 0.5f*(a+b);
+    }
+  }
+}
@@ -16,6 +16,11 @@ package edu.mines.jtk.mosaic;
 
 import java.awt.*;
 import java.awt.image.*;
+import java.util.ArrayList;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.ThreadFactory;
+import javax.swing.SwingUtilities;
 
 import edu.mines.jtk.awt.*;
 import edu.mines.jtk.dsp.Sampling;
@@ -40,7 +45,8 @@ import static edu.mines.jtk.util.ArrayMath.*;
  * the view typically contains more pixels than samples, this first mapping 
  * often requires interpolation between sampled values of functions f(x1,x2). 
  * Either linear or nearest-neighbor interpolation may be specified for this 
- * first step.
+ * first step. For views with fewer pixels than samples, sampled functions
+ * may also be decimated before interpolation; see {@link Decimation}.
  * <p>
  * The second step depends on the number (one, three, or four) of sampled 
  * functions specified. For one function, the byte values are indices for 
@@ -78,6 +84,23 @@ public class PixelsView extends TiledView implements ColorMapped {
     LINEAR
   }
 
+  /**
+   * Method used to decimate samples of f(x1,x2) for zoomed-out views.
+   * When a view has fewer pixels than samples, the method NONE simply
+   * interpolates the full-resolution samples, so that pixels between
+   * them are ignored. Other methods interpolate a level of a lazily
+   * built multi-resolution pyramid, the finest level with at least one
+   * sample per pixel. The method MEAN decimates by averaging samples. The
+   * method PEAK decimates by keeping the sample with largest magnitude,
+   * so that isolated spikes and amplitudes remain visible. The default
+   * decimation method is NONE.
+   */
+  public enum Decimation {
+    NONE,
+    MEAN,
+    PEAK
+  }
+
   /**
    * Constructs a pixels view of the specified sampled function f(x1,x2).
    * Assumes zero first sample values and unit sampling intervals.
@@ -187,6 +210,8 @@ public class PixelsView extends TiledView implements ColorMapped {
     _s1 = s1;
     _s2 = s2;
     _f = copy(f);
+    _pyramids = null;
+    _tiles.clear();
     if (_clips==null) {
       _clips = new Clips[_nc];
       for (int ic=0; ic<_nc; ++ic)
@@ -208,6 +233,7 @@ public class PixelsView extends TiledView implements ColorMapped {
   public void setOrientation(Orientation orientation) {
     if (_orientation!=orientation) {
       _orientation = orientation;
+      _tiles.clear();
       updateSampling();
       repaint();
     }
@@ -228,6 +254,7 @@ public class PixelsView extends TiledView implements ColorMapped {
   public void setInterpolation(Interpolation interpolation) {
     if (_interpolation!=interpolation) {
       _interpolation = interpolation;
+      _tiles.clear();
       updateBestProjectors();
       repaint();
     }
@@ -241,6 +268,30 @@ public class PixelsView extends TiledView implements ColorMapped {
     return _interpolation;
   }
 
+  /**
+   * Sets the method for decimation of samples in zoomed-out views.
+   * With decimation, the cost of painting is proportional to the number
+   * of pixels painted, not to the number of samples; but pyramid levels
+   * require memory, up to three times that of the sampled functions.
+   * @param decimation the decimation method.
+   */
+  public void setDecimation(Decimation decimation) {
+    if (_decimation!=decimation) {
+      _decimation = decimation;
+      _pyramids = null;
+      _tiles.clear();
+      repaint();
+    }
+  }
+
+  /**
+   * Gets the method for decimation of samples in zoomed-out views.
+   * @return the decimation method.
+   */
+  public Decimation getDecimation() {
+    return _decimation;
+  }
+
   /**
    * Sets the index color model for this view. For three or four color
    * components, a direct color model is used instead of this index color 
@@ -413,14 +464,53 @@ public class PixelsView extends TiledView implements ColorMapped {
   }
 
   public void paint(Graphics2D g2d) {
-
-    // Ensure clips are correct.
-    updateClips();
-
-    // Projectors and transcaler.
     Projector hp = getHorizontalProjector();
     Projector vp = getVerticalProjector();
     Transcaler ts = getTranscaler();
+    paint(g2d,hp,vp,ts);
+  }
+
+  public ColorMap getColorMap() {
+    return _colorMap;
+  }
+
+  /**
+   * Sets whether screen tiles not yet cached are rasterized in the
+   * background. If true, then painting in the Swing event dispatch thread
+   * does not wait for those tiles, which are rasterized by worker threads
+   * and then painted by a subsequent repaint. Decimated images for
+   * zoomed-out views are likewise computed by worker threads. Painting
+   * in other threads, such as when painting to an image, always waits
+   * for all tiles. The default is false.
+   * @param background true, for background rasterization; false, otherwise.
+   */
+  public void setBackgroundRasterization(boolean background) {
+    _background = background;
+  }
+
+  /**
+   * Determines whether screen tiles are rasterized in the background.
+   * @return true, for background rasterization; false, otherwise.
+   */
+  public boolean isBackgroundRasterization() {
+    return _background;
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // package
+
+  /**
+   * Paints this view with the specified projectors and transcaler.
+   * The image is rasterized in square screen tiles, which are computed
+   * in parallel and cached, so that they may be reused when this view is
+   * repainted or panned. Tiles depend on sample values, clips, orientation,
+   * interpolation and decimation, but not on the color model, and they are
+   * discarded when any of those change.
+   */
+  void paint(Graphics2D g2d, Projector hp, Projector vp, Transcaler ts) {
+
+    // Ensure clips are correct.
+    updateClips();
 
     // Compute the view rectangle in pixels (device coordinates). Each sample 
     // contributes a rectangle of pixels that corresponds to an area _dx*_dy 
@@ -452,107 +542,111 @@ public class PixelsView extends TiledView implements ColorMapped {
     clipRect = clipRect.intersection(viewRect);
     if (clipRect.isEmpty())
       return;
-    
-    // Sample coordinates corresponding to the clip rectangle.
-    int xc = clipRect.x;
-    int yc = clipRect.y;
-    int wc = clipRect.width;
-    int hc = clipRect.height;
-    double xu = ts.x(xc);
-    double yu = ts.y(yc);
-    double wu = ts.width(wc);
-    double hu = ts.height(hc);
-    double x0 = hp.v(xu);
-    double y0 = vp.v(yu);
-    double x1 = hp.v(xu+wu);
-    double y1 = vp.v(yu+hu);
-
-    // Image pixel sampling.
-    int nx = wc;
-    int ny = hc;
-    int nxy = nx*ny;
-    double dx = (x1-x0)/max(1,nx-1);
-    double dy = (y1-y0)/max(1,ny-1);
-    double fx = x0;
-    double fy = y0;
 
-    // If only one component (using index color model) ...
-    if (_nc==1) {
-      float[][] f = _f[0];
-      float clipMin = _clipMin[0];
-      float clipMax = _clipMax[0];
-      byte[] b = (_interpolation==Interpolation.LINEAR) ?
-        interpolateImageBytesLinear(f,clipMin,clipMax,nx,dx,fx,ny,dy,fy) :
-        interpolateImageBytesNearest(f,clipMin,clipMax,nx,dx,fx,ny,dy,fy);
-      ColorModel cm = _colorMap.getColorModel();
-      DataBuffer db = new DataBufferByte(b,nxy,0);
-      int dt = DataBuffer.TYPE_BYTE;
-      int[] bm = new int[]{0xff};
-      SampleModel sm = new SinglePixelPackedSampleModel(dt,nx,ny,bm);
-      WritableRaster wr = Raster.createWritableRaster(sm,db,null);
-      BufferedImage bi = new BufferedImage(cm,wr,false,null);
-      g2d.drawImage(bi,xc,yc,null);
+    // Sample coordinates of pixel centers in the view rectangle are
+    // (xa+ix*dx,ya+iy*dy), for ix = 0, 1, ..., wd-1, and
+    // iy = 0, 1, ..., hd-1. This sampling does not change when the view
+    // is panned, and so neither do pixels in tiles aligned with the view.
+    double x0 = hp.v(ts.x(xd));
+    double y0 = vp.v(ts.y(yd));
+    final double dx = (hp.v(ts.x(xd+wd))-x0)/wd;
+    final double dy = (vp.v(ts.y(yd+hd))-y0)/hd;
+    final double xa = x0+0.5*dx;
+    final double ya = y0+0.5*dy;
+    final int w = wd;
+    final int h = hd;
+
+    // Sampled floats, possibly decimated, to be interpolated. Decimated
+    // floats are computed when first needed to rasterize a tile.
+    final Level lv = getLevel(dx,dy);
+    final float[] clipMin = copy(_clipMin);
+    final float[] clipMax = copy(_clipMax);
+
+    // If not tiled, rasterize the entire view rectangle as one image.
+    if (!_tiled) {
+      Object p = rasterize(lv,clipMin,clipMax,0,0,w,h,xa,dx,ya,dy);
+      g2d.drawImage(makeImage(p,w,h),xd,yd,null);
+      return;
     }
 
-    // else, if three or four components (using direct color model) ...
-    else {
-      byte[][] b = new byte[_nc][];
-      for (int ic=0; ic<_nc; ++ic) {
-        float[][] f = _f[ic];
-        float clipMin = _clipMin[ic];
-        float clipMax = _clipMax[ic];
-        b[ic] = (_interpolation==Interpolation.LINEAR) ?
-          interpolateImageBytesLinear(f,clipMin,clipMax,nx,dx,fx,ny,dy,fy) :
-          interpolateImageBytesNearest(f,clipMin,clipMax,nx,dx,fx,ny,dy,fy);
+    // Cached tiles that intersect the clip rectangle, and keys for those
+    // that must be rasterized.
+    int ts0 = ImageTileCache.SIZE;
+    int kx0 = (clipRect.x-xd)/ts0;
+    int ky0 = (clipRect.y-yd)/ts0;
+    int kx1 = (clipRect.x+clipRect.width-1-xd)/ts0;
+    int ky1 = (clipRect.y+clipRect.height-1-yd)/ts0;
+    int mx = 1+kx1-kx0;
+    int my = 1+ky1-ky0;
+    final Object[] pixels = new Object[mx*my];
+    final ArrayList<ImageTileCache.Key> keys =
+      new ArrayList<ImageTileCache.Key>();
+    final ArrayList<Integer> indices = new ArrayList<Integer>();
+    for (int ky=ky0,k=0; ky<=ky1; ++ky) {
+      for (int kx=kx0; kx<=kx1; ++kx,++k) {
+        ImageTileCache.Key key = _tiles.key(w,h,kx,ky);
+        pixels[k] = _tiles.get(key);
+        if (pixels[k]==null) {
+          keys.add(key);
+          indices.add(k);
+        }
       }
-      ColorModel cm;
-      int[] bm;
-      int[] i = new int[nxy];
-      if (_nc==3) {
-        cm = new DirectColorModel(24,
-          0x00ff0000,
-          0x0000ff00,
-          0x000000ff);
-        bm = new int[]{
-          0x00ff0000,
-          0x0000ff00,
-          0x000000ff,
-        };
-        byte[] b0 = b[0], b1 = b[1], b2 = b[2];
-        for (int ixy=0; ixy<nxy; ++ixy)
-          i[ixy] = ((b0[ixy]&0xff)<<16) | 
-                   ((b1[ixy]&0xff)<< 8) | 
-                   ((b2[ixy]&0xff)    );
-      } else {
-        cm = new DirectColorModel(32,
-          0x00ff0000,
-          0x0000ff00,
-          0x000000ff, 
-          0xff000000);
-        bm = new int[]{
-          0x00ff0000,
-          0x0000ff00,
-          0x000000ff,
-          0xff000000,
-        };
-        byte[] b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3];
-        for (int ixy=0; ixy<nxy; ++ixy)
-          i[ixy] = ((b3[ixy]&0xff)<<24) |
-                   ((b0[ixy]&0xff)<<16) | 
-                   ((b1[ixy]&0xff)<< 8) | 
-                   ((b2[ixy]&0xff)    );
+    }
+
+    // Rasterize missing tiles, either in the background, while painting
+    // only those tiles already cached, or in parallel, now.
+    int nkey = keys.size();
+    if (_background && SwingUtilities.isEventDispatchThread()) {
+      for (final ImageTileCache.Key key:keys) {
+        if (_tiles.markPending(key)) {
+          getExecutor().execute(new Runnable() {
+            public void run() {
+              Object p = rasterize(lv,clipMin,clipMax,w,h,xa,dx,ya,dy,key);
+              _tiles.put(key,p,countPixels(p));
+              repaint();
+            }
+          });
+        }
+      }
+    } else if (nkey>0) {
+      lv.getF();
+      Parallel.loop(nkey,new Parallel.LoopInt() {
+        public void compute(int i) {
+          ImageTileCache.Key key = keys.get(i);
+          Object p = rasterize(lv,clipMin,clipMax,w,h,xa,dx,ya,dy,key);
+          _tiles.put(key,p,countPixels(p));
+          pixels[indices.get(i)] = p;
+        }
+      });
+    }
+
+    // Draw the tiles.
+    for (int ky=ky0,k=0; ky<=ky1; ++ky) {
+      for (int kx=kx0; kx<=kx1; ++kx,++k) {
+        if (pixels[k]!=null) {
+          int nx = min(ts0,w-kx*ts0);
+          int ny = min(ts0,h-ky*ts0);
+          BufferedImage bi = makeImage(pixels[k],nx,ny);
+          g2d.drawImage(bi,xd+kx*ts0,yd+ky*ts0,null);
+        }
       }
-      DataBuffer db = new DataBufferInt(i,nxy,0);
-      int dt = DataBuffer.TYPE_INT;
-      SampleModel sm = new SinglePixelPackedSampleModel(dt,nx,ny,bm);
-      WritableRaster wr = Raster.createWritableRaster(sm,db,null);
-      BufferedImage bi = new BufferedImage(cm,wr,false,null);
-      g2d.drawImage(bi,xc,yc,null);
     }
   }
 
-  public ColorMap getColorMap() {
-    return _colorMap;
+  /**
+   * Gets the cache of rasterized screen tiles.
+   */
+  ImageTileCache getTileCache() {
+    return _tiles;
+  }
+
+  /**
+   * Sets whether this view is painted in cached screen tiles. If false,
+   * the view rectangle is rasterized as one image, as a reference for
+   * testing tiled painting. The default is true.
+   */
+  void setTiled(boolean tiled) {
+    _tiled = tiled;
   }
 
   ///////////////////////////////////////////////////////////////////////////
@@ -570,6 +664,10 @@ public class PixelsView extends TiledView implements ColorMapped {
   // Interpolation method.
   private Interpolation _interpolation = Interpolation.LINEAR;
 
+  // Decimation method and pyramids, one for each component, built lazily.
+  private Decimation _decimation = Decimation.NONE;
+  private PixelsPyramid[] _pyramids;
+
   // Clips, one for each component.
   Clips[] _clips;
   float[] _clipMin;
@@ -578,6 +676,13 @@ public class PixelsView extends TiledView implements ColorMapped {
   // Color map with default gray color model.
   private ColorMap _colorMap = new ColorMap(ColorMap.GRAY);
 
+  // Cached screen tiles of bytes or packed colors, before any color model
+  // is applied, and whether to rasterize missing tiles in the background.
+  private static final long MAX_TILE_PIXELS = 1L<<24;
+  private ImageTileCache _tiles = new ImageTileCache(MAX_TILE_PIXELS);
+  private boolean _background;
+  private boolean _tiled = true;
+
   // Sampling of the function f(x1,x2) in the pixel (x,y) coordinate system. 
   private boolean _transposed;
   private boolean _xflipped;
@@ -589,6 +694,190 @@ public class PixelsView extends TiledView implements ColorMapped {
   private double _dy;
   private double _fy;
 
+  // Sampled floats for one level of decimation, with their sampling in
+  // the pixel (x,y) coordinate system. Each decimated sample is centered
+  // on the block of samples that it represents. Decimated floats are got
+  // from pyramids only when first needed, which may be in a background
+  // thread, because building a pyramid level may be costly.
+  private static class Level {
+    synchronized float[][][] getF() {
+      if (f==null) {
+        f = new float[pyramids.length][][];
+        for (int ic=0; ic<pyramids.length; ++ic)
+          f[ic] = pyramids[ic].get(l1,l2);
+      }
+      return f;
+    }
+    float[][][] f;
+    PixelsPyramid[] pyramids;
+    int l1,l2;
+    int nx;
+    double dx,fx;
+    int ny;
+    double dy,fy;
+  }
+
+  /**
+   * Gets the level of decimation for the specified sampling intervals
+   * dx and dy of pixels, in the (x,y) coordinates of samples.
+   */
+  private Level getLevel(double dx, double dy) {
+    int lx = 0;
+    int ly = 0;
+    if (_decimation!=Decimation.NONE) {
+      lx = PixelsPyramid.levelFor(abs(dx/_dx),_nx);
+      ly = PixelsPyramid.levelFor(abs(dy/_dy),_ny);
+    }
+    Level lv = new Level();
+    if (lx==0 && ly==0) {
+      lv.f = _f;
+    } else {
+      if (_pyramids==null) {
+        boolean peak = _decimation==Decimation.PEAK;
+        _pyramids = new PixelsPyramid[_nc];
+        for (int ic=0; ic<_nc; ++ic)
+          _pyramids[ic] = new PixelsPyramid(_f[ic],peak);
+      }
+      lv.pyramids = _pyramids;
+      lv.l1 = (_transposed)?ly:lx;
+      lv.l2 = (_transposed)?lx:ly;
+    }
+    int mx = 1<<lx;
+    int my = 1<<ly;
+    lv.nx = PixelsPyramid.sampleCount(_nx,lx);
+    lv.dx = _dx*mx;
+    lv.fx = _fx+0.5*(mx-1)*_dx;
+    lv.ny = PixelsPyramid.sampleCount(_ny,ly);
+    lv.dy = _dy*my;
+    lv.fy = _fy+0.5*(my-1)*_dy;
+    return lv;
+  }
+
+  // Worker threads shared by all views for background rasterization.
+  private static ExecutorService _executor;
+  private static synchronized ExecutorService getExecutor() {
+    if (_executor==null) {
+      int nthread = max(1,Runtime.getRuntime().availableProcessors()-1);
+      _executor = Executors.newFixedThreadPool(nthread,new ThreadFactory() {
+        public Thread newThread(Runnable r) {
+          Thread t = new Thread(r,"PixelsView");
+          t.setDaemon(true);
+          return t;
+        }
+      });
+    }
+    return _executor;
+  }
+
+  /**
+   * Rasterizes one screen tile in a view rectangle with width w and
+   * height h.
+   */
+  private Object rasterize(
+    Level lv, float[] clipMin, float[] clipMax,
+    int w, int h, double xa, double dx, double ya, double dy,
+    ImageTileCache.Key key)
+  {
+    int x0 = key.kx*ImageTileCache.SIZE;
+    int y0 = key.ky*ImageTileCache.SIZE;
+    int nx = min(ImageTileCache.SIZE,w-x0);
+    int ny = min(ImageTileCache.SIZE,h-y0);
+    return rasterize(lv,clipMin,clipMax,x0,y0,nx,ny,xa,dx,ya,dy);
+  }
+
+  /**
+   * Rasterizes nx*ny pixels with upper-left corner (x0,y0) in the view
+   * rectangle. Returns an array of bytes for one component, or an array
+   * of packed colors for three or four components.
+   */
+  private Object rasterize(
+    Level lv, float[] clipMin, float[] clipMax,
+    int x0, int y0, int nx, int ny,
+    double xa, double dx, double ya, double dy)
+  {
+    int nxy = nx*ny;
+    byte[][] b = new byte[_nc][];
+    for (int ic=0; ic<_nc; ++ic) {
+      float[][] f = lv.getF()[ic];
+      b[ic] = (_interpolation==Interpolation.LINEAR) ?
+        interpolateImageBytesLinear(lv,f,clipMin[ic],clipMax[ic],
+                                    x0,nx,dx,xa,y0,ny,dy,ya) :
+        interpolateImageBytesNearest(lv,f,clipMin[ic],clipMax[ic],
+                                     x0,nx,dx,xa,y0,ny,dy,ya);
+    }
+    if (_nc==1)
+      return b[0];
+    int[] i = new int[nxy];
+    if (_nc==3) {
+      byte[] b0 = b[0], b1 = b[1], b2 = b[2];
+      for (int ixy=0; ixy<nxy; ++ixy)
+        i[ixy] = ((b0[ixy]&0xff)<<16) |
+                 ((b1[ixy]&0xff)<< 8) |
+                 ((b2[ixy]&0xff)    );
+    } else {
+      byte[] b0 = b[0], b1 = b[1], b2 = b[2], b3 = b[3];
+      for (int ixy=0; ixy<nxy; ++ixy)
+        i[ixy] = ((b3[ixy]&0xff)<<24) |
+                 ((b0[ixy]&0xff)<<16) |
+                 ((b1[ixy]&0xff)<< 8) |
+                 ((b2[ixy]&0xff)    );
+    }
+    return i;
+  }
+
+  private static int countPixels(Object pixels) {
+    return (pixels instanceof byte[]) ?
+      ((byte[])pixels).length :
+      ((int[])pixels).length;
+  }
+
+  /**
+   * Makes an image from a rasterized tile. For one component, the image
+   * uses the current index color model; otherwise, a direct color model.
+   */
+  private BufferedImage makeImage(Object pixels, int nx, int ny) {
+    int nxy = nx*ny;
+    ColorModel cm;
+    DataBuffer db;
+    int dt;
+    int[] bm;
+    if (pixels instanceof byte[]) {
+      cm = _colorMap.getColorModel();
+      db = new DataBufferByte((byte[])pixels,nxy,0);
+      dt = DataBuffer.TYPE_BYTE;
+      bm = new int[]{0xff};
+    } else if (_nc==3) {
+      cm = new DirectColorModel(24,
+        0x00ff0000,
+        0x0000ff00,
+        0x000000ff);
+      db = new DataBufferInt((int[])pixels,nxy,0);
+      dt = DataBuffer.TYPE_INT;
+      bm = new int[]{
+        0x00ff0000,
+        0x0000ff00,
+        0x000000ff,
+      };
+    } else {
+      cm = new DirectColorModel(32,
+        0x00ff0000,
+        0x0000ff00,
+        0x000000ff,
+        0xff000000);
+      db = new DataBufferInt((int[])pixels,nxy,0);
+      dt = DataBuffer.TYPE_INT;
+      bm = new int[]{
+        0x00ff0000,
+        0x0000ff00,
+        0x000000ff,
+        0xff000000,
+      };
+    }
+    SampleModel sm = new SinglePixelPackedSampleModel(dt,nx,ny,bm);
+    WritableRaster wr = Raster.createWritableRaster(sm,db,null);
+    return new BufferedImage(cm,wr,false,null);
+  }
+
   private void checkComponent(int ic) {
     Check.argument(ic<_nc,"valid index for color component");
   }
@@ -607,6 +896,7 @@ public class PixelsView extends TiledView implements ColorMapped {
       if (_clipMin[ic]!=clipMin || _clipMax[ic]!=clipMax) {
         _clipMin[ic] = clipMin;
         _clipMax[ic] = clipMax;
+        _tiles.clear();
         if (_nc==1) {
           _colorMap.setValueRange(clipMin,clipMax);
         }
@@ -708,11 +998,13 @@ public class PixelsView extends TiledView implements ColorMapped {
    * Linear interpolation of sampled floats to image bytes. The bytes in 
    * the returned array[nx*ny] will be used as indices in a color-mapped 
    * buffered image.
+   * Pixel (ix,iy) is at (xa+(x0+ix)*dx,ya+(y0+iy)*dy), so that pixels
+   * in adjacent tiles are computed exactly as in one larger image.
    */
   private byte[] interpolateImageBytesLinear(
-    float[][] f, float clipMin, float clipMax,
-    int nx, double dx, double fx,
-    int ny, double dy, double fy)
+    Level lv, float[][] f, float clipMin, float clipMax,
+    int x0, int nx, double dx, double xa,
+    int y0, int ny, double dy, double ya)
   {
     // Array of bytes.
     byte[] b = new byte[nx*ny];
@@ -731,13 +1023,13 @@ public class PixelsView extends TiledView implements ColorMapped {
     int[] kf = new int[nx];
     float[] wf = new float[nx];
     for (int ix=0; ix<nx; ++ix) {
-      double xi = fx+ix*dx;
-      double xn = (xi-_fx)/_dx;
+      double xi = xa+(x0+ix)*dx;
+      double xn = (xi-lv.fx)/lv.dx;
       if (xn<=0.0) {
         kf[ix] = 0;
         wf[ix] = 0.0f;
-      } else if (xn>=_nx-1) {
-        kf[ix] = _nx-2;
+      } else if (xn>=lv.nx-1) {
+        kf[ix] = lv.nx-2;
         wf[ix] = 1.0f;
       } else {
         kf[ix] = (int)xn;
@@ -747,11 +1039,11 @@ public class PixelsView extends TiledView implements ColorMapped {
 
     // For all pixel y, ...
     for (int iy=0; iy<ny; ++iy) {
-      double yi = fy+iy*dy;
+      double yi = ya+(y0+iy)*dy;
 
       // Index of sample y.
-      double yn = max(0.0,min(_ny-1,(yi-_fy)/_dy));
-      int jy = max(0,min(_ny-2,(int)yn));
+      double yn = max(0.0,min(lv.ny-1,(yi-lv.fy)/lv.dy));
+      int jy = max(0,min(lv.ny-2,(int)yn));
 
       // If image y is not between current sampled y, ...
       if (jy!=jy1 || iy==0) {
@@ -761,7 +1053,7 @@ public class PixelsView extends TiledView implements ColorMapped {
           float[] temp = temp1;
           temp1 = temp2;
           temp2 = temp;
-          interpx(f,clipMin,clipMax,min(jy+1,_ny-1),nx,kf,wf,temp2);
+          interpx(lv,f,clipMin,clipMax,min(jy+1,lv.ny-1),nx,kf,wf,temp2);
         }
 
         // Else if temp1 is still useful, make it temp2 and compute temp1.
@@ -769,13 +1061,13 @@ public class PixelsView extends TiledView implements ColorMapped {
           float[] temp = temp1;
           temp1 = temp2;
           temp2 = temp;
-          interpx(f,clipMin,clipMax,jy,nx,kf,wf,temp1);
+          interpx(lv,f,clipMin,clipMax,jy,nx,kf,wf,temp1);
         }
 
         // Else compute both temp1 and temp2. */
         else {
-          interpx(f,clipMin,clipMax,             jy,nx,kf,wf,temp1);
-          interpx(f,clipMin,clipMax,min(jy+1,_ny-1),nx,kf,wf,temp2);
+          interpx(lv,f,clipMin,clipMax,             jy,nx,kf,wf,temp1);
+          interpx(lv,f,clipMin,clipMax,min(jy+1,lv.ny-1),nx,kf,wf,temp2);
         }                 
 
         // Remember index jy1 corresponding to temp1.
@@ -794,13 +1086,13 @@ public class PixelsView extends TiledView implements ColorMapped {
    * Also maps clipMin to 0.0f, and clipMax to 255.0f.
    */
   private void interpx(
-    float[][] f, float clipMin, float clipMax,
+    Level lv, float[][] f, float clipMin, float clipMax,
     int jy, int nx, int[] kf, float[] wf, float[] t) 
   {
     float fscale = 255.0f/(clipMax-clipMin);
     float fshift = clipMin;
     if (_transposed) {
-      if (_nx==1) {
+      if (lv.nx==1) {
         float fc = (f[0][jy]-fshift)*fscale;
         for (int ix=0; ix<nx; ++ix)
           t[ix] = fc;
@@ -815,7 +1107,7 @@ public class PixelsView extends TiledView implements ColorMapped {
       }
     } else {
       float[] fjy = f[jy];
-      if (_nx==1) {
+      if (lv.nx==1) {
         float f0 = (fjy[0]-fshift)*fscale;
         for (int ix=0; ix<nx; ++ix)
           t[ix] = f0;
@@ -853,11 +1145,13 @@ public class PixelsView extends TiledView implements ColorMapped {
    * Nearest-neighbor interpolation of sampled floats to image bytes. The 
    * bytes in the returned array[nx*ny] will be used as indices in a 
    * color-mapped buffered image.
+   * Pixel (ix,iy) is at (xa+(x0+ix)*dx,ya+(y0+iy)*dy), so that pixels
+   * in adjacent tiles are computed exactly as in one larger image.
    */
   private byte[] interpolateImageBytesNearest(
-    float[][] f, float clipMin, float clipMax,
-    int nx, double dx, double fx,
-    int ny, double dy, double fy)
+    Level lv, float[][] f, float clipMin, float clipMax,
+    int x0, int nx, double dx, double xa,
+    int y0, int ny, double dy, double ya)
   {
     // Array of bytes.
     byte[] b = new byte[nx*ny];
@@ -872,12 +1166,12 @@ public class PixelsView extends TiledView implements ColorMapped {
     // Precomputed indices for fast interpolation in x direction.
     int[] kf = new int[nx];
     for (int ix=0; ix<nx; ++ix) {
-      double xi = fx+ix*dx;
-      double xn = (xi-_fx)/_dx;
+      double xi = xa+(x0+ix)*dx;
+      double xn = (xi-lv.fx)/lv.dx;
       if (xn<=0.0) {
         kf[ix] = 0;
-      } else if (xn>=_nx-1) {
-        kf[ix] = _nx-1;
+      } else if (xn>=lv.nx-1) {
+        kf[ix] = lv.nx-1;
       } else {
         kf[ix] = (int)(xn+0.5);
       }
@@ -885,11 +1179,11 @@ public class PixelsView extends TiledView implements ColorMapped {
 
     // For all pixel y, ...
     for (int iy=0; iy<ny; ++iy) {
-      double yi = fy+iy*dy;
+      double yi = ya+(y0+iy)*dy;
 
       // Index of sample y.
-      double yn = max(0.0,min(_ny-1,(yi-_fy)/_dy));
-      int jy = max(0,min(_ny-1,(int)(yn+0.5)));
+      double yn = max(0.0,min(lv.ny-1,(yi-lv.fy)/lv.dy));
+      int jy = max(0,min(lv.ny-1,(int)(yn+0.5)));
 
       // If necessary, interpolate a new row of bytes.
       if (jy!=jytemp) {
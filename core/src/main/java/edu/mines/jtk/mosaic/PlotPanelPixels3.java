@@ -242,6 +242,28 @@ public class PlotPanelPixels3 extends PlotPanel {
     _p23.setInterpolation(interpolation);
   }
 
+  /**
+   * Sets the method for decimation of samples in zoomed-out views.
+   * @param decimation the decimation method.
+   */
+  public void setDecimation(PixelsView.Decimation decimation) {
+    _p12.setDecimation(decimation);
+    _p13.setDecimation(decimation);
+    _p23.setDecimation(decimation);
+  }
+
+  /**
+   * Sets whether image tiles are rasterized in the background. Because
+   * only the view of a slice that changes must be rasterized again, this
+   * mode is most useful when stepping through slices interactively.
+   * @param background true, for background rasterization; false, otherwise.
+   */
+  public void setBackgroundRasterization(boolean background) {
+    _p12.setBackgroundRasterization(background);
+    _p13.setBackgroundRasterization(background);
+    _p23.setBackgroundRasterization(background);
+  }
+
   /**
    * Sets the color of lines drawn to indicate slice locations.
    * @param color the line color; if null, no lines are drawn.
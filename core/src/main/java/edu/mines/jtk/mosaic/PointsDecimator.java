@@ -0,0 +1,256 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import edu.mines.jtk.util.Parallel;
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * Decimates points (u,w) that are too dense to be resolved when painted.
+ * Points are binned with bin widths that are powers of two not greater
+ * than the widths of pixels, so that the bins for each zoom level do not
+ * change when a view is panned. Decimation returns the increasing indices
+ * of the points to be painted.
+ * <p>
+ * For a curve, each run of consecutive points that fall in the same bin
+ * of u is reduced to at most four points: the first, last, and those with
+ * minimum and maximum w. A polyline through only those points paints the
+ * same envelope of pixels as one through all of the points in the run.
+ * For marks, only the first point in each bin of (u,w) is kept.
+ * <p>
+ * Points are decimated in parallel, in chunks of consecutive points.
+ * Runs and bins that span chunks may therefore yield a few extra points.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.26
+ */
+final class PointsDecimator {
+
+  /**
+   * Bins for one coordinate. Bin boundaries are multiples of a bin width,
+   * in either linear or log10 coordinates.
+   */
+  static final class Bins {
+
+    /**
+     * Constructs bins for the specified pixel width.
+     * @param width the width of one pixel, in linear or log10 coordinates.
+     * @param log true, for log10 coordinates; false, for linear.
+     */
+    Bins(double width, boolean log) {
+      _exponent = Math.getExponent(width);
+      _scale = Math.scalb(1.0,-_exponent);
+      _log = log;
+    }
+
+    /**
+     * Gets the exponent e of the bin width 2^e, which identifies the
+     * zoom level for these bins.
+     */
+    int getExponent() {
+      return _exponent;
+    }
+
+    /**
+     * Returns true, if these bins are in log10 coordinates.
+     */
+    boolean isLog() {
+      return _log;
+    }
+
+    /**
+     * Returns the bin for the specified coordinate. For log10 coordinates,
+     * all non-positive values fall in one bin.
+     */
+    long bin(float v) {
+      double t = v;
+      if (_log)
+        t = (v>0.0f)?log10(t):Double.NEGATIVE_INFINITY;
+      return (long)Math.floor(t*_scale);
+    }
+
+    private int _exponent;
+    private double _scale;
+    private boolean _log;
+  }
+
+  /**
+   * Determines whether bins are useful for the specified pixel width.
+   * @param width the width of one pixel.
+   * @return true, if useful; false, otherwise.
+   */
+  static boolean isBinnable(double width) {
+    return width>Double.MIN_NORMAL && width<Double.MAX_VALUE;
+  }
+
+  /**
+   * Returns indices of points that envelope a curve.
+   * @param n number of points.
+   * @param u array of coordinates u.
+   * @param w array of coordinates w.
+   * @param bu bins for coordinates u.
+   * @return array of indices of points to be kept.
+   */
+  static int[] envelope(
+    int n, final float[] u, final float[] w, final Bins bu)
+  {
+    return decimate(n,new Chunker() {
+      public int[] decimate(int i0, int i1) {
+        return envelope(i0,i1,u,w,bu);
+      }
+    });
+  }
+
+  /**
+   * Returns indices of points that mark all occupied bins.
+   * @param n number of points.
+   * @param u array of coordinates u.
+   * @param w array of coordinates w.
+   * @param bu bins for coordinates u.
+   * @param bw bins for coordinates w.
+   * @return array of indices of points to be kept.
+   */
+  static int[] cells(
+    int n, final float[] u, final float[] w, final Bins bu, final Bins bw)
+  {
+    return decimate(n,new Chunker() {
+      public int[] decimate(int i0, int i1) {
+        return cells(i0,i1,u,w,bu,bw);
+      }
+    });
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int CHUNK = 65536;
+
+  private interface Chunker {
+    public int[] decimate(int i0, int i1);
+  }
+
+  private static int[] decimate(final int n, final Chunker c) {
+    int nchunk = 1+(n-1)/CHUNK;
+    if (nchunk<=1)
+      return c.decimate(0,n);
+    final int[][] k = new int[nchunk][];
+    Parallel.loop(nchunk,new Parallel.LoopInt() {
+      public void compute(int ichunk) {
+        int i0 = ichunk*CHUNK;
+        int i1 = min(n,i0+CHUNK);
+        k[ichunk] = c.decimate(i0,i1);
+      }
+    });
+    int nk = 0;
+    for (int ichunk=0; ichunk<nchunk; ++ichunk)
+      nk += k[ichunk].length;
+    int[] kall = new int[nk];
+    for (int ichunk=0,jk=0; ichunk<nchunk; ++ichunk) {
+      System.arraycopy(k[ichunk],0,kall,jk,k[ichunk].length);
+      jk += k[ichunk].length;
+    }
+    return kall;
+  }
+
+  private static int[] envelope(
+    int i0, int i1, float[] u, float[] w, Bins bu)
+  {
+    int[] k = new int[i1-i0];
+    int nk = 0;
+    int[] r = new int[4];
+    for (int i=i0; i<i1;) {
+      long b = bu.bin(u[i]);
+      int ifirst = i;
+      int imin = i;
+      int imax = i;
+      for (++i; i<i1 && bu.bin(u[i])==b; ++i) {
+        if (w[i]<w[imin]) imin = i;
+        if (w[i]>w[imax]) imax = i;
+      }
+      int ilast = i-1;
+      r[0] = ifirst;
+      r[1] = min(imin,imax);
+      r[2] = max(imin,imax);
+      r[3] = ilast;
+      for (int ir=0; ir<4; ++ir)
+        if (ir==0 || r[ir]!=r[ir-1])
+          k[nk++] = r[ir];
+    }
+    return copy(nk,k);
+  }
+
+  private static int[] cells(
+    int i0, int i1, float[] u, float[] w, Bins bu, Bins bw)
+  {
+    int[] k = new int[i1-i0];
+    int nk = 0;
+    BinSet bs = new BinSet();
+    for (int i=i0; i<i1; ++i) {
+      if (bs.add(bu.bin(u[i]),bw.bin(w[i])))
+        k[nk++] = i;
+    }
+    return copy(nk,k);
+  }
+
+  /**
+   * A set of pairs of bins, with open addressing and linear probing.
+   */
+  private static class BinSet {
+    boolean add(long bu, long bw) {
+      if (2*(_n+1)>_bu.length)
+        grow();
+      int i = index(bu,bw,_bu.length);
+      while (_used[i]) {
+        if (_bu[i]==bu && _bw[i]==bw)
+          return false;
+        i = (i+1)&(_bu.length-1);
+      }
+      _used[i] = true;
+      _bu[i] = bu;
+      _bw[i] = bw;
+      ++_n;
+      return true;
+    }
+    private int _n;
+    private boolean[] _used = new boolean[1024];
+    private long[] _bu = new long[1024];
+    private long[] _bw = new long[1024];
+    private static int index(long bu, long bw, int length) {
+      long h = bu*0x9e3779b97f4a7c15L+bw;
+      h ^= h>>>29;
+      h *= 0xbf58476d1ce4e5b9L;
+      h ^= h>>>32;
+      return (int)h&(length-1);
+    }
+    private void grow() {
+      boolean[] used = _used;
+      long[] bu = _bu;
+      long[] bw = _bw;
+      int length = 2*used.length;
+      _used = new boolean[length];
+      _bu = new long[length];
+      _bw = new long[length];
+      for (int j=0; j<used.length; ++j) {
+        if (used[j]) {
+          int i = index(bu[j],bw[j],length);
+          while (_used[i])
+            i = (i+1)&(length-1);
+          _used[i] = true;
+          _bu[i] = bu[j];
+          _bw[i] = bw[j];
+        }
+      }
+    }
+  }
+}
@@ -16,6 +16,7 @@ package edu.mines.jtk.mosaic;
 
 import java.awt.*;
 import java.util.ArrayList;
+import java.util.HashMap;
 
 import edu.mines.jtk.dsp.Sampling;
 import edu.mines.jtk.util.Check;
@@ -434,6 +435,32 @@ public class PointsView extends TiledView {
     repaint();
   }
 
+  /**
+   * Sets whether segments with many points are decimated when painted.
+   * If true, then points that are too dense to be resolved on screen are
+   * not painted; the pixels painted for lines and marks are nearly the
+   * same, but the cost of painting is proportional to the number of
+   * pixels, not the number of points. Text labels are painted for all
+   * points. Decimation is computed in parallel and cached for the most
+   * recently painted zoom levels. The default is false.
+   * @param decimated true, for decimation; false, otherwise.
+   */
+  public void setDecimated(boolean decimated) {
+    if (_decimated!=decimated) {
+      _decimated = decimated;
+      _decimations.clear();
+      repaint();
+    }
+  }
+
+  /**
+   * Determines whether segments with many points are decimated.
+   * @return true, for decimation; false, otherwise.
+   */
+  public boolean isDecimated() {
+    return _decimated;
+  }
+
   /**
    * Sets the horizontal axis scaling.
    * @param hscale horizontal axis scaling.
@@ -447,13 +474,20 @@ public class PointsView extends TiledView {
   }
   
   public void paint(Graphics2D g2d) {
-    g2d.setRenderingHint(
-      RenderingHints.KEY_ANTIALIASING,
-      RenderingHints.VALUE_ANTIALIAS_ON);
-
     Projector hp = getHorizontalProjector();
     Projector vp = getVerticalProjector();
     Transcaler ts = getTranscaler();
+    paint(g2d,hp,vp,ts);
+  }
+
+  /**
+   * Paints this view with specified projectors and transcaler. Used by
+   * tests, which have no tile to provide these.
+   */
+  void paint(Graphics2D g2d, Projector hp, Projector vp, Transcaler ts) {
+    g2d.setRenderingHint(
+      RenderingHints.KEY_ANTIALIASING,
+      RenderingHints.VALUE_ANTIALIAS_ON);
 
     // Font size and line width from graphics context.
     float fontSize = g2d.getFont().getSize2D();
@@ -524,40 +558,47 @@ public class PointsView extends TiledView {
     int[] x = new int[_nxmax];
     int[] y = new int[_nxmax];
 
+    // Decimation for the current zoom level; null, if none.
+    Decimation dec = getDecimation(hp,vp,ts);
+
     // For all plot segments, ...
     for (int is=0; is<_ns; ++is) {
-
-      // Compute (x,y) coordinates.
       int n = _nx.get(is);
       float[] x1 = _x1.get(is);
       float[] x2 = _x2.get(is);
-      computeXY(hp,vp,ts,n,x1,x2,x,y);
 
       // Draw lines between consecutive points.
-      if (gline!=null)
-        gline.drawPolyline(x,y,n);
+      if (gline!=null) {
+        int[] k = (dec!=null)?dec.lines(is):null;
+        int m = computeXY(hp,vp,ts,n,k,x1,x2,x,y);
+        gline.drawPolyline(x,y,m);
+      }
 
       // Draw marks at points.
       if (gmark!=null) {
+        int[] k = (dec!=null)?dec.marks(is):null;
+        int m = computeXY(hp,vp,ts,n,k,x1,x2,x,y);
         if (_markStyle==Mark.POINT) {
-          paintPoint(gmark,n,x,y);
+          paintPoint(gmark,m,x,y);
         } else if (_markStyle==Mark.PLUS) {
-          paintPlus(gmark,markSize,n,x,y);
+          paintPlus(gmark,markSize,m,x,y);
         } else if (_markStyle==Mark.CROSS) {
-          paintCross(gmark,markSize,n,x,y);
+          paintCross(gmark,markSize,m,x,y);
         } else if (_markStyle==Mark.FILLED_CIRCLE) {
-          paintFilledCircle(gmark,markSize,n,x,y);
+          paintFilledCircle(gmark,markSize,m,x,y);
         } else if (_markStyle==Mark.HOLLOW_CIRCLE) {
-          paintHollowCircle(gmark,markSize,n,x,y);
+          paintHollowCircle(gmark,markSize,m,x,y);
         } else if (_markStyle==Mark.FILLED_SQUARE) {
-          paintFilledSquare(gmark,markSize,n,x,y);
+          paintFilledSquare(gmark,markSize,m,x,y);
         } else if (_markStyle==Mark.HOLLOW_SQUARE) {
-          paintHollowSquare(gmark,markSize,n,x,y);
+          paintHollowSquare(gmark,markSize,m,x,y);
         }
       }
 
-      // Draw text labels.
+      // Draw text labels, for all points, because labels of nearby
+      // points may differ.
       if (gtext!=null) {
+        computeXY(hp,vp,ts,n,null,x1,x2,x,y);
         float[] z = _x3.get(is);
         paintLabel(gtext,markSize,n,x,y,z);
       }
@@ -582,6 +623,94 @@ public class PointsView extends TiledView {
   private Color _markColor = null;
   private String _textFormat = "%1.4G";
 
+  // Decimation of segments with many points, for recent zoom levels.
+  private static final int DECIMATE_MIN = 4096;
+  private static final int DECIMATION_LEVELS = 8;
+  private boolean _decimated = false;
+  private HashMap<Long,Decimation> _decimations =
+    new HashMap<Long,Decimation>();
+
+  /**
+   * Indices of points painted for one zoom level. Indices are computed
+   * only when a segment is first painted at that level.
+   */
+  private class Decimation {
+    Decimation(PointsDecimator.Bins b1, PointsDecimator.Bins b2) {
+      _b1 = b1;
+      _b2 = b2;
+      _lines = new int[_ns][];
+      _marks = new int[_ns][];
+    }
+    int[] lines(int is) {
+      int n = _nx.get(is);
+      if (n<DECIMATE_MIN)
+        return null;
+      if (_lines[is]==null)
+        _lines[is] = PointsDecimator.envelope(n,_x1.get(is),_x2.get(is),_b1);
+      return _lines[is];
+    }
+    int[] marks(int is) {
+      int n = _nx.get(is);
+      if (n<DECIMATE_MIN)
+        return null;
+      if (_marks[is]==null)
+        _marks[is] =
+          PointsDecimator.cells(n,_x1.get(is),_x2.get(is),_b1,_b2);
+      return _marks[is];
+    }
+    private PointsDecimator.Bins _b1,_b2; // bins for x1 and x2
+    private int[][] _lines; // indices of points for lines
+    private int[][] _marks; // indices of points for marks
+  }
+
+  /**
+   * Gets the decimation for the zoom level of the specified projectors
+   * and transcaler. Returns null, if no decimation is necessary.
+   */
+  private Decimation getDecimation(
+    Projector hp, Projector vp, Transcaler ts)
+  {
+    if (!_decimated || _nxmax<DECIMATE_MIN)
+      return null;
+    double wh = pixelWidth(hp,ts.x(0),ts.x(1));
+    double wv = pixelWidth(vp,ts.y(0),ts.y(1));
+    if (!PointsDecimator.isBinnable(wh) || !PointsDecimator.isBinnable(wv))
+      return null;
+    PointsDecimator.Bins bh = new PointsDecimator.Bins(wh,hp.isLog());
+    PointsDecimator.Bins bv = new PointsDecimator.Bins(wv,vp.isLog());
+    PointsDecimator.Bins b1 = bh, b2 = bv;
+    if (_orientation==Orientation.X1DOWN_X2RIGHT) {
+      b1 = bv;
+      b2 = bh;
+    }
+    long key = ((long)(b1.getExponent()&0xffff)<<18) |
+               ((long)(b2.getExponent()&0xffff)<< 2) |
+               (b1.isLog()?2L:0L) |
+               (b2.isLog()?1L:0L);
+    Decimation dec = _decimations.get(key);
+    if (dec==null) {
+      if (_decimations.size()>=DECIMATION_LEVELS)
+        _decimations.clear();
+      dec = new Decimation(b1,b2);
+      _decimations.put(key,dec);
+    }
+    return dec;
+  }
+
+  /**
+   * Returns the width of one pixel in world coordinates, or in log10
+   * world coordinates, for a projector with a log scale.
+   */
+  private static double pixelWidth(Projector p, double u0, double u1) {
+    double v0 = p.v(u0);
+    double v1 = p.v(u1);
+    if (p.isLog()) {
+      v0 = log10(v0);
+      v1 = log10(v1);
+    }
+    return abs(v1-v0);
+  }
+
   /**
    * Called when we might new realignment.
    */
@@ -590,6 +719,8 @@ public class PointsView extends TiledView {
   }
   
   private void updateBestProjectors(AxisScale hscale, AxisScale vscale) {
+    _decimations.clear();
+
     // Min and max (x1,x2) values.
     float x1min =  FLT_MAX;
     float x2min =  FLT_MAX;
@@ -686,9 +817,9 @@ public class PointsView extends TiledView {
     return (ca==null)?cb==null:ca.equals(cb);
   }
 
-  private void computeXY(
+  private int computeXY(
     Projector hp, Projector vp, Transcaler ts,
-    int n, float[] x1, float[] x2, int[] x, int[] y) 
+    int n, int[] k, float[] x1, float[] x2, int[] x, int[] y)
   {
     ts = ts.combineWith(hp,vp);
     float[] xv = null;
@@ -702,10 +833,13 @@ public class PointsView extends TiledView {
     }
     double hLeft = Math.min(hp.v0(),hp.v1());
     double vBot = Math.min(vp.v0(),vp.v1());
-    for (int i=0; i<n; ++i) {
-      x[i] = ts.x((xv[i]<=0 && hp.getScale()==AxisScale.LOG10)?hLeft:xv[i]);
-      y[i] = ts.y((yv[i]<=0 && vp.getScale()==AxisScale.LOG10)?vBot:yv[i]);
+    int m = (k!=null)?k.length:n;
+    for (int i=0; i<m; ++i) {
+      int j = (k!=null)?k[i]:i;
+      x[i] = ts.x((xv[j]<=0 && hp.getScale()==AxisScale.LOG10)?hLeft:xv[j]);
+      y[i] = ts.y((yv[j]<=0 && vp.getScale()==AxisScale.LOG10)?vBot:yv[j]);
     }
+    return m;
   }
 
   /*
@@ -789,7 +923,7 @@ public class PointsView extends TiledView {
   }
   
   private void paintLabel(
-    Graphics2D g2d, int s, int n, int[] x, int[] y, float[] z) 
+    Graphics2D g2d, int s, int n, int[] x, int[] y, float[] z)
   {
     s /= 2;
     for (int i=0; i<n; ++i) {
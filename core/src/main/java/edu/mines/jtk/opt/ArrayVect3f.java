@@ -15,6 +15,7 @@ limitations under the License.
 package edu.mines.jtk.opt;
 
 import edu.mines.jtk.util.Almost;
+import edu.mines.jtk.util.Parallel;
 
 import java.io.IOException;
 import java.io.ObjectInputStream;
@@ -33,11 +34,18 @@ import java.util.logging.Logger;
  * prevents the mixin pattern, but you can share the wrapped array
  * as a private member of your own class,
  * and easily delegate all implemented methods.
+ * <p></p>
+ * Operations on the wrapped array are performed in parallel over
+ * its first dimension.  If a WorkspacePool is enabled, then rectangular
+ * arrays allocated by clone() are returned to that pool by dispose(),
+ * so that repeated solves need not reallocate large vectors.  In that
+ * case, do not use an array obtained from getData() after disposing of
+ * the vector that wraps it.  Pooling is disabled by default.
  *
  * @author W.S. Harlan
  */
 
-public class ArrayVect3f implements Vect {
+public class ArrayVect3f implements FusedVect {
 
     /**
      * wrapped data
@@ -49,6 +57,11 @@ public class ArrayVect3f implements Vect {
      */
     protected transient double _variance = 1.0;
 
+    /**
+     * true, if wrapped data were taken from a WorkspacePool by clone().
+     */
+    private transient boolean _pooled = false;
+
     private static final Logger LOG = Logger.getLogger("edu.mines.jtk.opt");
     private static final long serialVersionUID = 1L; // try never to change
     private static final int VERSION = 1; // compatible change in serialization
@@ -90,6 +103,7 @@ public class ArrayVect3f implements Vect {
     protected final void init(final float[][][] data, final double variance) {
         _data = data;
         _variance = variance;
+        _pooled = false;
     }
 
     /**
@@ -116,13 +130,34 @@ public class ArrayVect3f implements Vect {
         final float s1 = (float) scaleThis;
         final float s2 = (float) scaleOther;
         final ArrayVect3f rhs = (ArrayVect3f) other;
-        for (int i = 0; i < _data.length; ++i) {
-            for (int j = 0; j < _data[0].length; ++j) {
-                for (int k = 0; k < _data[0][0].length; ++k) {
-                    _data[i][j][k] = s1 * _data[i][j][k] + s2 * rhs._data[i][j][k];
-                }
+        Parallel.loop(_data.length, new Parallel.LoopInt() {
+            @Override
+            public void compute(final int i) {
+                add(s1, s2, rhs._data[i], _data[i]);
             }
-        }
+        });
+    }
+
+    // FusedVect interface
+    @Override
+    public double addAndDot(final double scaleThis, final double scaleOther,
+                            final VectConst other, final VectConst dotOther) {
+        final float s1 = (float) scaleThis;
+        final float s2 = (float) scaleOther;
+        final ArrayVect3f rhs = (ArrayVect3f) other;
+        final ArrayVect3f dhs = (ArrayVect3f) dotOther;
+        return Parallel.reduce(_data.length, new Parallel.ReduceInt<Double>() {
+            @Override
+            public Double compute(final int i) {
+                add(s1, s2, rhs._data[i], _data[i]);
+                return dot(_data[i], dhs._data[i]);
+            }
+
+            @Override
+            public Double combine(final Double d1, final Double d2) {
+                return d1 + d2;
+            }
+        });
     }
 
     // Vect interface
@@ -134,6 +169,10 @@ public class ArrayVect3f implements Vect {
     // Vect interface
     @Override
     public void dispose() {
+        if (_pooled) {
+            WorkspacePool.give(_data);
+        }
+        _pooled = false;
         _data = null;
     }
 
@@ -164,14 +203,28 @@ public class ArrayVect3f implements Vect {
     @Override
     public ArrayVect3f clone() {
         try {
-            final float[][][] newData = new float[_data.length][_data[0].length][];
-            for (int i = 0; i < newData.length; ++i) {
-                for (int j = 0; j < newData[0].length; ++j) {
-                    newData[i][j] = _data[i][j].clone();
+            final boolean pooled = WorkspacePool.isEnabled()
+                    && WorkspacePool.isRectangular(_data);
+            final float[][][] newData = pooled
+                    ? WorkspacePool.take(_data.length, _data[0].length,
+                                         _data[0][0].length)
+                    : new float[_data.length][_data[0].length][];
+            Parallel.loop(newData.length, new Parallel.LoopInt() {
+                @Override
+                public void compute(final int i) {
+                    for (int j = 0; j < newData[i].length; ++j) {
+                        if (pooled) {
+                            System.arraycopy(_data[i][j], 0, newData[i][j], 0,
+                                    newData[i][j].length);
+                        } else {
+                            newData[i][j] = _data[i][j].clone();
+                        }
+                    }
                 }
-            }
+            });
             final ArrayVect3f result = (ArrayVect3f) super.clone();
             result.init(newData, _variance);
+            result._pooled = pooled;
             return result;
         } catch (CloneNotSupportedException ex) {
             final IllegalStateException e = new IllegalStateException(ex.getMessage());
@@ -183,13 +236,40 @@ public class ArrayVect3f implements Vect {
     // VectConst interface
     @Override
     public double dot(final VectConst other) {
-        double result = 0.0;
         final ArrayVect3f rhs = (ArrayVect3f) other;
-        for (int i = 0; i < _data.length; ++i) {
-            for (int j = 0; j < _data[0].length; ++j) {
-                for (int k = 0; k < _data[0][0].length; ++k) {
-                    result += (double) _data[i][j][k] * rhs._data[i][j][k];
-                }
+        return Parallel.reduce(_data.length, new Parallel.ReduceInt<Double>() {
+            @Override
+            public Double compute(final int i) {
+                return dot(_data[i], rhs._data[i]);
+            }
+
+            @Override
+            public Double combine(final Double d1, final Double d2) {
+                return d1 + d2;
+            }
+        });
+    }
+
+    // Computes y = s1*y + s2*x for one 2D slice.
+    private static void add(final float s1, final float s2,
+                            final float[][] x, final float[][] y) {
+        for (int j = 0; j < y.length; ++j) {
+            final float[] xj = x[j];
+            final float[] yj = y[j];
+            for (int k = 0; k < yj.length; ++k) {
+                yj[k] = s1 * yj[k] + s2 * xj[k];
+            }
+        }
+    }
+
+    // Computes the dot product of one 2D slice.
+    private static double dot(final float[][] x, final float[][] y) {
+        double result = 0.0;
+        for (int j = 0; j < x.length; ++j) {
+            final float[] xj = x[j];
+            final float[] yj = y[j];
+            for (int k = 0; k < xj.length; ++k) {
+                result += (double) xj[k] * yj[k];
             }
         }
         return result;
@@ -0,0 +1,39 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+/**
+ * A differentiable scalar function of a vector, to be minimized by
+ * LbfgsSolver or NonlinearCgSolver. Each evaluation computes both the
+ * value of the function and its gradient, because most objective
+ * functions share work between the two.
+ * <p>
+ * If a solver is configured to evaluate trial steps of a line search
+ * concurrently, then this method may be called by multiple threads
+ * at once, with different arguments, and must be thread-safe.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public interface DifferentiableFunction {
+    /**
+     * Evaluate the function and its gradient for a specified vector.
+     *
+     * @param x The vector at which to evaluate; must not be modified.
+     * @param g Output gradient of the function at x; overwritten.
+     *          This vector has the same shape as x.
+     * @return The value of the function at x.
+     */
+    double evaluate(VectConst x, Vect g);
+}
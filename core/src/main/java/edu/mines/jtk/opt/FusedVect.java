@@ -0,0 +1,48 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+/**
+ * A Vect that can fuse an update with a dot product.
+ * Solvers such as conjugate gradients often add a scaled vector to
+ * another vector and then immediately compute a dot product with the
+ * result. For very large vectors, performance is limited by memory
+ * bandwidth, and combining these operations saves one pass through
+ * the vector. Use VectUtil.addAndDot() to call this method if
+ * implemented, and otherwise to call add() and dot().
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public interface FusedVect extends Vect {
+    /**
+     * Add a scaled version of another vector to a scaled version of this
+     * vector, and then return the dot product of this vector with
+     * yet another vector.
+     * Must give the same result as
+     * <pre>
+     * add(scaleThis, scaleOther, other);
+     * return dot(dotOther);
+     * </pre>
+     *
+     * @param scaleThis  Multiply this vector by this scalar before adding.
+     * @param scaleOther Multiply the other vector by this scalar before adding.
+     * @param other      The other vector to be multiplied.
+     * @param dotOther   The vector to be dotted with the result;
+     *                   may be this vector or the other vector.
+     * @return The dot product.
+     */
+    double addAndDot(double scaleThis, double scaleOther, VectConst other,
+                     VectConst dotOther);
+}
@@ -0,0 +1,248 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Monitor;
+
+import java.util.logging.Logger;
+
+/**
+ * Minimize a smooth nonlinear function with the limited-memory BFGS
+ * (L-BFGS) quasi-Newton method. The inverse Hessian is approximated
+ * by the m most recent pairs of steps s = x1-x0 and gradient changes
+ * y = g1-g0, and is applied with the two-loop recursion:
+ * <pre>
+ * q = g
+ * for i = k-1, ..., k-m:  a_i = rho_i s_i'q,  q = q - a_i y_i
+ * r = gamma q,  gamma = s'y/y'y for the newest pair
+ * for i = k-m, ..., k-1:  b = rho_i y_i'r,  r = r + (a_i-b) s_i
+ * d = -r
+ * </pre>
+ * where rho_i = 1/(y_i's_i). The pairs are kept in 2m vectors that are
+ * recycled, so that no vectors are allocated after the first m iterations.
+ * Each iteration ends with a line search that satisfies the strong Wolfe
+ * conditions, so that y's is positive and the approximate inverse
+ * Hessian remains positive-definite.
+ * <p>
+ * Usually the initial step of one is accepted, and each iteration costs
+ * only one evaluation of the function and gradient.
+ * If the function is thread-safe, setConcurrentEvaluations() lets
+ * the line search evaluate several trial steps at once.
+ * <p>
+ * Reference: Nocedal, J., and Wright, S.J., 2006, Numerical optimization,
+ * 2nd edition: Springer, Algorithm 7.4.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public class LbfgsSolver {
+    private static final Logger LOG = Logger.getLogger("edu.mines.jtk.opt");
+
+    /**
+     * Constructs a solver.
+     *
+     * @param func The function to minimize.
+     * @param m    The number of correction pairs to keep; typically 3 to 20.
+     */
+    public LbfgsSolver(final DifferentiableFunction func, final int m) {
+        Check.argument(m > 0, "m>0");
+        _func = func;
+        _m = m;
+    }
+
+    /**
+     * Set the number of trial steps that the line search may evaluate
+     * concurrently. The default is one, a serial search. Values larger
+     * than one require a thread-safe function.
+     *
+     * @param ntrial The number of concurrent trial steps.
+     */
+    public void setConcurrentEvaluations(final int ntrial) {
+        Check.argument(ntrial >= 1, "ntrial>=1");
+        _ntrial = ntrial;
+    }
+
+    /**
+     * Set the tolerance for convergence. Iterations stop when the
+     * norm of the gradient is less than this tolerance times the norm of
+     * the initial gradient. The default is 1.0e-6.
+     *
+     * @param gtol The relative gradient tolerance.
+     */
+    public void setGradientTolerance(final double gtol) {
+        Check.argument(gtol >= 0.0, "gtol>=0.0");
+        _gtol = gtol;
+    }
+
+    /**
+     * Return a new vector that minimizes the function.
+     *
+     * @param x0               The initial vector, which is not modified.
+     * @param numberIterations The maximum number of iterations.
+     * @param monitor          If non-null, then track all progress.
+     * @return The optimized vector.
+     */
+    public Vect solve(final VectConst x0, final int numberIterations,
+                      Monitor monitor) {
+        if (monitor == null) {
+            monitor = Monitor.NULL_MONITOR;
+        }
+        monitor.report(0.0);
+        final VectLineSearch search =
+                new VectLineSearch(_func, FTOL, GTOL, _ntrial);
+        final Vect x = x0.clone();
+        final Vect g = x0.clone();
+        double f = _func.evaluate(x, g);
+        _niter = 0;
+        _neval = 1;
+        _converged = false;
+
+        final double gnorm0 = Math.sqrt(g.dot(g));
+        final Vect[] s = new Vect[_m];
+        final Vect[] y = new Vect[_m];
+        final double[] rho = new double[_m];
+        final double[] alpha = new double[_m];
+        final Vect d = g.clone();
+        final Vect xp = x.clone();
+        int k = 0; // number of pairs stored
+        int newest = -1;
+        double gamma = 1.0 / Math.max(gnorm0, Double.MIN_NORMAL);
+        try {
+            while (_niter < numberIterations && !monitor.isCanceled()) {
+                final double gnorm = Math.sqrt(g.dot(g));
+                if (gnorm <= _gtol * gnorm0) {
+                    _converged = true;
+                    break;
+                }
+
+                // Two-loop recursion for d = -H g.
+                VectUtil.copy(d, g);
+                for (int l = 0; l < k; ++l) {
+                    final int i = (newest - l + _m) % _m;
+                    alpha[i] = rho[i] * s[i].dot(d);
+                    d.add(1.0, -alpha[i], y[i]);
+                }
+                VectUtil.scale(d, gamma);
+                for (int l = k - 1; l >= 0; --l) {
+                    final int i = (newest - l + _m) % _m;
+                    final double beta = rho[i] * y[i].dot(d);
+                    d.add(1.0, alpha[i] - beta, s[i]);
+                }
+                VectUtil.scale(d, -1.0);
+                if (!(d.dot(g) < 0.0)) { // not a descent direction; restart
+                    k = 0;
+                    VectUtil.copy(d, g);
+                    VectUtil.scale(d, -1.0 / gnorm);
+                }
+
+                // Line search from x along d.
+                VectUtil.copy(xp, x);
+                final int next = (newest + 1) % _m;
+                if (s[next] == null) {
+                    s[next] = g.clone();
+                    y[next] = g.clone();
+                }
+                VectUtil.copy(y[next], g);
+                final VectLineSearch.Result r = search.search(x, g, f, d, 1.0);
+                _neval += r.neval;
+                ++_niter;
+                monitor.report((double) _niter / numberIterations);
+                if (r.s == 0.0) {
+                    LOG.fine("Line search found no decrease. Stopping.");
+                    break;
+                }
+                f = r.f;
+
+                // Store the new pair, s = x1-x0, y = g1-g0.
+                VectUtil.copy(s[next], x);
+                s[next].add(1.0, -1.0, xp);
+                y[next].add(-1.0, 1.0, g);
+                final double ys = y[next].dot(s[next]);
+                if (ys > 0.0) {
+                    rho[next] = 1.0 / ys;
+                    gamma = ys / y[next].dot(y[next]);
+                    newest = next;
+                    k = Math.min(k + 1, _m);
+                } else if (k == _m) { // oldest pair was overwritten
+                    --k;
+                }
+            }
+        } finally {
+            for (int i = 0; i < _m; ++i) {
+                if (s[i] != null) {
+                    s[i].dispose();
+                    y[i].dispose();
+                }
+            }
+            d.dispose();
+            xp.dispose();
+            g.dispose();
+        }
+        _f = f;
+        monitor.report(1.0);
+        return x;
+    }
+
+    /**
+     * Get the number of iterations performed by the last solve.
+     *
+     * @return The number of iterations.
+     */
+    public int getIterationCount() {
+        return _niter;
+    }
+
+    /**
+     * Get the number of function evaluations in the last solve.
+     *
+     * @return The number of evaluations.
+     */
+    public int getEvaluationCount() {
+        return _neval;
+    }
+
+    /**
+     * Get the function value at the solution of the last solve.
+     *
+     * @return The function value.
+     */
+    public double getValue() {
+        return _f;
+    }
+
+    /**
+     * Determine whether the last solve converged to the gradient tolerance.
+     *
+     * @return true, if converged; false, otherwise.
+     */
+    public boolean converged() {
+        return _converged;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // private
+
+    private static final double FTOL = 1.0e-4;
+    private static final double GTOL = 0.9;
+
+    private final DifferentiableFunction _func;
+    private final int _m;
+    private int _ntrial = 1;
+    private double _gtol = 1.0e-6;
+    private int _niter;
+    private int _neval;
+    private double _f;
+    private boolean _converged;
+}
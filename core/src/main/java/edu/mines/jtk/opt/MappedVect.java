@@ -0,0 +1,397 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+import edu.mines.jtk.io.MappedFloatArray;
+import edu.mines.jtk.util.Almost;
+import edu.mines.jtk.util.Parallel;
+
+import java.io.File;
+import java.io.IOException;
+import java.io.ObjectInputStream;
+import java.io.ObjectOutputStream;
+import java.nio.FloatBuffer;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.logging.Logger;
+
+/**
+ * Implement a Vect as a disk-backed array of floats, for vectors
+ * too large to fit in memory.
+ * Floats are stored in a temporary memory-mapped file.
+ * Operations stream through the file in chunks, and chunks
+ * are processed in parallel.
+ * Solvers such as QuadraticSolver may thereby solve problems
+ * with more unknowns than fit in memory, provided that the
+ * Quadratic or Transform can apply its operators to these vectors.
+ * <p></p>
+ * When a vector is disposed, its file is kept in a pool, and
+ * reused by the next new vector or clone with the same size and
+ * directory.  Solvers that repeatedly clone and dispose vectors
+ * thereby reuse a few files and their mappings, instead of creating
+ * and mapping new files that are released only by the garbage
+ * collector.  Therefore, do not use an array obtained from getData()
+ * after disposing of the vector that wraps it.  Pooled files are
+ * closed and deleted by clearPool().  All temporary files, whether
+ * pooled or used by vectors not disposed, are deleted when the virtual
+ * machine exits.
+ * <p></p>
+ * Clones are stored in temporary files in the same directory.
+ * Serialization writes all values, and deserialization uses
+ * a temporary file in the default directory.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public class MappedVect implements FusedVect {
+
+    private static final Logger LOG = Logger.getLogger("edu.mines.jtk.opt");
+    private static final long serialVersionUID = 1L; // try never to change
+    private static final int CHUNK = 1 << 20; // floats per chunk
+    private static final int MAX_PER_SIZE = 8; // pooled files per size
+
+    // Arrays of disposed vectors, keyed by directory and size.
+    private static final Map<String, List<MappedFloatArray>> s_pool =
+            new HashMap<String, List<MappedFloatArray>>();
+
+    private transient MappedFloatArray _array = null;
+    private transient File _dir = null;
+    private transient double _variance = 1.0;
+
+    /**
+     * Construct a vector of zeros stored in a temporary file.
+     *
+     * @param dir      Directory for temporary files; if null, use the
+     *                 default temporary-file directory.
+     * @param size     Number of floats in the vector.
+     * @param variance This variance will be used to divide data in
+     *                 multiplyInverseCovariance.
+     */
+    public MappedVect(final File dir, final long size, final double variance) {
+        init(dir, size, variance, true);
+    }
+
+    /**
+     * Close and delete the files of all disposed vectors that are
+     * held for reuse.
+     */
+    public static void clearPool() {
+        final List<MappedFloatArray> arrays = new ArrayList<MappedFloatArray>();
+        synchronized (s_pool) {
+            for (final List<MappedFloatArray> list : s_pool.values()) {
+                arrays.addAll(list);
+            }
+            s_pool.clear();
+        }
+        for (final MappedFloatArray array : arrays) {
+            close(array);
+        }
+    }
+
+    /**
+     * Get the value of the variance passed to the constructor.
+     *
+     * @return This variance will be used to divide data in
+     *         multiplyInverseCovariance.
+     */
+    public double getVariance() {
+        return _variance;
+    }
+
+    /**
+     * Return the number of floats in this vector.
+     *
+     * @return number of floats.
+     */
+    public long getSize() {
+        return _array.size();
+    }
+
+    /**
+     * Get the embedded array of floats, for reading and writing values.
+     *
+     * @return The disk-backed array.
+     */
+    public MappedFloatArray getData() {
+        return _array;
+    }
+
+    // Vect interface
+    @Override
+    public void add(final double scaleThis, final double scaleOther, final VectConst other) {
+        addAndDot(scaleThis, scaleOther, other, null);
+    }
+
+    // FusedVect interface
+    @Override
+    public double addAndDot(final double scaleThis, final double scaleOther,
+                            final VectConst other, final VectConst dotOther) {
+        final float s1 = (float) scaleThis;
+        final float s2 = (float) scaleOther;
+        final MappedFloatArray x = ((MappedVect) other)._array;
+        final MappedFloatArray y = _array;
+        final MappedFloatArray z = (dotOther != null) ? ((MappedVect) dotOther)._array : null;
+        return reduce(new Chunk() {
+            @Override
+            public double compute(final long i, final int n) {
+                final FloatBuffer yb = segment(y, i);
+                final FloatBuffer xb = segment(x, i);
+                final FloatBuffer zb = (z != null) ? segment(z, i) : null;
+                final int k = offset(i);
+                double sum = 0.0;
+                for (int j = k; j < k + n; ++j) {
+                    final float yj = s1 * yb.get(j) + s2 * xb.get(j);
+                    yb.put(j, yj);
+                    if (zb != null) {
+                        sum += (double) yj * zb.get(j);
+                    }
+                }
+                return sum;
+            }
+        });
+    }
+
+    // Vect interface
+    @Override
+    public void project(final double scaleThis, final double scaleOther, final VectConst other) {
+        add(scaleThis, scaleOther, other);
+    }
+
+    // Vect interface
+    @Override
+    public void dispose() {
+        if (_array != null) {
+            give(_dir, _array);
+            _array = null;
+        }
+    }
+
+    // Vect interface
+    @Override
+    public void multiplyInverseCovariance() {
+        final double scale = Almost.FLOAT.divide(1.0, getSize() * _variance, 0.0);
+        VectUtil.scale(this, scale);
+    }
+
+    // VectConst interface
+    @Override
+    public double magnitude() {
+        return Almost.FLOAT.divide(dot(this), getSize() * _variance, 0.0);
+    }
+
+    // Vect interface
+    @Override
+    public void constrain() {
+    }
+
+    // Vect interface
+    @Override
+    public void postCondition() {
+    }
+
+    // VectConst interface
+    @Override
+    public MappedVect clone() {
+        try {
+            final MappedVect result = (MappedVect) super.clone();
+            result.init(_dir, getSize(), _variance, false);
+            final MappedFloatArray x = _array;
+            final MappedFloatArray y = result._array;
+            reduce(new Chunk() {
+                @Override
+                public double compute(final long i, final int n) {
+                    final FloatBuffer xb = segment(x, i);
+                    final FloatBuffer yb = segment(y, i);
+                    final int k = offset(i);
+                    xb.limit(k + n).position(k);
+                    yb.position(k);
+                    yb.put(xb);
+                    return 0.0;
+                }
+            });
+            return result;
+        } catch (CloneNotSupportedException ex) {
+            final IllegalStateException e = new IllegalStateException(ex.getMessage());
+            e.initCause(ex);
+            throw e;
+        }
+    }
+
+    // VectConst interface
+    @Override
+    public double dot(final VectConst other) {
+        final MappedFloatArray x = _array;
+        final MappedFloatArray y = ((MappedVect) other)._array;
+        return reduce(new Chunk() {
+            @Override
+            public double compute(final long i, final int n) {
+                final FloatBuffer xb = segment(x, i);
+                final FloatBuffer yb = segment(y, i);
+                final int k = offset(i);
+                double sum = 0.0;
+                for (int j = k; j < k + n; ++j) {
+                    sum += (double) xb.get(j) * yb.get(j);
+                }
+                return sum;
+            }
+        });
+    }
+
+    @Override
+    public String toString() {
+        return "MappedVect[size=" + getSize() + ", file=" + _array.getFile() + "]";
+    }
+
+    // Computes something for one chunk of floats. Chunks never span
+    // more than one mapped segment, so each chunk is computed directly
+    // in the mapped buffers, without copying floats to arrays.
+    private interface Chunk {
+        double compute(long i, int n);
+    }
+
+    // If zero, values in a reused file are set to zero; otherwise,
+    // those values are arbitrary.
+    private void init(final File dir, final long size, final double variance,
+                      final boolean zero) {
+        _dir = dir;
+        _variance = variance;
+        _array = take(dir, size);
+        if (_array != null) {
+            if (zero) {
+                final MappedFloatArray y = _array;
+                reduce(new Chunk() {
+                    @Override
+                    public double compute(final long i, final int n) {
+                        final FloatBuffer yb = segment(y, i);
+                        final int k = offset(i);
+                        for (int j = k; j < k + n; ++j) {
+                            yb.put(j, 0.0f);
+                        }
+                        return 0.0;
+                    }
+                });
+            }
+            return;
+        }
+        try {
+            _array = MappedFloatArray.createTemp(dir, size);
+        } catch (IOException ex) {
+            final IllegalStateException e = new IllegalStateException(ex.getMessage());
+            e.initCause(ex);
+            throw e;
+        }
+    }
+
+    private static String key(final File dir, final long size) {
+        return ((dir != null) ? dir.getAbsolutePath() : "") + ":" + size;
+    }
+
+    // Takes an array from the pool, or returns null if none is available.
+    private static MappedFloatArray take(final File dir, final long size) {
+        synchronized (s_pool) {
+            final List<MappedFloatArray> list = s_pool.get(key(dir, size));
+            return (list != null && !list.isEmpty())
+                    ? list.remove(list.size() - 1) : null;
+        }
+    }
+
+    // Gives an array to the pool, or closes it if the pool is full.
+    private static void give(final File dir, final MappedFloatArray array) {
+        synchronized (s_pool) {
+            final String key = key(dir, array.size());
+            List<MappedFloatArray> list = s_pool.get(key);
+            if (list == null) {
+                list = new ArrayList<MappedFloatArray>();
+                s_pool.put(key, list);
+            }
+            if (list.size() < MAX_PER_SIZE) {
+                list.add(array);
+                return;
+            }
+        }
+        close(array);
+    }
+
+    private static void close(final MappedFloatArray array) {
+        try {
+            array.close();
+        } catch (IOException e) {
+            LOG.warning("Unable to close " + array.getFile() + ": " + e.getMessage());
+        }
+    }
+
+    // Sums the results of computing all chunks in parallel.
+    private double reduce(final Chunk chunk) {
+        final long size = getSize();
+        final int nchunk = (int) ((size + CHUNK - 1) / CHUNK);
+        if (nchunk == 0) {
+            return 0.0;
+        }
+        return Parallel.reduce(nchunk, new Parallel.ReduceInt<Double>() {
+            @Override
+            public Double compute(final int ichunk) {
+                final long i = (long) ichunk * CHUNK;
+                final int n = (int) Math.min(CHUNK, size - i);
+                return chunk.compute(i, n);
+            }
+
+            @Override
+            public Double combine(final Double d1, final Double d2) {
+                return d1 + d2;
+            }
+        });
+    }
+
+    // A view of the mapped segment that contains the float with index i.
+    private static FloatBuffer segment(final MappedFloatArray a, final long i) {
+        return a.getSegment((int) (i / MappedFloatArray.SEGMENT_LENGTH));
+    }
+
+    // The index of the float with index i in its mapped segment.
+    private static int offset(final long i) {
+        return (int) (i % MappedFloatArray.SEGMENT_LENGTH);
+    }
+
+    private void writeObject(final ObjectOutputStream out)
+            throws IOException {
+        final long size = getSize();
+        out.writeLong(size);
+        out.writeDouble(_variance);
+        final float[] a = new float[CHUNK];
+        for (long i = 0; i < size; i += CHUNK) {
+            final int n = (int) Math.min(CHUNK, size - i);
+            _array.get(i, n, a, 0);
+            for (int j = 0; j < n; ++j) {
+                out.writeFloat(a[j]);
+            }
+        }
+    }
+
+    private void readObject(final ObjectInputStream in)
+            throws IOException, ClassNotFoundException {
+        final long size = in.readLong();
+        final double variance = in.readDouble();
+        init(null, size, variance, false);
+        final float[] a = new float[CHUNK];
+        for (long i = 0; i < size; i += CHUNK) {
+            final int n = (int) Math.min(CHUNK, size - i);
+            for (int j = 0; j < n; ++j) {
+                a[j] = in.readFloat();
+            }
+            _array.set(i, n, a, 0);
+        }
+    }
+}
@@ -0,0 +1,210 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Monitor;
+
+import java.util.logging.Logger;
+
+/**
+ * Minimize a smooth nonlinear function with nonlinear conjugate gradients.
+ * Search directions are updated with the Polak-Ribiere+ formula
+ * <pre>
+ * beta = max(0, g1'(g1-g0)/g0'g0)
+ * d = -g1 + beta d
+ * </pre>
+ * which restarts with steepest descent whenever beta would be negative.
+ * The search also restarts if successive gradients are far from
+ * orthogonal (Powell's test, |g1'g0| &gt; 0.2 g1'g1) or if d is not a
+ * descent direction.
+ * <p>
+ * Each line search satisfies the strong Wolfe conditions, with an initial
+ * step chosen so that the first-order change in the function equals that
+ * of the previous iteration. Only four vectors are kept, fewer than for
+ * LbfgsSolver, which usually converges in fewer evaluations.
+ * If the function is thread-safe, setConcurrentEvaluations() lets
+ * the line search evaluate several trial steps at once.
+ * <p>
+ * Reference: Nocedal, J., and Wright, S.J., 2006, Numerical optimization,
+ * 2nd edition: Springer, Section 5.2.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public class NonlinearCgSolver {
+    private static final Logger LOG = Logger.getLogger("edu.mines.jtk.opt");
+
+    /**
+     * Constructs a solver.
+     *
+     * @param func The function to minimize.
+     */
+    public NonlinearCgSolver(final DifferentiableFunction func) {
+        _func = func;
+    }
+
+    /**
+     * Set the number of trial steps that the line search may evaluate
+     * concurrently. The default is one, a serial search. Values larger
+     * than one require a thread-safe function.
+     *
+     * @param ntrial The number of concurrent trial steps.
+     */
+    public void setConcurrentEvaluations(final int ntrial) {
+        Check.argument(ntrial >= 1, "ntrial>=1");
+        _ntrial = ntrial;
+    }
+
+    /**
+     * Set the tolerance for convergence. Iterations stop when the
+     * norm of the gradient is less than this tolerance times the norm of
+     * the initial gradient. The default is 1.0e-6.
+     *
+     * @param gtol The relative gradient tolerance.
+     */
+    public void setGradientTolerance(final double gtol) {
+        Check.argument(gtol >= 0.0, "gtol>=0.0");
+        _gtol = gtol;
+    }
+
+    /**
+     * Return a new vector that minimizes the function.
+     *
+     * @param x0               The initial vector, which is not modified.
+     * @param numberIterations The maximum number of iterations.
+     * @param monitor          If non-null, then track all progress.
+     * @return The optimized vector.
+     */
+    public Vect solve(final VectConst x0, final int numberIterations,
+                      Monitor monitor) {
+        if (monitor == null) {
+            monitor = Monitor.NULL_MONITOR;
+        }
+        monitor.report(0.0);
+        final VectLineSearch search =
+                new VectLineSearch(_func, FTOL, GTOL, _ntrial);
+        final Vect x = x0.clone();
+        final Vect g = x0.clone();
+        double f = _func.evaluate(x, g);
+        _niter = 0;
+        _neval = 1;
+        _converged = false;
+
+        double gg = g.dot(g);
+        final double gnorm0 = Math.sqrt(gg);
+        final Vect d = g.clone();
+        final Vect gp = g.clone();
+        double ggOld = gg;
+        double dg = 0.0;
+        double step = 0.0; // first-order decrease s*d'g of previous step
+        try {
+            while (_niter < numberIterations && !monitor.isCanceled()) {
+                if (Math.sqrt(gg) <= _gtol * gnorm0) {
+                    _converged = true;
+                    break;
+                }
+
+                // Update the search direction d = -g + beta d.
+                double beta = 0.0;
+                if (_niter > 0) {
+                    final double ggp = g.dot(gp);
+                    if (Math.abs(ggp) <= 0.2 * gg) {
+                        beta = Math.max(0.0, (gg - ggp) / ggOld);
+                    }
+                }
+                dg = VectUtil.addAndDot(d, beta, -1.0, g, g);
+                if (!(dg < 0.0)) { // not a descent direction; restart
+                    VectUtil.copy(d, g);
+                    VectUtil.scale(d, -1.0);
+                    dg = -gg;
+                }
+                final double s0 = (step < 0.0) ? step / dg
+                        : 1.0 / Math.sqrt(gg);
+
+                // Line search from x along d.
+                VectUtil.copy(gp, g);
+                ggOld = gg;
+                final VectLineSearch.Result r = search.search(x, g, f, d, s0);
+                _neval += r.neval;
+                ++_niter;
+                monitor.report((double) _niter / numberIterations);
+                if (r.s == 0.0) {
+                    LOG.fine("Line search found no decrease. Stopping.");
+                    break;
+                }
+                f = r.f;
+                step = r.s * dg;
+                gg = g.dot(g);
+            }
+        } finally {
+            d.dispose();
+            gp.dispose();
+            g.dispose();
+        }
+        _f = f;
+        monitor.report(1.0);
+        return x;
+    }
+
+    /**
+     * Get the number of iterations performed by the last solve.
+     *
+     * @return The number of iterations.
+     */
+    public int getIterationCount() {
+        return _niter;
+    }
+
+    /**
+     * Get the number of function evaluations in the last solve.
+     *
+     * @return The number of evaluations.
+     */
+    public int getEvaluationCount() {
+        return _neval;
+    }
+
+    /**
+     * Get the function value at the solution of the last solve.
+     *
+     * @return The function value.
+     */
+    public double getValue() {
+        return _f;
+    }
+
+    /**
+     * Determine whether the last solve converged to the gradient tolerance.
+     *
+     * @return true, if converged; false, otherwise.
+     */
+    public boolean converged() {
+        return _converged;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // private
+
+    private static final double FTOL = 1.0e-4;
+    private static final double GTOL = 0.1;
+
+    private final DifferentiableFunction _func;
+    private int _ntrial = 1;
+    private double _gtol = 1.0e-6;
+    private int _niter;
+    private int _neval;
+    private double _f;
+    private boolean _converged;
+}
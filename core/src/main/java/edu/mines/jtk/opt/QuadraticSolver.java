@@ -126,14 +126,14 @@ public class QuadraticSolver {
                 }
                 u.add(beta, -1.0, q);
             }
+            final double pg;
             { // Did not save "a" before calculating beta, to avoid extra instance.
                 final Vect a = qa;
                 VectUtil.copy(a, g);
                 _quadratic.inverseHessian(a);
                 a.postCondition();
-                p.add(beta, -1.0, a);
+                pg = VectUtil.addAndDot(p, beta, -1.0, a, g); // p = -a + beta p
             }
-            final double pg = p.dot(g);
             checkNaN(pg);
             pu = p.dot(u);
             checkNaN(pu);
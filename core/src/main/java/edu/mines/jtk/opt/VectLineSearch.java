@@ -0,0 +1,246 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+import edu.mines.jtk.util.Check;
+import edu.mines.jtk.util.Parallel;
+
+/**
+ * Searches along a direction vector for a minimum of a
+ * DifferentiableFunction. This class wraps LineSearch, the Mor'e and
+ * Thuente algorithm for one dimension, for the vector solvers in this
+ * package. A successful search updates the vector x and gradient g
+ * in place.
+ * <p>
+ * Optionally, several trial steps on a geometric grid around the initial
+ * step may be evaluated concurrently. The lowest trial that satisfies
+ * both the sufficient-decrease and curvature conditions is accepted
+ * immediately. Otherwise, the trials are cached and the serial search
+ * resumes from the best of them, without repeating those evaluations.
+ * Concurrent trials require a thread-safe function and one extra copy
+ * of x and g for each trial.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+final class VectLineSearch {
+
+    /**
+     * The result of a search.
+     */
+    static final class Result {
+        /** The step accepted; zero, if no decrease was found. */
+        final double s;
+        /** The function value for the accepted step. */
+        final double f;
+        /** The number of function evaluations. */
+        final int neval;
+        /** True, if the step satisfies both Wolfe conditions. */
+        final boolean converged;
+
+        private Result(final double s, final double f, final int neval,
+                       final boolean converged) {
+            this.s = s;
+            this.f = f;
+            this.neval = neval;
+            this.converged = converged;
+        }
+    }
+
+    /**
+     * Constructs a line search.
+     *
+     * @param func   The function to minimize.
+     * @param ftol   Tolerance for the sufficient-decrease condition.
+     * @param gtol   Tolerance for the curvature condition.
+     * @param ntrial Number of trial steps to evaluate concurrently;
+     *               one for a serial search.
+     */
+    VectLineSearch(final DifferentiableFunction func,
+                   final double ftol, final double gtol, final int ntrial) {
+        Check.argument(0.0 < ftol && ftol < gtol && gtol < 1.0,
+                "0<ftol<gtol<1");
+        Check.argument(ntrial >= 1, "ntrial>=1");
+        _func = func;
+        _ftol = ftol;
+        _gtol = gtol;
+        _ntrial = ntrial;
+    }
+
+    /**
+     * Searches along a direction from x. If a decrease is found, then
+     * x and g are replaced by the new point and its gradient.
+     *
+     * @param x  The current point; updated.
+     * @param g  The gradient at x; updated.
+     * @param f  The function value at x.
+     * @param d  The search direction; must be a descent direction.
+     * @param s0 The initial step; must be positive.
+     * @return The result.
+     */
+    Result search(final Vect x, final Vect g, final double f,
+                  final VectConst d, final double s0) {
+        final double dg = g.dot(d);
+        Check.argument(dg < 0.0, "d is a descent direction");
+        Check.argument(s0 > 0.0, "s0>0.0");
+        final Evaluator e = new Evaluator(x, g, d);
+        try {
+            int neval = 0;
+            double s = s0;
+            if (_ntrial > 1) {
+                e.evaluateTrials(s0);
+                neval += _ntrial;
+
+                // Accept the lowest trial that satisfies both conditions.
+                // Otherwise, resume from the lowest sufficient decrease.
+                int jw = -1;
+                int jf = -1;
+                for (int j = 0; j < _ntrial; ++j) {
+                    final double sj = e._ss[j];
+                    final double fj = e._fs[j];
+                    if (fj <= f + _ftol * sj * dg) {
+                        if (jf < 0 || fj < e._fs[jf]) {
+                            jf = j;
+                        }
+                        if (Math.abs(e._gs[j]) <= -_gtol * dg &&
+                                (jw < 0 || fj < e._fs[jw])) {
+                            jw = j;
+                        }
+                    }
+                }
+                if (jw >= 0) {
+                    e.accept(jw);
+                    return new Result(e._ss[jw], e._fs[jw], neval, true);
+                }
+                s = (jf >= 0) ? e._ss[jf] : e._ss[_ntrial - 1];
+            }
+            final LineSearch ls = new LineSearch(e, STOL, _ftol, _gtol);
+            final LineSearch.Result lr = ls.search(s, f, dg, 0.0, SMAX * s0);
+            neval += e._nserial;
+            if (!(lr.f < f)) {
+                return new Result(0.0, f, neval, false);
+            }
+            e.accept(lr.s);
+            return new Result(lr.s, lr.f, neval, lr.converged());
+        } finally {
+            e.dispose();
+        }
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // private
+
+    private static final double STOL = 1.0e-10;
+    private static final double SMAX = 1.0e6;
+
+    private final DifferentiableFunction _func;
+    private final double _ftol;
+    private final double _gtol;
+    private final int _ntrial;
+
+    // Evaluates f(x+s*d) and its directional derivative for the 1D search,
+    // remembering concurrent trials and the most recent serial evaluation.
+    private class Evaluator implements LineSearch.Function {
+        final Vect _x, _g;
+        final VectConst _d;
+        double[] _ss, _fs, _gs;
+        Vect[] _xs, _gv;
+        Vect _xt, _gt;
+        double _st = Double.NaN;
+        int _nserial;
+
+        Evaluator(final Vect x, final Vect g, final VectConst d) {
+            _x = x;
+            _g = g;
+            _d = d;
+        }
+
+        void evaluateTrials(final double s0) {
+            final int n = _ntrial;
+            _ss = new double[n];
+            _fs = new double[n];
+            _gs = new double[n];
+            _xs = new Vect[n];
+            _gv = new Vect[n];
+            for (int j = 0; j < n; ++j) {
+                _ss[j] = s0 * Math.pow(2.0, 1 - j); // 2*s0, s0, s0/2, ...
+            }
+            Parallel.loop(n, new Parallel.LoopInt() {
+                @Override
+                public void compute(final int j) {
+                    final Vect xj = _x.clone();
+                    xj.add(1.0, _ss[j], _d);
+                    final Vect gj = _g.clone();
+                    _fs[j] = _func.evaluate(xj, gj);
+                    _gs[j] = gj.dot(_d);
+                    _xs[j] = xj;
+                    _gv[j] = gj;
+                }
+            });
+        }
+
+        @Override
+        public double[] evaluate(final double s) {
+            for (int j = 0; _ss != null && j < _ss.length; ++j) {
+                if (_ss[j] == s) {
+                    return new double[]{_fs[j], _gs[j]};
+                }
+            }
+            if (_xt == null) {
+                _xt = _x.clone();
+                _gt = _g.clone();
+            }
+            VectUtil.copy(_xt, _x);
+            _xt.add(1.0, s, _d);
+            final double f = _func.evaluate(_xt, _gt);
+            _st = s;
+            ++_nserial;
+            return new double[]{f, _gt.dot(_d)};
+        }
+
+        void accept(final int j) {
+            VectUtil.copy(_x, _xs[j]);
+            VectUtil.copy(_g, _gv[j]);
+        }
+
+        void accept(final double s) {
+            for (int j = 0; _ss != null && j < _ss.length; ++j) {
+                if (_ss[j] == s) {
+                    accept(j);
+                    return;
+                }
+            }
+            if (s != _st) {
+                evaluate(s);
+            }
+            VectUtil.copy(_x, _xt);
+            VectUtil.copy(_g, _gt);
+        }
+
+        void dispose() {
+            for (int j = 0; _xs != null && j < _xs.length; ++j) {
+                if (_xs[j] != null) {
+                    _xs[j].dispose();
+                }
+                if (_gv[j] != null) {
+                    _gv[j].dispose();
+                }
+            }
+            if (_xt != null) {
+                _xt.dispose();
+                _gt.dispose();
+            }
+        }
+    }
+}
@@ -66,6 +66,31 @@ public class VectUtil {
         to.add(0.0, 1.0, from);
     }
 
+    /**
+     * Add a scaled version of another vector to a scaled version of a
+     * vector, and then return the dot product of the result with
+     * yet another vector.  Uses a single pass through the vectors
+     * if the vector is a FusedVect.
+     *
+     * @param v          Vector to be updated.
+     * @param scaleThis  Multiply v by this scalar before adding.
+     * @param scaleOther Multiply the other vector by this scalar before adding.
+     * @param other      The other vector to be multiplied.
+     * @param dotOther   The vector to be dotted with the updated v.
+     * @return The dot product.
+     */
+    public static double addAndDot(final Vect v,
+                                   final double scaleThis,
+                                   final double scaleOther,
+                                   final VectConst other,
+                                   final VectConst dotOther) {
+        if (v instanceof FusedVect) {
+            return ((FusedVect) v).addAndDot(scaleThis, scaleOther, other, dotOther);
+        }
+        v.add(scaleThis, scaleOther, other);
+        return v.dot(dotOther);
+    }
+
     /**
      * Clone a vector and initialized to zero, so that
      * out.dot(out) == 0.
@@ -0,0 +1,173 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+ ****************************************************************************/
+package edu.mines.jtk.opt;
+
+import java.lang.ref.SoftReference;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.Iterator;
+import java.util.List;
+import java.util.Map;
+
+/**
+ * A pool of arrays that can be reused as workspace by vectors.
+ * Solvers clone and dispose several vectors for every solve. When
+ * those vectors hold gigabytes of floats, repeatedly allocating and
+ * zeroing new arrays is costly, and may provoke full garbage collections.
+ * When pooling is enabled, vectors such as ArrayVect3f instead take
+ * arrays from this pool when cloned, and give them back when disposed.
+ * Pooling is disabled by default, because an array obtained from a
+ * pooled vector must not be used after that vector is disposed.
+ * <p></p>
+ * The pool holds arrays by soft references, so that the garbage collector
+ * may reclaim them when memory is low. Arrays taken from the pool have
+ * arbitrary contents. The pool is shared by all threads.
+ *
+ * @author Dave Hale, Colorado School of Mines
+ */
+public class WorkspacePool {
+
+    /**
+     * Enable or disable pooling. When disabled, arrays are always
+     * allocated, and arrays given back are discarded. Pooling is
+     * disabled by default.
+     *
+     * @param enabled true, to enable pooling; false, to disable.
+     */
+    public static synchronized void setEnabled(final boolean enabled) {
+        s_enabled = enabled;
+        if (!enabled) {
+            clear();
+        }
+    }
+
+    /**
+     * Determine whether pooling is enabled.
+     *
+     * @return true, if enabled; false, otherwise.
+     */
+    public static synchronized boolean isEnabled() {
+        return s_enabled;
+    }
+
+    /**
+     * Discard all arrays held by this pool.
+     */
+    public static synchronized void clear() {
+        s_pool.clear();
+    }
+
+    /**
+     * Take an array from the pool, or allocate one if none is available.
+     *
+     * @param n1 Length of the first dimension.
+     * @param n2 Length of the second dimension.
+     * @param n3 Length of the third dimension.
+     * @return An array[n1][n2][n3] with arbitrary contents.
+     */
+    static float[][][] take(final int n1, final int n2, final int n3) {
+        synchronized (WorkspacePool.class) {
+            final List<SoftReference<float[][][]>> list = s_pool.get(key(n1, n2, n3));
+            if (list != null) {
+                while (!list.isEmpty()) {
+                    final float[][][] a = list.remove(list.size() - 1).get();
+                    if (a != null) {
+                        return a;
+                    }
+                }
+            }
+        }
+        return new float[n1][n2][n3];
+    }
+
+    /**
+     * Give an array back to the pool. The array must not be used again
+     * by the caller. Arrays that are not rectangular are discarded.
+     *
+     * @param a The array.
+     */
+    static void give(final float[][][] a) {
+        if (!isRectangular(a)) {
+            return;
+        }
+        final int n1 = a.length;
+        final int n2 = a[0].length;
+        final int n3 = a[0][0].length;
+        synchronized (WorkspacePool.class) {
+            if (!s_enabled) {
+                return;
+            }
+            final String key = key(n1, n2, n3);
+            List<SoftReference<float[][][]>> list = s_pool.get(key);
+            if (list == null) {
+                list = new ArrayList<SoftReference<float[][][]>>();
+                s_pool.put(key, list);
+            }
+            for (final Iterator<SoftReference<float[][][]>> i = list.iterator();
+                 i.hasNext(); ) {
+                final float[][][] b = i.next().get();
+                if (b == null) {
+                    i.remove();
+                } else if (b == a) {
+                    return;
+                }
+            }
+            if (list.size() < MAX_PER_SHAPE) {
+                list.add(new SoftReference<float[][][]>(a));
+            }
+        }
+    }
+
+    /**
+     * Determine whether an array is non-empty and rectangular, so that
+     * it can be pooled.
+     *
+     * @param a The array.
+     * @return true, if rectangular; false, otherwise.
+     */
+    static boolean isRectangular(final float[][][] a) {
+        if (a == null || a.length == 0 || a[0].length == 0) {
+            return false;
+        }
+        final int n2 = a[0].length;
+        final int n3 = a[0][0].length;
+        for (final float[][] ai : a) {
+            if (ai.length != n2) {
+                return false;
+            }
+            for (final float[] aij : ai) {
+                if (aij.length != n3) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    ///////////////////////////////////////////////////////////////////////////
+    // private
+
+    private static final int MAX_PER_SHAPE = 8;
+    private static boolean s_enabled = false;
+    private static final Map<String, List<SoftReference<float[][][]>>> s_pool =
+            new HashMap<String, List<SoftReference<float[][][]>>>();
+
+    private WorkspacePool() {
+    }
+
+    private static String key(final int n1, final int n2, final int n3) {
+        return n1 + "x" + n2 + "x" + n3;
+    }
+}
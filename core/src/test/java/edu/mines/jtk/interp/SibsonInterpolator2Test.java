@@ -118,10 +118,98 @@ public class SibsonInterpolator2Test extends TestCase {
     }
   }
 
+  public void testAddRemoveMove() {
+    TestFunction tf = TestFunction.makeSine();
+    float[][] fx = tf.sampleScattered2(NS,XMIN,XMAX,XMIN,XMAX);
+    float[] f = fx[0], x1 = fx[1], x2 = fx[2];
+
+    // The sample nearest the center, which is not on the bounding box.
+    int k = 0;
+    float dk = Float.MAX_VALUE;
+    for (int i=0; i<NS; ++i) {
+      float d1 = x1[i]-0.5f*(XMIN+XMAX);
+      float d2 = x2[i]-0.5f*(XMIN+XMAX);
+      if (d1*d1+d2*d2<dk) {
+        k = i;
+        dk = d1*d1+d2*d2;
+      }
+    }
+
+    // Interpolate without sample k, then add it and update the grid.
+    float[][] fy = without(k,fx);
+    SibsonInterpolator2 si = new SibsonInterpolator2(fy[0],fy[1],fy[2]);
+    float[][] g = si.interpolate(SX,SX);
+    assertEquals(NS-1,si.addSample(f[k],x1[k],x2[k]));
+    si.interpolate(SX,SX,g);
+    float[][] e = new SibsonInterpolator2(f,x1,x2).interpolate(SX,SX);
+    assertEquals(e,g);
+
+    // Move sample k, and update the grid.
+    float x1k = x1[k]+0.01f;
+    float x2k = x2[k]-0.01f;
+    si.moveSample(NS-1,x1k,x2k);
+    si.interpolate(SX,SX,g);
+    float[][] fz = {append(fy[0],f[k]),append(fy[1],x1k),append(fy[2],x2k)};
+    e = new SibsonInterpolator2(fz[0],fz[1],fz[2]).interpolate(SX,SX);
+    assertEquals(e,g);
+
+    // Remove sample k, and update the grid.
+    si.removeSample(NS-1);
+    si.interpolate(SX,SX,g);
+    e = new SibsonInterpolator2(fy[0],fy[1],fy[2]).interpolate(SX,SX);
+    assertEquals(e,g);
+  }
+
+  public void testAddOutsideBounds() {
+    TestFunction tf = TestFunction.makeSine();
+    float[][] fx = tf.sampleScattered2(NS,XMIN,XMAX,XMIN,XMAX);
+    float[] f = fx[0], x1 = fx[1], x2 = fx[2];
+
+    // With bounds set, add a sample outside the bounds of other samples,
+    // so that ghost samples must be replaced, and update the grid.
+    SibsonInterpolator2 si = new SibsonInterpolator2(f,x1,x2);
+    si.setBounds(SX,SX);
+    float[][] g = si.interpolate(SX,SX);
+    float fk = 1.0f, x1k = 1.2f*XMAX, x2k = 0.5f*(XMIN+XMAX);
+    assertEquals(NS,si.addSample(fk,x1k,x2k));
+    si.interpolate(SX,SX,g);
+    SibsonInterpolator2 sj =
+      new SibsonInterpolator2(append(f,fk),append(x1,x1k),append(x2,x2k));
+    sj.setBounds(SX,SX);
+    float[][] e = sj.interpolate(SX,SX);
+    assertEquals(e,g);
+  }
+
+  private static float[][] without(int k, float[][] fx) {
+    int n = fx[0].length;
+    float[][] fy = new float[fx.length][n-1];
+    for (int j=0; j<fx.length; ++j) {
+      for (int i=0,m=0; i<n; ++i) {
+        if (i!=k)
+          fy[j][m++] = fx[j][i];
+      }
+    }
+    return fy;
+  }
+  private static float[] append(float[] a, float b) {
+    int n = a.length;
+    float[] c = new float[n+1];
+    System.arraycopy(a,0,c,0,n);
+    c[n] = b;
+    return c;
+  }
+
   private static final double TOLERANCE = 1.0e-5;
   private void assertEquals(float e, float a) {
     assertEquals(e,a,TOLERANCE);
   }
+  private void assertEquals(float[][] e, float[][] a) {
+    int n2 = e.length;
+    int n1 = e[0].length;
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        assertEquals(e[i2][i1],a[i2][i1]);
+  }
   private void assertValue(
     SibsonInterpolator2 si, float x1, float x2, float f) 
   {
@@ -110,6 +110,95 @@ public class SibsonInterpolator3Test extends TestCase {
     }
   }
 
+  public void testAddRemoveMove() {
+    TestFunction tf = TestFunction.makeSine();
+    float[][] fx = tf.sampleScattered3(NS,XMIN,XMAX,XMIN,XMAX,XMIN,XMAX);
+    float[] f = fx[0], x1 = fx[1], x2 = fx[2], x3 = fx[3];
+    Sampling s = new Sampling(21,0.05,0.0);
+
+    // The sample nearest the center, which is not on the bounding box.
+    int k = 0;
+    float dk = Float.MAX_VALUE;
+    for (int i=0; i<NS; ++i) {
+      float d1 = x1[i]-0.5f*(XMIN+XMAX);
+      float d2 = x2[i]-0.5f*(XMIN+XMAX);
+      float d3 = x3[i]-0.5f*(XMIN+XMAX);
+      if (d1*d1+d2*d2+d3*d3<dk) {
+        k = i;
+        dk = d1*d1+d2*d2+d3*d3;
+      }
+    }
+
+    // Interpolate without sample k, then add it and update the grid.
+    float[][] fy = without(k,fx);
+    SibsonInterpolator3 si =
+      new SibsonInterpolator3(fy[0],fy[1],fy[2],fy[3]);
+    float[][][] g = si.interpolate(s,s,s);
+    assertEquals(NS-1,si.addSample(f[k],x1[k],x2[k],x3[k]));
+    si.interpolate(s,s,s,g);
+    float[][][] e = new SibsonInterpolator3(f,x1,x2,x3).interpolate(s,s,s);
+    assertEquals(e,g);
+
+    // Move sample k, and update the grid.
+    float x1k = x1[k]+0.01f;
+    float x2k = x2[k]-0.01f;
+    float x3k = x3[k]+0.01f;
+    si.moveSample(NS-1,x1k,x2k,x3k);
+    si.interpolate(s,s,s,g);
+    float[][] fz = {
+      append(fy[0],f[k]),append(fy[1],x1k),
+      append(fy[2],x2k),append(fy[3],x3k)};
+    e = new SibsonInterpolator3(fz[0],fz[1],fz[2],fz[3]).interpolate(s,s,s);
+    assertEquals(e,g);
+
+    // Remove sample k, and update the grid.
+    si.removeSample(NS-1);
+    si.interpolate(s,s,s,g);
+    e = new SibsonInterpolator3(fy[0],fy[1],fy[2],fy[3]).interpolate(s,s,s);
+    assertEquals(e,g);
+  }
+
+  public void testAddOutsideBounds() {
+    TestFunction tf = TestFunction.makeSine();
+    float[][] fx = tf.sampleScattered3(NS,XMIN,XMAX,XMIN,XMAX,XMIN,XMAX);
+    float[] f = fx[0], x1 = fx[1], x2 = fx[2], x3 = fx[3];
+    Sampling s = new Sampling(21,0.05,0.0);
+
+    // With bounds set, add a sample outside the bounds of other samples,
+    // so that ghost samples must be replaced, and update the grid.
+    SibsonInterpolator3 si = new SibsonInterpolator3(f,x1,x2,x3);
+    si.setBounds(s,s,s);
+    float[][][] g = si.interpolate(s,s,s);
+    float fk = 1.0f, x1k = 1.2f*XMAX;
+    float x2k = 0.5f*(XMIN+XMAX), x3k = 0.5f*(XMIN+XMAX);
+    assertEquals(NS,si.addSample(fk,x1k,x2k,x3k));
+    si.interpolate(s,s,s,g);
+    SibsonInterpolator3 sj = new SibsonInterpolator3(
+      append(f,fk),append(x1,x1k),append(x2,x2k),append(x3,x3k));
+    sj.setBounds(s,s,s);
+    float[][][] e = sj.interpolate(s,s,s);
+    assertEquals(e,g);
+  }
+
+  private static float[][] without(int k, float[][] fx) {
+    int n = fx[0].length;
+    float[][] fy = new float[fx.length][n-1];
+    for (int j=0; j<fx.length; ++j) {
+      for (int i=0,m=0; i<n; ++i) {
+        if (i!=k)
+          fy[j][m++] = fx[j][i];
+      }
+    }
+    return fy;
+  }
+  private static float[] append(float[] a, float b) {
+    int n = a.length;
+    float[] c = new float[n+1];
+    System.arraycopy(a,0,c,0,n);
+    c[n] = b;
+    return c;
+  }
+
   public static void benchMethods() {
     TestFunction tf = TestFunction.makeSine();
     //TestFunction tf = TestFunction.makeLinear();
@@ -151,6 +240,15 @@ public class SibsonInterpolator3Test extends TestCase {
   private void assertEquals(float e, float a) {
     assertEquals(e,a,TOLERANCE);
   }
+  private void assertEquals(float[][][] e, float[][][] a) {
+    int n3 = e.length;
+    int n2 = e[0].length;
+    int n1 = e[0][0].length;
+    for (int i3=0; i3<n3; ++i3)
+      for (int i2=0; i2<n2; ++i2)
+        for (int i1=0; i1<n1; ++i1)
+          assertEquals(e[i3][i2][i1],a[i3][i2][i1]);
+  }
   private void assertValue(
     SibsonInterpolator3 si, float x1, float x2, float x3, float f) 
   {
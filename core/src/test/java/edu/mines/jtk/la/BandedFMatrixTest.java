@@ -0,0 +1,102 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.util.ArrayMath.*;
+
+/**
+ * Tests {@link edu.mines.jtk.la.BandedFMatrix}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.20
+ */
+public class BandedFMatrixTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(BandedFMatrixTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTridiagonal() {
+    int n = 100;
+    BandedFMatrix m = makeMatrix(n,1,1);
+    float[][] d = m.d();
+    TridiagonalFMatrix t = new TridiagonalFMatrix(n,d[0],d[1],d[2]);
+    float[] r = randfloat(n);
+    float[] u = zerofloat(n);
+    float[] v = zerofloat(n);
+    m.solve(r,u);
+    t.solve(r,v);
+    assertEqualFuzzy(u,v);
+  }
+
+  public void testSolve() {
+    int[][] bands = {{0,0},{2,2},{1,3},{3,0},{0,2}};
+    for (int[] band:bands) {
+      int n = 100;
+      BandedFMatrix m = makeMatrix(n,band[0],band[1]);
+      float[] r = randfloat(n);
+      float[] u = zerofloat(n);
+      m.solve(r,u);
+      assertEqualFuzzy(r,m.times(u));
+    }
+  }
+
+  public void testSolveMany() {
+    int n = 101;
+    int nr = 1000;
+    BandedFMatrix m = makeMatrix(n,2,2);
+    float[][] r = randfloat(n,nr);
+    float[][] u1 = zerofloat(n,nr);
+    m.solve1(r,u1);
+    for (int i=0; i<nr; ++i)
+      assertEqualFuzzy(r[i],m.times(u1[i]));
+    float[][] u2 = transpose(r);
+    m.solve2(u2,u2); // in place
+    u2 = transpose(u2);
+    for (int i=0; i<nr; ++i)
+      assertEqualFuzzy(u1[i],u2[i]);
+  }
+
+  public void testGetSet() {
+    BandedFMatrix m = new BandedFMatrix(5,2,1);
+    m.set(3,1,2.0f);
+    m.set(1,2,3.0f);
+    assertEquals(2.0f,m.get(3,1),0.0f);
+    assertEquals(3.0f,m.get(1,2),0.0f);
+    assertEquals(0.0f,m.get(0,4),0.0f);
+    assertEquals(2.0f,m.d()[0][3],0.0f);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Random diagonally dominant matrix.
+  private static BandedFMatrix makeMatrix(int n, int kl, int ku) {
+    float[][] d = sub(randfloat(n,kl+ku+1),0.5f);
+    for (int i=0; i<n; ++i)
+      d[kl][i] = 1.0f+kl+ku;
+    return new BandedFMatrix(n,kl,ku,d);
+  }
+
+  private static void assertEqualFuzzy(float[] a, float[] b) {
+    int n = a.length;
+    double eps = 0.00001*max(max(abs(a)),max(abs(b)));
+    for (int j=0; j<n; ++j) {
+      assertEquals(a[j],b[j],eps);
+    }
+  }
+}
@@ -0,0 +1,83 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.CsrDMatrixTest.makeRandom;
+import static edu.mines.jtk.la.KrylovSolverTest.makeLaplacian;
+
+/**
+ * Tests {@link edu.mines.jtk.la.CsrDMatrixChd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class CsrDMatrixChdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(CsrDMatrixChdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testNotPositiveDefinite() {
+    CsrDMatrix a = new CsrDMatrix(new DMatrix(new double[][]{
+      {1.0,  2.0},
+      {2.0,  1.0},
+    }));
+    CsrDMatrixChd chd = new CsrDMatrixChd(a);
+    assertFalse(chd.isPositiveDefinite());
+  }
+
+  public void testRandom() {
+    test(makeSpd(10));
+    test(makeSpd(100));
+    test(makeSpd(300));
+  }
+
+  public void testLaplacian() {
+    CsrDMatrix a = makeLaplacian(30,40,0.0);
+    test(a);
+    int nnz0 = new CsrDMatrixChd(a,false).countNonZeros();
+    int nnz1 = new CsrDMatrixChd(a,true).countNonZeros();
+    assertTrue(nnz1<=nnz0);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static CsrDMatrix makeSpd(int n) {
+    DMatrix b = makeRandom(n,n,0.02).toDMatrix();
+    return new CsrDMatrix(b.transposeTimes(b).plus(DMatrix.identity(n,n)));
+  }
+
+  private static void test(CsrDMatrix a) {
+    int n = a.getN();
+    double[] b = makeRandom(n);
+    DMatrix bd = new DMatrix(n,1);
+    for (int i=0; i<n; ++i)
+      bd.set(i,0,b[i]);
+    DMatrix xd = new DMatrixChd(a.toDMatrix()).solve(bd);
+    for (boolean reorder:new boolean[]{false,true}) {
+      CsrDMatrixChd chd = new CsrDMatrixChd(a,reorder);
+      assertTrue(chd.isPositiveDefinite());
+      double[] x = chd.solve(b);
+      for (int i=0; i<n; ++i)
+        assertEquals(xd.get(i,0),x[i],1.0e-10*(1.0+Math.abs(xd.get(i,0))));
+      double[] y = a.times(x);
+      for (int i=0; i<n; ++i)
+        assertEquals(b[i],y[i],1.0e-10);
+    }
+  }
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.DMatrixTest.assertEqualExact;
+
+/**
+ * Tests {@link edu.mines.jtk.la.CsrDMatrix} and other sparse matrices.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class CsrDMatrixTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(CsrDMatrixTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTriplets() {
+    int[] i = {2,0,1,0,2,0};
+    int[] j = {1,2,1,0,1,2};
+    double[] v = {1.0,2.0,3.0,4.0,5.0,6.0};
+    CsrDMatrix a = CsrDMatrix.fromTriplets(3,3,i,j,v);
+    assertEquals(4,a.countNonZeros());
+    assertEqualExact(new DMatrix(new double[][]{
+      {4.0, 0.0, 8.0},
+      {0.0, 3.0, 0.0},
+      {0.0, 6.0, 0.0},
+    }),a.toDMatrix());
+    assertEquals(8.0,a.get(0,2),0.0);
+    assertEquals(0.0,a.get(2,2),0.0);
+    assertFalse(a.isSymmetric());
+    CscDMatrix c = CscDMatrix.fromTriplets(3,3,i,j,v);
+    assertEqualExact(a.toDMatrix(),c.toDMatrix());
+  }
+
+  public void testTranspose() {
+    CsrDMatrix a = makeRandom(30,20,0.2);
+    DMatrix ad = a.toDMatrix();
+    assertEqualExact(ad.transpose(),a.transpose().toDMatrix());
+    double[] x = makeRandom(30);
+    double[] y = new double[20];
+    a.transposeTimes(x,y);
+    assertEqual(times(ad.transpose(),x),y);
+  }
+
+  public void testTimes() {
+    testTimes(7,5,0.5);
+    testTimes(200,300,0.05);
+    testTimes(10000,10000,0.001);
+  }
+
+  public void testSymmetric() {
+    CsrDMatrix a = makeRandom(50,50,0.1);
+    CsrDMatrix b = new CsrDMatrix(
+      a.toDMatrix().plus(a.toDMatrix().transpose()));
+    assertTrue(b.isSymmetric());
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // package
+
+  static CsrDMatrix makeRandom(int m, int n, double density) {
+    Random r = new Random(314159);
+    int nt = (int)(density*m*n);
+    int[] i = new int[nt];
+    int[] j = new int[nt];
+    double[] v = new double[nt];
+    for (int it=0; it<nt; ++it) {
+      i[it] = r.nextInt(m);
+      j[it] = r.nextInt(n);
+      v[it] = r.nextDouble()-0.5;
+    }
+    return CsrDMatrix.fromTriplets(m,n,i,j,v);
+  }
+
+  static double[] makeRandom(int n) {
+    Random r = new Random(271828);
+    double[] x = new double[n];
+    for (int i=0; i<n; ++i)
+      x[i] = r.nextDouble()-0.5;
+    return x;
+  }
+
+  static void assertEqual(double[] e, double[] a) {
+    assertEquals(e.length,a.length);
+    for (int i=0; i<e.length; ++i)
+      assertEquals(e[i],a[i],1.0e-12*(1.0+Math.abs(e[i])));
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static void testTimes(int m, int n, double density) {
+    CsrDMatrix a = makeRandom(m,n,density);
+    double[] x = makeRandom(n);
+    double[] y = a.times(x);
+
+    // Naive product, for comparison.
+    int[] rp = a.getRowPointers();
+    int[] ci = a.getColumnIndices();
+    double[] v = a.getValues();
+    double[] e = new double[m];
+    for (int i=0; i<m; ++i) {
+      for (int p=rp[i]; p<rp[i+1]; ++p)
+        e[i] += v[p]*x[ci[p]];
+    }
+    assertEqual(e,y);
+
+    CscDMatrix c = CscDMatrix.fromCsr(a);
+    assertEqual(e,c.times(x));
+    double[] z = makeRandom(m);
+    double[] yt = new double[n];
+    a.transposeTimes(z,yt);
+    double[] ct = new double[n];
+    c.transposeTimes(z,ct);
+    assertEqual(yt,ct);
+
+    if (m%5==0 && n%5==0) {
+      BsrDMatrix b = BsrDMatrix.fromCsr(a,5);
+      assertEqual(e,b.times(x));
+    }
+  }
+
+  private static double[] times(DMatrix a, double[] x) {
+    int m = a.getM();
+    int n = a.getN();
+    double[] y = new double[m];
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<n; ++j)
+        y[i] += a.get(i,j)*x[j];
+    }
+    return y;
+  }
+}
@@ -0,0 +1,190 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.DMatrixTest.assertEqualFuzzy;
+
+/**
+ * Tests {@link edu.mines.jtk.la.DMatrixBatch}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.19
+ */
+public class DMatrixBatchTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(DMatrixBatchTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testLu() {
+    for (int n=1; n<=8; ++n) {
+      DMatrix[] a = new DMatrix[NB];
+      DMatrix[] b = new DMatrix[NB];
+      for (int k=0; k<NB; ++k) {
+        a[k] = DMatrix.random(n,n).minus(DMatrix.identity(n,n));
+        b[k] = DMatrix.random(n,1);
+      }
+      double[][][] ab = pack(a);
+      double[][] bb = packVectors(b);
+      assertEquals(0,DMatrixBatch.solveLu(ab,bb));
+      for (int k=0; k<NB; ++k)
+        assertEqualFuzzy(new DMatrixLud(a[k]).solve(b[k]),unpack(bb,k));
+    }
+  }
+
+  public void testCholesky() {
+    for (int n=1; n<=8; ++n) {
+      DMatrix[] a = new DMatrix[NB];
+      DMatrix[] b = new DMatrix[NB];
+      for (int k=0; k<NB; ++k) {
+        DMatrix r = DMatrix.random(n,n);
+        a[k] = r.transposeTimes(r).plus(DMatrix.identity(n,n));
+        b[k] = DMatrix.random(n,1);
+      }
+      double[][][] ab = pack(a);
+      double[][] bb = packVectors(b);
+      assertEquals(0,DMatrixBatch.solveCholesky(ab,bb));
+      for (int k=0; k<NB; ++k)
+        assertEqualFuzzy(new DMatrixChd(a[k]).solve(b[k]),unpack(bb,k));
+    }
+  }
+
+  public void testQr() {
+    for (int n=1; n<=6; ++n) {
+      int m = n+2;
+      DMatrix[] a = new DMatrix[NB];
+      DMatrix[] b = new DMatrix[NB];
+      for (int k=0; k<NB; ++k) {
+        a[k] = DMatrix.random(m,n);
+        b[k] = DMatrix.random(m,1);
+      }
+      double[][][] ab = pack(a);
+      double[][] bb = packVectors(b);
+      double[][] xb = new double[n][NB];
+      assertEquals(0,DMatrixBatch.solveQr(ab,bb,xb));
+      for (int k=0; k<NB; ++k)
+        assertEqualFuzzy(new DMatrixQrd(a[k]).solve(b[k]),unpack(xb,k));
+    }
+  }
+
+  public void testSymmetricEigen() {
+    for (int n=1; n<=8; ++n) {
+      DMatrix[] a = new DMatrix[NB];
+      for (int k=0; k<NB; ++k) {
+        DMatrix r = DMatrix.random(n,n);
+        a[k] = r.plus(r.transpose());
+      }
+      double[][][] ab = pack(a);
+      double[][][] vb = new double[n][n][NB];
+      double[][] db = new double[n][NB];
+      DMatrixBatch.solveSymmetricEigen(ab,vb,db);
+      for (int k=0; k<NB; ++k) {
+        DMatrix v = new DMatrix(n,n);
+        DMatrix d = new DMatrix(n,n);
+        for (int i=0; i<n; ++i) {
+          if (i>0)
+            assertTrue(db[i-1][k]>=db[i][k]);
+          d.set(i,i,db[i][k]);
+          for (int j=0; j<n; ++j)
+            v.set(j,i,vb[i][j][k]);
+        }
+        assertEqualFuzzy(a[k].times(v),v.times(d));
+        assertEqualFuzzy(DMatrix.identity(n,n),v.transposeTimes(v));
+      }
+    }
+  }
+
+  public void testSingular() {
+    DMatrix[] a = new DMatrix[NB];
+    DMatrix[] b = new DMatrix[NB];
+    for (int k=0; k<NB; ++k) {
+      a[k] = (k%3==0)?new DMatrix(3,3):DMatrix.identity(3,3);
+      b[k] = DMatrix.random(3,1);
+    }
+    double[][] bb = packVectors(b);
+    assertEquals((NB+2)/3,DMatrixBatch.solveLu(pack(a),bb));
+    for (int k=0; k<NB; ++k) {
+      DMatrix x = (k%3==0)?new DMatrix(3,1):b[k];
+      assertEqualFuzzy(x,unpack(bb,k));
+    }
+    bb = packVectors(b);
+    assertEquals((NB+2)/3,DMatrixBatch.solveCholesky(pack(a),bb));
+  }
+
+  public void testNearlySingular() {
+
+    // Rounding errors make the last diagonal elements of U and R for
+    // these matrices tiny, but not zero.
+    DMatrix a = new DMatrix(new double[][]{
+      {1.0, 2.0, 3.0},
+      {4.0, 5.0, 6.0},
+      {7.0, 8.0, 9.0},
+    });
+    DMatrix q = new DMatrix(new double[][]{
+      { 1.0, 2.0, 3.0},
+      { 4.0, 5.0, 6.0},
+      { 7.0, 8.0, 9.0},
+      {10.0,11.0,12.0},
+    });
+    DMatrix[] ab = {a,DMatrix.identity(3,3)};
+    DMatrix[] bb = {DMatrix.random(3,1),DMatrix.random(3,1)};
+    assertEquals(1,DMatrixBatch.solveLu(pack(ab),packVectors(bb)));
+    ab[0] = a.transposeTimes(a);
+    assertEquals(1,DMatrixBatch.solveCholesky(pack(ab),packVectors(bb)));
+    DMatrix[] qb = {q,DMatrix.random(4,3)};
+    DMatrix[] cb = {DMatrix.random(4,1),DMatrix.random(4,1)};
+    double[][] xb = new double[3][2];
+    assertEquals(1,DMatrixBatch.solveQr(pack(qb),packVectors(cb),xb));
+    assertEquals(0.0,xb[0][0]);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final int NB = 1000; // more than one chunk
+
+  private static double[][][] pack(DMatrix[] a) {
+    int m = a[0].getM();
+    int n = a[0].getN();
+    double[][][] ab = new double[m][n][a.length];
+    for (int k=0; k<a.length; ++k) {
+      for (int i=0; i<m; ++i) {
+        for (int j=0; j<n; ++j)
+          ab[i][j][k] = a[k].get(i,j);
+      }
+    }
+    return ab;
+  }
+
+  private static double[][] packVectors(DMatrix[] b) {
+    int m = b[0].getM();
+    double[][] bb = new double[m][b.length];
+    for (int k=0; k<b.length; ++k) {
+      for (int i=0; i<m; ++i)
+        bb[i][k] = b[k].get(i,0);
+    }
+    return bb;
+  }
+
+  private static DMatrix unpack(double[][] b, int k) {
+    int n = b.length;
+    DMatrix x = new DMatrix(n,1);
+    for (int i=0; i<n; ++i)
+      x.set(i,0,b[i][k]);
+    return x;
+  }
+}
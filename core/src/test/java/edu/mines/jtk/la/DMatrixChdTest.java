@@ -0,0 +1,79 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.DMatrixTest.assertEqualFuzzy;
+
+/**
+ * Tests {@link edu.mines.jtk.la.DMatrixChd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.14
+ */
+public class DMatrixChdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(DMatrixChdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testNotPositiveDefinite() {
+    DMatrix a = new DMatrix(new double[][]{
+      {1.0,  2.0},
+      {2.0,  1.0},
+    });
+    DMatrixChd chd = new DMatrixChd(a);
+    assertFalse(chd.isPositiveDefinite());
+  }
+
+  public void testSimple() {
+    DMatrix a = new DMatrix(new double[][]{
+      {4.0,  2.0},
+      {2.0,  5.0},
+    });
+    DMatrixChd chd = new DMatrixChd(a);
+    assertTrue(chd.isPositiveDefinite());
+    assertEquals(16.0,chd.det(),1.0e-12);
+    test(a);
+  }
+
+  public void testRandom() {
+    test(makeSpd(10));
+    test(makeSpd(100));
+    test(makeSpd(300));
+  }
+
+  private static DMatrix makeSpd(int n) {
+    DMatrix a = DMatrix.random(n,n);
+    return a.transposeTimes(a).plus(DMatrix.identity(n,n));
+  }
+
+  private void test(DMatrix a) {
+    int n = a.getN();
+    DMatrixChd chd = new DMatrixChd(a);
+    assertTrue(chd.isPositiveDefinite());
+    DMatrix l = chd.getL();
+    for (int i=0; i<n; ++i) {
+      for (int j=i+1; j<n; ++j)
+        assertEquals(0.0,l.get(i,j),0.0);
+    }
+    assertEqualFuzzy(a,l.timesTranspose(l));
+    int nrhs = 2;
+    DMatrix b = DMatrix.random(n,nrhs);
+    DMatrix x = chd.solve(b);
+    assertEqualFuzzy(b,a.times(x));
+  }
+}
@@ -56,6 +56,11 @@ public class DMatrixQrdTest extends TestCase {
     test(DMatrix.random(101,100));
   }
 
+  public void testRandomBlocked() {
+    test(DMatrix.random(300,300));
+    test(DMatrix.random(333,300));
+  }
+
   private void test(DMatrix a) {
     int m = a.getM();
     int n = a.getN();
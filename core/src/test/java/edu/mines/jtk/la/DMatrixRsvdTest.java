@@ -0,0 +1,132 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.la.DMatrixRsvd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.22
+ */
+public class DMatrixRsvdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(DMatrixRsvdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testMatrix() {
+    double[] s = decaying(200);
+    DMatrix a = makeMatrix(300,s);
+    check(a,new DMatrixRsvd(a,10),s,1.0e-10);
+  }
+
+  public void testWide() {
+    double[] s = decaying(150);
+    DMatrix a = makeMatrix(200,s).transpose();
+    check(a,new DMatrixRsvd(a,8),s,1.0e-10);
+  }
+
+  public void testLowRank() {
+    double[] s = {5.0,4.0,3.0,2.0,1.0,0.0,0.0,0.0,0.0,0.0};
+    DMatrix a = makeMatrix(40,s);
+    check(a,new DMatrixRsvd(a,5,0,0),s,1.0e-12);
+  }
+
+  public void testOperator() {
+    double[] s = decaying(200);
+    final DMatrix a = makeMatrix(300,s);
+    final double[][] aa = a.getArray();
+    DOperator aop = new DOperator() {
+      public void apply(double[] x, double[] y) {
+        for (int i=0; i<y.length; ++i) {
+          y[i] = 0.0;
+          for (int j=0; j<x.length; ++j)
+            y[i] += aa[i][j]*x[j];
+        }
+      }
+    };
+    DOperator atop = new DOperator() {
+      public void apply(double[] x, double[] y) {
+        for (int j=0; j<y.length; ++j) {
+          y[j] = 0.0;
+          for (int i=0; i<x.length; ++i)
+            y[j] += aa[i][j]*x[i];
+        }
+      }
+    };
+    check(a,new DMatrixRsvd(300,200,aop,atop,10,10,2),s,1.0e-10);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Singular values 2^(-i/2), decreasing.
+  private static double[] decaying(int n) {
+    double[] s = new double[n];
+    for (int i=0; i<n; ++i)
+      s[i] = Math.pow(2.0,-0.5*i);
+    return s;
+  }
+
+  // Returns A = U*S*V' for random orthonormal columns U and V.
+  private static DMatrix makeMatrix(int m, double[] s) {
+    int n = s.length;
+    Random r = new Random(5);
+    DMatrix u = new DMatrixQrd(random(m,n,r)).getQ();
+    DMatrix v = new DMatrixQrd(random(n,n,r)).getQ();
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        u.set(i,j,u.get(i,j)*s[j]);
+    return u.timesTranspose(v);
+  }
+
+  private static DMatrix random(int m, int n, Random r) {
+    DMatrix x = new DMatrix(m,n);
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        x.set(i,j,r.nextGaussian());
+    return x;
+  }
+
+  private static void check(
+    DMatrix a, DMatrixRsvd svd, double[] s, double tiny)
+  {
+    double[] sk = svd.getSingularValues();
+    int k = sk.length;
+    for (int i=0; i<k; ++i)
+      assertEquals(s[i],sk[i],tiny*s[0]);
+    DMatrix u = svd.getU();
+    DMatrix v = svd.getV();
+    assertEquals(a.getM(),u.getM());
+    assertEquals(a.getN(),v.getM());
+    assertEqual(DMatrix.identity(k,k),u.transposeTimes(u),1.0e-12);
+    assertEqual(DMatrix.identity(k,k),v.transposeTimes(v),1.0e-12);
+
+    // A*V = U*S, for the k largest singular values.
+    assertEqual(u.times(svd.getS()),a.times(v),1.0e-7*s[0]);
+  }
+
+  private static void assertEqual(DMatrix a, DMatrix b, double tiny) {
+    assertEquals(a.getM(),b.getM());
+    assertEquals(a.getN(),b.getN());
+    for (int i=0; i<a.getM(); ++i)
+      for (int j=0; j<a.getN(); ++j)
+        assertEquals(a.get(i,j),b.get(i,j),tiny);
+  }
+}
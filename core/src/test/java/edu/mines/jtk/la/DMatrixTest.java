@@ -148,10 +148,46 @@ public class DMatrixTest extends TestCase {
     assertTrue(trace==t.trace());
   }
 
+  public void testArrayTimesEmpty() {
+    DMatrix a = new DMatrix(0,3);
+    DMatrix c = a.arrayTimes(a);
+    assertEquals(0,c.getM());
+    assertEquals(3,c.getN());
+    assertEquals(0,a.arrayTimesEquals(a).getM());
+  }
+
+  public void testTimes() {
+    int[][] mnks = {{3,4,5},{1,7,1},{65,66,67},{301,530,267}};
+    for (int[] mnk:mnks) {
+      int m = mnk[0], n = mnk[1], k = mnk[2];
+      DMatrix a = DMatrix.random(m,k);
+      DMatrix b = DMatrix.random(k,n);
+      DMatrix c = naiveTimes(a,b);
+      assertEqualFuzzy(c,a.times(b));
+      assertEqualFuzzy(c,a.timesTranspose(b.transpose()));
+      assertEqualFuzzy(c,a.transpose().transposeTimes(b));
+    }
+  }
 
   ///////////////////////////////////////////////////////////////////////////
   // package
 
+  static DMatrix naiveTimes(DMatrix a, DMatrix b) {
+    int m = a.getM();
+    int n = b.getN();
+    int k = a.getN();
+    DMatrix c = new DMatrix(m,n);
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<n; ++j) {
+        double s = 0.0;
+        for (int p=0; p<k; ++p)
+          s += a.get(i,p)*b.get(p,j);
+        c.set(i,j,s);
+      }
+    }
+    return c;
+  }
+
   static void assertEqualExact(DMatrix a, DMatrix b) {
     assertEqual(a,b,false);
   }
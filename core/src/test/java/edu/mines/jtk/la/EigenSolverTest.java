@@ -0,0 +1,161 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.la.EigenSolver}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.22
+ */
+public class EigenSolverTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(EigenSolverTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testLanczos() {
+    int n = 200;
+    double[] d = squares(n);
+    DMatrix a = makeSymmetric(d);
+    EigenSolver es = new EigenSolver(SMALL,NITER);
+    check(a,es.lanczos(a,5,true),d,true);
+    check(a,es.lanczos(a,3,false),d,false);
+  }
+
+  public void testLobpcg() {
+    int n = 100;
+    double[] d = squares(n);
+    DMatrix a = makeSymmetric(d);
+    EigenSolver es = new EigenSolver(SMALL,NITER);
+    check(a,es.lobpcg(a,null,5,true),d,true);
+    EigenSolver.Result r0 = es.lobpcg(a,null,4,false);
+    check(a,r0,d,false);
+
+    // An approximate inverse of A greatly accelerates convergence.
+    final DMatrix m = makeSymmetric(reciprocals(d)).times(1.1);
+    DOperator mop = new DOperator() {
+      public void apply(double[] x, double[] y) {
+        times(m,x,y);
+      }
+    };
+    EigenSolver.Result r1 = es.lobpcg(a,mop,4,false);
+    check(a,r1,d,false);
+    assertTrue(r1.niter<r0.niter);
+  }
+
+  public void testOperator() {
+    int n = 60;
+    CsrDMatrix a = KrylovSolverTest.makeLaplacian(n,1,0.0);
+    double[] d = new double[n];
+    for (int j=0; j<n; ++j)
+      d[j] = 4.0-2.0*Math.cos((n-j)*Math.PI/(n+1)); // decreasing
+    DMatrix ad = new DMatrix(n,n);
+    for (int i=0; i<n; ++i)
+      for (int j=0; j<n; ++j)
+        ad.set(i,j,a.get(i,j));
+    EigenSolver es = new EigenSolver(SMALL,NITER);
+    check(ad,es.lanczos(n,a,4,true),d,true);
+    check(ad,es.lobpcg(n,a,null,4,true),d,true);
+  }
+
+  public void testNotConverged() {
+    DMatrix a = makeSymmetric(squares(200));
+    EigenSolver es = new EigenSolver(SMALL,2);
+    EigenSolver.Result r = es.lobpcg(a,null,5,false);
+    assertFalse(r.converged());
+    assertEquals(2,r.niter);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final double SMALL = 1.0e-10;
+  private static final int NITER = 1000;
+
+  // Eigenvalues (n-i)^2, in decreasing order.
+  private static double[] squares(int n) {
+    double[] d = new double[n];
+    for (int i=0; i<n; ++i)
+      d[i] = (double)(n-i)*(n-i);
+    return d;
+  }
+
+  private static double[] reciprocals(double[] d) {
+    double[] r = new double[d.length];
+    for (int i=0; i<d.length; ++i)
+      r[i] = 1.0/d[i];
+    return r;
+  }
+
+  // Returns A = Q*D*Q' for a random orthogonal matrix Q.
+  private static DMatrix makeSymmetric(double[] d) {
+    int n = d.length;
+    java.util.Random r = new java.util.Random(3);
+    DMatrix g = new DMatrix(n,n);
+    for (int i=0; i<n; ++i)
+      for (int j=0; j<n; ++j)
+        g.set(i,j,r.nextGaussian());
+    DMatrix q = new DMatrixQrd(g).getQ();
+    DMatrix qd = new DMatrix(q);
+    for (int i=0; i<n; ++i)
+      for (int j=0; j<n; ++j)
+        qd.set(i,j,q.get(i,j)*d[j]);
+    DMatrix a = qd.timesTranspose(q);
+    for (int i=0; i<n; ++i)
+      for (int j=0; j<i; ++j)
+        a.set(i,j,a.get(j,i));
+    return a;
+  }
+
+  private static void times(DMatrix a, double[] x, double[] y) {
+    int n = x.length;
+    for (int i=0; i<n; ++i) {
+      double s = 0.0;
+      for (int j=0; j<n; ++j)
+        s += a.get(i,j)*x[j];
+      y[i] = s;
+    }
+  }
+
+  // Checks eigenvalues against d (decreasing), and residuals.
+  private static void check(
+    DMatrix a, EigenSolver.Result r, double[] d, boolean largest)
+  {
+    assertTrue(r.converged());
+    int n = d.length;
+    int k = r.values.length;
+    double scale = Math.max(Math.abs(d[0]),Math.abs(d[n-1]));
+    for (int i=0; i<k; ++i) {
+      double di = largest?d[i]:d[n-1-i];
+      assertEquals(di,r.values[i],1.0e-8*scale);
+      double[] x = new double[n];
+      double[] y = new double[n];
+      for (int j=0; j<n; ++j)
+        x[j] = r.vectors.get(j,i);
+      times(a,x,y);
+      double rr = 0.0, xx = 0.0;
+      for (int j=0; j<n; ++j) {
+        double rj = y[j]-r.values[i]*x[j];
+        rr += rj*rj;
+        xx += x[j]*x[j];
+      }
+      assertEquals(1.0,xx,1.0e-10);
+      assertTrue(Math.sqrt(rr)<=1.0e-6*scale);
+    }
+  }
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.FMatrixTest.assertEqualFuzzy;
+import static edu.mines.jtk.la.FMatrixTest.assertEqualRefined;
+
+/**
+ * Tests {@link edu.mines.jtk.la.FMatrixChd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixChdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(FMatrixChdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testNotPositiveDefinite() {
+    FMatrix a = new FMatrix(new float[][]{
+      {0.0f, 1.0f, 1.0f},
+      {0.0f, 2.0f, 3.0f},
+      {0.0f, 3.0f, 6.0f},
+    });
+    FMatrixChd chd = new FMatrixChd(a);
+    assertFalse(chd.isPositiveDefinite());
+  }
+
+  public void testSimple() {
+    FMatrix a = new FMatrix(new float[][]{
+      {4.0f, 1.0f, 1.0f},
+      {1.0f, 2.0f, 3.0f},
+      {1.0f, 3.0f, 6.0f},
+    });
+    test(a);
+  }
+
+  public void testRandom() {
+    test(makeSpd(10));
+    test(makeSpd(100));
+    test(makeSpd(300));
+  }
+
+  public void testRefine() {
+    int n = 200;
+    FMatrix r = FMatrix.random(n,n);
+    DMatrix a = r.transposeTimes(r).toDMatrix();
+    a.plusEquals(DMatrix.identity(n,n));
+    DMatrix b = DMatrix.random(n,3);
+    final FMatrixChd chd = new FMatrixChd(new FMatrix(a));
+    DMatrix x = chd.solve(a,b);
+    DMatrix y = new DMatrixChd(a).solve(b);
+    assertEqualRefined(x,y);
+    DMatrix z = Refinement.solve(a,b,new Refinement.Solver() {
+      public FMatrix solve(FMatrix r) {
+        return chd.solve(r);
+      }
+    });
+    assertNotNull(z);
+    assertEqualRefined(z,y);
+  }
+
+  public void testRefineNotPositiveDefinite() {
+    DMatrix a = new DMatrix(new double[][]{
+      {1.0, 1.0},
+      {1.0, 1.0+1.0e-9},
+    });
+    DMatrix b = new DMatrix(new double[][]{{1.0},{2.0}});
+    FMatrixChd chd = new FMatrixChd(new FMatrix(a));
+    assertFalse(chd.isPositiveDefinite());
+    DMatrix x = chd.solve(a,b);
+    DMatrix y = new DMatrixChd(a).solve(b);
+    assertEqualRefined(x,y);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static FMatrix makeSpd(int n) {
+    FMatrix r = FMatrix.random(n,n);
+    return r.transposeTimes(r).plus(FMatrix.identity(n,n));
+  }
+
+  private void test(FMatrix a) {
+    int m = a.getM();
+
+    FMatrixChd chd = new FMatrixChd(a);
+    assertTrue(chd.isPositiveDefinite());
+    FMatrix l = chd.getL();
+    FMatrix llt = l.timesTranspose(l);
+    assertEqualFuzzy(a,llt);
+
+    int nrhs = 10;
+    FMatrix b = FMatrix.random(m,nrhs);
+    FMatrix x = chd.solve(b);
+    FMatrix ax = a.times(x);
+    assertEqualFuzzy(ax,b);
+  }
+}
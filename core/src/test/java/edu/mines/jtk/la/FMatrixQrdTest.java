@@ -0,0 +1,70 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.FMatrixTest.assertEqualFuzzy;
+
+/**
+ * Tests {@link edu.mines.jtk.la.FMatrixQrd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixQrdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(FMatrixQrdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testRankDeficient() {
+    FMatrix a = new FMatrix(new float[][]{
+      {0.0f,  0.0f},
+      {3.0f,  4.0f},
+    });
+    FMatrixQrd qrd = new FMatrixQrd(a);
+    assertFalse(qrd.isFullRank());
+  }
+
+  public void testRandom() {
+    test(FMatrix.random(100,100));
+    test(FMatrix.random(101,100));
+  }
+
+  public void testRandomBlocked() {
+    test(FMatrix.random(300,300));
+    test(FMatrix.random(333,300));
+  }
+
+  private void test(FMatrix a) {
+    int m = a.getM();
+    int n = a.getN();
+
+    FMatrixQrd qrd = new FMatrixQrd(a);
+    FMatrix q = qrd.getQ();
+    FMatrix r = qrd.getR();
+    FMatrix qr = q.times(r);
+    assertEqualFuzzy(a,qr);
+
+    if (m==n) {
+      int nrhs = 2;
+      FMatrix b = FMatrix.random(m,nrhs);
+      FMatrix x = qrd.solve(b);
+      FMatrix ax = a.times(x);
+      assertEqualFuzzy(ax,b);
+    }
+  }
+}
@@ -0,0 +1,150 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import static java.lang.Math.max;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.la.FMatrix}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(FMatrixTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testConstruct() {
+    int m = 3;
+    int n = 4;
+
+    FMatrix z1 = new FMatrix(m,n);
+    FMatrix z2 = new FMatrix(m,n,0.0f);
+    assertEqualExact(z1,z2);
+    assertFalse(z1.isSquare());
+
+    FMatrix r1 = FMatrix.random(m,n);
+    FMatrix r2 = new FMatrix(r1);
+    assertEqualExact(r1,r2);
+    assertTrue(r1.equals(r2));
+    assertEquals(r1.hashCode(),r2.hashCode());
+    assertNotSame(r1.getArray(),r2.getArray());
+
+    FMatrix i1 = FMatrix.identity(m,n);
+    FMatrix i2 = new FMatrix(new float[][]{{1,0,0,0},{0,1,0,0},{0,0,1,0}});
+    assertEqualExact(i1,i2);
+  }
+
+  public void testConvert() {
+    DMatrix d = DMatrix.random(5,7);
+    FMatrix f = new FMatrix(d);
+    DMatrix e = f.toDMatrix();
+    for (int i=0; i<5; ++i) {
+      for (int j=0; j<7; ++j) {
+        assertEquals((float)d.get(i,j),f.get(i,j),0.0f);
+        assertEquals(f.get(i,j),e.get(i,j),0.0);
+      }
+    }
+    assertEqualExact(f,new FMatrix(e));
+  }
+
+  public void testOther() {
+    int m = 3;
+    int n = 4;
+
+    FMatrix r = FMatrix.random(m,n);
+    FMatrix s = FMatrix.random(m,n);
+    FMatrix r0 = new FMatrix(r);
+    assertEqualFuzzy(r0,r.plus(s).minus(s));
+    assertEqualFuzzy(r0,r.times(2.0f).times(0.5f));
+    assertEqualFuzzy(r0,r.negate().negate());
+    assertEqualFuzzy(r0,r.transpose().transpose());
+    assertEqualFuzzy(r0,r.arrayTimes(s).arrayRightDivide(s));
+
+    FMatrix t = r.times(r.transpose());
+    assertTrue(t.isSymmetric());
+  }
+
+  public void testTimes() {
+    int[][] mnks = {{3,4,5},{1,7,1},{65,66,67},{301,530,267}};
+    for (int[] mnk:mnks) {
+      int m = mnk[0], n = mnk[1], k = mnk[2];
+      FMatrix a = FMatrix.random(m,k);
+      FMatrix b = FMatrix.random(k,n);
+      FMatrix c = naiveTimes(a,b);
+      assertEqualFuzzy(c,a.times(b));
+      assertEqualFuzzy(c,a.timesTranspose(b.transpose()));
+      assertEqualFuzzy(c,a.transpose().transposeTimes(b));
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // package
+
+  static FMatrix naiveTimes(FMatrix a, FMatrix b) {
+    int m = a.getM();
+    int n = b.getN();
+    int k = a.getN();
+    FMatrix c = new FMatrix(m,n);
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<n; ++j) {
+        double s = 0.0;
+        for (int p=0; p<k; ++p)
+          s += a.get(i,p)*b.get(p,j);
+        c.set(i,j,(float)s);
+      }
+    }
+    return c;
+  }
+
+  static void assertEqualExact(FMatrix a, FMatrix b) {
+    assertEqual(a,b,false);
+  }
+
+  public static void assertEqualFuzzy(FMatrix a, FMatrix b) {
+    assertEqual(a,b,true);
+  }
+
+  static void assertEqual(FMatrix a, FMatrix b, boolean fuzzy) {
+    assertEquals(a.getM(),b.getM());
+    assertEquals(a.getN(),b.getN());
+    int m = a.getM();
+    int n = a.getN();
+    float eps = (fuzzy)?0.001f*max(a.normF(),b.normF()):0.0f;
+    for (int i=0; i<m; ++i) {
+      for (int j=0; j<n; ++j) {
+        assertEquals(a.get(i,j),b.get(i,j),eps);
+      }
+    }
+  }
+
+  // Asserts that the solutions x and y are equal to nearly double
+  // precision, relative to the largest element in y.
+  public static void assertEqualRefined(DMatrix x, DMatrix y) {
+    int m = x.getM();
+    int n = x.getN();
+    double ymax = 0.0;
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        ymax = max(ymax,Math.abs(y.get(i,j)));
+    for (int i=0; i<m; ++i)
+      for (int j=0; j<n; ++j)
+        assertEquals(y.get(i,j),x.get(i,j),1.0e-10*ymax);
+  }
+}
@@ -0,0 +1,160 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.la;
+
+import java.util.ArrayList;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.la.CsrDMatrixTest.makeRandom;
+
+/**
+ * Tests {@link edu.mines.jtk.la.KrylovSolver} and
+ * {@link edu.mines.jtk.la.Preconditioners}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.18
+ */
+public class KrylovSolverTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(KrylovSolverTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testCg() {
+    CsrDMatrix a = makeLaplacian(60,70,0.0);
+    KrylovSolver ks = new KrylovSolver(SMALL,NITER);
+    int n0 = test(a,null,ks,CG);
+    int n1 = test(a,Preconditioners.jacobi(a),ks,CG);
+    int n2 = test(a,Preconditioners.ic0(a),ks,CG);
+    assertTrue(n2<n0);
+    assertTrue(n2<n1);
+  }
+
+  public void testIc0NotPositive() {
+    CsrDMatrix a = new CsrDMatrix(new DMatrix(new double[][]{
+      { 2.0, 1.0},
+      { 1.0,-1.0}
+    }));
+    try {
+      Preconditioners.ic0(a);
+      fail("non-positive diagonal element");
+    } catch (IllegalArgumentException e) {
+      // expected
+    }
+  }
+
+  public void testBicgstab() {
+    CsrDMatrix a = makeLaplacian(60,70,0.3);
+    KrylovSolver ks = new KrylovSolver(SMALL,NITER);
+    int n0 = test(a,null,ks,BICGSTAB);
+    test(a,Preconditioners.jacobi(a),ks,BICGSTAB);
+    int n2 = test(a,Preconditioners.ilu0(a),ks,BICGSTAB);
+    assertTrue(n2<n0);
+  }
+
+  public void testGmres() {
+    CsrDMatrix a = makeLaplacian(24,30,0.3);
+    KrylovSolver ks = new KrylovSolver(SMALL,NITER);
+    int n0 = test(a,null,ks,GMRES);
+    test(a,Preconditioners.jacobi(a),ks,GMRES);
+    int n2 = test(a,Preconditioners.ilu0(a),ks,GMRES);
+    assertTrue(n2<n0);
+  }
+
+  public void testNotConverged() {
+    CsrDMatrix a = makeLaplacian(60,70,0.0);
+    KrylovSolver ks = new KrylovSolver(SMALL,5);
+    double[] b = makeRandom(a.getM());
+    double[] x = new double[a.getN()];
+    KrylovSolver.Result r = ks.cg(a,null,b,x);
+    assertFalse(r.converged());
+    assertEquals(5,r.niter);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // package
+
+  // Five-point Laplacian plus an advection term with coefficient c,
+  // which makes the matrix non-symmetric if c is non-zero.
+  static CsrDMatrix makeLaplacian(int n1, int n2, double c) {
+    ArrayList<Integer> il = new ArrayList<Integer>();
+    ArrayList<Integer> jl = new ArrayList<Integer>();
+    ArrayList<Double> vl = new ArrayList<Double>();
+    for (int i2=0; i2<n2; ++i2) {
+      for (int i1=0; i1<n1; ++i1) {
+        int i = i1+i2*n1;
+        add(il,jl,vl,i,i,4.0);
+        if (i1>0) add(il,jl,vl,i,i-1,-1.0-c);
+        if (i1<n1-1) add(il,jl,vl,i,i+1,-1.0+c);
+        if (i2>0) add(il,jl,vl,i,i-n1,-1.0);
+        if (i2<n2-1) add(il,jl,vl,i,i+n1,-1.0);
+      }
+    }
+    int nt = il.size();
+    int[] i = new int[nt];
+    int[] j = new int[nt];
+    double[] v = new double[nt];
+    for (int it=0; it<nt; ++it) {
+      i[it] = il.get(it);
+      j[it] = jl.get(it);
+      v[it] = vl.get(it);
+    }
+    return CsrDMatrix.fromTriplets(n1*n2,n1*n2,i,j,v);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static final double SMALL = 1.0e-8;
+  private static final int NITER = 2000;
+  private static final int CG = 0, BICGSTAB = 1, GMRES = 2;
+
+  // Returns the number of iterations required.
+  private static int test(
+    CsrDMatrix a, DOperator m, KrylovSolver ks, int method)
+  {
+    int n = a.getN();
+    double[] b = makeRandom(n);
+    double[] x = new double[n];
+    KrylovSolver.Result r;
+    if (method==CG) {
+      r = ks.cg(a,m,b,x);
+    } else if (method==BICGSTAB) {
+      r = ks.bicgstab(a,m,b,x);
+    } else {
+      r = ks.gmres(a,m,b,x,40);
+    }
+    assertTrue(r.converged());
+    assertTrue(r.rnorm<=SMALL);
+    double[] y = a.times(x);
+    double rr = 0.0, bb = 0.0;
+    for (int i=0; i<n; ++i) {
+      rr += (b[i]-y[i])*(b[i]-y[i]);
+      bb += b[i]*b[i];
+    }
+    assertTrue(Math.sqrt(rr/bb)<=10.0*SMALL);
+    return r.niter;
+  }
+
+  private static void add(
+    ArrayList<Integer> il, ArrayList<Integer> jl, ArrayList<Double> vl,
+    int i, int j, double v)
+  {
+    il.add(i);
+    jl.add(j);
+    vl.add(v);
+  }
+}
@@ -45,6 +45,73 @@ public class TridiagonalFMatrixTest extends TestCase {
     assertEqualFuzzy(r,s);
   }
 
+  public void testSolveMany() {
+    int n = 101;
+    int m = 1000;
+    TridiagonalFMatrix t = makeMatrix(n);
+    float[][] r = randfloat(n,m);
+    float[][] u1 = zerofloat(n,m);
+    t.solve1(r,u1);
+    for (int i=0; i<m; ++i)
+      assertNearlyEqual(r[i],t.times(u1[i]));
+    float[][] rt = transpose(r);
+    float[][] u2 = zerofloat(m,n);
+    t.solve2(rt,u2);
+    assertNearlyEqual(u1,transpose(u2));
+  }
+
+  public void testSolveParallel() {
+    int[] ns = {1,2,3,7,8,100,1023,1024,1025,100000};
+    for (int n:ns) {
+      TridiagonalFMatrix t = makeMatrix(n);
+      float[] r = randfloat(n);
+      float[] u = zerofloat(n);
+      t.solveParallel(r,u);
+      assertNearlyEqual(r,t.times(u));
+    }
+  }
+
+  public void testSolveBatch() {
+    int n = 50;
+    int m = 1000;
+    float[][] a = randfloat(m,n);
+    float[][] b = randfloat(m,n);
+    float[][] c = randfloat(m,n);
+    float[][] r = randfloat(m,n);
+    float[][] u = zerofloat(m,n);
+    add(b,add(a,c),b);
+    TridiagonalFMatrix.solveBatch(a,b,c,r,u);
+    float[][] ut = transpose(u);
+    float[][] at = transpose(a), bt = transpose(b), ct = transpose(c);
+    float[][] rt = transpose(r);
+    for (int k=0; k<m; ++k) {
+      TridiagonalFMatrix t = new TridiagonalFMatrix(n,at[k],bt[k],ct[k]);
+      assertNearlyEqual(rt[k],t.times(ut[k]));
+    }
+  }
+
+  private static TridiagonalFMatrix makeMatrix(int n) {
+    float[] a = randfloat(n);
+    float[] b = randfloat(n);
+    float[] c = randfloat(n);
+    for (int i=0; i<n; ++i)
+      b[i] += a[i]+c[i]+1.0f; // diagonally dominant
+    return new TridiagonalFMatrix(n,a,b,c);
+  }
+
+  private static void assertNearlyEqual(float[][] a, float[][] b) {
+    for (int i=0; i<a.length; ++i)
+      assertNearlyEqual(a[i],b[i]);
+  }
+
+  private static void assertNearlyEqual(float[] a, float[] b) {
+    int n = a.length;
+    double eps = 0.00001*max(max(abs(a)),max(abs(b)));
+    for (int j=0; j<n; ++j) {
+      assertEquals(a[j],b[j],eps);
+    }
+  }
+
   private static void assertEqualFuzzy(float[] a, float[] b) {
     int n = a.length;
     double eps = 0.000001*max(max(a),max(b));
@@ -0,0 +1,59 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.lapack;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.la.FMatrix;
+
+import static edu.mines.jtk.la.FMatrixTest.assertEqualFuzzy;
+
+/**
+ * Tests {@link edu.mines.jtk.lapack.FMatrixEvd}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixEvdTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(FMatrixEvdTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testSymmetric() {
+    test(new FMatrix(new float[][]{
+      {4,1,1},
+      {1,2,3},
+      {1,3,6}
+    }));
+  }
+
+  public void testRandom() {
+    int n = 100;
+    FMatrix r = FMatrix.random(n,n);
+    test(r.transposeTimes(r));
+  }
+
+  private void test(FMatrix a) {
+    FMatrixEvd evd = new FMatrixEvd(a);
+    FMatrix d = evd.getD();
+    FMatrix v = evd.getV();
+    assertEqualFuzzy(a.times(v),v.times(d));
+    assertEqualFuzzy(a,v.times(d).timesTranspose(v));
+    float[] e = evd.getRealEigenvalues();
+    for (int i=1; i<e.length; ++i)
+      assertTrue(e[i-1]<=e[i]);
+  }
+}
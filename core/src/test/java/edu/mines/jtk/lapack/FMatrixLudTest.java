@@ -0,0 +1,111 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.lapack;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.la.DMatrix;
+import edu.mines.jtk.la.DMatrixLud;
+import edu.mines.jtk.la.FMatrix;
+
+import static edu.mines.jtk.la.FMatrixTest.assertEqualFuzzy;
+import static edu.mines.jtk.la.FMatrixTest.assertEqualRefined;
+
+/**
+ * Tests {@link edu.mines.jtk.lapack.FMatrixLud}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.16
+ */
+public class FMatrixLudTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(FMatrixLudTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testSingular() {
+    FMatrix a = new FMatrix(new float[][]{
+      {0.0f,  0.0f},
+      {3.0f,  4.0f},
+    });
+    FMatrixLud lud = new FMatrixLud(a);
+    assertTrue(lud.isSingular());
+  }
+
+  public void testSimple() {
+    test(new FMatrix(new float[][]{
+      {0.0f,  2.0f},
+      {3.0f,  4.0f},
+    }));
+    test(new FMatrix(new float[][]{
+      {0.0f,  2.0f},
+      {3.0f,  4.0f},
+      {5.0f,  6.0f},
+    }));
+  }
+
+  public void testRandom() {
+    test(FMatrix.random(100,100));
+    test(FMatrix.random(101,100));
+  }
+
+  public void testRandomBlocked() {
+    test(FMatrix.random(300,300));
+    test(FMatrix.random(333,300));
+  }
+
+  public void testRefine() {
+    int n = 200;
+    DMatrix a = DMatrix.random(n,n);
+    DMatrix b = DMatrix.random(n,3);
+    FMatrixLud lud = new FMatrixLud(new FMatrix(a));
+    DMatrix x = lud.solve(a,b);
+    DMatrix y = new DMatrixLud(a).solve(b);
+    assertEqualRefined(x,y);
+  }
+
+  public void testRefineSingular() {
+    DMatrix a = new DMatrix(new double[][]{
+      {1.0, 1.0},
+      {1.0, 1.0+1.0e-9},
+    });
+    DMatrix b = new DMatrix(new double[][]{{1.0},{2.0}});
+    FMatrixLud lud = new FMatrixLud(new FMatrix(a));
+    assertTrue(lud.isSingular());
+    DMatrix x = lud.solve(a,b);
+    DMatrix y = new DMatrixLud(a).solve(b);
+    assertEqualRefined(x,y);
+  }
+
+  private void test(FMatrix a) {
+    int m = a.getM();
+    int n = a.getN();
+
+    FMatrixLud lud = new FMatrixLud(a);
+    int[] piv = lud.getPivotIndices();
+    FMatrix l = lud.getL();
+    FMatrix u = lud.getU();
+    FMatrix lu = l.times(u);
+    assertEqualFuzzy(a.get(piv,null),lu);
+
+    if (m==n) {
+      int nrhs = 2;
+      FMatrix b = FMatrix.random(m,nrhs);
+      FMatrix x = lud.solve(b);
+      FMatrix ax = a.times(x);
+      assertEqualFuzzy(ax,b);
+    }
+  }
+}
@@ -0,0 +1,200 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mesh.CompactTetMesh}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.28
+ */
+public class CompactTetMeshTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(CompactTetMeshTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTetMesh() {
+    Random random = new Random(314159);
+    TetMesh tm = new TetMesh();
+    for (int inode=0; inode<1000; ++inode) {
+      float x = random.nextFloat();
+      float y = random.nextFloat();
+      float z = random.nextFloat();
+      tm.addNode(new TetMesh.Node(x,y,z));
+    }
+    CompactTetMesh cm = new CompactTetMesh(tm);
+    assertEquals(tm.countNodes(),cm.countNodes());
+    assertEquals(tm.countTets(),cm.countTets());
+    checkNabors(cm);
+    for (int itest=0; itest<1000; ++itest) {
+      float x = 1.2f*random.nextFloat()-0.1f;
+      float y = 1.2f*random.nextFloat()-0.1f;
+      float z = 1.2f*random.nextFloat()-0.1f;
+      TetMesh.PointLocation pl = tm.locatePoint(x,y,z);
+      int tet = cm.findTet(x,y,z);
+      assertEquals(pl.isOutside(),tet<0);
+      if (tet>=0)
+        assertTrue(contains(cm,tet,x,y,z));
+      TetMesh.Node node = tm.findNodeNearest(x,y,z);
+      int inode = cm.findNodeNearest(x,y,z);
+      assertEquals(node.x(),cm.x(inode));
+      assertEquals(node.y(),cm.y(inode));
+      assertEquals(node.z(),cm.z(inode));
+    }
+  }
+
+  public void testPoints() {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be in tets
+    z[nnode-1] = z[0];
+    CompactTetMesh cm = new CompactTetMesh(x,y,z);
+    assertEquals(nnode,cm.countNodes());
+    assertTrue(cm.tet(0)>=0);
+    assertTrue(cm.tet(nnode-1)<0);
+    checkNabors(cm);
+    for (int inode=1; inode<nnode-1; ++inode) {
+      int[] tets = cm.getTetNabors(inode);
+      for (int tet:tets) {
+        boolean found = false;
+        for (int k=0; k<4; ++k)
+          found = found || cm.tetNode(tet,k)==inode;
+        assertTrue(found);
+      }
+    }
+    CompactTetMesh cn = new CompactTetMesh(x,y,z,cm.getTetNodes());
+    assertEquals(cm.countTets(),cn.countTets());
+    int ntet = cm.countTets();
+    for (int tet=0; tet<ntet; ++tet)
+      for (int k=0; k<4; ++k)
+        assertEquals(cm.tetNabor(tet,k),cn.tetNabor(tet,k));
+  }
+
+  public void testDuplicates() {
+    Random random = new Random(314159);
+    int nnode = 50000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    for (int inode=1; inode<nnode; inode+=7) {
+      int jnode = random.nextInt(inode); // an earlier node
+      x[inode] = x[jnode];
+      y[inode] = y[jnode];
+      z[inode] = z[jnode];
+    }
+    CompactTetMesh cm;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      cm = new CompactTetMesh(x,y,z);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    assertEquals(nnode,cm.countNodes());
+    checkNabors(cm);
+    int[] first = SpatialOrder.duplicates(x,y,z);
+    for (int inode=0; inode<nnode; ++inode)
+      assertEquals(first[inode]==inode,cm.tet(inode)>=0);
+  }
+
+  public void testNaturalNabors() {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    CompactTetMesh cm = new CompactTetMesh(x,y,z);
+    for (int itest=0; itest<100; ++itest) {
+      float xp = 0.2f+0.6f*random.nextFloat();
+      float yp = 0.2f+0.6f*random.nextFloat();
+      float zp = 0.2f+0.6f*random.nextFloat();
+      int[] tets = cm.getNaturalNaborTets(xp,yp,zp);
+      int ntet = cm.countTets();
+      int nsphere = 0;
+      for (int tet=0; tet<ntet; ++tet)
+        if (inSphere(cm,tet,xp,yp,zp))
+          ++nsphere;
+      assertEquals(nsphere,tets.length);
+      assertTrue(cm.getNaturalNaborNodes(xp,yp,zp).length>=4);
+    }
+  }
+
+  private static void checkNabors(CompactTetMesh cm) {
+    int ntet = cm.countTets();
+    for (int tet=0; tet<ntet; ++tet) {
+      for (int k=0; k<4; ++k) {
+        int nabor = cm.tetNabor(tet,k);
+        if (nabor>=0) {
+          boolean found = false;
+          for (int l=0; l<4; ++l)
+            found = found || cm.tetNabor(nabor,l)==tet;
+          assertTrue(found);
+        }
+      }
+    }
+  }
+
+  private static boolean contains(
+    CompactTetMesh cm, int tet, float x, float y, float z)
+  {
+    int[] n = new int[4];
+    for (int k=0; k<4; ++k)
+      n[k] = cm.tetNode(tet,k);
+    double[][] p = new double[4][];
+    for (int k=0; k<4; ++k)
+      p[k] = new double[]{cm.x(n[k]),cm.y(n[k]),cm.z(n[k])};
+    double[] q = {x,y,z};
+    return Geometry.leftOfPlane(p[1],p[2],p[3],q)<=0.0 &&
+           Geometry.leftOfPlane(p[3],p[2],p[0],q)<=0.0 &&
+           Geometry.leftOfPlane(p[3],p[0],p[1],q)<=0.0 &&
+           Geometry.leftOfPlane(p[0],p[2],p[1],q)<=0.0;
+  }
+
+  private static boolean inSphere(
+    CompactTetMesh cm, int tet, float x, float y, float z)
+  {
+    int na = cm.tetNode(tet,0), nb = cm.tetNode(tet,1);
+    int nc = cm.tetNode(tet,2), nd = cm.tetNode(tet,3);
+    return Geometry.inSphere(
+      cm.x(na),cm.y(na),cm.z(na),
+      cm.x(nb),cm.y(nb),cm.z(nb),
+      cm.x(nc),cm.y(nc),cm.z(nc),
+      cm.x(nd),cm.y(nd),cm.z(nd),
+      x,y,z)>0.0;
+  }
+}
@@ -0,0 +1,173 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mesh.CompactTriMesh}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.03.28
+ */
+public class CompactTriMeshTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(CompactTriMeshTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTriMesh() {
+    Random random = new Random(314159);
+    TriMesh tm = new TriMesh();
+    for (int inode=0; inode<1000; ++inode) {
+      float x = random.nextFloat();
+      float y = random.nextFloat();
+      tm.addNode(new TriMesh.Node(x,y));
+    }
+    CompactTriMesh cm = new CompactTriMesh(tm);
+    assertEquals(tm.countNodes(),cm.countNodes());
+    assertEquals(tm.countTris(),cm.countTris());
+    checkNabors(cm);
+    for (int itest=0; itest<1000; ++itest) {
+      float x = 1.2f*random.nextFloat()-0.1f;
+      float y = 1.2f*random.nextFloat()-0.1f;
+      TriMesh.PointLocation pl = tm.locatePoint(x,y);
+      int tri = cm.findTri(x,y);
+      assertEquals(pl.isOutside(),tri<0);
+      if (tri>=0)
+        assertTrue(contains(cm,tri,x,y));
+      TriMesh.Node node = tm.findNodeNearest(x,y);
+      int inode = cm.findNodeNearest(x,y);
+      assertEquals(node.x(),cm.x(inode));
+      assertEquals(node.y(),cm.y(inode));
+    }
+  }
+
+  public void testPoints() {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be in tris
+    CompactTriMesh cm = new CompactTriMesh(x,y);
+    assertEquals(nnode,cm.countNodes());
+    assertTrue(cm.tri(0)>=0);
+    assertTrue(cm.tri(nnode-1)<0);
+    checkNabors(cm);
+    CompactTriMesh cn = new CompactTriMesh(x,y,cm.getTriNodes());
+    assertEquals(cm.countTris(),cn.countTris());
+    int ntri = cm.countTris();
+    for (int tri=0; tri<ntri; ++tri)
+      for (int k=0; k<3; ++k)
+        assertEquals(cm.triNabor(tri,k),cn.triNabor(tri,k));
+  }
+
+  public void testDuplicates() {
+    Random random = new Random(314159);
+    int nnode = 100000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    for (int inode=1; inode<nnode; inode+=7) {
+      int jnode = random.nextInt(inode); // an earlier node
+      x[inode] = x[jnode];
+      y[inode] = y[jnode];
+    }
+    CompactTriMesh cm;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      cm = new CompactTriMesh(x,y);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    assertEquals(nnode,cm.countNodes());
+    checkNabors(cm);
+    int[] first = SpatialOrder.duplicates(x,y);
+    for (int inode=0; inode<nnode; ++inode)
+      assertEquals(first[inode]==inode,cm.tri(inode)>=0);
+  }
+
+  public void testNaturalNabors() {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    CompactTriMesh cm = new CompactTriMesh(x,y);
+    for (int itest=0; itest<100; ++itest) {
+      float xp = 0.2f+0.6f*random.nextFloat();
+      float yp = 0.2f+0.6f*random.nextFloat();
+      int[] tris = cm.getNaturalNaborTris(xp,yp);
+      int ntri = cm.countTris();
+      int ncircle = 0;
+      for (int tri=0; tri<ntri; ++tri)
+        if (inCircle(cm,tri,xp,yp))
+          ++ncircle;
+      assertEquals(ncircle,tris.length);
+      assertTrue(cm.getNaturalNaborNodes(xp,yp).length>=3);
+    }
+  }
+
+  private static void checkNabors(CompactTriMesh cm) {
+    int ntri = cm.countTris();
+    for (int tri=0; tri<ntri; ++tri) {
+      for (int k=0; k<3; ++k) {
+        int nabor = cm.triNabor(tri,k);
+        if (nabor>=0) {
+          boolean found = false;
+          for (int l=0; l<3; ++l)
+            found = found || cm.triNabor(nabor,l)==tri;
+          assertTrue(found);
+        }
+      }
+    }
+  }
+
+  private static boolean contains(
+    CompactTriMesh cm, int tri, float x, float y)
+  {
+    int na = cm.triNode(tri,0), nb = cm.triNode(tri,1), nc = cm.triNode(tri,2);
+    double xa = cm.x(na), ya = cm.y(na);
+    double xb = cm.x(nb), yb = cm.y(nb);
+    double xc = cm.x(nc), yc = cm.y(nc);
+    return Geometry.leftOfLine(xa,ya,xb,yb,x,y)>=0.0 &&
+           Geometry.leftOfLine(xb,yb,xc,yc,x,y)>=0.0 &&
+           Geometry.leftOfLine(xc,yc,xa,ya,x,y)>=0.0;
+  }
+
+  private static boolean inCircle(
+    CompactTriMesh cm, int tri, float x, float y)
+  {
+    int na = cm.triNode(tri,0), nb = cm.triNode(tri,1), nc = cm.triNode(tri,2);
+    return Geometry.inCircle(
+      cm.x(na),cm.y(na),
+      cm.x(nb),cm.y(nb),
+      cm.x(nc),cm.y(nc),
+      x,y)>0.0;
+  }
+}
@@ -14,6 +14,8 @@ limitations under the License.
 ****************************************************************************/
 package edu.mines.jtk.mesh;
 
+import java.util.Random;
+
 import junit.framework.TestCase;
 import junit.framework.TestSuite;
 
@@ -205,6 +207,49 @@ public class GeometryTest extends TestCase {
     assertTrue(rf!=0.0);
   }
 
+  public void testFiltered() {
+    Random r = new Random(314159);
+    int n = 1000;
+    double[] x = new double[n];
+    double[] y = new double[n];
+    double[] z = new double[n];
+    for (int itest=0; itest<100; ++itest) {
+
+      // Half of the tests use points on a small grid, with many points
+      // in planes and on spheres; the other half use nearly coplanar
+      // points with coordinates like those in the special tests above.
+      for (int i=0; i<n; ++i) {
+        if (itest%2==0) {
+          x[i] = r.nextInt(4);
+          y[i] = r.nextInt(4);
+          z[i] = r.nextInt(4);
+        } else {
+          x[i] = 100.0+10.0*r.nextDouble();
+          y[i] = 125.85385+1.0e-9*r.nextDouble();
+          z[i] = 4.71224+1.0e-9*r.nextDouble();
+        }
+      }
+      double xa = x[0], ya = y[0], za = z[0];
+      double xb = x[1], yb = y[1], zb = z[1];
+      double xc = x[2], yc = y[2], zc = z[2];
+      double xd = x[3], yd = y[3], zd = z[3];
+      for (int i=0; i<n; ++i) {
+        double ra = Geometry.leftOfPlane(
+          xa,ya,za,xb,yb,zb,xc,yc,zc,x[i],y[i],z[i]);
+        double rf = Geometry.leftOfPlaneFiltered(
+          xa,ya,za,xb,yb,zb,xc,yc,zc,x[i],y[i],z[i]);
+        assertTrue(Math.signum(ra)==Math.signum(rf));
+      }
+      for (int i=0; i<n; ++i) {
+        double ra = Geometry.inSphere(
+          xa,ya,za,xb,yb,zb,xc,yc,zc,xd,yd,zd,x[i],y[i],z[i]);
+        double rf = Geometry.inSphereFiltered(
+          xa,ya,za,xb,yb,zb,xc,yc,zc,xd,yd,zd,x[i],y[i],z[i]);
+        assertTrue(Math.signum(ra)==Math.signum(rf));
+      }
+    }
+  }
+
   public void xtestInSphereSpeed() {
     float pa[] = {1.0f,0.0f,0.0f};
     float pb[] = {0.0f,1.0f,0.0f};
@@ -0,0 +1,176 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.io.File;
+import java.io.IOException;
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.io.ArrayFile;
+
+/**
+ * Tests {@link edu.mines.jtk.mesh.MeshFile}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.04
+ */
+public class MeshFileTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(MeshFileTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTetMesh() throws IOException {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    TetMesh ta = new TetMesh();
+    TetMesh.Node[] nodes = ta.addNodes(x,y,z);
+    for (int inode=0; inode<nnode; ++inode)
+      nodes[inode].index = inode;
+    File file = null;
+    ArrayFile af = null;
+    try {
+      file = File.createTempFile("junk","dat");
+      af = new ArrayFile(file,"rw");
+      MeshFile.write(af,ta);
+      af.seek(0);
+      TetMesh tb = MeshFile.readTetMesh(af);
+      tb.validate();
+      assertEquals(ta.countNodes(),tb.countNodes());
+      assertEquals(ta.countTets(),tb.countTets());
+      TetMesh.NodeIterator ni = tb.getNodes();
+      while (ni.hasNext()) {
+        TetMesh.Node node = ni.next();
+        assertEquals(x[node.index],node.x());
+        assertEquals(y[node.index],node.y());
+        assertEquals(z[node.index],node.z());
+      }
+      af.seek(0);
+      CompactTetMesh cm = MeshFile.readCompactTetMesh(af);
+      assertEquals(ta.countNodes(),cm.countNodes());
+      assertEquals(ta.countTets(),cm.countTets());
+      af.seek(0);
+      MeshFile.write(af,cm);
+      af.seek(0);
+      TetMesh tc = MeshFile.readTetMesh(af);
+      tc.validate();
+      assertEquals(ta.countTets(),tc.countTets());
+    } finally {
+      if (af!=null)
+        af.close();
+      if (file!=null)
+        file.delete();
+    }
+  }
+
+  public void testTriMesh() throws IOException {
+    Random random = new Random(314159);
+    int nnode = 1000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node, in no tris
+    y[nnode-1] = y[0]; // of the compact mesh
+    CompactTriMesh ca = new CompactTriMesh(x,y);
+    File file = null;
+    ArrayFile af = null;
+    try {
+      file = File.createTempFile("junk","dat");
+      af = new ArrayFile(file,"rw");
+      MeshFile.write(af,ca);
+      af.seek(0);
+      CompactTriMesh cb = MeshFile.readCompactTriMesh(af);
+      assertEquals(ca.countNodes(),cb.countNodes());
+      assertEquals(ca.countTris(),cb.countTris());
+      af.seek(0);
+      TriMesh ta = MeshFile.readTriMesh(af);
+      ta.validate();
+      assertEquals(nnode-1,ta.countNodes());
+      assertEquals(ca.countTris(),ta.countTris());
+      af.seek(0);
+      MeshFile.write(af,ta);
+      af.seek(0);
+      TriMesh tb = MeshFile.readTriMesh(af);
+      tb.validate();
+      assertEquals(ta.countTris(),tb.countTris());
+    } finally {
+      if (af!=null)
+        af.close();
+      if (file!=null)
+        file.delete();
+    }
+  }
+
+  public void testTriSurf() throws IOException {
+    TriSurf sa = new TriSurf();
+    for (int i=0; i<8; ++i)
+      sa.addNode(new TriSurf.Node(i&1,(i>>1)&1,(i>>2)&1));
+    assertEquals(12,sa.countFaces());
+    File file = null;
+    ArrayFile af = null;
+    try {
+      file = File.createTempFile("junk","dat");
+      af = new ArrayFile(file,"rw");
+      MeshFile.write(af,sa);
+      af.seek(0);
+      TriSurf sb = MeshFile.readTriSurf(af);
+      assertEquals(8,sb.countNodes());
+      assertEquals(12,sb.countFaces());
+    } finally {
+      if (af!=null)
+        af.close();
+      if (file!=null)
+        file.delete();
+    }
+  }
+
+  public void testByteOrder() throws IOException {
+    TriMesh ta = new TriMesh();
+    ta.addNodes(new float[]{0.0f,1.0f,0.0f},new float[]{0.0f,0.0f,1.0f});
+    File file = null;
+    ArrayFile af = null;
+    try {
+      file = File.createTempFile("junk","dat");
+      af = new ArrayFile(file,"rw",
+        java.nio.ByteOrder.BIG_ENDIAN,java.nio.ByteOrder.LITTLE_ENDIAN);
+      MeshFile.write(af,ta);
+      af.seek(0);
+      try {
+        MeshFile.readTriMesh(af);
+        fail("expected IOException for different byte order");
+      } catch (IOException e) {
+        assertTrue(true);
+      }
+    } finally {
+      if (af!=null)
+        af.close();
+      if (file!=null)
+        file.delete();
+    }
+  }
+}
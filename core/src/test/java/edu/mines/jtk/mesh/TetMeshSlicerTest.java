@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mesh;
+
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mesh.TetMeshSlicer}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.12
+ */
+public class TetMeshSlicerTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(TetMeshSlicerTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testSlice() {
+    CompactTetMesh mesh = makeCubeMesh(2000);
+    TetMeshSlicer slicer = new TetMeshSlicer(mesh);
+    int nnode = mesh.countNodes();
+    float[] f = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode)
+      f[inode] = mesh.x(inode)+mesh.y(inode);
+    float[][] xyzf = slicer.slice(0.0,0.0,1.0,-0.3,f);
+    float[] xyz = xyzf[0];
+    float[] fv = xyzf[1];
+    int ntri = xyz.length/9;
+    assertEquals(3*ntri,fv.length);
+    for (int iv=0; iv<3*ntri; ++iv) {
+      float x = xyz[3*iv], y = xyz[3*iv+1], z = xyz[3*iv+2];
+      assertEquals(0.3f,z,1.0e-5f);
+      assertEquals(x+y,fv[iv],1.0e-5f);
+    }
+    assertEquals(1.0,area(xyz,0.0f,0.0f,1.0f),1.0e-4);
+  }
+
+  public void testIsosurface() {
+    CompactTetMesh mesh = makeCubeMesh(2000);
+    TetMeshSlicer slicer = new TetMeshSlicer(mesh);
+    int nnode = mesh.countNodes();
+    float[] g = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode)
+      g[inode] = mesh.x(inode)+mesh.y(inode)+mesh.z(inode);
+    float[] xyz = slicer.isosurface(g,1.5f);
+    int nv = xyz.length/3;
+    for (int iv=0; iv<nv; ++iv)
+      assertEquals(1.5f,xyz[3*iv]+xyz[3*iv+1]+xyz[3*iv+2],1.0e-5f);
+    float s = (float)(1.0/Math.sqrt(3.0));
+    double area = 0.75*Math.sqrt(3.0); // area of hexagon in unit cube
+    assertEquals(area,area(xyz,s,s,s),1.0e-4);
+    assertEquals(0,slicer.isosurface(g,4.0f).length);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  // Mesh with nodes at the corners of the unit cube and at random points
+  // inside the cube.
+  private static CompactTetMesh makeCubeMesh(int n) {
+    Random random = new Random(314159);
+    float[] x = new float[n];
+    float[] y = new float[n];
+    float[] z = new float[n];
+    for (int i=0; i<8; ++i) {
+      x[i] = i%2;
+      y[i] = (i/2)%2;
+      z[i] = i/4;
+    }
+    for (int i=8; i<n; ++i) {
+      x[i] = random.nextFloat();
+      y[i] = random.nextFloat();
+      z[i] = random.nextFloat();
+    }
+    return new CompactTetMesh(x,y,z);
+  }
+
+  // Sum of areas of triangles. Asserts that all triangle normals have
+  // positive dot products with the specified vector (u,v,w).
+  private static double area(float[] xyz, float u, float v, float w) {
+    double area = 0.0;
+    int ntri = xyz.length/9;
+    for (int itri=0,i=0; itri<ntri; ++itri,i+=9) {
+      double ux = xyz[i+3]-xyz[i  ];
+      double uy = xyz[i+4]-xyz[i+1];
+      double uz = xyz[i+5]-xyz[i+2];
+      double vx = xyz[i+6]-xyz[i  ];
+      double vy = xyz[i+7]-xyz[i+1];
+      double vz = xyz[i+8]-xyz[i+2];
+      double nx = uy*vz-uz*vy;
+      double ny = uz*vx-ux*vz;
+      double nz = ux*vy-uy*vx;
+      double dot = nx*u+ny*v+nz*w;
+      assertTrue(dot>=-1.0e-10);
+      area += 0.5*dot;
+    }
+    return area;
+  }
+}
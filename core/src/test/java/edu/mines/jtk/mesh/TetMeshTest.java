@@ -351,6 +351,256 @@ public class TetMeshTest extends TestCase {
     //System.out.println("Nodes added/removed = "+nadd+"/"+nremove);
   }
 
+  public void testAddNodes() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 2000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be added
+    z[nnode-1] = z[0];
+    TetMesh ta = new TetMesh();
+    for (int inode=0; inode<nnode; ++inode)
+      ta.addNode(new TetMesh.Node(x[inode],y[inode],z[inode]));
+    TetMesh tb = new TetMesh();
+    TetMesh.Node[] nodes = tb.addNodes(x,y,z);
+    tb.validate();
+    assertEquals(nnode-1,tb.countNodes());
+    assertEquals(ta.countTets(),tb.countTets());
+    assertTrue((nodes[0]==null)!=(nodes[nnode-1]==null));
+    for (int inode=1; inode<nnode-1; ++inode)
+      assertTrue(nodes[inode].tet()!=null);
+  }
+
+  public void testAddNodesParallel() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 50000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+      z[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be added
+    z[nnode-1] = z[0];
+    TetMesh ta = new TetMesh();
+    TetMesh.Node[] nodesa = ta.addNodes(x,y,z);
+    TetMesh tb = new TetMesh();
+    TetMesh.Node[] nodesb;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      nodesb = tb.addNodesParallel(x,y,z);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    tb.validate();
+    assertEquals(nnode-1,tb.countNodes());
+    assertEquals(ta.countTets(),tb.countTets());
+    assertTrue((nodesb[0]==null)!=(nodesb[nnode-1]==null));
+    for (int inode=1; inode<nnode-1; ++inode) {
+      int na = ta.getTetNabors(nodesa[inode]).length;
+      int nb = tb.getTetNabors(nodesb[inode]).length;
+      assertEquals(na,nb);
+    }
+  }
+
+  public void testAddNodesParallelGrid() {
+    int n1 = 40, n2 = 40, n3 = 40;
+    int nnode = n1*n2*n3;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    float[] z = new float[nnode];
+    for (int i3=0,inode=0; i3<n3; ++i3) {
+      for (int i2=0; i2<n2; ++i2) {
+        for (int i1=0; i1<n1; ++i1,++inode) {
+          x[inode] = i1;
+          y[inode] = i2;
+          z[inode] = i3;
+        }
+      }
+    }
+    TetMesh mesh = new TetMesh();
+    TetMesh.Node[] nodes;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      nodes = mesh.addNodesParallel(x,y,z);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    mesh.validate();
+    assertEquals(nnode,mesh.countNodes());
+    for (int inode=0; inode<nnode; ++inode)
+      assertTrue(nodes[inode].tet()!=null);
+    double volume = 0.0;
+    TetMesh.TetIterator ti = mesh.getTets();
+    while (ti.hasNext()) {
+      TetMesh.Tet tet = ti.next();
+      TetMesh.Node a = tet.nodeA(), b = tet.nodeB();
+      TetMesh.Node c = tet.nodeC(), d = tet.nodeD();
+      double v = Geometry.leftOfPlane(
+        a.x(),a.y(),a.z(),b.x(),b.y(),b.z(),
+        c.x(),c.y(),c.z(),d.x(),d.y(),d.z())/6.0;
+      assertTrue(v>0.0);
+      volume += v;
+    }
+    assertEquals((n1-1)*(n2-1)*(n3-1),volume,1.0e-6);
+  }
+
+  public void testImproveQuality() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 2000;
+    TetMesh mesh = new TetMesh();
+    for (int inode=0; inode<nnode; ++inode) {
+      float x = random.nextFloat();
+      float y = random.nextFloat();
+      float z = random.nextFloat();
+      mesh.addNode(new TetMesh.Node(x,y,z));
+    }
+    java.util.HashMap<TetMesh.Node,float[]> hull =
+      new java.util.HashMap<TetMesh.Node,float[]>();
+    TetMesh.FaceIterator fi = mesh.getFacesOnHull();
+    while (fi.hasNext()) {
+      TetMesh.Face face = fi.next();
+      TetMesh.Node[] nodes = {face.nodeA(),face.nodeB(),face.nodeC()};
+      for (TetMesh.Node node:nodes)
+        hull.put(node,new float[]{node.x(),node.y(),node.z()});
+    }
+    double qualityMin = 0.2;
+    int nbefore = countTetsWithQualityLessThan(mesh,qualityMin);
+    double qbefore = minQuality(mesh);
+    int nafter = mesh.improveQuality(qualityMin);
+    mesh.validate();
+    assertEquals(nnode,mesh.countNodes());
+    assertEquals(nafter,countTetsWithQualityLessThan(mesh,qualityMin));
+    assertTrue(nafter<nbefore);
+    assertTrue(minQuality(mesh)>=qbefore);
+    for (TetMesh.Node node:hull.keySet()) {
+      float[] xyz = hull.get(node);
+      assertTrue(node.x()==xyz[0] && node.y()==xyz[1] && node.z()==xyz[2]);
+    }
+  }
+  private static int countTetsWithQualityLessThan(TetMesh mesh, double q) {
+    int n = 0;
+    TetMesh.TetIterator ti = mesh.getTets();
+    while (ti.hasNext()) {
+      if (ti.next().quality()<q)
+        ++n;
+    }
+    return n;
+  }
+  private static double minQuality(TetMesh mesh) {
+    double qmin = 1.0;
+    TetMesh.TetIterator ti = mesh.getTets();
+    while (ti.hasNext())
+      qmin = Math.min(qmin,ti.next().quality());
+    return qmin;
+  }
+
+  public void testNodeGrid() {
+    java.util.Random random = new java.util.Random(314159);
+    TetMesh mesh = new TetMesh();
+    TetMeshNodeGrid grid = new TetMeshNodeGrid(mesh);
+    assertTrue(grid.findNodeNearest(0.5f,0.5f,0.5f)==null);
+    java.util.ArrayList<TetMesh.Node> nodes =
+      new java.util.ArrayList<TetMesh.Node>();
+    for (int inode=0; inode<1000; ++inode) {
+      float x = random.nextFloat();
+      float y = random.nextFloat();
+      float z = random.nextFloat();
+      TetMesh.Node node = new TetMesh.Node(x,y,z);
+      mesh.addNode(node);
+      nodes.add(node);
+    }
+    for (int inode=0; inode<100; ++inode) {
+      TetMesh.Node node = nodes.remove(nodes.size()-1);
+      mesh.removeNode(node);
+    }
+    for (int inode=0; inode<100; ++inode) {
+      TetMesh.Node node = nodes.get(inode);
+      float x = 2.0f*random.nextFloat();
+      float y = 2.0f*random.nextFloat();
+      float z = 2.0f*random.nextFloat();
+      mesh.moveNode(node,x,y,z);
+    }
+    int npoint = 1000;
+    float[] x = new float[npoint];
+    float[] y = new float[npoint];
+    float[] z = new float[npoint];
+    for (int ipoint=0; ipoint<npoint; ++ipoint) {
+      x[ipoint] = 3.0f*random.nextFloat()-0.5f;
+      y[ipoint] = 3.0f*random.nextFloat()-0.5f;
+      z[ipoint] = 3.0f*random.nextFloat()-0.5f;
+    }
+    TetMesh.Node[] nearest = grid.findNodeNearest(x,y,z);
+    for (int ipoint=0; ipoint<npoint; ++ipoint) {
+      double dmin = Double.MAX_VALUE;
+      for (TetMesh.Node node:nodes)
+        dmin = Math.min(dmin,distanceSquared(node,x[ipoint],y[ipoint],
+                                                  z[ipoint]));
+      TetMesh.Node node = nearest[ipoint];
+      assertTrue(node==grid.findNodeNearest(x[ipoint],y[ipoint],z[ipoint]));
+      assertTrue(node==mesh.findNodeNearest(x[ipoint],y[ipoint],z[ipoint]));
+      assertEquals(dmin,distanceSquared(node,x[ipoint],y[ipoint],z[ipoint]),
+        0.0);
+    }
+    double[][] planes = {
+      { 1.0, 2.0, 3.0,-4.0}, // steepest in z
+      { 3.0,-1.0, 0.5,-1.0}, // steepest in x
+      { 0.0, 1.0, 0.0,-0.7}, // perpendicular to y
+      { 1.0, 1.0, 1.0,10.0}, // outside the grid
+    };
+    for (double[] plane:planes) {
+      double a = plane[0], b = plane[1], c = plane[2], d = plane[3];
+      double dmin = Double.MAX_VALUE;
+      for (TetMesh.Node node:nodes) {
+        double dp = a*node.x()+b*node.y()+c*node.z()+d;
+        dmin = Math.min(dmin,dp*dp);
+      }
+      TetMesh.Node node = grid.findNodeNearestPlane(a,b,c,d);
+      double dp = a*node.x()+b*node.y()+c*node.z()+d;
+      assertEquals(dmin,dp*dp,0.0);
+    }
+    grid.dispose();
+    assertTrue(mesh.getNodeGrid()==null);
+  }
+  private static double distanceSquared(
+    TetMesh.Node node, float x, float y, float z)
+  {
+    double dx = x-node.x();
+    double dy = y-node.y();
+    double dz = z-node.z();
+    return dx*dx+dy*dy+dz*dz;
+  }
+
+  public void testNodeGridInit() {
+    TetMesh mesh = new TetMesh();
+    TetMeshNodeGrid grid = new TetMeshNodeGrid(mesh);
+    for (int inode=0; inode<100; ++inode)
+      mesh.addNode(new TetMesh.Node(inode%5,(inode/5)%5,inode/25));
+    assertTrue(grid.findNodeNearest(2.0f,2.0f,2.0f)!=null);
+
+    // After the mesh is initialized, the grid has no nodes, but is still
+    // updated as nodes are added to the mesh.
+    mesh.init();
+    assertTrue(mesh.getNodeGrid()==grid);
+    assertTrue(grid.findNodeNearest(2.0f,2.0f,2.0f)==null);
+    assertTrue(mesh.findNodeNearest(2.0f,2.0f,2.0f)==null);
+    TetMesh.Node node = new TetMesh.Node(5.0f,5.0f,5.0f);
+    mesh.addNode(node);
+    assertTrue(grid.findNodeNearest(2.0f,2.0f,2.0f)==node);
+    assertTrue(mesh.findNodeNearest(2.0f,2.0f,2.0f)==node);
+    grid.dispose();
+  }
+
   public void benchAddNode() {
     java.util.Random random = new java.util.Random();
     for (int itest=0; itest<16; ++itest) {
@@ -385,6 +635,67 @@ public class TetMeshTest extends TestCase {
     }
   }
 
+  public void benchAddNodes() {
+    java.util.Random random = new java.util.Random();
+    for (int itest=0; itest<3; ++itest) {
+      for (int nnode=1000; nnode<=1024000; nnode*=4) {
+        float[] x = new float[nnode];
+        float[] y = new float[nnode];
+        float[] z = new float[nnode];
+        for (int inode=0; inode<nnode; ++inode) {
+          x[inode] = random.nextFloat();
+          y[inode] = random.nextFloat();
+          z[inode] = random.nextFloat();
+        }
+        Stopwatch sw = new Stopwatch();
+        sw.restart();
+        TetMesh ta = new TetMesh();
+        for (int inode=0; inode<nnode; ++inode)
+          ta.addNode(new TetMesh.Node(x[inode],y[inode],z[inode]));
+        sw.stop();
+        double ta1 = sw.time();
+        sw.restart();
+        TetMesh tb = new TetMesh();
+        tb.addNodes(x,y,z);
+        sw.stop();
+        double tb1 = sw.time();
+        System.out.println(
+          "Added "+nnode+" nodes to make "+tb.countTets()+" tets:" +
+          " addNode "+ta1+" s, addNodes "+tb1+" s.");
+      }
+    }
+  }
+
+  public void benchAddNodesParallel() {
+    java.util.Random random = new java.util.Random();
+    for (int itest=0; itest<3; ++itest) {
+      for (int nnode=16000; nnode<=1024000; nnode*=4) {
+        float[] x = new float[nnode];
+        float[] y = new float[nnode];
+        float[] z = new float[nnode];
+        for (int inode=0; inode<nnode; ++inode) {
+          x[inode] = random.nextFloat();
+          y[inode] = random.nextFloat();
+          z[inode] = random.nextFloat();
+        }
+        Stopwatch sw = new Stopwatch();
+        sw.restart();
+        TetMesh ta = new TetMesh();
+        ta.addNodes(x,y,z);
+        sw.stop();
+        double ta1 = sw.time();
+        sw.restart();
+        TetMesh tb = new TetMesh();
+        tb.addNodesParallel(x,y,z);
+        sw.stop();
+        double tb1 = sw.time();
+        System.out.println(
+          "Added "+nnode+" nodes to make "+tb.countTets()+" tets:" +
+          " addNodes "+ta1+" s, addNodesParallel "+tb1+" s.");
+      }
+    }
+  }
+
   public void benchFind() {
     int nnode = 1000;
     int nfind = 10000;
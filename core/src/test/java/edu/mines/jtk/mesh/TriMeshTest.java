@@ -198,6 +198,98 @@ public class TriMeshTest extends TestCase {
     //System.out.println("Nodes added/removed = "+nadd+"/"+nremove);
   }
 
+  public void testAddNodes() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 2000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be added
+    TriMesh ta = new TriMesh();
+    for (int inode=0; inode<nnode; ++inode)
+      ta.addNode(new TriMesh.Node(x[inode],y[inode]));
+    TriMesh tb = new TriMesh();
+    TriMesh.Node[] nodes = tb.addNodes(x,y);
+    tb.validate();
+    assertEquals(nnode-1,tb.countNodes());
+    assertEquals(ta.countTris(),tb.countTris());
+    assertTrue((nodes[0]==null)!=(nodes[nnode-1]==null));
+    for (int inode=1; inode<nnode-1; ++inode)
+      assertTrue(nodes[inode].tri()!=null);
+  }
+
+  public void testAddNodesParallel() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 100000;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      x[inode] = random.nextFloat();
+      y[inode] = random.nextFloat();
+    }
+    x[nnode-1] = x[0]; // a duplicate node
+    y[nnode-1] = y[0]; // will not be added
+    TriMesh ta = new TriMesh();
+    TriMesh.Node[] nodesa = ta.addNodes(x,y);
+    TriMesh tb = new TriMesh();
+    TriMesh.Node[] nodesb;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      nodesb = tb.addNodesParallel(x,y);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    tb.validate();
+    assertEquals(nnode-1,tb.countNodes());
+    assertEquals(ta.countTris(),tb.countTris());
+    assertTrue((nodesb[0]==null)!=(nodesb[nnode-1]==null));
+    for (int inode=1; inode<nnode-1; ++inode) {
+      int na = ta.getTriNabors(nodesa[inode]).length;
+      int nb = tb.getTriNabors(nodesb[inode]).length;
+      assertEquals(na,nb);
+    }
+  }
+
+  public void testAddNodesParallelGrid() {
+    int n1 = 300, n2 = 300;
+    int nnode = n1*n2;
+    float[] x = new float[nnode];
+    float[] y = new float[nnode];
+    for (int i2=0,inode=0; i2<n2; ++i2) {
+      for (int i1=0; i1<n1; ++i1,++inode) {
+        x[inode] = i1;
+        y[inode] = i2;
+      }
+    }
+    TriMesh mesh = new TriMesh();
+    TriMesh.Node[] nodes;
+    ParallelDelaunay.setThreadCount(4);
+    try {
+      nodes = mesh.addNodesParallel(x,y);
+    } finally {
+      ParallelDelaunay.setThreadCount(0);
+    }
+    mesh.validate();
+    assertEquals(nnode,mesh.countNodes());
+    for (int inode=0; inode<nnode; ++inode)
+      assertTrue(nodes[inode].tri()!=null);
+    double area = 0.0;
+    TriMesh.TriIterator ti = mesh.getTris();
+    while (ti.hasNext()) {
+      TriMesh.Tri tri = ti.next();
+      TriMesh.Node a = tri.nodeA(), b = tri.nodeB(), c = tri.nodeC();
+      double v = Geometry.leftOfLine(
+        a.x(),a.y(),b.x(),b.y(),c.x(),c.y())/2.0;
+      assertTrue(v>0.0);
+      area += v;
+    }
+    assertEquals((n1-1)*(n2-1),area,1.0e-6);
+  }
+
   public void benchAddNode() {
     java.util.Random random = new java.util.Random();
     for (int itest=0; itest<3; ++itest) {
@@ -226,6 +318,63 @@ public class TriMeshTest extends TestCase {
     }
   }
 
+  public void benchAddNodes() {
+    java.util.Random random = new java.util.Random();
+    for (int itest=0; itest<3; ++itest) {
+      for (int nnode=1000; nnode<=1024000; nnode*=4) {
+        float[] x = new float[nnode];
+        float[] y = new float[nnode];
+        for (int inode=0; inode<nnode; ++inode) {
+          x[inode] = random.nextFloat();
+          y[inode] = random.nextFloat();
+        }
+        Stopwatch sw = new Stopwatch();
+        sw.restart();
+        TriMesh ta = new TriMesh();
+        for (int inode=0; inode<nnode; ++inode)
+          ta.addNode(new TriMesh.Node(x[inode],y[inode]));
+        sw.stop();
+        double ta1 = sw.time();
+        sw.restart();
+        TriMesh tb = new TriMesh();
+        tb.addNodes(x,y);
+        sw.stop();
+        double tb1 = sw.time();
+        System.out.println(
+          "Added "+nnode+" nodes to make "+tb.countTris()+" tris:" +
+          " addNode "+ta1+" s, addNodes "+tb1+" s.");
+      }
+    }
+  }
+
+  public void benchAddNodesParallel() {
+    java.util.Random random = new java.util.Random();
+    for (int itest=0; itest<3; ++itest) {
+      for (int nnode=16000; nnode<=4096000; nnode*=4) {
+        float[] x = new float[nnode];
+        float[] y = new float[nnode];
+        for (int inode=0; inode<nnode; ++inode) {
+          x[inode] = random.nextFloat();
+          y[inode] = random.nextFloat();
+        }
+        Stopwatch sw = new Stopwatch();
+        sw.restart();
+        TriMesh ta = new TriMesh();
+        ta.addNodes(x,y);
+        sw.stop();
+        double ta1 = sw.time();
+        sw.restart();
+        TriMesh tb = new TriMesh();
+        tb.addNodesParallel(x,y);
+        sw.stop();
+        double tb1 = sw.time();
+        System.out.println(
+          "Added "+nnode+" nodes to make "+tb.countTris()+" tris:" +
+          " addNodes "+ta1+" s, addNodesParallel "+tb1+" s.");
+      }
+    }
+  }
+
   public void benchFind() {
     int nnode = 1000;
     int nfind = 10000;
@@ -56,4 +56,45 @@ public class TriSurfTest extends TestCase {
     ts.addNodes(nodes);
     assertEquals(12,ts.countFaces());
   }
+
+  public void testAddNodesParallel() {
+    java.util.Random random = new java.util.Random(314159);
+    int nnode = 20000;
+    TriSurf.Node[] nodesa = new TriSurf.Node[nnode];
+    TriSurf.Node[] nodesb = new TriSurf.Node[nnode];
+    for (int inode=0; inode<nnode; ++inode) {
+      float x = 2.0f*random.nextFloat()-1.0f;
+      float y = 2.0f*random.nextFloat()-1.0f;
+      float z = 2.0f*random.nextFloat()-1.0f;
+      float s = 1.0f/(float)Math.sqrt(x*x+y*y+z*z);
+      nodesa[inode] = new TriSurf.Node(x*s,y*s,z*s);
+      nodesb[inode] = new TriSurf.Node(x*s,y*s,z*s);
+    }
+    TriSurf tsa = new TriSurf();
+    tsa.addNodes(nodesa);
+    TriSurf tsb = new TriSurf();
+    tsb.addNodesParallel(nodesb);
+    assertEquals(tsa.countNodes(),tsb.countNodes());
+    assertEquals(tsa.countFaces(),tsb.countFaces());
+
+    TriSurf.Triangles t = tsb.getTriangles();
+    int nt = t.ijk.length/3;
+    int nv = t.nodes.length;
+    assertEquals(tsb.countFaces(),nt);
+    assertEquals(3*nv,t.xyz.length);
+    assertEquals(3*nv,t.uvw.length);
+    for (int i=0; i<3*nt; ++i)
+      assertTrue(0<=t.ijk[i] && t.ijk[i]<nv);
+    for (int iv=0; iv<nv; ++iv) {
+      TriSurf.Node node = t.nodes[iv];
+      assertTrue(node.isInSurface());
+      assertEquals(node.x(),t.xyz[3*iv  ]);
+      assertEquals(node.y(),t.xyz[3*iv+1]);
+      assertEquals(node.z(),t.xyz[3*iv+2]);
+      float u = t.uvw[3*iv  ];
+      float v = t.uvw[3*iv+1];
+      float w = t.uvw[3*iv+2];
+      assertEquals(1.0f,u*u+v*v+w*w,0.001f);
+    }
+  }
 }
@@ -0,0 +1,177 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.awt.Color;
+import java.awt.Graphics2D;
+import java.awt.image.BufferedImage;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.dsp.Sampling;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.ContoursView}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.27
+ */
+public class ContoursViewTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(ContoursViewTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testContoursMatchSerial() {
+
+    // Grids large enough that cell edges are marked in parallel.
+    int n1 = 600;
+    int n2 = 500;
+    Sampling s1 = new Sampling(n1);
+    Sampling s2 = new Sampling(n2);
+    float[][][] fs = {bowl(n1,n2),wave(n1,n2)};
+    for (float[][] f:fs) {
+      ContoursView cv = new ContoursView(f);
+      float[] cs = cv.getContours();
+      assertTrue(cs.length>1);
+      for (int ic=0; ic<cs.length; ++ic) {
+        float[][][] c = cv.getContour(ic);
+        float[][][] r = ContoursView.makeContourSerial(cs[ic],s1,s2,f);
+        assertEqual(r,c);
+      }
+    }
+  }
+
+  public void testClosedContours() {
+    int n1 = 600;
+    int n2 = 500;
+    ContoursView cv = new ContoursView(bowl(n1,n2));
+    cv.setContours(new Sampling(8,10000.0,10000.0));
+    float[] cs = cv.getContours();
+    for (int ic=0; ic<cs.length; ++ic) {
+      float rc = (float)Math.sqrt(cs[ic]);
+      float[][][] c = cv.getContour(ic);
+      float[][] x1 = c[0];
+      float[][] x2 = c[1];
+      int ns = x1.length;
+
+      // Circles of radius less than 249.5 lie inside the grid, and are
+      // closed; larger circles are cut by the top and bottom of the grid.
+      if (rc<249.5f) {
+        assertEquals(1,ns);
+        int n = x1[0].length;
+        assertEquals(x1[0][0],x1[0][n-1],0.0f);
+        assertEquals(x2[0][0],x2[0][n-1],0.0f);
+      } else {
+        assertEquals(2,ns);
+        for (int js=0; js<ns; ++js) {
+          int n = x1[js].length;
+          assertTrue(x1[js][0]!=x1[js][n-1] || x2[js][0]!=x2[js][n-1]);
+        }
+      }
+
+      // All points lie on the circle.
+      for (int js=0; js<ns; ++js) {
+        for (int j=0; j<x1[js].length; ++j) {
+          float d1 = x1[js][j]-0.5f*(n1-1);
+          float d2 = x2[js][j]-0.5f*(n2-1);
+          assertEquals(rc,(float)Math.sqrt(d1*d1+d2*d2),0.01f);
+        }
+      }
+    }
+  }
+
+  public void testContoursCache() {
+    ContoursView cv = new ContoursView(bowl(60,50));
+    assertEquals(0,cv.getContoursUpdateCount());
+
+    // Repaints, zooms and changes in line style or orientation reuse the
+    // cached contours.
+    Transcaler ts = new Transcaler(0.0,0.0,1.0,1.0,0,0,599,499);
+    paint(cv,ts);
+    assertEquals(1,cv.getContoursUpdateCount());
+    paint(cv,ts);
+    assertEquals(1,cv.getContoursUpdateCount());
+    paint(cv,new Transcaler(0.0,0.0,1.0,1.0,-600,-500,599,499));
+    assertEquals(1,cv.getContoursUpdateCount());
+    cv.setLineColor(Color.RED);
+    cv.setOrientation(ContoursView.Orientation.X1DOWN_X2RIGHT);
+    paint(cv,ts);
+    assertEquals(1,cv.getContoursUpdateCount());
+
+    // Setting the sampled function or the contour values does not.
+    cv.set(wave(60,50));
+    paint(cv,ts);
+    assertEquals(2,cv.getContoursUpdateCount());
+    cv.setContours(new Sampling(5,0.2,-0.4));
+    paint(cv,ts);
+    assertEquals(3,cv.getContoursUpdateCount());
+    assertEquals(5,cv.getContours().length);
+    cv.setContours(10);
+    paint(cv,ts);
+    assertEquals(4,cv.getContoursUpdateCount());
+    cv.setClips(-0.5f,0.5f);
+    paint(cv,ts);
+    assertEquals(5,cv.getContoursUpdateCount());
+    paint(cv,ts);
+    assertEquals(5,cv.getContoursUpdateCount());
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static void paint(ContoursView cv, Transcaler ts) {
+    int type = BufferedImage.TYPE_INT_RGB;
+    BufferedImage bi = new BufferedImage(600,500,type);
+    Graphics2D g2d = bi.createGraphics();
+    g2d.setClip(0,0,600,500);
+    cv.paint(g2d,
+      cv.getBestHorizontalProjector(),
+      cv.getBestVerticalProjector(),ts);
+    g2d.dispose();
+  }
+
+  private static void assertEqual(float[][][] r, float[][][] c) {
+    for (int k=0; k<2; ++k) {
+      assertEquals(r[k].length,c[k].length);
+      for (int js=0; js<r[k].length; ++js) {
+        assertEquals(r[k][js].length,c[k][js].length);
+        for (int j=0; j<r[k][js].length; ++j)
+          assertEquals(r[k][js][j],c[k][js][j],0.0f);
+      }
+    }
+  }
+
+  // Squared distance from the center of the grid.
+  private static float[][] bowl(int n1, int n2) {
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2) {
+      for (int i1=0; i1<n1; ++i1) {
+        float d1 = i1-0.5f*(n1-1);
+        float d2 = i2-0.5f*(n2-1);
+        f[i2][i1] = d1*d1+d2*d2;
+      }
+    }
+    return f;
+  }
+
+  private static float[][] wave(int n1, int n2) {
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        f[i2][i1] = (float)(Math.sin(0.03*i1)*Math.cos(0.02*i2));
+    return f;
+  }
+}
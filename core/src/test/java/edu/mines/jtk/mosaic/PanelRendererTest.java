@@ -0,0 +1,125 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.awt.image.BufferedImage;
+import java.io.File;
+import java.util.ArrayList;
+import java.util.concurrent.Future;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.PanelRenderer}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.25
+ */
+public class PanelRendererTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(PanelRendererTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testLayout() {
+    PlotPanel panel = makePanel();
+    panel.layoutToSize(800,600);
+    Mosaic mosaic = panel.getMosaic();
+    assertTrue(mosaic.getWidth()>0 && mosaic.getWidth()<=800);
+    assertTrue(mosaic.getHeight()>0 && mosaic.getHeight()<=600);
+    Tile tile = mosaic.getTile(0,0);
+    assertTrue(tile.getWidth()>0 && tile.getHeight()>0);
+  }
+
+  public void testConcurrent() throws Exception {
+    BufferedImage expected =
+      PanelRenderer.paintToImage(makePanel(),400,300,800);
+    assertEquals(800,expected.getWidth());
+    assertEquals(600,expected.getHeight());
+    assertFalse(isUniform(expected));
+    int n = 8;
+    PanelRenderer pr = new PanelRenderer(4);
+    ArrayList<Future<BufferedImage>> futures =
+      new ArrayList<Future<BufferedImage>>();
+    for (int i=0; i<n; ++i)
+      futures.add(pr.submitImage(makePanel(),400,300,800));
+    pr.finish();
+    for (Future<BufferedImage> future:futures)
+      assertTrue(isSame(expected,future.get()));
+  }
+
+  public void testPng() throws Exception {
+    File file = File.createTempFile("PanelRendererTest",".png");
+    try {
+      PanelRenderer pr = new PanelRenderer(2);
+      Future<String> future =
+        pr.submitPng(makePanel(),400,300,72.0,4.0,file.getPath());
+      pr.finish();
+      assertEquals(file.getPath(),future.get());
+      assertTrue(file.length()>0);
+    } finally {
+      file.delete();
+    }
+  }
+
+  public void testFailure() throws Exception {
+    PanelRenderer pr = new PanelRenderer(2);
+    Future<BufferedImage> good = pr.submitImage(makePanel(),400,300,800);
+    Future<BufferedImage> bad = pr.submitImage(makePanel(),400,300,0);
+    try {
+      pr.finish();
+      fail("finish should throw when rendering fails");
+    } catch (RuntimeException e) {
+      assertTrue(e.getCause() instanceof IllegalArgumentException);
+    }
+    assertTrue(good.isDone() && bad.isDone());
+    assertEquals(800,good.get().getWidth());
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static PlotPanel makePanel() {
+    int n1 = 101, n2 = 51;
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        f[i2][i1] = (float)Math.sin(0.1*i1)*(float)Math.cos(0.2*i2);
+    PlotPanel panel = new PlotPanel();
+    panel.addPixels(f);
+    panel.addColorBar();
+    panel.setTitle("test");
+    return panel;
+  }
+
+  private static boolean isUniform(BufferedImage image) {
+    int rgb = image.getRGB(0,0);
+    for (int iy=0; iy<image.getHeight(); ++iy)
+      for (int ix=0; ix<image.getWidth(); ++ix)
+        if (image.getRGB(ix,iy)!=rgb)
+          return false;
+    return true;
+  }
+
+  private static boolean isSame(BufferedImage a, BufferedImage b) {
+    if (a.getWidth()!=b.getWidth() || a.getHeight()!=b.getHeight())
+      return false;
+    for (int iy=0; iy<a.getHeight(); ++iy)
+      for (int ix=0; ix<a.getWidth(); ++ix)
+        if (a.getRGB(ix,iy)!=b.getRGB(ix,iy))
+          return false;
+    return true;
+  }
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.PixelsPyramid}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.23
+ */
+public class PixelsPyramidTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(PixelsPyramidTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testCounts() {
+    assertEquals(1,PixelsPyramid.levelCount(1));
+    assertEquals(2,PixelsPyramid.levelCount(2));
+    assertEquals(3,PixelsPyramid.levelCount(3));
+    assertEquals(18,PixelsPyramid.levelCount(100000));
+    assertEquals(100000,PixelsPyramid.sampleCount(100000,0));
+    assertEquals(50000,PixelsPyramid.sampleCount(100000,1));
+    assertEquals(98,PixelsPyramid.sampleCount(100000,10));
+    assertEquals(1,PixelsPyramid.sampleCount(100000,17));
+    assertEquals(0,PixelsPyramid.levelFor(0.5,1000));
+    assertEquals(0,PixelsPyramid.levelFor(1.9,1000));
+    assertEquals(1,PixelsPyramid.levelFor(2.0,1000));
+    assertEquals(6,PixelsPyramid.levelFor(100.0,100000));
+    assertEquals(2,PixelsPyramid.levelFor(100.0,3));
+  }
+
+  public void testMean() {
+    int n1 = 7, n2 = 5;
+    float[][] f = ramp(n1,n2);
+    PixelsPyramid pp = new PixelsPyramid(f,false);
+    assertSame(f,pp.get(0,0));
+    float[][] g = pp.get(1,1);
+    assertEquals(3,g.length);
+    assertEquals(4,g[0].length);
+    assertEquals(0.25f*(f[0][0]+f[0][1]+f[1][0]+f[1][1]),g[0][0],1.0e-5f);
+    assertEquals(0.5f*(f[4][2]+f[4][3]),g[2][1],1.0e-5f);
+    assertEquals(0.5f*(f[0][6]+f[1][6]),g[0][3],1.0e-5f);
+    assertEquals(f[4][6],g[2][3],1.0e-5f);
+
+    // Built in a different order, the same level has the same values.
+    PixelsPyramid pq = new PixelsPyramid(f,false);
+    pq.get(0,1);
+    float[][] h = pq.get(1,1);
+    for (int i2=0; i2<g.length; ++i2)
+      for (int i1=0; i1<g[0].length; ++i1)
+        assertEquals(g[i2][i1],h[i2][i1],1.0e-5f);
+  }
+
+  public void testPeak() {
+    int n1 = 1000, n2 = 300;
+    float[][] f = new float[n2][n1];
+    f[123][456] = -9.0f;
+    f[7][999] = 5.0f;
+    PixelsPyramid pp = new PixelsPyramid(f,true);
+    float[][] g = pp.get(5,3);
+    assertEquals(PixelsPyramid.sampleCount(n2,3),g.length);
+    assertEquals(PixelsPyramid.sampleCount(n1,5),g[0].length);
+    assertEquals(-9.0f,g[123>>3][456>>5]);
+    assertEquals(5.0f,g[7>>3][999>>5]);
+    float[][] h = pp.get(9,9);
+    assertEquals(1,h.length);
+    assertEquals(2,h[0].length);
+    assertEquals(-9.0f,h[0][0]);
+    assertEquals(5.0f,h[0][1]);
+  }
+
+  private static float[][] ramp(int n1, int n2) {
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        f[i2][i1] = i1+10.0f*i2+0.1f*i1*i2;
+    return f;
+  }
+}
@@ -0,0 +1,132 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.awt.Graphics2D;
+import java.awt.image.BufferedImage;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.awt.ColorMap;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.PixelsView}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.24
+ */
+public class PixelsViewTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(PixelsViewTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testTileReuse() {
+    PixelsView pv = new PixelsView(ramp(101,201));
+    ImageTileCache tc = pv.getTileCache();
+
+    // First paint rasterizes all 4*3 tiles; the second reuses them.
+    Transcaler ts = new Transcaler(0.0,0.0,1.0,1.0,0,0,999,699);
+    paint(pv,ts);
+    assertEquals(12,tc.getMissCount());
+    assertEquals(0,tc.getHitCount());
+    assertEquals(12,tc.size());
+    paint(pv,ts);
+    assertEquals(12,tc.getMissCount());
+    assertEquals(12,tc.getHitCount());
+
+    // Panning reuses tiles.
+    paint(pv,new Transcaler(0.0,0.0,1.0,1.0,-300,0,699,699));
+    assertEquals(12,tc.getMissCount());
+    assertEquals(21,tc.getHitCount());
+
+    // Zooming does not; 5*3 tiles are visible in the zoomed view.
+    paint(pv,new Transcaler(0.0,0.0,1.0,1.0,-1000,0,999,699));
+    assertEquals(27,tc.getMissCount());
+    assertEquals(21,tc.getHitCount());
+
+    // Changing the color model does not invalidate tiles.
+    pv.setColorModel(ColorMap.JET);
+    paint(pv,ts);
+    assertEquals(27,tc.getMissCount());
+    assertEquals(33,tc.getHitCount());
+
+    // Changing clips does.
+    pv.setClips(0.2f,0.8f);
+    paint(pv,ts);
+    assertEquals(39,tc.getMissCount());
+  }
+
+  public void testTilesMatchImage() {
+    float[][] f = wave(101,201);
+    Transcaler[] tss = {
+      new Transcaler(0.0,0.0,1.0,1.0,0,0,999,699), // all tiles full size
+      new Transcaler(0.0,0.0,1.0,1.0,-300,-100,699,599), // panned
+      new Transcaler(0.0,0.0,1.0,1.0,-1000,-500,999,1199), // zoomed
+    };
+    PixelsView.Interpolation[] pis = {
+      PixelsView.Interpolation.LINEAR,
+      PixelsView.Interpolation.NEAREST,
+    };
+    for (PixelsView.Interpolation pi:pis) {
+      PixelsView pv = new PixelsView(f);
+      PixelsView pr = new PixelsView(f);
+      pv.setInterpolation(pi);
+      pr.setInterpolation(pi);
+      pr.setTiled(false);
+      for (Transcaler ts:tss) {
+        BufferedImage bi = paint(pv,ts);
+        BufferedImage br = paint(pr,ts);
+
+        // All pixels, including those on both sides of tile boundaries,
+        // such as pixels 255 and 256, must equal those in the reference.
+        for (int iy=0; iy<700; ++iy)
+          for (int ix=0; ix<1000; ++ix)
+            assertEquals(br.getRGB(ix,iy),bi.getRGB(ix,iy));
+      }
+    }
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static BufferedImage paint(PixelsView pv, Transcaler ts) {
+    int type = BufferedImage.TYPE_INT_RGB;
+    BufferedImage bi = new BufferedImage(1000,700,type);
+    Graphics2D g2d = bi.createGraphics();
+    g2d.setClip(0,0,1000,700);
+    pv.paint(g2d,
+      pv.getBestHorizontalProjector(),
+      pv.getBestVerticalProjector(),ts);
+    g2d.dispose();
+    return bi;
+  }
+
+  private static float[][] wave(int n1, int n2) {
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        f[i2][i1] = (float)(Math.sin(0.3*i1)*Math.cos(0.2*i2));
+    return f;
+  }
+
+  private static float[][] ramp(int n1, int n2) {
+    float[][] f = new float[n2][n1];
+    for (int i2=0; i2<n2; ++i2)
+      for (int i1=0; i1<n1; ++i1)
+        f[i2][i1] = (float)i1/(float)(n1-1);
+    return f;
+  }
+}
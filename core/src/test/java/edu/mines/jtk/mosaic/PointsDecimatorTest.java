@@ -0,0 +1,120 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.PointsDecimator}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.26
+ */
+public class PointsDecimatorTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(PointsDecimatorTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testBins() {
+    PointsDecimator.Bins b = new PointsDecimator.Bins(0.3,false);
+    assertEquals(-2,b.getExponent());
+    assertEquals(0L,b.bin(0.1f));
+    assertEquals(1L,b.bin(0.3f));
+    assertEquals(-1L,b.bin(-0.1f));
+    PointsDecimator.Bins bl = new PointsDecimator.Bins(1.0,true);
+    assertEquals(2L,bl.bin(100.0f));
+    assertEquals(bl.bin(0.0f),bl.bin(-1.0f));
+    assertFalse(PointsDecimator.isBinnable(0.0));
+    assertFalse(PointsDecimator.isBinnable(Double.POSITIVE_INFINITY));
+  }
+
+  public void testEnvelope() {
+    int n = 1000001;
+    float[] u = new float[n];
+    float[] w = new float[n];
+    Random r = new Random(3);
+    for (int i=0; i<n; ++i) {
+      u[i] = i*0.001f;
+      w[i] = (float)Math.sin(0.01*i)+r.nextFloat();
+    }
+    PointsDecimator.Bins bu = new PointsDecimator.Bins(1.0,false);
+    int[] k = PointsDecimator.envelope(n,u,w,bu);
+    assertEquals(0,k[0]);
+    assertEquals(n-1,k[k.length-1]);
+    for (int j=1; j<k.length; ++j)
+      assertTrue(k[j-1]<k[j]);
+
+    // At most four points per bin, plus a few for chunk boundaries.
+    assertTrue(k.length<=4*1001+4*16);
+
+    // Envelopes of all points and kept points are the same in each bin.
+    HashMap<Long,float[]> all = envelopes(n,null,u,w,bu);
+    HashMap<Long,float[]> kept = envelopes(k.length,k,u,w,bu);
+    assertEquals(all.size(),kept.size());
+    for (Long b:all.keySet()) {
+      assertEquals(all.get(b)[0],kept.get(b)[0]);
+      assertEquals(all.get(b)[1],kept.get(b)[1]);
+    }
+  }
+
+  public void testCells() {
+    int n = 200000;
+    float[] u = new float[n];
+    float[] w = new float[n];
+    Random r = new Random(5);
+    for (int i=0; i<n; ++i) {
+      u[i] = (float)r.nextGaussian();
+      w[i] = (float)r.nextGaussian();
+    }
+    PointsDecimator.Bins bu = new PointsDecimator.Bins(0.5,false);
+    PointsDecimator.Bins bw = new PointsDecimator.Bins(0.5,false);
+    int[] k = PointsDecimator.cells(n,u,w,bu,bw);
+    HashSet<String> cellsAll = new HashSet<String>();
+    for (int i=0; i<n; ++i)
+      cellsAll.add(bu.bin(u[i])+","+bw.bin(w[i]));
+    HashSet<String> cellsKept = new HashSet<String>();
+    for (int j=0; j<k.length; ++j)
+      cellsKept.add(bu.bin(u[k[j]])+","+bw.bin(w[k[j]]));
+    assertEquals(cellsAll,cellsKept);
+    assertTrue(k.length<=cellsAll.size()*4);
+    assertTrue(k.length<n/100);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static HashMap<Long,float[]> envelopes(
+    int m, int[] k, float[] u, float[] w, PointsDecimator.Bins bu)
+  {
+    HashMap<Long,float[]> e = new HashMap<Long,float[]>();
+    for (int j=0; j<m; ++j) {
+      int i = (k!=null)?k[j]:j;
+      long b = bu.bin(u[i]);
+      float[] ei = e.get(b);
+      if (ei==null) {
+        e.put(b,new float[]{w[i],w[i]});
+      } else {
+        ei[0] = Math.min(ei[0],w[i]);
+        ei[1] = Math.max(ei[1],w[i]);
+      }
+    }
+    return e;
+  }
+}
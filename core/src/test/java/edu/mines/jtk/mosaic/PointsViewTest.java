@@ -0,0 +1,134 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.mosaic;
+
+import java.awt.BasicStroke;
+import java.awt.Graphics2D;
+import java.awt.RenderingHints;
+import java.awt.image.BufferedImage;
+import java.util.Random;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/**
+ * Tests {@link edu.mines.jtk.mosaic.PointsView}.
+ * @author Dave Hale, Colorado School of Mines
+ * @version 2017.04.26
+ */
+public class PointsViewTest extends TestCase {
+  public static void main(String[] args) {
+    TestSuite suite = new TestSuite(PointsViewTest.class);
+    junit.textui.TestRunner.run(suite);
+  }
+
+  public void testNotDecimatedByDefault() {
+    int n = 20000;
+    float[][] x = walk(n);
+    PointsView pv = new PointsView(x[0],x[1]);
+    assertFalse(pv.isDecimated());
+
+    // Lines through all points, as painted without decimation.
+    Transcaler ts = new Transcaler(0.0,0.0,1.0,1.0,0,0,599,399);
+    Projector hp = pv.getBestHorizontalProjector();
+    Projector vp = pv.getBestVerticalProjector();
+    BufferedImage bi = paint(pv,hp,vp,ts);
+    BufferedImage br = image();
+    Graphics2D g2d = br.createGraphics();
+    g2d.setRenderingHint(
+      RenderingHints.KEY_ANTIALIASING,
+      RenderingHints.VALUE_ANTIALIAS_ON);
+    g2d.setStroke(new BasicStroke(1.0f));
+    int[][] xy = computeXY(hp,vp,ts,x);
+    g2d.drawPolyline(xy[0],xy[1],n);
+    g2d.dispose();
+    assertEqualImages(br,bi);
+  }
+
+  public void testLabelsNotDecimated() {
+    int n = 5000;
+    float[][] x = walk(n);
+    PointsView pv = new PointsView(x[0],x[1],x[2]);
+    pv.setLineStyle(PointsView.Line.NONE);
+    pv.setDecimated(true);
+
+    // Labels for all points, including those decimated for marks.
+    Transcaler ts = new Transcaler(0.0,0.0,1.0,1.0,0,0,599,399);
+    Projector hp = pv.getBestHorizontalProjector();
+    Projector vp = pv.getBestVerticalProjector();
+    BufferedImage bi = paint(pv,hp,vp,ts);
+    BufferedImage br = image();
+    Graphics2D g2d = br.createGraphics();
+    g2d.setRenderingHint(
+      RenderingHints.KEY_ANTIALIASING,
+      RenderingHints.VALUE_ANTIALIAS_ON);
+    int s = Math.round(g2d.getFont().getSize2D()/2.0f)/2;
+    int[][] xy = computeXY(hp,vp,ts,x);
+    for (int i=0; i<n; ++i) {
+      String label = String.format("%1.4G",x[2][i]);
+      g2d.drawString(label,xy[0][i]+s,xy[1][i]-s);
+    }
+    g2d.dispose();
+    assertEqualImages(br,bi);
+  }
+
+  ///////////////////////////////////////////////////////////////////////////
+  // private
+
+  private static BufferedImage image() {
+    return new BufferedImage(600,400,BufferedImage.TYPE_INT_RGB);
+  }
+
+  private static BufferedImage paint(
+    PointsView pv, Projector hp, Projector vp, Transcaler ts)
+  {
+    BufferedImage bi = image();
+    Graphics2D g2d = bi.createGraphics();
+    pv.paint(g2d,hp,vp,ts);
+    g2d.dispose();
+    return bi;
+  }
+
+  private static int[][] computeXY(
+    Projector hp, Projector vp, Transcaler ts, float[][] x)
+  {
+    ts = ts.combineWith(hp,vp);
+    int n = x[0].length;
+    int[][] xy = new int[2][n];
+    for (int i=0; i<n; ++i) {
+      xy[0][i] = ts.x(x[0][i]);
+      xy[1][i] = ts.y(x[1][i]);
+    }
+    return xy;
+  }
+
+  private static void assertEqualImages(BufferedImage br, BufferedImage bi) {
+    for (int iy=0; iy<br.getHeight(); ++iy)
+      for (int ix=0; ix<br.getWidth(); ++ix)
+        assertEquals(br.getRGB(ix,iy),bi.getRGB(ix,iy));
+  }
+
+  // Random walk (x1,x2), with labels x3.
+  private static float[][] walk(int n) {
+    Random r = new Random(7);
+    float[][] x = new float[3][n];
+    for (int i=1; i<n; ++i) {
+      x[0][i] = x[0][i-1]+r.nextFloat()-0.5f;
+      x[1][i] = x[1][i-1]+r.nextFloat()-0.5f;
+      x[2][i] = i;
+    }
+    return x;
+  }
+}
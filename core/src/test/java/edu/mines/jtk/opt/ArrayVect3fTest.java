@@ -51,6 +51,71 @@ public class ArrayVect3fTest extends TestCase {
     assert Almost.FLOAT.equal(1./7., v.magnitude());
   }
 
+  /** Test parallel and fused operations, and pooled clones. */
+  public void testFusedAndPooled() {
+    float[][][] a = new float[31][17][11];
+    float[][][] b = new float[31][17][11];
+    for (int i=0; i<a.length; ++i) {
+      for (int j=0; j<a[i].length; ++j) {
+        for (int k=0; k<a[i][j].length; ++k) {
+          a[i][j][k] = i+2.5f*j - 1.7f*k;
+          b[i][j][k] = 0.3f*i - j + 0.5f*k;
+        }
+      }
+    }
+    ArrayVect3f va = new ArrayVect3f(a, 1.0);
+
+    // By default, a disposed clone does not give its array to the pool.
+    ArrayVect3f vx = va.clone();
+    float[][][] x = vx.getData();
+    vx.dispose();
+    vx = va.clone();
+    assert vx.getData() != x;
+    vx.dispose();
+
+    WorkspacePool.setEnabled(true);
+    try {
+      testPooled(a, b);
+    } finally {
+      WorkspacePool.setEnabled(false);
+    }
+  }
+
+  /** Test pooled clones, with pooling enabled. */
+  private static void testPooled(float[][][] a, float[][][] b) {
+    ArrayVect3f va = new ArrayVect3f(a, 1.0);
+    ArrayVect3f vb = new ArrayVect3f(b, 1.0);
+    ArrayVect3f vc = va.clone();
+    vc.add(0.5, -2.0, vb);
+    double expected = vc.dot(vb);
+    ArrayVect3f vd = va.clone();
+    double actual = VectUtil.addAndDot(vd, 0.5, -2.0, vb, vb);
+    assert Almost.FLOAT.equal(expected, actual);
+    assert Almost.FLOAT.equal(vc.dot(vc), vd.dot(vc));
+
+    // A disposed clone gives its array to the next clone.
+    float[][][] d = vd.getData();
+    vd.dispose();
+    ArrayVect3f ve = vb.clone();
+    assert ve.getData() == d;
+    assert Almost.FLOAT.equal(vb.dot(vb), ve.dot(vb));
+
+    // Wrapped arrays are never pooled.
+    va.dispose();
+    ArrayVect3f vf = vb.clone();
+    assert vf.getData() != a;
+
+    // Non-rectangular arrays are cloned row by row, and never pooled.
+    float[][][] c = {{{1.0f, 2.0f}, {3.0f}}, {{4.0f}, {5.0f, 6.0f, 7.0f}}};
+    ArrayVect3f vg = new ArrayVect3f(c, 1.0);
+    ArrayVect3f vh = vg.clone();
+    float[][][] h = vh.getData();
+    assert h[1][1].length == 3 && h[1][1][2] == 7.0f;
+    assert Almost.FLOAT.equal(vg.dot(vg), vh.dot(vg));
+    vh.dispose();
+    assert vg.clone().getData() != h;
+  }
+
   // OPTIONAL OPTIONAL OPTIONAL OPTIONAL OPTIONAL OPTIONAL OPTIONAL
 
   /* Initialize objects used by all test methods */
@@ -0,0 +1,126 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.opt;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+/** Unit tests for edu.mines.jtk.opt.LbfgsSolver.
+*/
+public class LbfgsSolverTest extends TestCase {
+
+  /** Minimize an extended Rosenbrock function. */
+  public void testRosenbrock() {
+    LbfgsSolver solver = new LbfgsSolver(ROSENBROCK, 5);
+    solver.setGradientTolerance(1.0e-10);
+    checkRosenbrock(solver.solve(makeStart(100), 1000, null));
+    assert solver.converged() : "converged";
+    assert solver.getEvaluationCount() < 3*solver.getIterationCount() :
+      "most steps accepted: "+solver.getEvaluationCount();
+  }
+
+  /** Same minimum with concurrent trial steps in line searches. */
+  public void testConcurrentEvaluations() {
+    LbfgsSolver solver = new LbfgsSolver(ROSENBROCK, 5);
+    solver.setGradientTolerance(1.0e-10);
+    solver.setConcurrentEvaluations(4);
+    checkRosenbrock(solver.solve(makeStart(100), 1000, null));
+    assert solver.converged() : "converged";
+  }
+
+  /** A quadratic converges in about as many iterations as CG. */
+  public void testQuadratic() {
+    final int n = 50;
+    DifferentiableFunction func = new DifferentiableFunction() {
+        public double evaluate(VectConst x, Vect g) {
+          double[] xa = ((ArrayVect1)x).getData();
+          double[] ga = ((ArrayVect1)g).getData();
+          double f = 0.0;
+          for (int i=0; i<n; ++i) {
+            double ai = 1.0+i;
+            ga[i] = ai*(xa[i]-1.0);
+            f += 0.5*ai*(xa[i]-1.0)*(xa[i]-1.0);
+          }
+          return f;
+        }
+      };
+    LbfgsSolver solver = new LbfgsSolver(func, 10);
+    solver.setGradientTolerance(1.0e-8);
+    ArrayVect1 x = (ArrayVect1) solver.solve(
+      new ArrayVect1(new double[n], 1.0), 200, null);
+    for (int i=0; i<n; ++i)
+      assert Math.abs(x.getData()[i]-1.0)<1.0e-6 : "x["+i+"]";
+    assert solver.getIterationCount() < 2*n : "iterations";
+  }
+
+  // The extended Rosenbrock function, sum of pairs
+  // 100*(x[i+1]-x[i]^2)^2 + (1-x[i])^2, with minimum zero at x = 1.
+  // The function is thread-safe.
+  static final DifferentiableFunction ROSENBROCK =
+    new DifferentiableFunction() {
+      public double evaluate(VectConst x, Vect g) {
+        double[] xa = ((ArrayVect1)x).getData();
+        double[] ga = ((ArrayVect1)g).getData();
+        double f = 0.0;
+        for (int i=0; i<xa.length; i+=2) {
+          double t1 = 1.0-xa[i];
+          double t2 = 10.0*(xa[i+1]-xa[i]*xa[i]);
+          ga[i+1] = 20.0*t2;
+          ga[i] = -2.0*(xa[i]*ga[i+1]+t1);
+          f += t1*t1+t2*t2;
+        }
+        return f;
+      }
+    };
+
+  // Standard start (-1.2,1,-1.2,1,...) for the Rosenbrock function.
+  static ArrayVect1 makeStart(int n) {
+    double[] x = new double[n];
+    for (int i=0; i<n; i+=2) {
+      x[i  ] = -1.2;
+      x[i+1] =  1.0;
+    }
+    return new ArrayVect1(x, 1.0);
+  }
+
+  static void checkRosenbrock(Vect v) {
+    double[] x = ((ArrayVect1)v).getData();
+    for (int i=0; i<x.length; ++i)
+      assert Math.abs(x[i]-1.0)<1.0e-4 : "x["+i+"]="+x[i];
+  }
+
+  // NO NEED TO CHANGE THE FOLLOWING
+
+  /** Standard constructor calls TestCase(name) constructor
+      @param name Name of junit Test.
+   */
+  public LbfgsSolverTest(String name) {super (name);}
+
+  /** This automatically generates a suite of all "test" methods.
+      @return A suite of all junit tests as a Test.
+   */
+  public static junit.framework.Test suite() {
+    try {assert false; throw new IllegalStateException("need -ea");}
+    catch (AssertionError e) {}
+    return new TestSuite(LbfgsSolverTest.class);
+  }
+
+  /** Run all tests with text gui if this class main is invoked
+      @param args Command-line arguments.
+   */
+  public static void main (String[] args) {
+    junit.textui.TestRunner.run(suite());
+  }
+}
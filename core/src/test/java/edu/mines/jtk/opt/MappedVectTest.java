@@ -0,0 +1,114 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.opt;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import edu.mines.jtk.io.MappedFloatArray;
+import edu.mines.jtk.util.Almost;
+
+/** Unit tests for edu.mines.jtk.opt.MappedVect.
+*/
+public class MappedVectTest extends TestCase {
+
+  /** Run VectUtil tests, with more than one chunk of floats. */
+  public void testAll() {
+    MappedVect v = makeVect(3000001, 2.2);
+    VectUtil.test(v);
+    v.dispose();
+  }
+
+  /** Solve a diagonal system with conjugate gradients. */
+  public void testQuadraticSolver() {
+    final int n = 100000;
+    Quadratic q = new Quadratic() {
+        public void multiplyHessian(Vect x) {
+          MappedFloatArray a = ((MappedVect)x).getData();
+          for (int i=0; i<n; ++i)
+            a.set(i, a.get(i)*(1.0f+i%3));
+        }
+        public void inverseHessian(Vect x) {}
+        public Vect getB() {
+          MappedVect b = new MappedVect(null, n, 1.0);
+          for (int i=0; i<n; ++i)
+            b.getData().set(i, -(1.0f+i%3));
+          return b;
+        }
+      };
+    QuadraticSolver qs = new QuadraticSolver(q);
+    MappedVect x = (MappedVect) qs.solve(3, null);
+    for (int i=0; i<n; i+=997)
+      assert Almost.FLOAT.equal(1.0, x.getData().get(i)) : "x["+i+"]";
+    x.dispose();
+  }
+
+  /** Disposed vectors give their files to new vectors and clones. */
+  public void testPool() {
+    MappedVect.clearPool();
+    MappedVect u = makeVect(1000, 1.0);
+    java.io.File file = u.getData().getFile();
+    u.dispose();
+    MappedVect v = new MappedVect(null, 1000, 1.0);
+    assert v.getData().getFile().equals(file);
+    for (int i=0; i<1000; ++i)
+      assert v.getData().get(i) == 0.0f;
+    MappedVect w = makeVect(1000, 1.0);
+    v.dispose();
+    MappedVect x = w.clone();
+    assert x.getData().getFile().equals(file);
+    assert Almost.FLOAT.equal(w.dot(w), x.dot(w));
+    w.dispose();
+    x.dispose();
+    MappedVect.clearPool();
+    assert !file.exists();
+  }
+
+  private static MappedVect makeVect(long n, double variance) {
+    MappedVect v = new MappedVect(null, n, variance);
+    MappedFloatArray a = v.getData();
+    float[] b = new float[1000];
+    for (long i=0; i<n; i+=b.length) {
+      int m = (int)Math.min(b.length, n-i);
+      for (int j=0; j<m; ++j)
+        b[j] = (float)Math.sin(0.001*(i+j)) + 0.5f;
+      a.set(i, m, b, 0);
+    }
+    return v;
+  }
+
+  // NO NEED TO CHANGE THE FOLLOWING
+
+  /** Standard constructor calls TestCase(name) constructor
+      @param name Name of junit Test.
+   */
+  public MappedVectTest(String name) {super (name);}
+
+  /** This automatically generates a suite of all "test" methods.
+      @return A suite of all junit tests as a Test.
+   */
+  public static junit.framework.Test suite() {
+    try {assert false; throw new IllegalStateException("need -ea");}
+    catch (AssertionError e) {}
+    return new TestSuite(MappedVectTest.class);
+  }
+
+  /** Run all tests with text gui if this class main is invoked
+      @param args Command-line arguments.
+   */
+  public static void main (String[] args) {
+    junit.textui.TestRunner.run(suite());
+  }
+}
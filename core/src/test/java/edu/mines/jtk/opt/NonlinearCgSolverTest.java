@@ -0,0 +1,75 @@
+/****************************************************************************
+Copyright 2017, Colorado School of Mines and others.
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+****************************************************************************/
+package edu.mines.jtk.opt;
+
+import junit.framework.TestCase;
+import junit.framework.TestSuite;
+
+import static edu.mines.jtk.opt.LbfgsSolverTest.*;
+
+/** Unit tests for edu.mines.jtk.opt.NonlinearCgSolver.
+*/
+public class NonlinearCgSolverTest extends TestCase {
+
+  /** Minimize an extended Rosenbrock function. */
+  public void testRosenbrock() {
+    NonlinearCgSolver solver = new NonlinearCgSolver(ROSENBROCK);
+    solver.setGradientTolerance(1.0e-10);
+    checkRosenbrock(solver.solve(makeStart(100), 5000, null));
+    assert solver.converged() : "converged";
+  }
+
+  /** Same minimum with concurrent trial steps in line searches. */
+  public void testConcurrentEvaluations() {
+    NonlinearCgSolver solver = new NonlinearCgSolver(ROSENBROCK);
+    solver.setGradientTolerance(1.0e-10);
+    solver.setConcurrentEvaluations(3);
+    checkRosenbrock(solver.solve(makeStart(100), 5000, null));
+    assert solver.converged() : "converged";
+  }
+
+  /** A zero gradient requires no iterations. */
+  public void testMinimumStart() {
+    NonlinearCgSolver solver = new NonlinearCgSolver(ROSENBROCK);
+    double[] x = new double[10];
+    java.util.Arrays.fill(x, 1.0);
+    solver.solve(new ArrayVect1(x, 1.0), 10, null);
+    assert solver.getIterationCount()==0 : "no iterations";
+    assert solver.getValue()==0.0 : "value";
+  }
+
+  // NO NEED TO CHANGE THE FOLLOWING
+
+  /** Standard constructor calls TestCase(name) constructor
+      @param name Name of junit Test.
+   */
+  public NonlinearCgSolverTest(String name) {super (name);}
+
+  /** This automatically generates a suite of all "test" methods.
+      @return A suite of all junit tests as a Test.
+   */
+  public static junit.framework.Test suite() {
+    try {assert false; throw new IllegalStateException("need -ea");}
+    catch (AssertionError e) {}
+    return new TestSuite(NonlinearCgSolverTest.class);
+  }
+
+  /** Run all tests with text gui if this class main is invoked
+      @param args Command-line arguments.
+   */
+  public static void main (String[] args) {
+    junit.textui.TestRunner.run(suite());
+  }
+}